@@ -0,0 +1,92 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <tenzir/aggregation_function.hpp>
+#include <tenzir/arrow_table_slice.hpp>
+#include <tenzir/hash/hash.hpp>
+#include <tenzir/plugin.hpp>
+#include <tenzir/sketch/hyperloglog.hpp>
+
+#include <arrow/util/bit_run_reader.h>
+
+#include <cmath>
+
+namespace tenzir::plugins::approx_count_distinct {
+
+namespace {
+
+template <concrete_type Type>
+class approx_count_distinct_function final : public aggregation_function {
+public:
+  explicit approx_count_distinct_function(type input_type) noexcept
+    : aggregation_function(std::move(input_type)) {
+    // nop
+  }
+
+private:
+  [[nodiscard]] auto output_type() const -> type override {
+    return type{uint64_type{}};
+  }
+
+  void add(const data_view& view) override {
+    using view_type = tenzir::view<type_to_data_t<Type>>;
+    if (caf::holds_alternative<caf::none_t>(view))
+      return;
+    sketch_.add(hash(caf::get<view_type>(view)));
+  }
+
+  void add(const arrow::Array& array) override {
+    if (array.null_count() == array.length())
+      return;
+    const auto& type = caf::get<Type>(input_type());
+    arrow::internal::VisitSetBitRunsVoid(
+      array.null_bitmap_data(), array.offset(), array.length(),
+      [&](int64_t position, int64_t length) {
+        for (auto row = position; row < position + length; ++row)
+          sketch_.add(hash(value_at(type, array, row)));
+      });
+  }
+
+  [[nodiscard]] auto finish() && -> caf::expected<data> override {
+    return data{static_cast<uint64_t>(std::llround(sketch_.estimate()))};
+  }
+
+  sketch::hyperloglog sketch_ = {};
+};
+
+class plugin : public virtual aggregation_function_plugin {
+  auto initialize([[maybe_unused]] const record& plugin_config,
+                  [[maybe_unused]] const record& global_config)
+    -> caf::error override {
+    return {};
+  }
+
+  [[nodiscard]] auto name() const -> std::string override {
+    return "approx_count_distinct";
+  };
+
+  [[nodiscard]] auto make_aggregation_function(const type& input_type) const
+    -> caf::expected<std::unique_ptr<aggregation_function>> override {
+    auto f = [&]<concrete_type Type>(
+               const Type&) -> std::unique_ptr<aggregation_function> {
+      return std::make_unique<approx_count_distinct_function<Type>>(
+        input_type);
+    };
+    return caf::visit(f, input_type);
+  }
+
+  auto aggregation_default() const -> data override {
+    return uint64_t{0};
+  }
+};
+
+} // namespace
+
+} // namespace tenzir::plugins::approx_count_distinct
+
+TENZIR_REGISTER_PLUGIN(tenzir::plugins::approx_count_distinct::plugin)
@@ -0,0 +1,141 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <tenzir/aggregation_function.hpp>
+#include <tenzir/arrow_table_slice.hpp>
+#include <tenzir/hash/hash.hpp>
+#include <tenzir/plugin.hpp>
+#include <tenzir/sketch/space_saving.hpp>
+
+#include <arrow/util/bit_run_reader.h>
+
+namespace tenzir::plugins::approx_top {
+
+namespace {
+
+template <concrete_type Type>
+struct heterogeneous_data_hash {
+  using is_transparent = void;
+
+  [[nodiscard]] auto operator()(view<type_to_data_t<Type>> value) const
+    -> size_t {
+    return hash(value);
+  }
+
+  [[nodiscard]] auto operator()(const type_to_data_t<Type>& value) const
+    -> size_t
+    requires(!std::is_same_v<view<type_to_data_t<Type>>, type_to_data_t<Type>>)
+  {
+    return hash(make_view(value));
+  }
+};
+
+template <concrete_type Type>
+struct heterogeneous_data_equal {
+  using is_transparent = void;
+
+  [[nodiscard]] auto operator()(const type_to_data_t<Type>& lhs,
+                                const type_to_data_t<Type>& rhs) const -> bool {
+    return lhs == rhs;
+  }
+
+  [[nodiscard]] auto operator()(const type_to_data_t<Type>& lhs,
+                                view<type_to_data_t<Type>> rhs) const -> bool
+    requires(!std::is_same_v<view<type_to_data_t<Type>>, type_to_data_t<Type>>)
+  {
+    return make_view(lhs) == rhs;
+  }
+};
+
+template <concrete_type Type>
+class approx_top_function final : public aggregation_function {
+public:
+  explicit approx_top_function(type input_type) noexcept
+    : aggregation_function(std::move(input_type)) {
+    // nop
+  }
+
+private:
+  [[nodiscard]] auto output_type() const -> type override {
+    return type{list_type{record_type{
+      {"value", input_type()},
+      {"count", uint64_type{}},
+    }}};
+  }
+
+  void add(const data_view& view) override {
+    using view_type = tenzir::view<type_to_data_t<Type>>;
+    if (caf::holds_alternative<caf::none_t>(view))
+      return;
+    add_value(caf::get<view_type>(view));
+  }
+
+  void add(const arrow::Array& array) override {
+    if (array.null_count() == array.length())
+      return;
+    const auto& type = caf::get<Type>(input_type());
+    arrow::internal::VisitSetBitRunsVoid(
+      array.null_bitmap_data(), array.offset(), array.length(),
+      [&](int64_t position, int64_t length) {
+        for (auto row = position; row < position + length; ++row)
+          add_value(value_at(type, array, row));
+      });
+  }
+
+  void add_value(view<type_to_data_t<Type>> value) {
+    sketch_.add(value, [](const auto& x) {
+      return materialize(x);
+    });
+  }
+
+  [[nodiscard]] auto finish() && -> caf::expected<data> override {
+    auto result = list{};
+    for (auto& counter : sketch_.top()) {
+      result.emplace_back(record{
+        {"value", data{std::move(counter.value)}},
+        {"count", counter.count},
+      });
+    }
+    return data{std::move(result)};
+  }
+
+  sketch::space_saving<type_to_data_t<Type>, heterogeneous_data_hash<Type>,
+                       heterogeneous_data_equal<Type>>
+    sketch_ = {};
+};
+
+class plugin : public virtual aggregation_function_plugin {
+  auto initialize([[maybe_unused]] const record& plugin_config,
+                  [[maybe_unused]] const record& global_config)
+    -> caf::error override {
+    return {};
+  }
+
+  [[nodiscard]] auto name() const -> std::string override {
+    return "approx_top";
+  };
+
+  [[nodiscard]] auto make_aggregation_function(const type& input_type) const
+    -> caf::expected<std::unique_ptr<aggregation_function>> override {
+    auto f = [&]<concrete_type Type>(
+               const Type&) -> std::unique_ptr<aggregation_function> {
+      return std::make_unique<approx_top_function<Type>>(input_type);
+    };
+    return caf::visit(f, input_type);
+  }
+
+  auto aggregation_default() const -> data override {
+    return list{};
+  }
+};
+
+} // namespace
+
+} // namespace tenzir::plugins::approx_top
+
+TENZIR_REGISTER_PLUGIN(tenzir::plugins::approx_top::plugin)
@@ -7,6 +7,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <tenzir/aggregation_function.hpp>
+#include <tenzir/detail/aggregation_kernels.hpp>
 #include <tenzir/detail/passthrough.hpp>
 #include <tenzir/hash/hash.hpp>
 #include <tenzir/plugin.hpp>
@@ -75,6 +76,10 @@ private:
     }
   }
 
+  void add(const arrow::Array& array) override {
+    detail::insert_distinct(caf::get<Type>(input_type()), array, distinct_);
+  }
+
   [[nodiscard]] auto finish() && -> caf::expected<data> override {
     return data{uint64_t{distinct_.size()}};
   }
@@ -7,8 +7,11 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <tenzir/aggregation_function.hpp>
+#include <tenzir/detail/aggregation_kernels.hpp>
 #include <tenzir/plugin.hpp>
 
+#include <functional>
+
 namespace tenzir::plugins::max {
 
 namespace {
@@ -35,6 +38,16 @@ private:
       max_ = materialize(caf::get<view_type>(view));
   }
 
+  void add(const arrow::Array& array) override {
+    if constexpr (detail::has_extremum_kernel_v<Type>) {
+      auto value = detail::select_extremum<Type>(array, std::greater<>{});
+      if (value && (!max_ || *value > *max_))
+        max_ = std::move(value);
+    } else {
+      aggregation_function::add(array);
+    }
+  }
+
   [[nodiscard]] caf::expected<data> finish() && override {
     return data{max_};
   }
@@ -7,8 +7,11 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <tenzir/aggregation_function.hpp>
+#include <tenzir/detail/aggregation_kernels.hpp>
 #include <tenzir/plugin.hpp>
 
+#include <functional>
+
 namespace tenzir::plugins::min {
 
 namespace {
@@ -35,6 +38,16 @@ private:
       min_ = materialize(caf::get<view_type>(view));
   }
 
+  void add(const arrow::Array& array) override {
+    if constexpr (detail::has_extremum_kernel_v<Type>) {
+      auto value = detail::select_extremum<Type>(array, std::less<>{});
+      if (value && (!min_ || *value < *min_))
+        min_ = std::move(value);
+    } else {
+      aggregation_function::add(array);
+    }
+  }
+
   [[nodiscard]] caf::expected<data> finish() && override {
     return data{min_};
   }
@@ -0,0 +1,132 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <tenzir/aggregation_function.hpp>
+#include <tenzir/detail/string_literal.hpp>
+#include <tenzir/detail/type_traits.hpp>
+#include <tenzir/plugin.hpp>
+#include <tenzir/sketch/tdigest.hpp>
+
+#include <arrow/util/bit_run_reader.h>
+
+namespace tenzir::plugins::quantile {
+
+namespace {
+
+template <class Type>
+concept quantile_type
+  = detail::is_any_v<Type, int64_type, uint64_type, double_type, duration_type>;
+
+template <quantile_type Type>
+class quantile_function final : public aggregation_function {
+public:
+  quantile_function(type input_type, double quantile) noexcept
+    : aggregation_function(std::move(input_type)), quantile_{quantile} {
+    // nop
+  }
+
+private:
+  [[nodiscard]] auto output_type() const -> type override {
+    if constexpr (std::is_same_v<Type, duration_type>)
+      return type{duration_type{}};
+    else
+      return type{double_type{}};
+  }
+
+  void add(const data_view& view) override {
+    using view_type = tenzir::view<type_to_data_t<Type>>;
+    if (caf::holds_alternative<caf::none_t>(view))
+      return;
+    const auto value = caf::get<view_type>(view);
+    if constexpr (std::is_same_v<Type, duration_type>)
+      digest_.add(static_cast<double>(value.count()));
+    else
+      digest_.add(static_cast<double>(value));
+  }
+
+  void add(const arrow::Array& array) override {
+    const auto& typed_array = caf::get<type_to_arrow_array_t<Type>>(array);
+    if (typed_array.null_count() == typed_array.length())
+      return;
+    arrow::internal::VisitSetBitRunsVoid(
+      typed_array.null_bitmap_data(), typed_array.offset(),
+      typed_array.length(), [&](int64_t position, int64_t length) {
+        const auto* values = typed_array.raw_values() + position;
+        for (auto i = int64_t{0}; i < length; ++i)
+          digest_.add(static_cast<double>(values[i]));
+      });
+  }
+
+  [[nodiscard]] auto finish() && -> caf::expected<data> override {
+    const auto result = digest_.quantile(quantile_);
+    if (not result)
+      return data{};
+    if constexpr (std::is_same_v<Type, duration_type>)
+      return data{duration{static_cast<duration::rep>(*result)}};
+    else
+      return data{*result};
+  }
+
+  double quantile_ = {};
+  sketch::tdigest digest_ = {};
+};
+
+/// An approximate quantile aggregation function. The quantile is given in
+/// per mille, as floating-point template parameters are not yet supported
+/// everywhere.
+template <detail::string_literal Name, int PerMille>
+class plugin final : public virtual aggregation_function_plugin {
+  static_assert(PerMille >= 0 and PerMille <= 1000);
+
+  auto initialize([[maybe_unused]] const record& plugin_config,
+                  [[maybe_unused]] const record& global_config)
+    -> caf::error override {
+    return {};
+  }
+
+  [[nodiscard]] auto name() const -> std::string override {
+    return std::string{Name.str()};
+  };
+
+  [[nodiscard]] auto make_aggregation_function(const type& input_type) const
+    -> caf::expected<std::unique_ptr<aggregation_function>> override {
+    auto f = detail::overload{
+      [&]<quantile_type Type>(const Type&)
+        -> caf::expected<std::unique_ptr<aggregation_function>> {
+        return std::make_unique<quantile_function<Type>>(
+          input_type, static_cast<double>(PerMille) / 1000.0);
+      },
+      [&](const auto&)
+        -> caf::expected<std::unique_ptr<aggregation_function>> {
+        return caf::make_error(ec::invalid_configuration,
+                               fmt::format("{} aggregation function does not "
+                                           "support type {}",
+                                           Name.str(), input_type));
+      },
+    };
+    return caf::visit(f, input_type);
+  }
+
+  auto aggregation_default() const -> data override {
+    return caf::none;
+  }
+};
+
+using median_plugin = plugin<"median", 500>;
+using p90_plugin = plugin<"p90", 900>;
+using p95_plugin = plugin<"p95", 950>;
+using p99_plugin = plugin<"p99", 990>;
+
+} // namespace
+
+} // namespace tenzir::plugins::quantile
+
+TENZIR_REGISTER_PLUGIN(tenzir::plugins::quantile::median_plugin)
+TENZIR_REGISTER_PLUGIN(tenzir::plugins::quantile::p90_plugin)
+TENZIR_REGISTER_PLUGIN(tenzir::plugins::quantile::p95_plugin)
+TENZIR_REGISTER_PLUGIN(tenzir::plugins::quantile::p99_plugin)
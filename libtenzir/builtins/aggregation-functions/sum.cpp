@@ -7,12 +7,36 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <tenzir/aggregation_function.hpp>
+#include <tenzir/detail/type_traits.hpp>
 #include <tenzir/plugin.hpp>
 
+#include <arrow/util/bit_run_reader.h>
+
+#include <array>
+
 namespace tenzir::plugins::sum {
 
 namespace {
 
+/// Sums a contiguous range of values. Independent partial sums allow for
+/// vectorization and hide the latency of floating-point additions.
+template <class Accumulator, class T>
+auto sum_values(const T* values, int64_t length) -> Accumulator {
+  auto partial = std::array<Accumulator, 4>{};
+  auto i = int64_t{0};
+  for (; i + 4 <= length; i += 4) {
+    partial[0] += static_cast<Accumulator>(values[i]);
+    partial[1] += static_cast<Accumulator>(values[i + 1]);
+    partial[2] += static_cast<Accumulator>(values[i + 2]);
+    partial[3] += static_cast<Accumulator>(values[i + 3]);
+  }
+  auto result = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+  for (; i < length; ++i) {
+    result += static_cast<Accumulator>(values[i]);
+  }
+  return result;
+}
+
 template <basic_type Type>
 class sum_function final : public aggregation_function {
 public:
@@ -37,6 +61,34 @@ private:
       sum_ = *sum_ + materialize(caf::get<view_type>(view));
   }
 
+  void add(const arrow::Array& array) override {
+    if constexpr (detail::is_any_v<Type, int64_type, uint64_type, double_type,
+                                   duration_type>) {
+      const auto& typed_array = caf::get<type_to_arrow_array_t<Type>>(array);
+      if (typed_array.null_count() == typed_array.length())
+        return;
+      using value_type
+        = std::remove_cvref_t<decltype(*typed_array.raw_values())>;
+      // Signed integers are summed as unsigned integers so that overflow
+      // wraps around instead of being undefined behavior.
+      using accumulator_type
+        = std::conditional_t<std::is_integral_v<value_type>,
+                             std::make_unsigned_t<value_type>, value_type>;
+      auto result = accumulator_type{};
+      arrow::internal::VisitSetBitRunsVoid(
+        typed_array.null_bitmap_data(), typed_array.offset(),
+        typed_array.length(), [&](int64_t position, int64_t length) {
+          result += sum_values<accumulator_type>(
+            typed_array.raw_values() + position, length);
+        });
+      const auto value
+        = type_to_data_t<Type>{static_cast<value_type>(result)};
+      sum_ = sum_ ? *sum_ + value : value;
+    } else {
+      aggregation_function::add(array);
+    }
+  }
+
   [[nodiscard]] caf::expected<data> finish() && override {
     return data{sum_};
   }
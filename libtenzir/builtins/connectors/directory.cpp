@@ -8,13 +8,20 @@
 
 #include <tenzir/argument_parser.hpp>
 #include <tenzir/concept/parseable/tenzir/pipeline.hpp>
+#include <tenzir/concept/parseable/tenzir/si.hpp>
+#include <tenzir/concept/printable/tenzir/json_printer_options.hpp>
+#include <tenzir/data.hpp>
 #include <tenzir/diagnostics.hpp>
+#include <tenzir/logger.hpp>
+#include <tenzir/output_partitioning.hpp>
 #include <tenzir/plugin.hpp>
 #include <tenzir/tql/parser.hpp>
 
 #include <caf/error.hpp>
 
 #include <filesystem>
+#include <fstream>
+#include <mutex>
 #include <system_error>
 
 namespace tenzir::plugins::directory {
@@ -23,16 +30,42 @@ struct saver_args {
   std::string path;
   bool append;
   bool real_time;
+  std::optional<output_partitioning> partitioning;
 
   template <class Inspector>
   friend auto inspect(Inspector& f, saver_args& x) -> bool {
     return f.object(x)
       .pretty_name("saver_args")
       .fields(f.field("path", x.path), f.field("append", x.append),
-              f.field("real_time", x.real_time));
+              f.field("real_time", x.real_time),
+              f.field("partitioning", x.partitioning));
   }
 };
 
+/// Lists the files that a partitioning saver wrote, with one JSON object per
+/// line that gets added when the file is closed.
+class manifest {
+public:
+  manifest(const std::filesystem::path& path, bool append)
+    : path_{path},
+      stream_{path, append ? std::ios::app : std::ios::trunc} {
+  }
+
+  void add(const record& entry) {
+    auto line = to_json(entry, {.style = no_style(), .oneline = true});
+    TENZIR_ASSERT(line);
+    auto lock = std::unique_lock{mutex_};
+    stream_ << *line << '\n' << std::flush;
+    if (not stream_)
+      TENZIR_WARN("failed to write manifest {}", path_);
+  }
+
+private:
+  std::filesystem::path path_;
+  std::mutex mutex_;
+  std::ofstream stream_;
+};
+
 class directory_saver final : public plugin_saver {
 public:
   directory_saver() = default;
@@ -52,7 +85,7 @@ public:
                              "cannot use directory saver outside of `to "
                              "directory write ...`");
     }
-    auto dir_path = std::filesystem::path(args_.path);
+    auto dir_path = std::filesystem::path(args_.path) / info->partition;
     std::error_code ec{};
     std::filesystem::create_directories(dir_path, ec);
     if (ec) {
@@ -60,10 +93,19 @@ public:
                              fmt::format("creating directory {} failed: {}",
                                          dir_path, ec.message()));
     }
-    auto file_path
-      = dir_path
-        / fmt::format("{}.{}.{}", info->input_schema.name(),
-                      info->input_schema.make_fingerprint(), info->format);
+    // Partitioned output may consist of many files per schema and partition,
+    // so we number them.
+    auto file_name
+      = args_.partitioning
+          ? fmt::format("{}.{}.{}.{}", info->input_schema.name(),
+                        info->input_schema.make_fingerprint(),
+                        info->sequence_number, info->format)
+          : fmt::format("{}.{}.{}", info->input_schema.name(),
+                        info->input_schema.make_fingerprint(), info->format);
+    auto file_path = dir_path / file_name;
+    if (args_.partitioning and not manifest_)
+      manifest_ = std::make_shared<manifest>(
+        std::filesystem::path{args_.path} / "_manifest.ndjson", args_.append);
     auto const* p = plugins::find<saver_parser_plugin>("file");
     if (!p) {
       return caf::make_error(ec::unspecified, "could not find `file` saver");
@@ -83,19 +125,34 @@ public:
     } catch (diagnostic& d) {
       return caf::make_error(ec::unspecified, fmt::format("{:?}", d));
     }
+    auto entry = record{
+      {"path", (std::filesystem::path{info->partition} / file_name).string()},
+      {"partition", info->partition},
+      {"schema", std::string{info->input_schema.name()}},
+      {"format", info->format},
+    };
     auto file_saver = parsed->instantiate(ctrl, std::move(info));
     if (not file_saver)
       return std::move(file_saver.error());
-    auto guard = caf::detail::make_scope_guard([=] {
-      // We also print this when the operator fails at runtime, but
-      // then again this also means that we did create the file, so
-      // that's probably alright.
-      fmt::print(stdout, "{}\n", file_path.string());
-    });
-    return [file_saver = std::move(*file_saver),
+    auto bytes = std::make_shared<uint64_t>(0);
+    auto guard = caf::detail::make_scope_guard(
+      [file_path, bytes, manifest = manifest_, entry = std::move(entry)] {
+        // We also print this when the operator fails at runtime, but
+        // then again this also means that we did create the file, so
+        // that's probably alright.
+        fmt::print(stdout, "{}\n", file_path.string());
+        if (manifest) {
+          auto closed = entry;
+          closed.emplace("bytes", *bytes);
+          manifest->add(closed);
+        }
+      });
+    return [file_saver = std::move(*file_saver), bytes,
             guard = std::make_shared<decltype(guard)>(std::move(guard))](
              chunk_ptr input) {
       (void)guard;
+      if (input)
+        *bytes += input->size();
       // TODO: handle overwrite semantics
       return file_saver(std::move(input));
     };
@@ -105,6 +162,10 @@ public:
     return false;
   }
 
+  auto partitioning() const -> std::optional<output_partitioning> override {
+    return args_.partitioning;
+  }
+
   auto default_printer() const -> std::string override {
     return "json";
   }
@@ -115,6 +176,7 @@ public:
 
 private:
   saver_args args_;
+  std::shared_ptr<manifest> manifest_;
 };
 
 class plugin : public virtual saver_plugin<directory_saver> {
@@ -124,10 +186,64 @@ public:
     auto parser = argument_parser{name(), "https://docs.tenzir.com/next/"
                                           "connectors/directory"};
     auto args = saver_args{};
+    auto partition_by = std::vector<std::string>{};
+    auto max_rows = std::optional<located<uint64_t>>{};
+    auto max_size = std::optional<located<std::string>>{};
+    auto max_age = std::optional<located<duration>>{};
+    auto max_open_files = std::optional<located<uint64_t>>{};
     parser.add(args.path, "<path>");
     parser.add("-a,--append", args.append);
     parser.add("-r,--real-time", args.real_time);
+    parser.add("--partition-by", partition_by, "<key>");
+    parser.add("--max-rows", max_rows, "<count>");
+    parser.add("--max-size", max_size, "<bytes>");
+    parser.add("--max-age", max_age, "<duration>");
+    parser.add("--max-open-files", max_open_files, "<count>");
     parser.parse(p);
+    if (partition_by.empty() and not max_rows and not max_size
+        and not max_age) {
+      if (max_open_files)
+        diagnostic::error("`--max-open-files` requires partitioning or "
+                          "rotation")
+          .primary(max_open_files->source)
+          .hint("use `--partition-by`, `--max-rows`, `--max-size`, or "
+                "`--max-age`")
+          .throw_();
+      return std::make_unique<directory_saver>(std::move(args));
+    }
+    auto partitioning = output_partitioning{};
+    for (const auto& key : partition_by) {
+      auto parsed = parse_partition_key(key);
+      if (not parsed)
+        diagnostic::error(parsed.error())
+          .note("from `--partition-by`")
+          .throw_();
+      partitioning.keys.push_back(std::move(*parsed));
+    }
+    const auto check_positive = [](const auto& option) {
+      if (option and option->inner <= decltype(option->inner){})
+        diagnostic::error("value must be positive")
+          .primary(option->source)
+          .throw_();
+    };
+    check_positive(max_rows);
+    check_positive(max_age);
+    check_positive(max_open_files);
+    if (max_rows)
+      partitioning.max_rows = max_rows->inner;
+    if (max_size) {
+      if (not parsers::bytesize(max_size->inner, partitioning.max_bytes)
+          or partitioning.max_bytes == 0)
+        diagnostic::error("invalid size `{}`", max_size->inner)
+          .primary(max_size->source)
+          .hint("use a positive number of bytes, e.g., `100Mi`")
+          .throw_();
+    }
+    if (max_age)
+      partitioning.max_age = max_age->inner;
+    if (max_open_files)
+      partitioning.max_open_files = max_open_files->inner;
+    args.partitioning = std::move(partitioning);
     return std::make_unique<directory_saver>(std::move(args));
   }
 };
@@ -8,6 +8,7 @@
 
 #include <tenzir/argument_parser.hpp>
 #include <tenzir/location.hpp>
+#include <tenzir/object_storage.hpp>
 #include <tenzir/plugin.hpp>
 
 #include <arrow/filesystem/filesystem.h>
@@ -24,11 +25,13 @@ namespace {
 struct s3_args {
   bool anonymous;
   located<std::string> uri;
+  object_read_args read;
 
   template <class Inspector>
   friend auto inspect(Inspector& f, s3_args& x) -> bool {
     return f.object(x).pretty_name("s3_args").fields(
-      f.field("anonymous", x.anonymous), f.field("uri", x.uri));
+      f.field("anonymous", x.anonymous), f.field("uri", x.uri),
+      f.field("read", x.read));
   }
 };
 
@@ -49,6 +52,7 @@ auto get_options(const s3_args& args) -> arrow::fs::S3Options {
 // upper limit defined by execution nodes for transporting events.
 // TODO: Get the backpressure-adjusted value at runtime from the execution node.
 constexpr size_t max_chunk_size = 1 << 20;
+
 } // namespace
 
 class s3_loader final : public plugin_loader {
@@ -78,39 +82,28 @@ public:
             .emit(ctrl.diagnostics());
           co_return;
         }
-        auto file_info = fs.ValueUnsafe()->GetFileInfo(
-          fmt::format("{}/{}", uri.host(), uri.path()));
-        if (not file_info.ok()) {
-          diagnostic::error("failed to get file info for URI "
-                            "`{}`: {}",
-                            args.uri.inner, file_info.status().ToString())
-            .primary(args.uri.source)
-            .emit(ctrl.diagnostics());
-          co_return;
-        }
-        auto input_stream = fs.ValueUnsafe()->OpenInputStream(*file_info);
-        if (not input_stream.ok()) {
-          diagnostic::error("failed to open input stream for URI "
-                            "`{}`: {}",
-                            args.uri.inner, input_stream.status().ToString())
+        // The path may refer to many objects, which we read concurrently
+        // with ranged reads.
+        auto files = expand_object_paths(
+          *fs.ValueUnsafe(), fmt::format("{}/{}", uri.host(), uri.path()));
+        if (not files) {
+          diagnostic::error("failed to resolve URI `{}`: {}", args.uri.inner,
+                            files.error())
             .primary(args.uri.source)
             .emit(ctrl.diagnostics());
           co_return;
         }
-        while (not input_stream.ValueUnsafe()->closed()) {
-          auto buffer = input_stream.ValueUnsafe()->Read(max_chunk_size);
-          if (not input_stream.ok()) {
-            diagnostic::error("failed to read from input stream for URI "
-                              "`{}`: {}",
-                              args.uri.inner, buffer.status().ToString())
+        auto chunks = read_objects(fs.MoveValueUnsafe(), std::move(*files),
+                                   args.read.to_options(max_chunk_size));
+        for (auto&& chunk : chunks) {
+          if (not chunk) {
+            diagnostic::error("failed to read from URI `{}`: {}",
+                              args.uri.inner, chunk.error())
               .primary(args.uri.source)
               .emit(ctrl.diagnostics());
             co_return;
           }
-          if (buffer.ValueUnsafe()->size() == 0) {
-            break;
-          }
-          co_yield chunk::make(buffer.MoveValueUnsafe());
+          co_yield std::move(*chunk);
         }
       }(args_, ctrl);
   }
@@ -249,8 +242,10 @@ public:
       fmt::format("https://docs.tenzir.com/docs/next/connectors/{}", name())};
     auto args = s3_args{};
     parser.add("--anonymous", args.anonymous);
+    args.read.add_to(parser);
     parser.add(args.uri, "<uri>");
     parser.parse(p);
+    args.read.validate();
     // TODO: URI parser.
     if (not args.uri.inner.starts_with("s3://"))
       args.uri.inner = fmt::format("s3://{}", args.uri.inner);
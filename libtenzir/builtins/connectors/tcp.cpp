@@ -13,15 +13,21 @@
 #include <tenzir/detail/string_literal.hpp>
 #include <tenzir/location.hpp>
 #include <tenzir/plugin.hpp>
+#include <tenzir/tcp_framing.hpp>
 
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <span>
 #include <system_error>
+#include <thread>
 
 using namespace std::chrono_literals;
 
@@ -322,6 +328,476 @@ auto make_tcp_bridge(tcp_bridge_actor::stateful_pointer<tcp_bridge_state> self)
   };
 }
 
+/// A thread-safe pool of read buffers. Chunks created by the pool return their
+/// buffer for reuse once they are no longer referenced.
+class buffer_pool : public std::enable_shared_from_this<buffer_pool> {
+public:
+  /// The size of the buffers managed by the pool.
+  static constexpr auto buffer_size = size_t{65'536};
+
+  /// The maximum number of idle buffers kept for reuse.
+  static constexpr auto max_idle_buffers = size_t{1'024};
+
+  buffer_pool() {
+    // Reserving upfront guarantees that returning a buffer never allocates.
+    idle_.reserve(max_idle_buffers);
+  }
+
+  /// Returns a buffer of at least the given size.
+  auto acquire(size_t size) -> std::vector<std::byte> {
+    if (size > buffer_size)
+      return std::vector<std::byte>(size);
+    auto lock = std::unique_lock{mutex_};
+    if (idle_.empty()) {
+      lock.unlock();
+      return std::vector<std::byte>(buffer_size);
+    }
+    auto result = std::move(idle_.back());
+    idle_.pop_back();
+    return result;
+  }
+
+  /// Creates a chunk from the first `size` bytes of a buffer acquired from the
+  /// pool. Reads that fill less than half of the buffer are copied into a
+  /// compact chunk and the buffer returns to the pool right away, so that a
+  /// chunk never occupies more than twice its size.
+  auto make_chunk(std::vector<std::byte> buffer, size_t size,
+                  chunk_metadata metadata) -> chunk_ptr {
+    TENZIR_ASSERT(size <= buffer.size());
+    if (size < buffer.size() / 2) {
+      auto result = chunk::copy(std::span<const std::byte>{buffer.data(), size},
+                                std::move(metadata));
+      release(std::move(buffer));
+      return result;
+    }
+    auto owned = std::make_unique<std::vector<std::byte>>(std::move(buffer));
+    const auto view = chunk::view_type{owned->data(), size};
+    return chunk::make(
+      view,
+      [pool = weak_from_this(), owned = std::move(owned)]() mutable noexcept {
+        if (auto self = pool.lock())
+          self->release(std::move(*owned));
+      },
+      std::move(metadata));
+  }
+
+  /// Returns a buffer acquired from the pool for reuse.
+  void release(std::vector<std::byte> buffer) noexcept {
+    if (buffer.size() != buffer_size)
+      return;
+    auto lock = std::unique_lock{mutex_};
+    if (idle_.size() < max_idle_buffers)
+      idle_.push_back(std::move(buffer));
+  }
+
+private:
+  std::mutex mutex_ = {};
+  std::vector<std::vector<std::byte>> idle_ = {};
+};
+
+/// A pool of threads that drives the connections of all TCP listeners in the
+/// process. It exists for as long as any listener uses it.
+class tcp_reactor {
+public:
+  /// Returns the reactor, starting it if necessary.
+  static auto get() -> std::shared_ptr<tcp_reactor> {
+    static auto mutex = std::mutex{};
+    static auto instance = std::weak_ptr<tcp_reactor>{};
+    auto lock = std::unique_lock{mutex};
+    auto result = instance.lock();
+    if (not result) {
+      result = std::make_shared<tcp_reactor>();
+      instance = result;
+    }
+    return result;
+  }
+
+  tcp_reactor() : guard_{boost::asio::make_work_guard(io_ctx_)} {
+    const auto num_threads
+      = std::clamp(size_t{std::thread::hardware_concurrency()} / 2, size_t{1},
+                   size_t{8});
+    for (auto i = size_t{0}; i < num_threads; ++i)
+      threads_.emplace_back([this] {
+        io_ctx_.run();
+      });
+  }
+
+  tcp_reactor(const tcp_reactor&) = delete;
+  auto operator=(const tcp_reactor&) -> tcp_reactor& = delete;
+
+  ~tcp_reactor() noexcept {
+    io_ctx_.stop();
+    for (auto& thread : threads_)
+      thread.join();
+  }
+
+  auto context() -> boost::asio::io_context& {
+    return io_ctx_;
+  }
+
+private:
+  boost::asio::io_context io_ctx_ = {};
+  boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+    guard_;
+  std::vector<std::thread> threads_ = {};
+};
+
+/// A connection accepted by the TCP listener.
+struct tcp_connection {
+  tcp_connection(boost::asio::ip::tcp::socket socket, tcp_framing framing)
+    : socket{std::move(socket)}, framer{framing} {
+    auto ec = boost::system::error_code{};
+    auto endpoint = this->socket.remote_endpoint(ec);
+    if (not ec)
+      peer = fmt::format("{}:{}", endpoint.address().to_string(),
+                         endpoint.port());
+  }
+
+  template <class Buffer, class Handler>
+  void async_read_some(const Buffer& buffer, Handler&& handler) {
+    if (tls_socket)
+      tls_socket->async_read_some(buffer, std::forward<Handler>(handler));
+    else
+      socket.async_read_some(buffer, std::forward<Handler>(handler));
+  }
+
+  // The socket of the connection, bound to a strand of the reactor.
+  boost::asio::ip::tcp::socket socket;
+
+  // TLS stream wrapping `socket` if we're in TLS mode.
+  std::optional<boost::asio::ssl::stream<boost::asio::ip::tcp::socket&>>
+    tls_socket = {};
+
+  // The address of the remote peer.
+  std::string peer = {};
+
+  // The framing state, accessed only by the reactor.
+  tcp_framer framer;
+};
+
+using tcp_listener_actor = caf::typed_actor<
+  // Start accepting connections.
+  auto(atom::accept)->caf::result<void>,
+  // Retrieve all chunks read so far, waiting for at least one.
+  auto(atom::read)->caf::result<std::vector<chunk_ptr>>>;
+
+struct tcp_listener_options {
+  std::string hostname = {};
+  std::string port = {};
+  std::string tls_certfile = {};
+  std::string tls_keyfile = {};
+  tcp_framing framing = {};
+  bool listen_once = false;
+};
+
+/// The sockets of a TCP listener. Their handlers run on the shared reactor, so
+/// the listener closes them there when it terminates, which cancels all of
+/// their pending operations.
+struct tcp_listener_sockets {
+  // The acceptor for incoming connections, bound to a strand of the reactor.
+  std::optional<boost::asio::ip::tcp::acceptor> acceptor = {};
+
+  // The accepted connections.
+  std::vector<std::weak_ptr<tcp_connection>> connections = {};
+};
+
+struct tcp_listener_state {
+  static constexpr auto name = "tcp-listener";
+
+  // The amount of data that we buffer before pausing reads.
+  static constexpr auto max_buffered_bytes = size_t{16} << 20;
+
+  tcp_listener_options options = {};
+
+  // The reactor running the async callbacks, shared with other listeners.
+  std::shared_ptr<tcp_reactor> reactor = tcp_reactor::get();
+
+  // The sockets of the listener.
+  std::shared_ptr<tcp_listener_sockets> sockets
+    = std::make_shared<tcp_listener_sockets>();
+
+  // The TLS context shared by all connections if we're in TLS mode.
+  std::optional<boost::asio::ssl::context> ssl_ctx = {};
+
+  // The pool for read buffers.
+  std::shared_ptr<buffer_pool> pool = std::make_shared<buffer_pool>();
+
+  // The number of open connections.
+  size_t num_connections = 0;
+
+  // Connections that wait for buffered data to be consumed before reading.
+  std::vector<std::shared_ptr<tcp_connection>> paused = {};
+
+  // Data read but not yet retrieved.
+  std::vector<chunk_ptr> chunks = {};
+  size_t buffered_bytes = 0;
+
+  // Set when the listener cannot accept any more connections.
+  caf::error error = {};
+
+  // Promise that is delivered whenever new data arrives.
+  caf::typed_response_promise<std::vector<chunk_ptr>> read_rp = {};
+};
+
+using tcp_listener_pointer
+  = tcp_listener_actor::stateful_pointer<tcp_listener_state>;
+
+void deliver_chunks(tcp_listener_pointer self);
+
+void read_from_connection(tcp_listener_pointer self,
+                          std::shared_ptr<tcp_connection> connection);
+
+void handle_read(tcp_listener_pointer self,
+                 std::shared_ptr<tcp_connection> connection, chunk_ptr chunk,
+                 caf::error err, bool closed) {
+  if (chunk) {
+    self->state.buffered_bytes += chunk->size();
+    self->state.chunks.push_back(std::move(chunk));
+  }
+  if (closed) {
+    if (err)
+      TENZIR_WARN("{} closes connection to {}: {}", *self, connection->peer,
+                  err);
+    else
+      TENZIR_VERBOSE("{} lost connection to {}", *self, connection->peer);
+    TENZIR_ASSERT(self->state.num_connections > 0);
+    --self->state.num_connections;
+    if (self->state.num_connections == 0 && not self->state.sockets->acceptor
+        && not self->state.error)
+      self->state.error
+        = caf::make_error(ec::end_of_input, "connection closed");
+  } else if (self->state.buffered_bytes < self->state.max_buffered_bytes) {
+    read_from_connection(self, std::move(connection));
+  } else {
+    self->state.paused.push_back(std::move(connection));
+  }
+  deliver_chunks(self);
+}
+
+void read_from_connection(tcp_listener_pointer self,
+                          std::shared_ptr<tcp_connection> connection) {
+  auto buffer = self->state.pool->acquire(connection->framer.read_size());
+  auto offset = connection->framer.prepare(buffer);
+  auto asio_buffer
+    = boost::asio::buffer(buffer.data() + offset, buffer.size() - offset);
+  // The framing happens on the reactor thread so that the actor only needs to
+  // move chunks around.
+  connection->async_read_some(
+    asio_buffer,
+    [self, weak_hdl = caf::actor_cast<caf::weak_actor_ptr>(self),
+     pool = self->state.pool, connection, buffer = std::move(buffer),
+     offset](boost::system::error_code ec, size_t length) mutable {
+      auto chunk = chunk_ptr{};
+      auto err = caf::error{};
+      auto closed = static_cast<bool>(ec);
+      if (ec) {
+        pool->release(std::move(buffer));
+        if (ec != boost::asio::error::eof
+            && ec != boost::asio::ssl::error::stream_truncated)
+          err = caf::make_error(ec::system_error,
+                                fmt::format("failed to read from TCP socket: "
+                                            "{}",
+                                            ec.message()));
+        if (auto remainder = connection->framer.finish(); not remainder)
+          err = std::move(remainder.error());
+        else if (not remainder->empty())
+          chunk = chunk::make(std::move(*remainder),
+                              chunk_metadata{.origin = connection->peer});
+      } else if (auto size = connection->framer.frame(buffer, offset + length);
+                 not size) {
+        err = std::move(size.error());
+        closed = true;
+      } else if (*size > 0) {
+        chunk = pool->make_chunk(std::move(buffer), *size,
+                                 chunk_metadata{.origin = connection->peer});
+      } else {
+        // The framer carried over everything, so we can reuse the buffer.
+        pool->release(std::move(buffer));
+      }
+      if (auto hdl = weak_hdl.lock()) {
+        caf::anon_send(caf::actor_cast<caf::actor>(hdl),
+                       caf::make_action([self, connection, chunk,
+                                         err = std::move(err), closed] {
+                         handle_read(self, connection, chunk, err, closed);
+                       }));
+      }
+    });
+}
+
+void deliver_chunks(tcp_listener_pointer self) {
+  if (not self->state.read_rp.pending())
+    return;
+  if (not self->state.chunks.empty()) {
+    self->state.read_rp.deliver(std::exchange(self->state.chunks, {}));
+    self->state.buffered_bytes = 0;
+    for (auto& connection : std::exchange(self->state.paused, {}))
+      read_from_connection(self, std::move(connection));
+    return;
+  }
+  if (self->state.error)
+    self->state.read_rp.deliver(self->state.error);
+}
+
+void accept_connection(tcp_listener_pointer self) {
+  TENZIR_ASSERT(self->state.sockets->acceptor);
+  // Every connection gets its own strand, so that the handlers of a
+  // connection never run concurrently.
+  self->state.sockets->acceptor->async_accept(
+    boost::asio::make_strand(self->state.reactor->context()),
+    [self, weak_hdl = caf::actor_cast<caf::weak_actor_ptr>(self)](
+      boost::system::error_code ec, boost::asio::ip::tcp::socket peer) {
+      auto hdl = weak_hdl.lock();
+      if (not hdl)
+        return;
+      caf::anon_send(
+        caf::actor_cast<caf::actor>(hdl),
+        caf::make_action([self, ec, peer = std::move(peer)]() mutable {
+          if (ec) {
+            self->state.error = caf::make_error(
+              ec::system_error,
+              fmt::format("failed to accept: {}", ec.message()));
+            self->state.sockets->acceptor.reset();
+            deliver_chunks(self);
+            return;
+          }
+          auto connection = std::make_shared<tcp_connection>(
+            std::move(peer), self->state.options.framing);
+          TENZIR_VERBOSE("{} accepted connection from {}", *self,
+                         connection->peer);
+          ++self->state.num_connections;
+          std::erase_if(self->state.sockets->connections,
+                        [](const auto& x) {
+                          return x.expired();
+                        });
+          self->state.sockets->connections.push_back(connection);
+          if (self->state.options.listen_once)
+            self->state.sockets->acceptor.reset();
+          else
+            accept_connection(self);
+          if (not self->state.ssl_ctx) {
+            read_from_connection(self, std::move(connection));
+            return;
+          }
+          connection->tls_socket.emplace(connection->socket,
+                                         *self->state.ssl_ctx);
+          connection->tls_socket->async_handshake(
+            boost::asio::ssl::stream_base::server,
+            [self, weak_hdl = caf::actor_cast<caf::weak_actor_ptr>(self),
+             connection](boost::system::error_code ec) {
+              auto hdl = weak_hdl.lock();
+              if (not hdl)
+                return;
+              caf::anon_send(
+                caf::actor_cast<caf::actor>(hdl),
+                caf::make_action([self, connection, ec] {
+                  if (ec) {
+                    handle_read(self, connection, {},
+                                caf::make_error(ec::system_error,
+                                                fmt::format("TLS handshake "
+                                                            "failed: {}",
+                                                            ec.message())),
+                                true);
+                    return;
+                  }
+                  read_from_connection(self, connection);
+                }));
+            });
+        }));
+    });
+}
+
+auto make_tcp_listener(tcp_listener_pointer self, tcp_listener_options options)
+  -> tcp_listener_actor::behavior_type {
+  self->state.options = std::move(options);
+  // Closing the sockets on the reactor cancels their pending operations, which
+  // releases the connections. The functor keeps the reactor alive until then.
+  self->attach_functor([reactor = self->state.reactor,
+                        sockets = self->state.sockets] {
+    if (sockets->acceptor) {
+      auto executor = sockets->acceptor->get_executor();
+      boost::asio::post(executor, [sockets] {
+        auto ec = boost::system::error_code{};
+        sockets->acceptor->close(ec);
+      });
+    }
+    for (const auto& weak_connection : sockets->connections) {
+      if (auto connection = weak_connection.lock()) {
+        auto executor = connection->socket.get_executor();
+        boost::asio::post(executor, [connection] {
+          auto ec = boost::system::error_code{};
+          connection->socket.close(ec);
+        });
+      }
+    }
+  });
+  return {
+    [self](atom::accept) -> caf::result<void> {
+      if (self->state.sockets->acceptor) {
+        return caf::make_error(ec::logic_error,
+                               fmt::format("{} is already accepting "
+                                           "connections",
+                                           *self));
+      }
+      const auto& options = self->state.options;
+      auto ec = boost::system::error_code{};
+      auto resolver
+        = boost::asio::ip::tcp::resolver{self->state.reactor->context()};
+      auto endpoints = resolver.resolve(options.hostname, options.port, ec);
+      if (ec || endpoints.empty()) {
+        return caf::make_error(
+          ec::system_error, fmt::format("failed to resolve host {}, service {}",
+                                        options.hostname, options.port));
+      }
+      auto endpoint = endpoints.begin()->endpoint();
+      try {
+        if (not options.tls_certfile.empty()) {
+          self->state.ssl_ctx.emplace(boost::asio::ssl::context::tls_server);
+          self->state.ssl_ctx->use_certificate_chain_file(options.tls_certfile);
+          self->state.ssl_ctx->use_private_key_file(
+            options.tls_keyfile, boost::asio::ssl::context::pem);
+          self->state.ssl_ctx->set_verify_mode(boost::asio::ssl::verify_none);
+        }
+      } catch (std::exception& e) {
+        return caf::make_error(ec::system_error,
+                               fmt::format("failed to set up TLS: {}",
+                                           e.what()));
+      }
+      // Create a new acceptor and bind to provided endpoint.
+      try {
+        self->state.sockets->acceptor.emplace(
+          boost::asio::make_strand(self->state.reactor->context()));
+        self->state.sockets->acceptor->open(endpoint.protocol());
+        auto reuse_address = boost::asio::socket_base::reuse_address(true);
+        self->state.sockets->acceptor->set_option(reuse_address);
+        self->state.sockets->acceptor->bind(endpoint);
+        auto backlog = boost::asio::socket_base::max_connections;
+        self->state.sockets->acceptor->listen(backlog);
+      } catch (std::exception& e) {
+        self->state.sockets->acceptor.reset();
+        return caf::make_error(ec::system_error,
+                               fmt::format("failed to bind to endpoint: {}",
+                                           e.what()));
+      }
+      TENZIR_VERBOSE("tcp connector listens on endpoint {}:{}",
+                     endpoint.address().to_string(), endpoint.port());
+      accept_connection(self);
+      return {};
+    },
+    [self](atom::read) -> caf::result<std::vector<chunk_ptr>> {
+      if (self->state.read_rp.pending()) {
+        return caf::make_error(ec::logic_error,
+                               fmt::format("{} cannot read while a read "
+                                           "request is pending",
+                                           *self));
+      }
+      self->state.read_rp
+        = self->make_response_promise<std::vector<chunk_ptr>>();
+      deliver_chunks(self);
+      return self->state.read_rp;
+    },
+  };
+}
+
 struct connector_args {
   std::string hostname = {};
   std::string port = {};
@@ -340,10 +816,12 @@ struct loader_args : connector_args {
               f.field("listen_once", x.listen_once),
               f.field("connect", x.connect), f.field("tls", x.tls),
               f.field("tls_certfile", x.tls_certfile),
-              f.field("tls_keyfile", x.tls_keyfile));
+              f.field("tls_keyfile", x.tls_keyfile),
+              f.field("framing", x.framing));
   }
 
   bool connect = false;
+  std::optional<std::string> framing = {};
 };
 
 struct saver_args : connector_args {
@@ -397,56 +875,42 @@ public:
         return {};
       }
     }
+    if (not args_.connect) {
+      return listen(args_, ctrl);
+    }
     auto make
       = [](loader_args args,
            operator_control_plane& ctrl) mutable -> generator<chunk_ptr> {
       auto tcp_bridge = ctrl.self().spawn(make_tcp_bridge);
-      do {
-        if (args.connect) {
-          ctrl.self()
-            .request(tcp_bridge, caf::infinite, atom::connect_v, args.tls,
-                     args.hostname, args.port)
-            .await(
-              [&]() {
-                // nop
-              },
-              [&](const caf::error& err) {
-                diagnostic::error("failed to connect: {}", err)
-                  .emit(ctrl.diagnostics());
-              });
-        } else {
-          ctrl.self()
-            .request(tcp_bridge, caf::infinite, atom::accept_v, args.hostname,
-                     args.port, args.tls_certfile.value_or(std::string{}),
-                     args.tls_keyfile.value_or(std::string{}))
-            .await(
-              [&]() {
-                // nop
-              },
-              [&](const caf::error& err) {
-                diagnostic::error("failed to listen: {}", err)
-                  .emit(ctrl.diagnostics());
-              });
-        }
-        co_yield {};
-        // Read and forward incoming data.
-        auto result = chunk_ptr{};
-        auto running = true;
-        while (running) {
-          constexpr auto buffer_size = uint64_t{65'536};
-          ctrl.self()
-            .request(tcp_bridge, caf::infinite, atom::read_v, buffer_size)
-            .await(
-              [&](chunk_ptr& chunk) {
-                result = std::move(chunk);
-              },
-              [&](const caf::error& err) {
-                TENZIR_DEBUG("tcp connector encountered error: {}", err);
-                running = false;
-              });
-          co_yield std::exchange(result, {});
-        }
-      } while (not args.connect and not args.listen_once);
+      ctrl.self()
+        .request(tcp_bridge, caf::infinite, atom::connect_v, args.tls,
+                 args.hostname, args.port)
+        .await(
+          [&]() {
+            // nop
+          },
+          [&](const caf::error& err) {
+            diagnostic::error("failed to connect: {}", err)
+              .emit(ctrl.diagnostics());
+          });
+      co_yield {};
+      // Read and forward incoming data.
+      auto result = chunk_ptr{};
+      auto running = true;
+      while (running) {
+        constexpr auto buffer_size = uint64_t{65'536};
+        ctrl.self()
+          .request(tcp_bridge, caf::infinite, atom::read_v, buffer_size)
+          .await(
+            [&](chunk_ptr& chunk) {
+              result = std::move(chunk);
+            },
+            [&](const caf::error& err) {
+              TENZIR_DEBUG("tcp connector encountered error: {}", err);
+              running = false;
+            });
+        co_yield std::exchange(result, {});
+      }
     };
     return make(args_, ctrl);
   }
@@ -466,6 +930,63 @@ public:
   }
 
 private:
+  /// Accepts any number of concurrent connections and forwards their data.
+  static auto listen(loader_args args, operator_control_plane& ctrl)
+    -> generator<chunk_ptr> {
+    auto framing = parse_tcp_framing(args.framing.value_or("newline"));
+    TENZIR_ASSERT(framing);
+    auto tcp_listener = ctrl.self().spawn(
+      make_tcp_listener, tcp_listener_options{
+                           .hostname = args.hostname,
+                           .port = args.port,
+                           .tls_certfile = args.tls_certfile.value_or(""),
+                           .tls_keyfile = args.tls_keyfile.value_or(""),
+                           .framing = *framing,
+                           .listen_once = args.listen_once,
+                         });
+    auto failed = false;
+    ctrl.self()
+      .request(tcp_listener, caf::infinite, atom::accept_v)
+      .await(
+        [&]() {
+          // nop
+        },
+        [&](const caf::error& err) {
+          diagnostic::error("failed to listen: {}", err)
+            .emit(ctrl.diagnostics());
+          failed = true;
+        });
+    if (failed) {
+      co_return;
+    }
+    co_yield {};
+    // Read and forward incoming data. The listener buffers data while we're
+    // busy, and stops reading from connections once its buffer is full.
+    auto chunks = std::vector<chunk_ptr>{};
+    auto running = true;
+    while (running) {
+      ctrl.self()
+        .request(tcp_listener, caf::infinite, atom::read_v)
+        .await(
+          [&](std::vector<chunk_ptr>& result) {
+            chunks = std::move(result);
+          },
+          [&](const caf::error& err) {
+            if (err != ec::end_of_input) {
+              diagnostic::error("tcp connector encountered error: {}", err)
+                .emit(ctrl.diagnostics());
+            }
+            running = false;
+          });
+      if (chunks.empty()) {
+        co_yield {};
+      }
+      for (auto& chunk : std::exchange(chunks, {})) {
+        co_yield std::move(chunk);
+      }
+    }
+  }
+
   loader_args args_;
 };
 
@@ -599,6 +1120,7 @@ public:
     parser.add(uri, "<endpoint>");
     if constexpr (std::is_same_v<Args, loader_args>) {
       parser.add("-c,--connect", args.connect);
+      parser.add("--framing", args.framing, "<none|newline|octet-counting>");
     } else if constexpr (std::is_same_v<Args, saver_args>) {
       parser.add("-l,--listen", args.listen);
     }
@@ -635,6 +1157,17 @@ public:
         diagnostic::error("conflicting options `--connect` and `--listen-once`")
           .throw_();
       }
+      if (args.framing) {
+        if (args.connect) {
+          diagnostic::error("conflicting options `--connect` and `--framing`")
+            .throw_();
+        }
+        if (not parse_tcp_framing(*args.framing)) {
+          diagnostic::error("invalid framing `{}`", *args.framing)
+            .hint("must be one of `none`, `newline`, or `octet-counting`")
+            .throw_();
+        }
+      }
       if (not args.connect and args.tls) {
         if (not args.tls_certfile or args.tls_certfile->empty()) {
           diagnostic::error("invalid TLS settings")
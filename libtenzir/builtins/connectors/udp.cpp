@@ -0,0 +1,512 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <tenzir/argument_parser.hpp>
+#include <tenzir/chunk.hpp>
+#include <tenzir/config.hpp>
+#include <tenzir/detail/narrow.hpp>
+#include <tenzir/detail/posix.hpp>
+#include <tenzir/diagnostics.hpp>
+#include <tenzir/location.hpp>
+#include <tenzir/logger.hpp>
+#include <tenzir/plugin.hpp>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace tenzir::plugins::udp {
+
+namespace {
+
+struct loader_args {
+  std::string hostname = {};
+  std::string port = {};
+  std::optional<located<uint64_t>> shards = {};
+  std::optional<located<uint64_t>> batch_size = {};
+  std::optional<located<uint64_t>> max_datagram_size = {};
+  bool insert_newlines = false;
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, loader_args& x) -> bool {
+    return f.object(x)
+      .pretty_name("tenzir.plugins.udp.loader_args")
+      .fields(f.field("hostname", x.hostname), f.field("port", x.port),
+              f.field("shards", x.shards), f.field("batch_size", x.batch_size),
+              f.field("max_datagram_size", x.max_datagram_size),
+              f.field("insert_newlines", x.insert_newlines));
+  }
+};
+
+/// The default number of datagrams to receive with a single system call.
+constexpr auto default_batch_size = uint64_t{128};
+
+/// The maximum number of datagrams to receive with a single system call.
+/// `recvmmsg` receives at most `UIO_MAXIOV` datagrams at once, which is 1024
+/// on Linux, and every receiver thread allocates a buffer of `batch_size`
+/// times `max_datagram_size` bytes.
+constexpr auto max_batch_size = uint64_t{1'024};
+
+/// The maximum size of a UDP datagram.
+constexpr auto max_udp_datagram_size = uint64_t{65'536};
+
+/// The default maximum size of a datagram. Longer datagrams get truncated.
+constexpr auto default_max_datagram_size = max_udp_datagram_size;
+
+/// The socket receive buffer size that we ask the kernel for. The kernel caps
+/// this at `net.core.rmem_max`.
+constexpr auto receive_buffer_size = 64 << 20;
+
+/// How long a receiver blocks in the kernel before checking whether it should
+/// stop.
+constexpr auto receive_timeout = 100ms;
+
+/// How long the loader waits for datagrams before yielding control.
+constexpr auto poll_timeout = 250ms;
+
+/// The amount of received data that we buffer before the receivers stop
+/// reading from their sockets, leaving it to the kernel to buffer or drop
+/// datagrams.
+constexpr auto max_queued_bytes = size_t{64} << 20;
+
+/// Splits an endpoint of the form `address:port` into address and port. IPv6
+/// addresses must be enclosed in brackets, e.g., `[::1]:514`.
+auto split_endpoint(std::string_view endpoint)
+  -> std::optional<std::pair<std::string, std::string>> {
+  auto address = std::string_view{};
+  auto port = std::string_view{};
+  if (endpoint.starts_with('[')) {
+    const auto close = endpoint.find(']');
+    if (close == std::string_view::npos
+        || endpoint.substr(close + 1, 1) != ":")
+      return std::nullopt;
+    address = endpoint.substr(1, close - 1);
+    port = endpoint.substr(close + 2);
+  } else {
+    const auto colon = endpoint.find(':');
+    if (colon == std::string_view::npos
+        || endpoint.find(':', colon + 1) != std::string_view::npos)
+      return std::nullopt;
+    address = endpoint.substr(0, colon);
+    port = endpoint.substr(colon + 1);
+  }
+  if (port.empty())
+    return std::nullopt;
+  return std::pair{std::string{address}, std::string{port}};
+}
+
+/// Formats the address and port of a socket address.
+auto format_sender(const sockaddr_storage& addr) -> std::string {
+  const auto* sa = reinterpret_cast<const sockaddr*>(&addr);
+  switch (addr.ss_family) {
+    case AF_INET:
+      return fmt::format(
+        "{}:{}", detail::to_string(sa),
+        ntohs(reinterpret_cast<const sockaddr_in*>(sa)->sin_port));
+    case AF_INET6:
+      return fmt::format(
+        "[{}]:{}", detail::to_string(sa),
+        ntohs(reinterpret_cast<const sockaddr_in6*>(sa)->sin6_port));
+    default:
+      return {};
+  }
+}
+
+/// Receives datagrams on one or more sockets bound to the same endpoint, each
+/// served by its own thread, and hands them out in batches.
+class udp_receiver {
+public:
+  static auto make(const loader_args& args)
+    -> caf::expected<std::unique_ptr<udp_receiver>> {
+    const auto num_shards
+      = args.shards ? std::max(args.shards->inner, uint64_t{1}) : uint64_t{1};
+    auto hints = addrinfo{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* info = nullptr;
+    const auto* node
+      = args.hostname.empty() ? nullptr : args.hostname.c_str();
+    if (auto err = ::getaddrinfo(node, args.port.c_str(), &hints, &info);
+        err != 0 || info == nullptr)
+      return caf::make_error(ec::system_error,
+                             fmt::format("failed to resolve host {}, service "
+                                         "{}: {}",
+                                         args.hostname, args.port,
+                                         ::gai_strerror(err)));
+    auto info_guard = std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)>{
+      info, &::freeaddrinfo};
+    auto result = std::unique_ptr<udp_receiver>{new udp_receiver{args}};
+    for (uint64_t i = 0; i < num_shards; ++i) {
+      auto fd = ::socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+      if (fd < 0)
+        return caf::make_error(ec::system_error,
+                               fmt::format("failed to create socket: {}",
+                                           detail::describe_errno()));
+      result->sockets_.push_back(fd);
+      const auto enable = 1;
+      if (::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable))
+          != 0)
+        return caf::make_error(ec::system_error,
+                               fmt::format("failed to set SO_REUSEADDR: {}",
+                                           detail::describe_errno()));
+      if (num_shards > 1) {
+#ifdef SO_REUSEPORT
+        // With SO_REUSEPORT, the kernel distributes incoming datagrams across
+        // all sockets bound to the same endpoint by hashing the sender.
+        if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable,
+                         sizeof(enable))
+            != 0)
+          return caf::make_error(ec::system_error,
+                                 fmt::format("failed to set SO_REUSEPORT: {}",
+                                             detail::describe_errno()));
+#else
+        return caf::make_error(ec::system_error,
+                               "sharding requires SO_REUSEPORT, which is not "
+                               "supported on this platform");
+#endif
+      }
+      // A larger receive buffer absorbs bursts while we're busy. Failing to
+      // set it is not fatal.
+      const auto buffer_size = receive_buffer_size;
+      if (::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer_size,
+                       sizeof(buffer_size))
+          != 0)
+        TENZIR_DEBUG("udp loader failed to set SO_RCVBUF: {}",
+                     detail::describe_errno());
+      auto timeout = timeval{};
+      timeout.tv_usec
+        = std::chrono::duration_cast<std::chrono::microseconds>(receive_timeout)
+            .count();
+      if (::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout))
+          != 0)
+        return caf::make_error(ec::system_error,
+                               fmt::format("failed to set SO_RCVTIMEO: {}",
+                                           detail::describe_errno()));
+      if (::bind(fd, info->ai_addr, info->ai_addrlen) != 0)
+        return caf::make_error(ec::system_error,
+                               fmt::format("failed to bind to {}:{}: {}",
+                                           args.hostname, args.port,
+                                           detail::describe_errno()));
+    }
+    for (auto fd : result->sockets_) {
+      result->threads_.emplace_back([receiver = result.get(), fd] {
+        receiver->run(fd);
+      });
+    }
+    TENZIR_VERBOSE("udp loader listens on endpoint {}:{} with {} socket(s)",
+                   args.hostname, args.port, num_shards);
+    return result;
+  }
+
+  udp_receiver(const udp_receiver&) = delete;
+  auto operator=(const udp_receiver&) -> udp_receiver& = delete;
+  udp_receiver(udp_receiver&&) = delete;
+  auto operator=(udp_receiver&&) -> udp_receiver& = delete;
+
+  ~udp_receiver() noexcept {
+    {
+      // Setting the flag while holding the lock ensures that no receiver
+      // misses the notification while waiting for space.
+      auto lock = std::unique_lock{mutex_};
+      stop_ = true;
+    }
+    space_available_.notify_all();
+    for (auto& thread : threads_)
+      thread.join();
+    for (auto fd : sockets_)
+      ::close(fd);
+  }
+
+  /// Waits for received datagrams, one chunk per datagram.
+  /// @returns The datagrams received so far, which may be empty if none
+  /// arrived within the timeout.
+  auto poll(std::chrono::milliseconds timeout)
+    -> caf::expected<std::vector<chunk_ptr>> {
+    auto lock = std::unique_lock{mutex_};
+    data_available_.wait_for(lock, timeout, [&] {
+      return not chunks_.empty() || error_;
+    });
+    if (chunks_.empty() && error_)
+      return error_;
+    queued_bytes_ = 0;
+    space_available_.notify_all();
+    return std::exchange(chunks_, {});
+  }
+
+private:
+  explicit udp_receiver(const loader_args& args)
+    : batch_size_{args.batch_size ? std::max(args.batch_size->inner,
+                                             uint64_t{1})
+                                  : default_batch_size},
+      max_datagram_size_{args.max_datagram_size
+                           ? std::max(args.max_datagram_size->inner,
+                                      uint64_t{1})
+                           : default_max_datagram_size},
+      insert_newlines_{args.insert_newlines} {
+  }
+
+  /// The loop of a receiver thread.
+  void run(int fd) {
+    auto buffer = std::vector<std::byte>(batch_size_ * max_datagram_size_);
+    auto addresses = std::vector<sockaddr_storage>(batch_size_);
+    auto iovecs = std::vector<iovec>(batch_size_);
+    auto lengths = std::vector<size_t>(batch_size_);
+    auto truncated = std::vector<bool>(batch_size_);
+#if TENZIR_LINUX
+    auto messages = std::vector<mmsghdr>(batch_size_);
+#endif
+    auto num_truncated = uint64_t{0};
+    while (not stop_) {
+#if TENZIR_LINUX
+      // Receive as many datagrams as are available with a single system call,
+      // blocking only until the first one arrives.
+      for (size_t i = 0; i < batch_size_; ++i) {
+        iovecs[i].iov_base = buffer.data() + i * max_datagram_size_;
+        iovecs[i].iov_len = max_datagram_size_;
+        messages[i] = {};
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+      }
+      const auto received = ::recvmmsg(
+        fd, messages.data(), detail::narrow_cast<unsigned>(batch_size_),
+        MSG_WAITFORONE, nullptr);
+      for (auto i = 0; i < received; ++i) {
+        lengths[i] = messages[i].msg_len;
+        truncated[i] = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+      }
+#else
+      auto message = msghdr{};
+      iovecs[0].iov_base = buffer.data();
+      iovecs[0].iov_len = max_datagram_size_;
+      message.msg_name = &addresses[0];
+      message.msg_namelen = sizeof(sockaddr_storage);
+      message.msg_iov = &iovecs[0];
+      message.msg_iovlen = 1;
+      const auto length = ::recvmsg(fd, &message, 0);
+      const auto received = length < 0 ? -1 : 1;
+      if (received == 1) {
+        lengths[0] = detail::narrow_cast<size_t>(length);
+        truncated[0] = (message.msg_flags & MSG_TRUNC) != 0;
+      }
+#endif
+      if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+          continue;
+        auto lock = std::unique_lock{mutex_};
+        error_ = caf::make_error(ec::system_error,
+                                 fmt::format("failed to receive datagrams: {}",
+                                             detail::describe_errno()));
+        data_available_.notify_one();
+        return;
+      }
+      // Copy the datagrams into a single, tightly packed buffer, and slice it
+      // into one chunk per datagram so that downstream operators see datagram
+      // boundaries and senders.
+      auto total_size = size_t{0};
+      for (auto i = 0; i < received; ++i)
+        total_size += lengths[i] + (insert_newlines_ ? 1 : 0);
+      auto packed = std::vector<std::byte>{};
+      packed.reserve(total_size);
+      auto offsets = std::vector<std::pair<size_t, size_t>>{};
+      offsets.reserve(received);
+      for (auto i = 0; i < received; ++i) {
+        const auto* begin = buffer.data() + i * max_datagram_size_;
+        const auto offset = packed.size();
+        packed.insert(packed.end(), begin, begin + lengths[i]);
+        if (insert_newlines_
+            && (lengths[i] == 0 || packed.back() != std::byte{'\n'}))
+          packed.push_back(std::byte{'\n'});
+        offsets.emplace_back(offset, packed.size() - offset);
+        if (truncated[i])
+          ++num_truncated;
+      }
+      if (num_truncated > 0) {
+        TENZIR_WARN("udp loader truncated {} datagram(s) exceeding {} bytes",
+                    num_truncated, max_datagram_size_);
+        num_truncated = 0;
+      }
+      auto batch = chunk::make(std::move(packed));
+      auto chunks = std::vector<chunk_ptr>{};
+      chunks.reserve(received);
+      auto sender = std::string{};
+      for (auto i = 0; i < received; ++i) {
+        // Consecutive datagrams usually come from the same sender, so we only
+        // format the sender address when it changes.
+        if (i == 0
+            || std::memcmp(&addresses[i], &addresses[i - 1],
+                           sizeof(sockaddr_storage))
+                 != 0)
+          sender = format_sender(addresses[i]);
+        const auto [offset, size] = offsets[i];
+        chunks.push_back(chunk::make(
+          as_bytes(batch).subspan(offset, size),
+          [batch]() noexcept {
+            static_cast<void>(batch);
+          },
+          chunk_metadata{.origin = sender}));
+      }
+      auto lock = std::unique_lock{mutex_};
+      space_available_.wait(lock, [&] {
+        return queued_bytes_ < max_queued_bytes || stop_;
+      });
+      queued_bytes_ += batch->size();
+      chunks_.insert(chunks_.end(), std::make_move_iterator(chunks.begin()),
+                     std::make_move_iterator(chunks.end()));
+      data_available_.notify_one();
+    }
+  }
+
+  const uint64_t batch_size_;
+  const uint64_t max_datagram_size_;
+  const bool insert_newlines_;
+  std::vector<int> sockets_ = {};
+  std::vector<std::thread> threads_ = {};
+  std::atomic<bool> stop_ = false;
+  std::mutex mutex_ = {};
+  std::condition_variable data_available_ = {};
+  std::condition_variable space_available_ = {};
+  std::vector<chunk_ptr> chunks_ = {};
+  size_t queued_bytes_ = 0;
+  caf::error error_ = {};
+};
+
+class loader final : public plugin_loader {
+public:
+  loader() = default;
+
+  explicit loader(loader_args args) : args_{std::move(args)} {
+  }
+
+  auto instantiate(operator_control_plane& ctrl) const
+    -> std::optional<generator<chunk_ptr>> override {
+    auto receiver = udp_receiver::make(args_);
+    if (not receiver) {
+      diagnostic::error("failed to listen: {}", receiver.error())
+        .emit(ctrl.diagnostics());
+      return {};
+    }
+    auto make = [](std::unique_ptr<udp_receiver> receiver,
+                   operator_control_plane& ctrl) -> generator<chunk_ptr> {
+      while (true) {
+        auto chunks = receiver->poll(poll_timeout);
+        if (not chunks) {
+          diagnostic::error("udp connector encountered error: {}",
+                            chunks.error())
+            .emit(ctrl.diagnostics());
+          co_return;
+        }
+        if (chunks->empty()) {
+          co_yield {};
+          continue;
+        }
+        for (auto& chunk : *chunks) {
+          co_yield std::move(chunk);
+        }
+      }
+    };
+    return make(std::move(*receiver), ctrl);
+  }
+
+  auto name() const -> std::string override {
+    return "udp";
+  }
+
+  auto default_parser() const -> std::string override {
+    return "json";
+  }
+
+  friend auto inspect(auto& f, loader& x) -> bool {
+    return f.object(x)
+      .pretty_name("tenzir.plugins.udp.loader")
+      .fields(f.field("args", x.args_));
+  }
+
+private:
+  loader_args args_;
+};
+
+class plugin final : public virtual loader_plugin<loader> {
+public:
+  auto parse_loader(parser_interface& p) const
+    -> std::unique_ptr<plugin_loader> override {
+    auto parser = argument_parser{
+      name(),
+      fmt::format("https://docs.tenzir.com/docs/connectors/{}", name())};
+    auto args = loader_args{};
+    auto uri = located<std::string>{};
+    parser.add(uri, "<endpoint>");
+    parser.add("--shards", args.shards, "<count>");
+    parser.add("--batch-size", args.batch_size, "<count>");
+    parser.add("--max-datagram-size", args.max_datagram_size, "<bytes>");
+    parser.add("-n,--insert-newlines", args.insert_newlines);
+    parser.parse(p);
+    if (uri.inner.starts_with("udp://")) {
+      uri.inner = std::move(uri.inner).substr(6);
+    }
+    auto endpoint = split_endpoint(uri.inner);
+    if (not endpoint) {
+      diagnostic::error("malformed endpoint")
+        .primary(uri.source)
+        .hint("format must be 'udp://address:port', with IPv6 addresses in "
+              "brackets")
+        .throw_();
+    }
+    std::tie(args.hostname, args.port) = std::move(*endpoint);
+    for (const auto* option : {&args.shards, &args.batch_size,
+                               &args.max_datagram_size}) {
+      if (*option and (*option)->inner == 0) {
+        diagnostic::error("value must be positive")
+          .primary((*option)->source)
+          .throw_();
+      }
+    }
+    if (args.batch_size and args.batch_size->inner > max_batch_size) {
+      diagnostic::error("batch size cannot exceed {}", max_batch_size)
+        .primary(args.batch_size->source)
+        .throw_();
+    }
+    if (args.max_datagram_size
+        and args.max_datagram_size->inner > max_udp_datagram_size) {
+      diagnostic::error("datagrams cannot exceed {} bytes",
+                        max_udp_datagram_size)
+        .primary(args.max_datagram_size->source)
+        .throw_();
+    }
+    return std::make_unique<loader>(std::move(args));
+  }
+
+  auto name() const -> std::string override {
+    return "udp";
+  }
+};
+
+} // namespace
+
+} // namespace tenzir::plugins::udp
+
+TENZIR_REGISTER_PLUGIN(tenzir::plugins::udp::plugin)
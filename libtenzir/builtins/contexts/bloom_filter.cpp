@@ -10,15 +10,19 @@
 #include <tenzir/concept/parseable/numeric.hpp>
 #include <tenzir/data.hpp>
 #include <tenzir/dcso_bloom_filter.hpp>
+#include <tenzir/dcso_bloom_hasher.hpp>
+#include <tenzir/detail/overload.hpp>
 #include <tenzir/detail/range_map.hpp>
 #include <tenzir/expression.hpp>
 #include <tenzir/fbs/data.hpp>
 #include <tenzir/flatbuffer.hpp>
 #include <tenzir/fwd.hpp>
+#include <tenzir/hash/xxhash.hpp>
 #include <tenzir/operator.hpp>
 #include <tenzir/plugin.hpp>
 #include <tenzir/series.hpp>
 #include <tenzir/series_builder.hpp>
+#include <tenzir/sketch/split_block_bloom_filter.hpp>
 #include <tenzir/table_slice.hpp>
 #include <tenzir/table_slice_builder.hpp>
 #include <tenzir/type.hpp>
@@ -31,12 +35,31 @@
 
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
+#include <variant>
 
 namespace tenzir::plugins::bloom_filter {
 
 namespace {
 
+/// Adapts `xxh64` to the interface of the hash function in `dcso_bloom_hasher`.
+/// The split-block Bloom filter selects the block from the high bits of a
+/// digest, which FNV-1 mixes poorly.
+class xxh64_digest {
+public:
+  auto operator()(const void* x, size_t n) noexcept -> void {
+    h_.add({static_cast<const std::byte*>(x), n});
+  }
+
+  explicit operator uint64_t() noexcept {
+    return h_.finish();
+  }
+
+private:
+  xxh64 h_;
+};
+
 class bloom_filter_context final : public virtual context {
 public:
   bloom_filter_context() noexcept = default;
@@ -45,7 +68,13 @@ public:
     : bloom_filter_{std::move(bloom_filter)} {
   }
 
-  bloom_filter_context(uint64_t n, double p) : bloom_filter_{n, p} {
+  explicit bloom_filter_context(
+    sketch::split_block_bloom_filter bloom_filter) noexcept
+    : bloom_filter_{std::move(bloom_filter)} {
+  }
+
+  bloom_filter_context(uint64_t n, double p)
+    : bloom_filter_{dcso_bloom_filter{n, p}} {
   }
 
   auto context_type() const -> std::string override {
@@ -55,12 +84,15 @@ public:
   /// Emits context information for every event in `slice` in order.
   auto apply(series s) const -> caf::expected<std::vector<series>> override {
     auto builder = series_builder{};
+    const auto data = attached_data();
     for (const auto& value : s.values()) {
-      if (bloom_filter_.lookup(value)) {
-        auto ptr = bloom_filter_.data().data();
-        auto size = bloom_filter_.data().size();
+      if (lookup(value)) {
         auto r = builder.record();
-        r.field("data", std::basic_string<std::byte>{ptr, size});
+        if (data) {
+          r.field("data", *data);
+        } else {
+          r.field("data").null();
+        }
       } else {
         builder.null();
       }
@@ -75,41 +107,40 @@ public:
 
   /// Inspects the context.
   auto show() const -> record override {
-    auto ptr = reinterpret_cast<const std::byte*>(bloom_filter_.data().data());
-    auto size = bloom_filter_.data().size();
-    auto data = std::basic_string<std::byte>{ptr, size};
+    const auto params = parameters();
+    auto attached = attached_data();
     return record{
-      {"num_elements", bloom_filter_.num_elements()},
+      {"num_elements", num_elements()},
+      {"layout", is_split_block() ? "split-block" : "classic"},
       {"parameters",
        record{
-         {"m", bloom_filter_.parameters().m},
-         {"n", bloom_filter_.parameters().n},
-         {"p", bloom_filter_.parameters().p},
-         {"k", bloom_filter_.parameters().k},
+         {"m", params.m},
+         {"n", params.n},
+         {"p", params.p},
+         {"k", params.k},
        }},
-      {"data", std::move(data)},
+      {"data", attached ? data{std::move(*attached)} : data{}},
     };
   }
 
   auto dump() -> generator<table_slice> override {
-    auto ptr = reinterpret_cast<const std::byte*>(bloom_filter_.data().data());
-    auto size = bloom_filter_.data().size();
-    auto data = std::basic_string<std::byte>{ptr, size};
+    const auto parameters = this->parameters();
     auto entry_builder = series_builder{};
     auto row = entry_builder.record();
-    row.field("num_elements", bloom_filter_.num_elements());
+    row.field("num_elements", num_elements());
+    row.field("layout", is_split_block() ? "split-block" : "classic");
     auto params = row.field("parameters").record();
-    if (bloom_filter_.parameters().m) {
-      params.field("m", *bloom_filter_.parameters().m);
+    if (parameters.m) {
+      params.field("m", *parameters.m);
     }
-    if (bloom_filter_.parameters().n) {
-      params.field("n", *bloom_filter_.parameters().n);
+    if (parameters.n) {
+      params.field("n", *parameters.n);
     }
-    if (bloom_filter_.parameters().p) {
-      params.field("p", *bloom_filter_.parameters().p);
+    if (parameters.p) {
+      params.field("p", *parameters.p);
     }
-    if (bloom_filter_.parameters().k) {
-      params.field("k", *bloom_filter_.parameters().k);
+    if (parameters.k) {
+      params.field("k", *parameters.k);
     }
     co_yield entry_builder.finish_assert_one_slice(
       fmt::format("tenzir.{}.info", context_type()));
@@ -140,7 +171,7 @@ public:
     auto context_values = values(slice.schema(), *context_array);
     for (const auto& value : key_values) {
       auto materialized_key = materialize(value);
-      bloom_filter_.add(materialized_key);
+      add(materialized_key);
       key_values_list.emplace_back(std::move(materialized_key));
     }
     auto query_f = [key_values_list = std::move(key_values_list)](
@@ -163,22 +194,125 @@ public:
   }
 
   auto reset(context::parameter_map) -> caf::expected<record> override {
-    auto params = bloom_filter_.parameters();
-    TENZIR_ASSERT(params.n && params.p);
-    bloom_filter_ = dcso_bloom_filter{*params.n, *params.p};
+    auto f = detail::overload{
+      [](dcso_bloom_filter& bloom_filter) {
+        auto params = bloom_filter.parameters();
+        TENZIR_ASSERT(params.n && params.p);
+        bloom_filter = dcso_bloom_filter{*params.n, *params.p};
+      },
+      [](sketch::split_block_bloom_filter& bloom_filter) {
+        auto cfg = sketch::bloom_filter_config{};
+        cfg.m = bloom_filter.parameters().m;
+        cfg.n = bloom_filter.parameters().n;
+        auto result = sketch::split_block_bloom_filter::make(cfg);
+        TENZIR_ASSERT(result);
+        bloom_filter = std::move(*result);
+      },
+    };
+    std::visit(f, bloom_filter_);
     return show();
   }
 
   auto save() const -> caf::expected<save_result> override {
-    std::vector<std::byte> buffer;
-    if (auto err = convert(bloom_filter_, buffer)) {
-      return add_context(err, "failed to serialize Bloom filter context");
-    }
-    return save_result{.data = chunk::make(std::move(buffer)), .version = 1};
+    auto f = detail::overload{
+      [](const dcso_bloom_filter& bloom_filter)
+        -> caf::expected<save_result> {
+        std::vector<std::byte> buffer;
+        if (auto err = convert(bloom_filter, buffer)) {
+          return add_context(err, "failed to serialize Bloom filter context");
+        }
+        return save_result{.data = chunk::make(std::move(buffer)),
+                           .version = 1};
+      },
+      [](const sketch::split_block_bloom_filter& bloom_filter)
+        -> caf::expected<save_result> {
+        auto frozen = freeze(bloom_filter);
+        if (not frozen) {
+          return add_context(frozen.error(),
+                             "failed to serialize Bloom filter context");
+        }
+        return save_result{.data = frozen->table(), .version = 2};
+      },
+    };
+    return std::visit(f, bloom_filter_);
   }
 
 private:
-  dcso_bloom_filter bloom_filter_;
+  auto is_split_block() const -> bool {
+    return std::holds_alternative<sketch::split_block_bloom_filter>(
+      bloom_filter_);
+  }
+
+  auto lookup(const data_view& value) const -> bool {
+    auto f = detail::overload{
+      [&](const dcso_bloom_filter& bloom_filter) {
+        return bloom_filter.lookup(value);
+      },
+      [&](const sketch::split_block_bloom_filter& bloom_filter) {
+        return bloom_filter.lookup(digest(value));
+      },
+    };
+    return std::visit(f, bloom_filter_);
+  }
+
+  auto add(const data& value) -> void {
+    auto f = detail::overload{
+      [&](dcso_bloom_filter& bloom_filter) {
+        bloom_filter.add(value);
+      },
+      [&](sketch::split_block_bloom_filter& bloom_filter) {
+        bloom_filter.add(digest(value));
+      },
+    };
+    std::visit(f, bloom_filter_);
+  }
+
+  auto num_elements() const -> uint64_t {
+    return std::visit(
+      [](const auto& bloom_filter) -> uint64_t {
+        return bloom_filter.num_elements();
+      },
+      bloom_filter_);
+  }
+
+  auto parameters() const -> bloom_filter_parameters {
+    auto f = detail::overload{
+      [](const dcso_bloom_filter& bloom_filter) {
+        return bloom_filter.parameters();
+      },
+      [](const sketch::split_block_bloom_filter& bloom_filter) {
+        const auto& params = bloom_filter.parameters();
+        auto result = bloom_filter_parameters{};
+        result.m = params.m;
+        result.n = params.n;
+        result.k = params.k;
+        result.p = params.p;
+        result.layout = bloom_filter_layout::split_block;
+        return result;
+      },
+    };
+    return std::visit(f, bloom_filter_);
+  }
+
+  /// Returns the data attached to the filter, which only the DCSO-compatible
+  /// Bloom filter supports.
+  auto attached_data() const -> std::optional<blob> {
+    if (const auto* bloom_filter
+        = std::get_if<dcso_bloom_filter>(&bloom_filter_)) {
+      return blob{bloom_filter->data().begin(), bloom_filter->data().end()};
+    }
+    return std::nullopt;
+  }
+
+  /// Computes the digest of a value for the split-block Bloom filter. This
+  /// converts values the same way as the DCSO-compatible Bloom filter does.
+  auto digest(const auto& value) const -> uint64_t {
+    return hasher_(value)[0];
+  }
+
+  std::variant<dcso_bloom_filter, sketch::split_block_bloom_filter>
+    bloom_filter_;
+  dcso_bloom_hasher<xxh64_digest> hasher_{1};
 };
 
 struct v1_loader : public context_loader {
@@ -197,9 +331,29 @@ struct v1_loader : public context_loader {
   }
 };
 
+/// Loads contexts with a split-block Bloom filter.
+struct v2_loader : public context_loader {
+  auto version() const -> int {
+    return 2;
+  }
+
+  auto load(chunk_ptr serialized) const
+    -> caf::expected<std::unique_ptr<context>> {
+    TENZIR_ASSERT(serialized != nullptr);
+    auto frozen
+      = sketch::frozen_split_block_bloom_filter::make(std::move(serialized));
+    if (not frozen) {
+      return add_context(frozen.error(),
+                         "failed to deserialize Bloom filter context");
+    }
+    return std::make_unique<bloom_filter_context>(thaw(*frozen));
+  }
+};
+
 class plugin : public virtual context_plugin {
   auto initialize(const record&, const record&) -> caf::error override {
     register_loader(std::make_unique<v1_loader>());
+    register_loader(std::make_unique<v2_loader>());
     return caf::none;
   }
 
@@ -211,6 +365,7 @@ class plugin : public virtual context_plugin {
     -> caf::expected<std::unique_ptr<context>> override {
     auto n = uint64_t{0};
     auto p = double{0.0};
+    auto split_block = false;
     for (const auto& [key, value] : parameters) {
       if (key == "capacity") {
         if (not value) {
@@ -229,6 +384,8 @@ class plugin : public virtual context_plugin {
           return caf::make_error(ec::invalid_argument,
                                  "--fp-probability is not a double");
         }
+      } else if (key == "split-block") {
+        split_block = true;
       } else {
         return caf::make_error(ec::invalid_argument,
                                fmt::format("invalid option: {}", key));
@@ -241,6 +398,17 @@ class plugin : public virtual context_plugin {
       return caf::make_error(ec::invalid_argument,
                              "--fp-probability not in (0,1)");
     }
+    if (split_block) {
+      auto cfg = sketch::bloom_filter_config{};
+      cfg.n = n;
+      cfg.p = p;
+      auto bloom_filter = sketch::split_block_bloom_filter::make(cfg);
+      if (not bloom_filter) {
+        return add_context(bloom_filter.error(),
+                           "failed to create split-block Bloom filter");
+      }
+      return std::make_unique<bloom_filter_context>(std::move(*bloom_filter));
+    }
     return std::make_unique<bloom_filter_context>(n, p);
   }
 };
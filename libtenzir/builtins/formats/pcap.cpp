@@ -19,8 +19,12 @@
 #include <tenzir/type.hpp>
 #include <tenzir/view.hpp>
 
+#include <arrow/array/data.h>
+#include <arrow/buffer_builder.h>
 #include <arrow/record_batch.h>
 
+#include <limits>
+
 namespace tenzir::plugins::pcap {
 
 namespace {
@@ -113,6 +117,108 @@ auto make_file_header_table_slice(const file_header& header) -> table_slice {
   return builder.finish();
 }
 
+/// Builds `pcap.packet` table slices column by column. The fixed-width columns
+/// go into buffers that are sized for a full batch up front, and the packet
+/// data of a batch goes into a single contiguous buffer.
+class packet_builder {
+public:
+  /// The maximum number of bytes of packet data in a single batch, which is
+  /// bounded by the 32-bit offsets of Arrow binary arrays.
+  static constexpr auto max_bytes
+    = size_t{std::numeric_limits<int32_t>::max()};
+
+  packet_builder()
+    : schema_{packet_record_type()}, arrow_schema_{schema_.to_arrow_schema()} {
+    reserve();
+  }
+
+  auto rows() const -> size_t {
+    return detail::narrow_cast<size_t>(timestamps_.length());
+  }
+
+  auto bytes() const -> size_t {
+    return detail::narrow_cast<size_t>(data_.length());
+  }
+
+  /// Appends a packet.
+  /// @pre `bytes() + data.size() <= max_bytes`
+  void add(uint32_t linktype, time timestamp, const packet_header& header,
+           std::span<const std::byte> data) {
+    TENZIR_ASSERT(bytes() + data.size() <= max_bytes);
+    if (rows() == capacity_) {
+      capacity_ *= 2;
+      reserve();
+    }
+    linktypes_.UnsafeAppend(linktype & 0x0000FFFF);
+    timestamps_.UnsafeAppend(timestamp.time_since_epoch().count());
+    captured_lengths_.UnsafeAppend(header.captured_packet_length);
+    original_lengths_.UnsafeAppend(header.original_packet_length);
+    offsets_.UnsafeAppend(detail::narrow_cast<int32_t>(data_.length()));
+    auto status = data_.Append(data.data(), detail::narrow_cast<int64_t>(
+                                              data.size()));
+    TENZIR_ASSERT(status.ok());
+  }
+
+  /// Returns the packets added so far as table slice, and resets the builder.
+  auto finish() -> table_slice {
+    const auto num_rows = timestamps_.length();
+    if (num_rows == 0)
+      return {};
+    offsets_.UnsafeAppend(detail::narrow_cast<int32_t>(data_.length()));
+    const auto num_bytes = data_.length();
+    // We pass on full buffers as they are, because shrinking them copies.
+    // Mostly empty buffers, e.g., after a batch timeout, are worth the copy
+    // to not hold on to the unused memory.
+    const auto shrink_to_fit
+      = 2 * num_rows < detail::narrow_cast<int64_t>(capacity_);
+    const auto take = [&](auto& builder) {
+      return builder.Finish(shrink_to_fit).ValueOrDie();
+    };
+    const auto make_array = [&](int index, arrow::BufferVector buffers) {
+      return arrow::MakeArray(
+        arrow::ArrayData::Make(arrow_schema_->field(index)->type(), num_rows,
+                               std::move(buffers), /*null_count=*/0));
+    };
+    auto columns = arrow::ArrayVector{
+      make_array(0, {nullptr, take(linktypes_)}),
+      make_array(1, {nullptr, take(timestamps_)}),
+      make_array(2, {nullptr, take(captured_lengths_)}),
+      make_array(3, {nullptr, take(original_lengths_)}),
+      make_array(4, {nullptr, take(offsets_), take(data_)}),
+    };
+    auto batch
+      = arrow::RecordBatch::Make(arrow_schema_, num_rows, std::move(columns));
+    // Size the buffers for the next batch based on the current one.
+    capacity_ = defaults::import::table_slice_size;
+    reserve(num_bytes);
+    return table_slice{batch, schema_};
+  }
+
+private:
+  void reserve(int64_t num_bytes = 0) {
+    const auto capacity = detail::narrow_cast<int64_t>(capacity_);
+    const auto additional = capacity - timestamps_.length();
+    auto status = linktypes_.Reserve(additional);
+    status &= timestamps_.Reserve(additional);
+    status &= captured_lengths_.Reserve(additional);
+    status &= original_lengths_.Reserve(additional);
+    // Offsets have one more entry than there are rows.
+    status &= offsets_.Reserve(capacity + 1 - offsets_.length());
+    status &= data_.Reserve(num_bytes);
+    TENZIR_ASSERT(status.ok());
+  }
+
+  type schema_;
+  std::shared_ptr<arrow::Schema> arrow_schema_;
+  size_t capacity_ = defaults::import::table_slice_size;
+  arrow::TypedBufferBuilder<uint64_t> linktypes_;
+  arrow::TypedBufferBuilder<int64_t> timestamps_;
+  arrow::TypedBufferBuilder<uint64_t> captured_lengths_;
+  arrow::TypedBufferBuilder<uint64_t> original_lengths_;
+  arrow::TypedBufferBuilder<int32_t> offsets_;
+  arrow::BufferBuilder data_;
+};
+
 struct parser_args {
   std::optional<location> emit_file_headers;
 
@@ -188,7 +294,7 @@ public:
       // Records, consisting of a 16-byte header and variable-length payload.
       // However, our parser is a bit smarter and also supports concatenated
       // PCAP traces.
-      auto builder = table_slice_builder{packet_record_type()};
+      auto builder = packet_builder{};
       auto num_packets = size_t{0};
       auto last_finish = std::chrono::steady_clock::now();
       while (true) {
@@ -201,7 +307,6 @@ public:
         packet_record packet;
         // We first try to parse a packet header first.
         while (true) {
-          TENZIR_DEBUG("reading packet header");
           auto length = sizeof(packet_header);
           auto bytes = read_n(length);
           if (!bytes) {
@@ -280,8 +385,6 @@ public:
         }
         // Read the packet.
         while (true) {
-          TENZIR_DEBUG("reading packet data of size {}",
-                       uint32_t{packet.header.captured_packet_length});
           auto length = packet.header.captured_packet_length;
           auto bytes = read_n(length);
           if (!bytes) {
@@ -302,8 +405,20 @@ public:
           break;
         }
         ++num_packets;
-        TENZIR_DEBUG("packet #{} got size: {}", num_packets,
-                     packet.data.size());
+        if (packet.data.size() > packet_builder::max_bytes) {
+          co_yield builder.finish();
+          diagnostic::error("packet #{} exceeds maximum size; got {} bytes",
+                            num_packets, packet.data.size())
+            .note("from `pcap`")
+            .emit(ctrl.diagnostics());
+          co_return;
+        }
+        // The packet data remains valid while we yield, because we do not
+        // read from the input in the meantime.
+        if (builder.bytes() + packet.data.size() > packet_builder::max_bytes) {
+          last_finish = now;
+          co_yield builder.finish();
+        }
         /// Build record.
         auto seconds = std::chrono::seconds(packet.header.timestamp);
         auto timestamp = time{std::chrono::duration_cast<duration>(seconds)};
@@ -316,18 +431,8 @@ public:
         } else {
           die("invalid magic number"); // validated earlier
         }
-        const auto* ptr = reinterpret_cast<const char*>(packet.data.data());
-        auto data = std::string_view{ptr, packet.data.size()};
-        if (!(builder.add(input_file_header.linktype & 0x0000FFFF)
-              && builder.add(timestamp)
-              && builder.add(packet.header.captured_packet_length)
-              && builder.add(packet.header.original_packet_length)
-              && builder.add(data))) {
-          diagnostic::error("failed to add packet #{}", num_packets)
-            .note("from `pcap`")
-            .emit(ctrl.diagnostics());
-          co_return;
-        }
+        builder.add(input_file_header.linktype, timestamp, packet.header,
+                    packet.data);
       }
       if (builder.rows() > 0) {
         co_yield builder.finish();
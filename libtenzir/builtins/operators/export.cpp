@@ -32,60 +32,10 @@
 #include <caf/timespan.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
-#include <queue>
+#include <algorithm>
 
 namespace tenzir::plugins::export_ {
 
-struct bridge_state {
-  std::queue<table_slice> buffer = {};
-  size_t num_buffered = {};
-  caf::typed_response_promise<table_slice> rp = {};
-  expression expr = {};
-};
-
-caf::behavior make_bridge(caf::stateful_actor<bridge_state>* self,
-                          importer_actor importer, expression expr) {
-  self->state.expr = std::move(expr);
-  self
-    ->request(importer, caf::infinite, atom::subscribe_v,
-              caf::actor_cast<receiver_actor<table_slice>>(self))
-    .then([]() {},
-          [self](const caf::error& err) {
-            self->quit(add_context(err, "failed to subscribe to importer"));
-          });
-  return {
-    [self](table_slice slice) {
-      auto filtered = filter(std::move(slice), self->state.expr);
-      if (not filtered)
-        return;
-      if (self->state.rp.pending()) {
-        self->state.rp.deliver(std::move(*filtered));
-      } else if (self->state.num_buffered < (1 << 22)) {
-        self->state.num_buffered += filtered->rows();
-        self->state.buffer.push(std::move(*filtered));
-      } else {
-        TENZIR_WARN("`export --live` dropped {} events because it failed to "
-                    "keep up",
-                    filtered->rows());
-      }
-    },
-    [self](atom::get) -> caf::result<table_slice> {
-      if (self->state.rp.pending()) {
-        return caf::make_error(ec::logic_error,
-                               "live exporter bridge promise out of sync");
-      }
-      if (self->state.buffer.empty()) {
-        self->state.rp = self->make_response_promise<table_slice>();
-        return self->state.rp;
-      }
-      auto result = std::move(self->state.buffer.front());
-      self->state.buffer.pop();
-      self->state.num_buffered -= result.rows();
-      return result;
-    },
-  };
-};
-
 class export_operator final : public crtp_operator<export_operator> {
 public:
   export_operator() = default;
@@ -109,11 +59,44 @@ public:
     }
     co_yield {};
     auto [importer] = std::move(*components);
-    auto bridge = ctrl.self().spawn(make_bridge, importer, expr_);
+    // All live exports share a single hub that evaluates their expressions
+    // together on every imported batch.
+    auto hub = live_query_hub_actor{};
+    ctrl.self()
+      .request(importer, caf::infinite, atom::get_v, atom::query_v)
+      .await(
+        [&hub](live_query_hub_actor& response) {
+          hub = std::move(response);
+        },
+        [&ctrl](const caf::error& err) {
+          diagnostic::error(err)
+            .note("failed to get live query hub")
+            .emit(ctrl.diagnostics());
+        });
+    co_yield {};
+    if (not hub) {
+      co_return;
+    }
+    auto id = std::optional<uint64_t>{};
+    ctrl.self()
+      .request(hub, caf::infinite, atom::subscribe_v, expr_)
+      .await(
+        [&id](uint64_t response) {
+          id = response;
+        },
+        [&ctrl](const caf::error& err) {
+          diagnostic::error(err)
+            .note("failed to subscribe to live query hub")
+            .emit(ctrl.diagnostics());
+        });
+    co_yield {};
+    if (not id) {
+      co_return;
+    }
     auto next = table_slice{};
     while (true) {
       ctrl.self()
-        .request(bridge, caf::infinite, atom::get_v)
+        .request(hub, caf::infinite, atom::get_v, *id)
         .await(
           [&next](table_slice& response) {
             next = std::move(response);
@@ -151,6 +134,16 @@ public:
       = tenzir::query_context::make_extract("export", blocking_self, expr_);
     query_context.priority = low_priority_ ? query_context::priority::low
                                            : query_context::priority::normal;
+    if (limit_) {
+      query_context.limit = limit_->count;
+      query_context.latest = limit_->latest;
+      // When asking for the latest events we look at one partition at a time,
+      // which the index schedules newest first, so that we can stop after the
+      // partition that completes the limit.
+      if (limit_->latest) {
+        query_context.taste = 1;
+      }
+    }
     auto query_cursor = tenzir::query_cursor{};
     ctrl.self()
       .request(index, caf::infinite, atom::evaluate_v, query_context)
@@ -172,7 +165,16 @@ public:
                  query_cursor.scheduled_partitions,
                  query_cursor.candidate_partitions, inflight_partitions);
     auto current_slice = std::optional<table_slice>{};
-    while (true) {
+    auto num_results = uint64_t{0};
+    auto limit_reached = [&] {
+      return limit_ and num_results >= limit_->count;
+    };
+    // When asking for the latest events we buffer all results and restore
+    // their import order at the end; we must not rely on the order in which
+    // the partitions arrive for that.
+    const auto latest = limit_ and limit_->latest;
+    auto latest_results = std::vector<table_slice>{};
+    while (not limit_reached()) {
       if (inflight_partitions == 0) {
         if (query_cursor.scheduled_partitions
             == query_cursor.candidate_partitions) {
@@ -210,14 +212,31 @@ public:
             diagnostic::warning(err).emit(ctrl.diagnostics());
             inflight_partitions = 0;
           });
-        if (current_slice) {
-          co_yield std::move(*current_slice);
+        if (not current_slice) {
+          co_yield {};
+          continue;
+        }
+        num_results += current_slice->rows();
+        if (latest) {
+          latest_results.push_back(std::move(*current_slice));
           current_slice.reset();
-        } else {
           co_yield {};
+        } else {
+          co_yield std::move(*current_slice);
+          current_slice.reset();
+        }
+        if (limit_reached()) {
+          break;
         }
       }
     }
+    std::stable_sort(latest_results.begin(), latest_results.end(),
+                     [](const table_slice& lhs, const table_slice& rhs) {
+                       return lhs.import_time() < rhs.import_time();
+                     });
+    for (auto& slice : latest_results) {
+      co_yield std::move(slice);
+    }
   }
 
   auto name() const -> std::string override {
@@ -255,15 +274,25 @@ public:
       std::make_unique<export_operator>(std::move(expr), live_, low_priority_)};
   }
 
+  auto push_down_limit(std::optional<event_limit> limit)
+    -> std::optional<event_limit> override {
+    if (not live_) {
+      limit_ = limit;
+    }
+    return std::nullopt;
+  }
+
   friend auto inspect(auto& f, export_operator& x) -> bool {
     return f.object(x).fields(f.field("expression", x.expr_),
-                              f.field("live", x.live_));
+                              f.field("live", x.live_),
+                              f.field("limit", x.limit_));
   }
 
 private:
   expression expr_;
   bool live_;
   bool low_priority_;
+  std::optional<event_limit> limit_ = {};
 };
 
 class plugin final : public virtual operator_plugin<export_operator> {
@@ -9,21 +9,24 @@
 #include <tenzir/argument_parser.hpp>
 #include <tenzir/arrow_table_slice.hpp>
 #include <tenzir/concept/parseable/tenzir/data.hpp>
+#include <tenzir/pattern.hpp>
 #include <tenzir/plugin.hpp>
 #include <tenzir/series_builder.hpp>
 
 // Both Boost.Regex and RE2 are used:
-//  - Boost.Regex is used for actual grokking
-//  - RE2 is used for parsing the patterns we're given
+//  - RE2 is used for grokking whenever the resolved pattern allows for it, and
+//    for parsing the patterns we're given
+//  - Boost.Regex is used for grokking with patterns that RE2 rejects
 //
-// RE2 can't be used for both, because it doesn't support all the regex features
-// the built-in patterns need.
+// RE2 can't be used exclusively, because it doesn't support all the regex
+// features some patterns need, e.g., lookarounds or backreferences.
 //
-// Boost.Regex _could_ be used for both, but it's slow, so we're using RE2 where
-// we can.
+// Boost.Regex _could_ be used for everything, but it's a backtracking engine,
+// so we're using RE2 where we can.
 #include <boost/regex.hpp>
 #include <caf/make_copy_on_write.hpp>
 #include <re2/re2.h>
+#include <re2/set.h>
 
 #include <algorithm>
 #include <ranges>
@@ -372,6 +375,270 @@ auto& get_builtin_pattern_store() {
   return store;
 }
 
+/// A regular expression with all named capture groups replaced by unnamed
+/// ones, which makes it palatable to RE2.
+struct numbered_regex {
+  /// The rewritten regular expression.
+  std::string regex;
+
+  /// The names of the named capture groups and their indices.
+  std::vector<std::pair<std::string, int>> names;
+
+  /// The number of capture groups, excluding the implicit group 0.
+  int group_count = 0;
+};
+
+/// Rewrites all named capture groups in `regex` to unnamed ones.
+auto make_numbered_regex(std::string_view regex) -> numbered_regex {
+  auto result = numbered_regex{};
+  result.regex.reserve(regex.size());
+  auto i = size_t{0};
+  const auto copy = [&](size_t n) {
+    n = std::min(n, regex.size() - i);
+    result.regex.append(regex.substr(i, n));
+    i += n;
+  };
+  while (i < regex.size()) {
+    switch (regex[i]) {
+      case '\\':
+        if (regex.substr(i).starts_with("\\Q")) {
+          // Everything up to \E is quoted.
+          const auto end = regex.find("\\E", i + 2);
+          copy(end == std::string_view::npos ? regex.size() - i
+                                             : end + 2 - i);
+        } else {
+          copy(2);
+        }
+        break;
+      case '[': {
+        // Parentheses within character classes don't open groups.
+        copy(1);
+        if (i < regex.size() and regex[i] == '^')
+          copy(1);
+        if (i < regex.size() and regex[i] == ']')
+          copy(1);
+        while (i < regex.size() and regex[i] != ']') {
+          if (regex[i] == '\\')
+            copy(2);
+          else if (regex.substr(i).starts_with("[:")) {
+            const auto end = regex.find(":]", i + 2);
+            copy(end == std::string_view::npos ? 1 : end + 2 - i);
+          } else
+            copy(1);
+        }
+        copy(1);
+        break;
+      }
+      case '(': {
+        const auto rest = regex.substr(i);
+        auto name_begin = size_t{0};
+        auto terminator = '>';
+        if (rest.starts_with("(?P<")) {
+          name_begin = 4;
+        } else if (rest.starts_with("(?<") and not rest.starts_with("(?<=")
+                   and not rest.starts_with("(?<!")) {
+          name_begin = 3;
+        } else if (rest.starts_with("(?'")) {
+          name_begin = 3;
+          terminator = '\'';
+        } else if (rest.starts_with("(?")) {
+          // Non-capturing groups, lookarounds, and flags.
+          copy(2);
+          break;
+        } else {
+          result.group_count += 1;
+          copy(1);
+          break;
+        }
+        const auto name_end = rest.find(terminator, name_begin);
+        if (name_end == std::string_view::npos) {
+          copy(rest.size());
+          break;
+        }
+        result.group_count += 1;
+        result.names.emplace_back(
+          std::string{rest.substr(name_begin, name_end - name_begin)},
+          result.group_count);
+        result.regex.push_back('(');
+        i += name_end + 1;
+        break;
+      }
+      default:
+        copy(1);
+        break;
+    }
+  }
+  return result;
+}
+
+/// The capture groups of a match, indexed by group number. Unmatched groups
+/// have a null data pointer.
+using capture_groups = std::vector<re2::StringPiece>;
+
+auto to_optional(re2::StringPiece group) -> std::optional<std::string_view> {
+  if (not group.data())
+    return std::nullopt;
+  return std::string_view{group.data(), group.size()};
+}
+
+/// A resolved pattern prepared for matching.
+class compiled_pattern {
+public:
+  explicit compiled_pattern(pattern source) : source_{std::move(source)} {
+    TENZIR_ASSERT(source_.resolved_pattern);
+    auto numbered = make_numbered_regex(source_.resolved_pattern->str());
+    group_count_ = numbered.group_count;
+    literal_
+      = detail::regex_required_literal(source_.resolved_pattern->str());
+    for (const auto& [name, _] : source_.named_captures) {
+      auto& indices = named_groups_.emplace_back();
+      for (const auto& [group_name, index] : numbered.names)
+        if (group_name == name)
+          indices.push_back(index);
+    }
+    auto re2 = std::make_unique<re2::RE2>(numbered.regex, options());
+    if (re2->ok() and re2->NumberOfCapturingGroups() == group_count_) {
+      re2_ = std::move(re2);
+      re2_regex_ = std::move(numbered.regex);
+    }
+  }
+
+  /// The options for all RE2 regular expressions. We match bytes rather than
+  /// UTF-8 code points to stay consistent with Boost.Regex.
+  static auto options() -> re2::RE2::Options {
+    auto result = re2::RE2::Options{re2::RE2::Quiet};
+    result.set_encoding(re2::RE2::Options::EncodingLatin1);
+    result.set_max_mem(int64_t{64} << 20);
+    return result;
+  }
+
+  /// Returns whether `input` may match, which is cheaper to check than
+  /// actually matching.
+  auto may_match(std::string_view input) const -> bool {
+    return literal_.empty() or input.find(literal_) != std::string_view::npos;
+  }
+
+  /// Matches the entire `input`, filling in `groups` on success.
+  auto match(std::string_view input, capture_groups& groups) const -> bool {
+    if (not may_match(input))
+      return false;
+    groups.assign(group_count_ + 1, re2::StringPiece{});
+    if (re2_)
+      return re2_->Match(re2::StringPiece{input.data(), input.size()}, 0,
+                         input.size(), re2::RE2::ANCHOR_BOTH, groups.data(),
+                         group_count_ + 1);
+    auto matches = boost::cmatch{};
+    if (not boost::regex_match(input.data(), input.data() + input.size(),
+                               matches, *source_.resolved_pattern))
+      return false;
+    for (auto i = size_t{0}; i < groups.size() and i < matches.size(); ++i)
+      if (matches[i].matched)
+        groups[i] = re2::StringPiece{matches[i].first,
+                                     static_cast<size_t>(matches[i].length())};
+    return true;
+  }
+
+  /// Returns the value of the *i*th named capture of the source pattern.
+  auto named_group(const capture_groups& groups, size_t i) const
+    -> std::optional<std::string_view> {
+    // With duplicate names, the leftmost group that matched wins.
+    for (auto index : named_groups_[i])
+      if (groups[index].data())
+        return to_optional(groups[index]);
+    return std::nullopt;
+  }
+
+  /// Returns the index of the named capture of the source pattern for the
+  /// capture group with the given index.
+  auto find_named_group(int index) const -> std::optional<size_t> {
+    for (auto i = size_t{0}; i < named_groups_.size(); ++i)
+      if (std::ranges::find(named_groups_[i], index) != named_groups_[i].end())
+        return i;
+    return std::nullopt;
+  }
+
+  auto source() const -> const pattern& {
+    return source_;
+  }
+
+  auto group_count() const -> int {
+    return group_count_;
+  }
+
+  /// The RE2-compatible regex, or the empty string if RE2 cannot match the
+  /// pattern.
+  auto re2_regex() const -> const std::string& {
+    return re2_regex_;
+  }
+
+private:
+  pattern source_ = {};
+  int group_count_ = 0;
+  std::string literal_ = {};
+  std::vector<std::vector<int>> named_groups_ = {};
+  std::unique_ptr<re2::RE2> re2_ = {};
+  std::string re2_regex_ = {};
+};
+
+/// Matches input against a list of patterns, picking the first one that
+/// matches. If RE2 supports all patterns, a single pass over the input finds
+/// all matching patterns at once.
+class matcher {
+public:
+  explicit matcher(std::span<const pattern> patterns) {
+    patterns_.reserve(patterns.size());
+    for (const auto& pattern : patterns)
+      patterns_.emplace_back(pattern);
+    if (patterns_.size() < 2)
+      return;
+    if (not std::ranges::all_of(patterns_, [](const auto& pattern) {
+          return not pattern.re2_regex().empty();
+        }))
+      return;
+    auto set = std::make_unique<re2::RE2::Set>(compiled_pattern::options(),
+                                               re2::RE2::ANCHOR_BOTH);
+    for (const auto& pattern : patterns_)
+      if (set->Add(pattern.re2_regex(), nullptr) < 0)
+        return;
+    if (not set->Compile())
+      return;
+    set_ = std::move(set);
+  }
+
+  /// Returns the first pattern that matches the entire `input`, filling in
+  /// `groups`, or `nullptr` if no pattern matches.
+  auto match(std::string_view input, capture_groups& groups) const
+    -> const compiled_pattern* {
+    if (set_) {
+      if (std::ranges::none_of(patterns_, [&](const auto& pattern) {
+            return pattern.may_match(input);
+          }))
+        return nullptr;
+      auto error = re2::RE2::Set::ErrorInfo{};
+      auto matches = std::vector<int>{};
+      if (set_->Match(re2::StringPiece{input.data(), input.size()}, &matches,
+                      &error)) {
+        const auto index = std::ranges::min(matches);
+        const auto& pattern = patterns_[index];
+        if (pattern.match(input, groups))
+          return &pattern;
+        return nullptr;
+      }
+      if (error.kind == re2::RE2::Set::kNoError)
+        return nullptr;
+      // The DFA ran out of memory; fall back to matching patterns one by one.
+    }
+    for (const auto& pattern : patterns_)
+      if (pattern.match(input, groups))
+        return &pattern;
+    return nullptr;
+  }
+
+private:
+  std::vector<compiled_pattern> patterns_ = {};
+  std::unique_ptr<re2::RE2::Set> set_ = {};
+};
+
 class grok_parser final : public plugin_parser {
 public:
   grok_parser() = default;
@@ -381,7 +648,10 @@ public:
     auto parser
       = argument_parser{"grok", "https://docs.tenzir.com/next/operators/"
                                 "transformations/grok"};
-    parser.add(input_pattern_.raw_pattern, "<input_pattern>");
+    std::string input_pattern{};
+    parser.add(input_pattern, "<input_pattern>");
+    std::vector<std::string> alternative_patterns{};
+    parser.add("--pattern", alternative_patterns, "<input_pattern>");
     std::optional<std::string> pattern_definitions{};
     parser.add("--pattern-definitions", pattern_definitions, "<patterns>");
     parser.add("--indexed-captures", indexed_captures_);
@@ -394,7 +664,11 @@ public:
       patterns_->patterns | std::views::values, [](const auto& p) -> bool {
         return p.resolved_pattern.has_value();
       }));
-    input_pattern_.resolve(*patterns_, false);
+    input_patterns_.emplace_back(std::move(input_pattern));
+    for (auto& alternative : alternative_patterns)
+      input_patterns_.emplace_back(std::move(alternative));
+    for (auto& input_pattern : input_patterns_)
+      input_pattern.resolve(*patterns_, false);
   }
 
   auto name() const -> std::string override {
@@ -413,91 +687,103 @@ public:
   auto parse_strings(std::shared_ptr<arrow::StringArray> input,
                      operator_control_plane& ctrl) const
     -> std::vector<series> override {
+    // Compiling the patterns is expensive, so we do it only once and not for
+    // every batch.
+    if (not matcher_)
+      matcher_ = std::make_shared<const matcher>(input_patterns_);
     auto builder = series_builder{type{record_type{}}};
+    auto groups = capture_groups{};
     for (auto&& string : values(string_type{}, *input)) {
       if (not string) {
         builder.null();
         continue;
       }
-      boost::cmatch matches{};
-      if (not boost::regex_match(string->begin(), string->end(), matches,
-                                 *input_pattern_.resolved_pattern)) {
-        diagnostic::warning("pattern could not be matched")
-          .hint("input: `{}`", *string)
-          .hint("pattern: `{}`", input_pattern_.resolved_pattern->str())
-          .emit(ctrl.diagnostics());
+      const auto* match = matcher_->match(*string, groups);
+      if (not match) {
+        if (input_patterns_.size() == 1) {
+          diagnostic::warning("pattern could not be matched")
+            .hint("input: `{}`", *string)
+            .hint("pattern: `{}`",
+                  input_patterns_.front().resolved_pattern->str())
+            .emit(ctrl.diagnostics());
+        } else {
+          diagnostic::warning("none of the patterns could be matched")
+            .hint("input: `{}`", *string)
+            .emit(ctrl.diagnostics());
+        }
         builder.null();
         continue;
       }
       auto record = builder.record();
-      auto infer_match = [&](std::string_view in) -> data {
-        const auto* f = in.begin();
-        const auto* const l = in.end();
-        constexpr auto parser = parsers::simple_data;
-        if (data d{}; parser(f, l, d) && f == l)
-          return d;
-        return data{std::string{in}};
-      };
-      auto convert_match
-        = [&](const boost::csub_match& match, capture_type type) -> data {
-        if (!match.matched)
-          return caf::none;
+      // Captures are added as views into the input wherever possible, so we
+      // don't copy the matched strings unless we have to.
+      auto add_field = [&](std::string_view name,
+                           std::optional<std::string_view> value,
+                           capture_type type) {
+        if (not include_unnamed_ and type == capture_type::unnamed)
+          return;
+        if (not value) {
+          record.field(name, caf::none);
+          return;
+        }
         switch (type) {
           case capture_type::implicit:
           case capture_type::unnamed:
-            if (not raw_)
-              return infer_match(std::string_view{match.first, match.second});
-            return data{std::string{match.first, match.second}};
-          case capture_type::infer:
-            return infer_match(std::string_view{match.first, match.second});
+            if (raw_) {
+              record.field(name, *value);
+              return;
+            }
+            [[fallthrough]];
+          case capture_type::infer: {
+            const auto* f = value->begin();
+            const auto* const l = value->end();
+            constexpr auto parser = parsers::simple_data;
+            if (data d{}; parser(f, l, d) && f == l)
+              record.field(name, d);
+            else
+              record.field(name, *value);
+            return;
+          }
           case capture_type::string:
-            return data{std::string{match.first, match.second}};
+            record.field(name, *value);
+            return;
           case capture_type::integer:
-            if (auto r = to<int64_t>(match.str()))
-              return data{*r};
-            // TODO: Should this be an error/warning?
-            return caf::none;
+            if (auto r = to<int64_t>(*value))
+              record.field(name, *r);
+            else
+              // TODO: Should this be an error/warning?
+              record.field(name, caf::none);
+            return;
           case capture_type::floating:
-            if (auto r = to<double>(match.str()))
-              return data{*r};
-            return caf::none;
+            if (auto r = to<double>(*value))
+              record.field(name, *r);
+            else
+              record.field(name, caf::none);
+            return;
         }
         TENZIR_UNREACHABLE();
       };
-      auto add_field
-        = [&](std::string_view name, data_view2 d, capture_type type) {
-            if (include_unnamed_ || type != capture_type::unnamed)
-              record.field(name, std::move(d));
-          };
+      const auto& named_captures = match->source().named_captures;
       if (indexed_captures_) {
-        for (int i = 0; i < static_cast<int>(
-                          input_pattern_.resolved_pattern->mark_count() + 1);
-             ++i) {
-          const auto& match = matches[i];
+        for (int i = 0; i < match->group_count() + 1; ++i) {
           // Find the same capture as a named capture,
           // to get the name and conversion type to use.
           // If there isn't a matching named capture,
           // use the (stringified) index as the field name
-          if (auto named_capture_it
-              = std::ranges::find_if(input_pattern_.named_captures,
-                                     [&](const auto& elem) {
-                                       const auto& other_match
-                                         = matches[elem.first];
-                                       return match == other_match;
-                                     });
-              named_capture_it != input_pattern_.named_captures.end()) {
-            const auto& [name, type] = *named_capture_it;
+          if (auto named = match->find_named_group(i)) {
+            const auto& [name, type] = named_captures[*named];
             TENZIR_ASSERT(not name.empty());
-            add_field(name, convert_match(match, type), type);
+            add_field(name, to_optional(groups[i]), type);
           } else {
-            const auto type = capture_type::implicit;
-            add_field(std::to_string(i), convert_match(match, type), type);
+            add_field(std::to_string(i), to_optional(groups[i]),
+                      capture_type::implicit);
           }
         }
       } else {
-        for (auto&& [name, type] : input_pattern_.named_captures) {
+        for (auto i = size_t{0}; i < named_captures.size(); ++i) {
+          const auto& [name, type] = named_captures[i];
           TENZIR_ASSERT(not name.empty());
-          add_field(name, convert_match(matches[name], type), type);
+          add_field(name, match->named_group(groups, i), type);
         }
       }
     }
@@ -515,7 +801,7 @@ public:
     return f.object(x)
       .pretty_name("grok_parser")
       .fields(f.field("patterns", get_patterns, set_patterns),
-              f.field("input_pattern", x.input_pattern_),
+              f.field("input_patterns", x.input_patterns_),
               f.field("indexed_captures", x.indexed_captures_),
               f.field("include_unnamed", x.include_unnamed_),
               f.field("raw", x.raw_));
@@ -526,8 +812,9 @@ private:
   // because inspect() has to create a copy of this every time.
   caf::intrusive_cow_ptr<pattern_store> patterns_{
     caf::make_copy_on_write<pattern_store>()};
-  pattern input_pattern_{};
+  std::vector<pattern> input_patterns_{};
   bool indexed_captures_{false}, include_unnamed_{false}, raw_{false};
+  mutable std::shared_ptr<const matcher> matcher_{};
 };
 
 class plugin final : public virtual parser_plugin<grok_parser> {
@@ -66,6 +66,8 @@
 #include <tenzir/status.hpp>
 #include <tenzir/table_slice.hpp>
 
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/writer.h>
 #include <arrow/record_batch.h>
 #include <caf/stateful_actor.hpp>
 #include <caf/typed_event_based_actor.hpp>
@@ -118,6 +120,12 @@ constexpr auto SPEC_V0 = R"_(
                 example: true
                 default: false
                 description: Use an experimental, more simple format for the contained schema, and render durations as numbers representing seconds as opposed to human-readable strings.
+              format:
+                type: string
+                enum: [json, arrow]
+                example: "arrow"
+                default: "json"
+                description: "The format of the response body. With `arrow`, the response contains the served events as Arrow IPC streams, one per consecutive batch of events with the same schema, and the next continuation token in the `X-Tenzir-Next-Continuation-Token` header. The header is absent if the pipeline is completed."
     responses:
       200:
         description: Success.
@@ -175,6 +183,11 @@ constexpr auto SPEC_V0 = R"_(
                       schema: "suricata.dns"
                       schema_id: "cd4771bas235f1"
                       events: 50
+          application/vnd.apache.arrow.stream:
+            schema:
+              type: string
+              format: binary
+              description: The served events as a sequence of Arrow IPC streams.
       400:
         description: Invalid arguments.
         content:
@@ -213,13 +226,71 @@ struct request_limits {
   duration timeout = defaults::api::serve::timeout;
 };
 
+enum class serve_format {
+  json,
+  arrow,
+};
+
 struct serve_request {
   std::string serve_id = {};
   std::string continuation_token = {};
   bool use_simple_format = {};
+  serve_format format = serve_format::json;
   request_limits limits = {};
 };
 
+/// An Arrow output stream that collects everything written to it as chunks.
+/// Buffers that Arrow hands over as shared pointers, i.e., the data buffers of
+/// record batches, are referenced rather than copied.
+class chunk_output_stream final : public arrow::io::OutputStream {
+public:
+  auto Close() -> arrow::Status override {
+    flush_pending();
+    closed_ = true;
+    return arrow::Status::OK();
+  }
+
+  auto closed() const -> bool override {
+    return closed_;
+  }
+
+  auto Tell() const -> arrow::Result<int64_t> override {
+    return position_;
+  }
+
+  auto Write(const void* data, int64_t nbytes) -> arrow::Status override {
+    const auto* bytes = static_cast<const std::byte*>(data);
+    pending_.insert(pending_.end(), bytes, bytes + nbytes);
+    position_ += nbytes;
+    return arrow::Status::OK();
+  }
+
+  auto Write(const std::shared_ptr<arrow::Buffer>& data)
+    -> arrow::Status override {
+    flush_pending();
+    chunks_.push_back(chunk::make(data));
+    position_ += data->size();
+    return arrow::Status::OK();
+  }
+
+  auto finish() && -> std::vector<chunk_ptr> {
+    flush_pending();
+    return std::move(chunks_);
+  }
+
+private:
+  void flush_pending() {
+    if (not pending_.empty()) {
+      chunks_.push_back(chunk::make(std::exchange(pending_, {})));
+    }
+  }
+
+  std::vector<chunk_ptr> chunks_ = {};
+  std::vector<std::byte> pending_ = {};
+  int64_t position_ = {};
+  bool closed_ = {};
+};
+
 /// A single serve operator as observed by the serve-manager.
 struct managed_serve_operator {
   /// The actor address of the execution node of the serve operator; stored for
@@ -679,6 +750,68 @@ struct serve_handler_state {
     if (*use_simple_format) {
       result.use_simple_format = **use_simple_format;
     }
+    auto format = try_get<std::string>(params, "format");
+    if (not format) {
+      return parse_error{
+        .message = "failed to read format",
+        .detail = caf::make_error(ec::invalid_argument,
+                                  fmt::format("parameter: {}; got params {}",
+                                              format.error(), params))};
+    }
+    if (*format) {
+      if (**format == "json") {
+        result.format = serve_format::json;
+      } else if (**format == "arrow") {
+        result.format = serve_format::arrow;
+      } else {
+        return parse_error{
+          .message = "format must be one of `json` or `arrow`",
+          .detail = caf::make_error(ec::invalid_argument,
+                                    fmt::format("got format {}", **format))};
+      }
+    }
+    return result;
+  }
+
+  static auto create_arrow_response(const std::string& next_continuation_token,
+                                    const std::vector<table_slice>& results)
+    -> rest_response {
+    auto stream = chunk_output_stream{};
+    auto writer = std::shared_ptr<arrow::ipc::RecordBatchWriter>{};
+    auto current_schema = type{};
+    auto finish_stream = [&] {
+      if (writer) {
+        const auto status = writer->Close();
+        TENZIR_ASSERT(status.ok(), status.ToString().c_str());
+        writer = nullptr;
+      }
+    };
+    // We start a new IPC stream whenever the schema changes, as a single
+    // stream cannot contain record batches with different schemas.
+    for (const auto& slice : results) {
+      if (slice.rows() == 0) {
+        continue;
+      }
+      auto batch = to_record_batch(slice);
+      if (not writer or slice.schema() != current_schema) {
+        finish_stream();
+        current_schema = slice.schema();
+        auto maybe_writer
+          = arrow::ipc::MakeStreamWriter(&stream, batch->schema());
+        TENZIR_ASSERT(maybe_writer.ok(),
+                      maybe_writer.status().ToString().c_str());
+        writer = maybe_writer.MoveValueUnsafe();
+      }
+      const auto status = writer->WriteRecordBatch(*batch);
+      TENZIR_ASSERT(status.ok(), status.ToString().c_str());
+    }
+    finish_stream();
+    auto result = rest_response::from_chunks(std::move(stream).finish(),
+                                             http_content_type::arrow_stream);
+    if (not next_continuation_token.empty()) {
+      result.add_header("X-Tenzir-Next-Continuation-Token",
+                        next_continuation_token);
+    }
     return result;
   }
 
@@ -763,9 +896,15 @@ struct serve_handler_state {
                 request.continuation_token, request.limits.min_events,
                 request.limits.timeout, request.limits.max_events)
       .then(
-        [rp, use_simple_format = request.use_simple_format](
+        [rp, use_simple_format = request.use_simple_format,
+         format = request.format](
           const std::tuple<std::string, std::vector<table_slice>>&
             result) mutable {
+          if (format == serve_format::arrow) {
+            rp.deliver(
+              create_arrow_response(std::get<0>(result), std::get<1>(result)));
+            return;
+          }
           rp.deliver(rest_response::from_json_string(create_response(
             std::get<0>(result), std::get<1>(result), use_simple_format)));
         },
@@ -1007,6 +1146,7 @@ public:
           {"min_events", uint64_type{}},
           {"timeout", duration_type{}},
           {"use_simple_format", bool_type{}},
+          {"format", string_type{}},
         },
         .version = api_version::v0,
         .content_type = http_content_type::json,
@@ -7,6 +7,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <tenzir/argument_parser.hpp>
+#include <tenzir/detail/narrow.hpp>
 #include <tenzir/error.hpp>
 #include <tenzir/logger.hpp>
 #include <tenzir/pipeline.hpp>
@@ -200,6 +201,40 @@ public:
     return optimize_result{std::nullopt, event_order::ordered, copy()};
   }
 
+  auto push_down_limit(std::optional<event_limit> limit)
+    -> std::optional<event_limit> override {
+    const auto begin = begin_.value_or(0);
+    if (begin >= 0) {
+      if (end_ and *end_ >= 0) {
+        // With a non-negative end, we only ever look at the first `end`
+        // events.
+        auto count = detail::narrow_cast<uint64_t>(*end_);
+        if (limit and not limit->latest) {
+          count = std::min(count, detail::narrow_cast<uint64_t>(begin)
+                                    + limit->count);
+        }
+        return event_limit{count, false};
+      }
+      if (not end_ and limit and not limit->latest) {
+        return event_limit{detail::narrow_cast<uint64_t>(begin) + limit->count,
+                           false};
+      }
+      // A negative end depends on the total number of events.
+      return std::nullopt;
+    }
+    if (end_ and *end_ >= 0) {
+      // A negative begin with a non-negative end depends on the total number
+      // of events.
+      return std::nullopt;
+    }
+    // With a negative begin, we only ever look at the last `-begin` events.
+    auto count = detail::narrow_cast<uint64_t>(-begin);
+    if (not end_ and limit and limit->latest) {
+      count = std::min(count, limit->count);
+    }
+    return event_limit{count, true};
+  }
+
   friend auto inspect(auto& f, slice_operator& x) -> bool {
     return f.object(x)
       .pretty_name("tenzir.plugin.slice.slice_operator")
@@ -29,6 +29,9 @@ namespace date = std::chrono;
 namespace date = arrow_vendored::date;
 #endif
 
+#include <arrow/util/bitmap_ops.h>
+
+#include <array>
 #include <ctime>
 
 namespace tenzir::plugins::time {
@@ -60,6 +63,11 @@ auto find_tz_by_name(std::string_view tz_name, diagnostic_handler& diag)
 }
 #endif
 
+/// The exclusive upper bound for the time of day. `strptime` accepts leap
+/// seconds, i.e., up to 61 for `%S`. POSIX time has no representation for
+/// them, so they carry over into the next minute, like with `timegm`.
+constexpr auto max_time_of_day = std::chrono::seconds{86400 + 2};
+
 // Need to give a little nudge using the explicit .operator syntax due to
 // incompatibilities with <chrono> and <date.h>
 template <typename Clock>
@@ -324,7 +332,7 @@ struct partial_timestamp {
       return {std::nullopt, std::nullopt, std::nullopt};
     auto time = std::chrono::seconds{tm_value->tm_sec + 60 * tm_value->tm_min
                                      + 60 * 60 * tm_value->tm_hour};
-    if (time >= std::chrono::seconds{86400} || time < std::chrono::seconds{0}) {
+    if (time >= max_time_of_day || time < std::chrono::seconds{0}) {
       diagnostic::error("invalid time").note("value: {}", time).emit(diag);
       return {std::nullopt, std::nullopt, std::nullopt};
     }
@@ -475,6 +483,318 @@ auto strptime_partial(diagnostic_handler& diag, const char* input,
   return partial_timestamp::from_tm_with_unset_fields(time, is_unset);
 }
 
+/// The fields of a timestamp extracted by a `compiled_format`.
+struct parsed_time {
+  std::optional<int> year;
+  std::optional<int> month;
+  std::optional<int> day;
+  std::optional<int> hour;
+  std::optional<int> minute;
+  std::optional<int> second;
+  long utc_offset = 0;
+};
+
+/// A format string compiled into a sequence of specialized field parsers.
+///
+/// This supports the subset of `strptime` conversion specifications that
+/// appears in practically all log timestamps, with the same semantics as the
+/// glibc implementation in the "C" locale. Formats using other specifications
+/// fail to compile, and callers fall back to `strptime_partial`.
+class compiled_format {
+public:
+  /// Compiles a format string, or returns `std::nullopt` if it contains
+  /// unsupported conversion specifications.
+  static auto make(std::string_view format) -> std::optional<compiled_format> {
+    auto result = compiled_format{};
+    for (auto i = size_t{0}; i < format.size(); ++i) {
+      const auto c = format[i];
+      if (is_space(c)) {
+        result.steps_.push_back({step::whitespace});
+        continue;
+      }
+      if (c != '%') {
+        result.steps_.push_back({step::literal, c});
+        continue;
+      }
+      if (++i == format.size())
+        return std::nullopt;
+      switch (format[i]) {
+        case '%':
+          result.steps_.push_back({step::literal, '%'});
+          break;
+        case 'n':
+        case 't':
+          result.steps_.push_back({step::whitespace});
+          break;
+        case 'Y':
+          result.steps_.push_back({step::year});
+          break;
+        case 'y':
+          result.steps_.push_back({step::short_year});
+          break;
+        case 'm':
+          result.steps_.push_back({step::month});
+          break;
+        case 'b':
+        case 'B':
+        case 'h':
+          result.steps_.push_back({step::month_name});
+          break;
+        case 'd':
+        case 'e':
+          result.steps_.push_back({step::day});
+          break;
+        case 'a':
+        case 'A':
+          result.steps_.push_back({step::weekday_name});
+          break;
+        case 'H':
+          result.steps_.push_back({step::hour});
+          break;
+        case 'M':
+          result.steps_.push_back({step::minute});
+          break;
+        case 'S':
+          result.steps_.push_back({step::second});
+          break;
+        case 'z':
+          result.steps_.push_back({step::utc_offset});
+          break;
+        // Composite specifications expand into their components.
+        case 'T':
+          result.steps_.insert(result.steps_.end(),
+                               {{step::hour},
+                                {step::literal, ':'},
+                                {step::minute},
+                                {step::literal, ':'},
+                                {step::second}});
+          break;
+        case 'R':
+          result.steps_.insert(
+            result.steps_.end(),
+            {{step::hour}, {step::literal, ':'}, {step::minute}});
+          break;
+        case 'F':
+          result.steps_.insert(result.steps_.end(),
+                               {{step::year},
+                                {step::literal, '-'},
+                                {step::month},
+                                {step::literal, '-'},
+                                {step::day}});
+          break;
+        case 'D':
+          result.steps_.insert(result.steps_.end(),
+                               {{step::month},
+                                {step::literal, '/'},
+                                {step::day},
+                                {step::literal, '/'},
+                                {step::short_year}});
+          break;
+        default:
+          return std::nullopt;
+      }
+    }
+    return result;
+  }
+
+  /// Parses `input` into `result`.
+  /// @returns A pointer past the last consumed character, or `nullptr` if the
+  /// input does not match the format.
+  auto parse(std::string_view input, parsed_time& result) const
+    -> const char* {
+    const auto* it = input.data();
+    const auto* end = it + input.size();
+    for (const auto& current : steps_) {
+      switch (current.kind) {
+        case step::literal:
+          if (it == end or *it != current.character)
+            return nullptr;
+          ++it;
+          break;
+        case step::whitespace:
+          while (it != end and is_space(*it))
+            ++it;
+          break;
+        case step::year:
+          if (not parse_number(it, end, 4, 0, 9999, result.year))
+            return nullptr;
+          *result.year -= 1900;
+          break;
+        case step::short_year:
+          if (not parse_number(it, end, 2, 0, 99, result.year))
+            return nullptr;
+          // POSIX: values in the range [69,99] refer to years in the 20th
+          // century, values in the range [00,68] to the 21st century.
+          if (*result.year < 69)
+            *result.year += 100;
+          break;
+        case step::month:
+          if (not parse_number(it, end, 2, 1, 12, result.month))
+            return nullptr;
+          *result.month -= 1;
+          break;
+        case step::month_name: {
+          auto index = parse_name(it, end, month_names);
+          if (not index)
+            return nullptr;
+          result.month = *index;
+          break;
+        }
+        case step::day:
+          if (not parse_number(it, end, 2, 1, 31, result.day))
+            return nullptr;
+          break;
+        case step::weekday_name:
+          if (not parse_name(it, end, weekday_names))
+            return nullptr;
+          break;
+        case step::hour:
+          if (not parse_number(it, end, 2, 0, 23, result.hour))
+            return nullptr;
+          break;
+        case step::minute:
+          if (not parse_number(it, end, 2, 0, 59, result.minute))
+            return nullptr;
+          break;
+        case step::second:
+          if (not parse_number(it, end, 2, 0, 61, result.second))
+            return nullptr;
+          break;
+        case step::utc_offset:
+          if (not parse_utc_offset(it, end, result.utc_offset))
+            return nullptr;
+          break;
+      }
+    }
+    return it;
+  }
+
+private:
+  struct step {
+    enum kind_t : uint8_t {
+      literal,
+      whitespace,
+      year,
+      short_year,
+      month,
+      month_name,
+      day,
+      weekday_name,
+      hour,
+      minute,
+      second,
+      utc_offset,
+    };
+
+    kind_t kind;
+    char character = {};
+  };
+
+  static constexpr auto month_names = std::array<std::string_view, 12>{
+    "january", "february", "march",     "april",   "may",      "june",
+    "july",    "august",   "september", "october", "november", "december",
+  };
+
+  static constexpr auto weekday_names = std::array<std::string_view, 7>{
+    "sunday",   "monday", "tuesday",  "wednesday",
+    "thursday", "friday", "saturday",
+  };
+
+  static constexpr auto is_space(char c) -> bool {
+    return c == ' ' or (c >= '\t' and c <= '\r');
+  }
+
+  static constexpr auto to_lower(char c) -> char {
+    return c >= 'A' and c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+  }
+
+  /// Parses up to `max_digits` digits after optional leading spaces.
+  static auto parse_number(const char*& it, const char* end, int max_digits,
+                           int min, int max, std::optional<int>& result)
+    -> bool {
+    while (it != end and *it == ' ')
+      ++it;
+    auto value = 0;
+    auto digits = 0;
+    while (digits < max_digits and it != end and *it >= '0' and *it <= '9') {
+      value = value * 10 + (*it - '0');
+      ++it;
+      ++digits;
+    }
+    if (digits == 0 or value < min or value > max)
+      return false;
+    result = value;
+    return true;
+  }
+
+  /// Matches the full or the three-letter abbreviated form of a name,
+  /// ignoring case, and returns its index.
+  template <size_t N>
+  static auto
+  parse_name(const char*& it, const char* end,
+             const std::array<std::string_view, N>& names)
+    -> std::optional<int> {
+    const auto matches = [&](std::string_view name) {
+      if (static_cast<size_t>(end - it) < name.size())
+        return false;
+      for (auto i = size_t{0}; i < name.size(); ++i)
+        if (to_lower(it[i]) != name[i])
+          return false;
+      return true;
+    };
+    for (auto i = size_t{0}; i < N; ++i) {
+      if (matches(names[i])) {
+        it += names[i].size();
+        return static_cast<int>(i);
+      }
+      if (matches(names[i].substr(0, 3))) {
+        it += 3;
+        return static_cast<int>(i);
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Parses `Z`, `+hh`, `+hhmm`, or `+hh:mm` into an offset in seconds.
+  static auto parse_utc_offset(const char*& it, const char* end, long& result)
+    -> bool {
+    while (it != end and *it == ' ')
+      ++it;
+    if (it == end)
+      return false;
+    if (*it == 'Z') {
+      ++it;
+      result = 0;
+      return true;
+    }
+    if (*it != '+' and *it != '-')
+      return false;
+    const auto negative = *it++ == '-';
+    auto value = 0;
+    auto digits = 0;
+    while (digits < 4 and it != end) {
+      if (digits == 2 and *it == ':' and it + 1 != end and it[1] >= '0'
+          and it[1] <= '9')
+        ++it;
+      if (*it < '0' or *it > '9')
+        break;
+      value = value * 10 + (*it - '0');
+      ++it;
+      ++digits;
+    }
+    if (digits == 2)
+      value *= 100;
+    else if (digits != 4)
+      return false;
+    if (value % 100 >= 60 or value / 100 > 24)
+      return false;
+    result = (value / 100 * 3600 + value % 100 * 60) * (negative ? -1 : 1);
+    return true;
+  }
+
+  std::vector<step> steps_ = {};
+};
+
 class time_parser final : public plugin_parser {
 public:
   time_parser() = default;
@@ -505,6 +825,10 @@ public:
   auto parse_strings(std::shared_ptr<arrow::StringArray> input,
                      operator_control_plane& ctrl) const
     -> std::vector<series> override {
+    if (not components_) {
+      if (auto compiled = compiled_format::make(format_))
+        return parse_timestamps(*compiled, *input, ctrl.diagnostics());
+    }
     auto b = series_builder{type{record_type{}}};
     for (auto&& string : values(string_type{}, *input)) {
       if (not string) {
@@ -590,6 +914,122 @@ public:
   }
 
 private:
+  /// Parses timestamps with a compiled format, writing them directly into a
+  /// time array instead of going through the `series_builder`.
+  auto parse_timestamps(const compiled_format& format,
+                        const arrow::StringArray& input,
+                        diagnostic_handler& diag) const
+    -> std::vector<series> {
+    // The defaults for missing fields and the cutoff for inferring the year
+    // are the same for all values, so we only compute them once per batch.
+    const auto today = std::chrono::floor<std::chrono::days>(
+      std::chrono::system_clock::now());
+    const auto today_ymd = date::year_month_day{today};
+    auto to_days = [&](int year, int month, int day)
+      -> std::optional<std::chrono::sys_days> {
+      auto ymd = date::year{year + 1900}
+                 / date::month{static_cast<unsigned>(month + 1)}
+                 / date::day{static_cast<unsigned>(day)};
+      if (not ymd.ok()) {
+        diagnostic::error("invalid date")
+          .note("value: `{}-{}-{}`", year + 1900, month + 1, day)
+          .emit(diag);
+        return std::nullopt;
+      }
+      return ymd_to_days<std::chrono::system_clock>(ymd);
+    };
+    auto builder = time_type::make_arrow_builder(arrow::default_memory_pool());
+    auto reserve_result = builder->Reserve(input.length());
+    TENZIR_ASSERT(reserve_result.ok(), reserve_result.ToString().c_str());
+    for (auto i = int64_t{0}; i < input.length(); ++i) {
+      if (input.IsNull(i)) {
+        builder->UnsafeAppendNull();
+        continue;
+      }
+      const auto string = input.GetView(i);
+      auto time = parsed_time{};
+      const auto* last = format.parse(string, time);
+      if (not last) {
+        diagnostic::error("failed to parse time")
+          .hint("input: `{}`, format: `{}`", string, format_)
+          .emit(diag);
+        return {};
+      }
+      if (last != string.data() + string.size()) {
+        diagnostic::error("failed to parse time")
+          .note("format string not exhaustive (`{}` not parsed)",
+                std::string_view{last, string.data() + string.size()})
+          .hint("input: `{}`, format: `{}`", string, format_)
+          .emit(diag);
+        return {};
+      }
+      const auto year_set = time.year.has_value();
+      if (strict_) {
+        if (not time.year or not time.month or not time.day or not time.hour
+            or not time.minute) {
+          diagnostic::error("insufficient information to create a datetime")
+            .hint("either provide a year, month, day, hour, and minute, or "
+                  "disable --strict to use default values")
+            .docs(docs)
+            .emit(diag);
+          return {};
+        }
+      } else {
+        // Missing fields default to today at 00:00:00, see the comments in
+        // `parse_strings` for details.
+        time.year
+          = time.year.value_or(static_cast<int>(today_ymd.year()) - 1900);
+        time.month
+          = time.month.value_or(static_cast<unsigned>(today_ymd.month()) - 1);
+        time.day = time.day.value_or(static_cast<unsigned>(today_ymd.day()));
+        time.hour = time.hour.value_or(0);
+        time.minute = time.minute.value_or(0);
+      }
+      const auto time_of_day
+        = std::chrono::seconds{time.second.value_or(0) + 60 * *time.minute
+                               + 60 * 60 * *time.hour};
+      if (time_of_day >= max_time_of_day) {
+        diagnostic::error("invalid time")
+          .note("value: {}", time_of_day)
+          .emit(diag);
+        return {};
+      }
+      auto days = to_days(*time.year, *time.month, *time.day);
+      if (not days)
+        return {};
+      auto tp = std::chrono::sys_seconds{*days} + time_of_day
+                - std::chrono::seconds{time.utc_offset};
+      if (not strict_ and not year_set
+          and std::chrono::floor<std::chrono::days>(tp) > today) {
+        // Dates without a year are assumed to lie in the past.
+        const auto utc_days = std::chrono::floor<std::chrono::days>(tp);
+        const auto utc_ymd = date::year_month_day{utc_days};
+        days = to_days(static_cast<int>(utc_ymd.year()) - 1900 - 1,
+                       static_cast<unsigned>(utc_ymd.month()) - 1,
+                       static_cast<unsigned>(utc_ymd.day()));
+        if (not days)
+          return {};
+        tp = std::chrono::sys_seconds{*days} + (tp - utc_days);
+      }
+      builder->UnsafeAppend(
+        std::chrono::duration_cast<duration>(tp.time_since_epoch()).count());
+    }
+    auto timestamps = builder->Finish().ValueOrDie();
+    const auto result_type = type{record_type{{"timestamp", time_type{}}}};
+    auto null_bitmap = std::shared_ptr<arrow::Buffer>{};
+    if (input.null_count() > 0) {
+      null_bitmap
+        = arrow::internal::CopyBitmap(arrow::default_memory_pool(),
+                                      input.null_bitmap_data(), input.offset(),
+                                      input.length())
+            .ValueOrDie();
+    }
+    auto result = std::make_shared<arrow::StructArray>(
+      result_type.to_arrow_type(), input.length(),
+      arrow::ArrayVector{std::move(timestamps)}, std::move(null_bitmap));
+    return {series{result_type, std::move(result)}};
+  }
+
   std::string format_;
   bool components_{false};
   bool strict_{false};
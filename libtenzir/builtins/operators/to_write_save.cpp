@@ -12,6 +12,7 @@
 #include <tenzir/detail/loader_saver_resolver.hpp>
 #include <tenzir/element_type.hpp>
 #include <tenzir/error.hpp>
+#include <tenzir/output_partitioning.hpp>
 #include <tenzir/parser_interface.hpp>
 #include <tenzir/pipeline.hpp>
 #include <tenzir/plugin.hpp>
@@ -22,7 +23,9 @@
 #include <caf/expected.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 namespace tenzir::plugins::write_to_print_save {
@@ -363,6 +366,239 @@ private:
   std::unique_ptr<plugin_saver> saver_;
 };
 
+/// The open files of a saver that partitions its input, with one file per
+/// schema and partition at a time.
+class partition_writers {
+public:
+  partition_writers(const plugin_printer& printer, plugin_saver& saver,
+                    output_partitioning partitioning,
+                    operator_control_plane& ctrl)
+    : printer_{printer},
+      saver_{saver},
+      partitioning_{std::move(partitioning)},
+      ctrl_{ctrl} {
+  }
+
+  partition_writers(const partition_writers&) = delete;
+  auto operator=(const partition_writers&) -> partition_writers& = delete;
+
+  ~partition_writers() noexcept {
+    close_all();
+  }
+
+  /// Writes events into the file of their partition, starting new files as
+  /// the configured limits get exceeded.
+  auto write(const std::string& partition, table_slice slice) -> caf::error {
+    auto& files = files_[slice.schema()][partition];
+    while (slice.rows() > 0) {
+      if (files.writer and is_full(*files.writer))
+        close(files);
+      if (not files.writer) {
+        if (auto err = open(slice.schema(), partition, files))
+          return err;
+      }
+      auto& writer = *files.writer;
+      auto rows = slice.rows();
+      if (partitioning_.max_rows > 0)
+        rows = std::min(rows, partitioning_.max_rows - writer.rows);
+      auto [head, tail] = split(slice, rows);
+      writer.rows += head.rows();
+      writer.last_write = ++writes_;
+      for (auto&& chunk : writer.printer->process(std::move(head))) {
+        if (chunk)
+          writer.bytes += chunk->size();
+        writer.saver(std::move(chunk));
+      }
+      slice = std::move(tail);
+    }
+    return {};
+  }
+
+  /// Closes all files that exceeded their maximum age.
+  void close_expired() {
+    if (not partitioning_.max_age)
+      return;
+    for (auto& [_, partitions] : files_)
+      for (auto& [_, files] : partitions)
+        if (files.writer and is_full(*files.writer))
+          close(files);
+  }
+
+  /// Closes all open files.
+  void close_all() {
+    for (auto& [_, partitions] : files_)
+      for (auto& [_, files] : partitions)
+        if (files.writer)
+          close(files);
+  }
+
+private:
+  struct open_file {
+    std::unique_ptr<printer_instance> printer = {};
+    std::function<void(chunk_ptr)> saver = {};
+    uint64_t rows = {};
+    uint64_t bytes = {};
+    std::chrono::steady_clock::time_point opened = {};
+    uint64_t last_write = {};
+  };
+
+  struct partition_files {
+    std::optional<open_file> writer = {};
+    uint64_t next_sequence_number = {};
+  };
+
+  auto is_full(const open_file& writer) const -> bool {
+    return (partitioning_.max_rows > 0
+            and writer.rows >= partitioning_.max_rows)
+           or (partitioning_.max_bytes > 0
+               and writer.bytes >= partitioning_.max_bytes)
+           or (partitioning_.max_age
+               and std::chrono::steady_clock::now() - writer.opened
+                     >= *partitioning_.max_age);
+  }
+
+  auto open(const type& schema, const std::string& partition,
+            partition_files& files) -> caf::error {
+    TENZIR_ASSERT(not files.writer);
+    if (partitioning_.max_open_files > 0
+        and open_files_ >= partitioning_.max_open_files)
+      close_least_recently_written();
+    auto printer = printer_.instantiate(schema, ctrl_);
+    if (not printer)
+      return std::move(printer.error());
+    auto saver = saver_.instantiate(
+      ctrl_, printer_info{
+               .input_schema = schema,
+               .format = printer_.name(),
+               .partition = partition,
+               .sequence_number = files.next_sequence_number,
+             });
+    if (not saver)
+      return std::move(saver.error());
+    files.writer = open_file{
+      .printer = std::move(*printer),
+      .saver = std::move(*saver),
+      .opened = std::chrono::steady_clock::now(),
+    };
+    ++files.next_sequence_number;
+    ++open_files_;
+    return {};
+  }
+
+  void close(partition_files& files) {
+    TENZIR_ASSERT(files.writer);
+    for (auto&& chunk : files.writer->printer->finish())
+      files.writer->saver(std::move(chunk));
+    // Destroying the saver closes the file.
+    files.writer.reset();
+    --open_files_;
+  }
+
+  void close_least_recently_written() {
+    auto* victim = static_cast<partition_files*>(nullptr);
+    for (auto& [_, partitions] : files_)
+      for (auto& [_, files] : partitions)
+        if (files.writer
+            and (not victim
+                 or files.writer->last_write < victim->writer->last_write))
+          victim = &files;
+    if (victim)
+      close(*victim);
+  }
+
+  const plugin_printer& printer_;
+  plugin_saver& saver_;
+  const output_partitioning partitioning_;
+  operator_control_plane& ctrl_;
+  std::unordered_map<type,
+                     std::unordered_map<std::string, partition_files>>
+    files_ = {};
+  uint64_t open_files_ = {};
+  uint64_t writes_ = {};
+};
+
+/// The operator for printing and saving data with a saver that partitions its
+/// input across files.
+class partitioned_write_and_save_operator final
+  : public crtp_operator<partitioned_write_and_save_operator> {
+public:
+  partitioned_write_and_save_operator() = default;
+
+  explicit partitioned_write_and_save_operator(
+    std::unique_ptr<plugin_printer> printer,
+    std::unique_ptr<plugin_saver> saver) noexcept
+    : printer_{std::move(printer)}, saver_{std::move(saver)} {
+  }
+
+  auto
+  operator()(generator<table_slice> input, operator_control_plane& ctrl) const
+    -> generator<std::monostate> {
+    auto partitioning = saver_->partitioning();
+    TENZIR_ASSERT(partitioning);
+    const auto keys = partitioning->keys;
+    auto writers
+      = partition_writers{*printer_, *saver_, std::move(*partitioning), ctrl};
+    for (auto&& slice : input) {
+      // Sinks get polled with empty slices while their input is idle, so this
+      // also closes expired files when no events arrive.
+      writers.close_expired();
+      if (slice.rows() == 0) {
+        co_yield {};
+        continue;
+      }
+      for (auto& [partition, events] : split_by_partition(slice, keys)) {
+        if (auto err = writers.write(partition, std::move(events))) {
+          diagnostic::error(err)
+            .note("failed to write partition `{}`", partition)
+            .emit(ctrl.diagnostics());
+          co_return;
+        }
+      }
+      co_yield {};
+    }
+    writers.close_all();
+  }
+
+  auto detached() const -> bool override {
+    return true;
+  }
+
+  auto location() const -> operator_location override {
+    return operator_location::local;
+  }
+
+  auto name() const -> std::string override {
+    return "internal-partitioned-write-save";
+  }
+
+  auto optimize(expression const& filter, event_order order) const
+    -> optimize_result override {
+    (void)filter, (void)order;
+    return optimize_result{std::nullopt, event_order::schema, copy()};
+  }
+
+  friend auto inspect(auto& f, partitioned_write_and_save_operator& x)
+    -> bool {
+    return plugin_inspect(f, x.printer_) && plugin_inspect(f, x.saver_);
+  }
+
+protected:
+  auto infer_type_impl(operator_type input) const
+    -> caf::expected<operator_type> override {
+    if (input.is<table_slice>()) {
+      return tag_v<void>;
+    }
+    // TODO: Fuse this check with crtp_operator::instantiate()
+    return caf::make_error(ec::type_clash,
+                           fmt::format("'{}' does not accept {} as input",
+                                       name(), operator_type_name(input)));
+  }
+
+private:
+  std::unique_ptr<plugin_printer> printer_;
+  std::unique_ptr<plugin_saver> saver_;
+};
+
 class to_plugin final : public virtual operator_parser_plugin {
 public:
   auto name() const -> std::string override {
@@ -410,7 +646,21 @@ public:
     // go. Note that it could be that `printer->allows_joining()` returns false,
     // but `saver->is_joining()` is true. The implementation of `write_operator`
     // contains the necessary check that it is only passed one single schema in
-    // that case, and it otherwise aborts the execution.
+    // that case, and it otherwise aborts the execution. Savers that partition
+    // their input additionally need to split events before printing them.
+    if (saver->partitioning()) {
+      TENZIR_ASSERT(not saver->is_joining());
+      if (compress) {
+        diagnostic::error("compression is not supported with partitioning or "
+                          "rotation")
+          .primary(saver_path.source)
+          .hint("remove the compression extension from the path")
+          .docs(docs)
+          .throw_();
+      }
+      return std::make_unique<partitioned_write_and_save_operator>(
+        std::move(printer), std::move(saver));
+    }
     if (not saver->is_joining() && not compress) {
       return std::make_unique<write_and_save_operator>(std::move(printer),
                                                        std::move(saver));
@@ -427,6 +677,9 @@ public:
 using write_and_save_plugin
   = operator_inspection_plugin<write_and_save_operator>;
 
+using partitioned_write_and_save_plugin
+  = operator_inspection_plugin<partitioned_write_and_save_operator>;
+
 } // namespace
 
 } // namespace tenzir::plugins::write_to_print_save
@@ -434,5 +687,7 @@ using write_and_save_plugin
 TENZIR_REGISTER_PLUGIN(tenzir::plugins::write_to_print_save::to_plugin)
 TENZIR_REGISTER_PLUGIN(
   tenzir::plugins::write_to_print_save::write_and_save_plugin)
+TENZIR_REGISTER_PLUGIN(
+  tenzir::plugins::write_to_print_save::partitioned_write_and_save_plugin)
 TENZIR_REGISTER_PLUGIN(tenzir::plugins::write_to_print_save::save_plugin)
 TENZIR_REGISTER_PLUGIN(tenzir::plugins::write_to_print_save::write_plugin)
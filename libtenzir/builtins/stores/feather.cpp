@@ -12,6 +12,7 @@
 #include <tenzir/concept/convertible/data.hpp>
 #include <tenzir/data.hpp>
 #include <tenzir/detail/narrow.hpp>
+#include <tenzir/diagnostics.hpp>
 #include <tenzir/error.hpp>
 #include <tenzir/fwd.hpp>
 #include <tenzir/generator.hpp>
@@ -27,6 +28,8 @@
 #include <arrow/util/iterator.h>
 #include <arrow/util/key_value_metadata.h>
 
+#include <span>
+
 namespace tenzir::plugins::feather {
 
 namespace {
@@ -96,16 +99,55 @@ auto wrap_record_batch(const table_slice& slice)
   return new_rb;
 }
 
+/// Converts a record batch read from a Feather store into a table slice.
+/// @param batch The record batch in the event envelope.
+/// @param schema The schema of the slice, or an empty type to derive it from
+/// the record batch.
+auto make_table_slice(const std::shared_ptr<arrow::RecordBatch>& batch,
+                      const type& schema) -> table_slice {
+  auto slice = schema ? table_slice{unwrap_record_batch(batch), schema}
+                      : table_slice{unwrap_record_batch(batch)};
+  slice.import_time(derive_import_time(batch->GetColumnByName("import_time")));
+  return slice;
+}
+
+// See arrow::ipc::internal::kArrowMagicBytes in
+// arrow/ipc/metadata_internal.h.
+constexpr auto arrow_magic_bytes = std::string_view{"ARROW1"};
+
+// The Arrow IPC file format pads the magic bytes to an 8-byte boundary before
+// the actual IPC stream.
+constexpr auto arrow_file_header_size = size_t{8};
+
+auto has_arrow_magic_bytes(std::span<const std::byte> bytes) -> bool {
+  return bytes.size() >= arrow_magic_bytes.size()
+         && std::memcmp(bytes.data(), arrow_magic_bytes.data(),
+                        arrow_magic_bytes.size())
+              == 0;
+}
+
+/// Collects the record batches of an Arrow IPC stream as they get decoded.
+class record_batch_listener final : public arrow::ipc::Listener {
+public:
+  auto OnRecordBatchDecoded(std::shared_ptr<arrow::RecordBatch> batch)
+    -> arrow::Status override {
+    batches.push_back(std::move(batch));
+    return arrow::Status::OK();
+  }
+
+  auto OnEOS() -> arrow::Status override {
+    eos = true;
+    return arrow::Status::OK();
+  }
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches = {};
+  bool eos = false;
+};
+
 /// Decode an Arrow IPC stream incrementally.
 auto decode_ipc_stream(chunk_ptr chunk)
   -> caf::expected<generator<std::shared_ptr<arrow::RecordBatch>>> {
-  // See arrow::ipc::internal::kArrowMagicBytes in
-  // arrow/ipc/metadata_internal.h.
-  static constexpr auto arrow_magic_bytes = std::string_view{"ARROW1"};
-  if (chunk->size() < arrow_magic_bytes.length()
-      || std::memcmp(chunk->data(), arrow_magic_bytes.data(),
-                     arrow_magic_bytes.size())
-           != 0)
+  if (!has_arrow_magic_bytes(as_bytes(chunk)))
     return caf::make_error(ec::format_error, "not an Apache Feather v1 or "
                                              "Arrow IPC file");
   auto open_reader_result
@@ -148,6 +190,92 @@ class passive_feather_store final : public passive_store {
     return {};
   }
 
+  [[nodiscard]] generator<table_slice>
+  load_incrementally(generator<chunk_ptr> input,
+                     diagnostic_handler& dh) override {
+    // Both Feather v2 and the Arrow IPC file format consist of padded magic
+    // bytes, followed by an Arrow IPC stream and a footer. We skip the magic
+    // bytes and decode the stream directly, which allows for emitting record
+    // batches as soon as their message is complete rather than waiting for
+    // the footer. The footer follows the end-of-stream marker, so we ignore
+    // everything after that. Input without magic bytes is decoded as a plain
+    // Arrow IPC stream.
+    auto listener = std::make_shared<record_batch_listener>();
+    auto decoder = arrow::ipc::StreamDecoder{listener};
+    auto header = std::vector<std::byte>{};
+    auto header_done = false;
+    auto schema = type{};
+    auto offset = id{0};
+    for (auto&& chunk : input) {
+      if (!chunk || chunk->size() == 0 || listener->eos) {
+        co_yield {};
+        continue;
+      }
+      if (!header_done) {
+        if (header.empty() && chunk->size() >= arrow_file_header_size) {
+          header_done = true;
+          if (has_arrow_magic_bytes(as_bytes(chunk)))
+            chunk = chunk->size() > arrow_file_header_size
+                      ? chunk->slice(arrow_file_header_size)
+                      : nullptr;
+        } else {
+          header.insert(header.end(), chunk->begin(), chunk->end());
+          if (header.size() < arrow_file_header_size) {
+            co_yield {};
+            continue;
+          }
+          header_done = true;
+          if (has_arrow_magic_bytes(header))
+            header.erase(header.begin(),
+                         header.begin() + arrow_file_header_size);
+          chunk = header.empty() ? nullptr
+                                 : chunk::make(std::exchange(header, {}));
+        }
+        if (!chunk) {
+          co_yield {};
+          continue;
+        }
+      }
+      if (auto status = decoder.Consume(as_arrow_buffer(std::move(chunk)));
+          !status.ok()) {
+        diagnostic::error("failed to decode Arrow IPC stream: {}",
+                          status.ToString())
+          .emit(dh);
+        co_return;
+      }
+      if (listener->batches.empty()) {
+        co_yield {};
+        continue;
+      }
+      for (auto& batch : std::exchange(listener->batches, {})) {
+        if (!batch->GetColumnByName("event")
+            || !batch->GetColumnByName("import_time")) {
+          diagnostic::error("Arrow IPC stream is not a Tenzir Feather store")
+            .note("record batch has no `event` and `import_time` columns")
+            .emit(dh);
+          co_return;
+        }
+        auto slice = make_table_slice(batch, schema);
+        if (!schema)
+          schema = slice.schema();
+        slice.offset(offset);
+        offset += slice.rows();
+        co_yield std::move(slice);
+      }
+    }
+    if (!header_done) {
+      diagnostic::error("failed to decode Arrow IPC stream")
+        .note("input ended after {} bytes", header.size())
+        .emit(dh);
+    } else if (!listener->eos) {
+      // Without the end-of-stream marker we cannot tell a truncated store
+      // from a complete one.
+      diagnostic::error("failed to decode Arrow IPC stream")
+        .note("input ended before the end-of-stream marker")
+        .emit(dh);
+    }
+  }
+
   [[nodiscard]] generator<table_slice> slices() const override {
     auto offset = id{};
     auto i = size_t{};
@@ -159,13 +287,9 @@ class passive_feather_store final : public passive_store {
         auto batch = std::move(*remaining_slices_iterator_);
         TENZIR_ASSERT(batch);
         ++remaining_slices_iterator_;
-        auto import_time_column = batch->GetColumnByName("import_time");
-        auto slice = cached_slices_.empty()
-                       ? table_slice{unwrap_record_batch(batch)}
-                       : table_slice{unwrap_record_batch(batch),
-                                     cached_slices_[0].schema()};
+        auto slice = make_table_slice(
+          batch, cached_slices_.empty() ? type{} : cached_slices_[0].schema());
         slice.offset(offset);
-        slice.import_time(derive_import_time(import_time_column));
         cached_slices_.push_back(std::move(slice));
       } else {
         co_return;
@@ -43,6 +43,13 @@ bool should_skip_index_creation(const type& type,
                                 const qualified_record_field& qf,
                                 const std::vector<index_config::rule>& rules);
 
+/// Creates the value index for a field whose index creation is not skipped.
+/// @param type The type of the field.
+/// @param index_opts Settings that are forwarded to the value index.
+/// @param config The index configuration.
+value_index_ptr make_field_index(const type& type, caf::settings index_opts,
+                                 const index_config& config);
+
 /// The state of the ACTIVE PARTITION actor.
 struct active_partition_state {
   // -- constructor ------------------------------------------------------------
@@ -86,8 +93,6 @@ struct active_partition_state {
 
   // -- utility functions ------------------------------------------------------
 
-  active_indexer_actor indexer_at(size_t position) const;
-
   void add_flush_listener(flush_listener_actor listener);
 
   void notify_flush_listeners();
@@ -133,14 +138,11 @@ struct active_partition_state {
   /// Path where the partition synopsis is written.
   std::optional<std::filesystem::path> synopsis_path = {};
 
-  /// Maps qualified fields to indexer actors.
+  /// Maps qualified fields to value indexes, which the partition updates
+  /// in-thread for every incoming table slice. Fields that are not indexed map
+  /// to a nullptr.
   //  TODO: Should we use the tsl map here for heterogeneous key lookup?
-  detail::stable_map<qualified_record_field, active_indexer_actor> indexers
-    = {};
-
-  /// Counts how many indexers have already responded to the `snapshot` atom
-  /// with a serialized chunk.
-  size_t persisted_indexers = {};
+  detail::stable_map<qualified_record_field, value_index_ptr> indexers = {};
 
   /// The store backend.
   const store_actor_plugin* store_plugin = {};
@@ -151,10 +153,6 @@ struct active_partition_state {
   /// Access info for the finished store.
   std::optional<resource> store_file = {};
 
-  /// Temporary storage for the serialized indexers of this partition, before
-  /// they get written into the flatbuffer.
-  std::map<caf::actor_id, tenzir::chunk_ptr> chunks = {};
-
   /// A once_flag for things that need to be done only once at shutdown.
   std::once_flag shutdown_once = {};
 
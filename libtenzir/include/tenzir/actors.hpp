@@ -157,18 +157,6 @@ using indexer_actor = typed_actor_fwd<
   // Requests the INDEXER to shut down.
   auto(atom::shutdown)->caf::result<void>>::unwrap;
 
-/// The ACTIVE INDEXER actor interface.
-using active_indexer_actor = typed_actor_fwd<
-  // Hooks into the table slice stream.
-  auto(caf::stream<table_slice>)
-    ->caf::result<caf::inbound_stream_slot<table_slice>>,
-  // Finalizes the ACTIVE INDEXER into a chunk, which containes an INDEXER.
-  auto(atom::snapshot)->caf::result<chunk_ptr>>
-  // Conform the the INDEXER ACTOR interface.
-  ::extend_with<indexer_actor>
-  // Conform to the procol of the STATUS CLIENT actor.
-  ::extend_with<status_client_actor>::unwrap;
-
 /// The ACCOUNTANT actor interface.
 using accountant_actor = typed_actor_fwd<
   // Update the configuration of the ACCOUNTANT.
@@ -231,6 +219,17 @@ using catalog_actor = typed_actor_fwd<
   // Conform to the procotol of the STATUS CLIENT actor.
   ::extend_with<status_client_actor>::unwrap;
 
+/// The interface of a LIVE QUERY HUB actor.
+using live_query_hub_actor = typed_actor_fwd<
+  // Register a live query, returning its id.
+  auto(atom::subscribe, expression)->caf::result<uint64_t>,
+  // Fetch the next matching events of a live query.
+  auto(atom::get, uint64_t)->caf::result<table_slice>,
+  // Remove a live query.
+  auto(atom::erase, uint64_t)->caf::result<void>>
+  // Receive all imported events from the IMPORTER.
+  ::extend_with<receiver_actor<table_slice>>::unwrap;
+
 /// The interface of an IMPORTER actor.
 using importer_actor = typed_actor_fwd<
   // Add a new sink.
@@ -239,6 +238,8 @@ using importer_actor = typed_actor_fwd<
   auto(atom::subscribe, atom::flush, flush_listener_actor)->caf::result<void>,
   // Register a subscriber for table slices.
   auto(atom::subscribe, receiver_actor<table_slice>)->caf::result<void>,
+  // Retrieve the LIVE QUERY HUB that evaluates live queries.
+  auto(atom::get, atom::query)->caf::result<live_query_hub_actor>,
   // Push buffered slices downstream to make the data available.
   auto(atom::flush)->caf::result<void>,
   // Import a batch of data.
@@ -497,7 +498,6 @@ CAF_BEGIN_TYPE_ID_BLOCK(tenzir_actors, caf::id_block::tenzir_atoms::end)
       std::tuple<tenzir::exec_node_actor, tenzir::operator_type, std::string>>))
 
   TENZIR_ADD_TYPE_ID((tenzir::accountant_actor))
-  TENZIR_ADD_TYPE_ID((tenzir::active_indexer_actor))
   TENZIR_ADD_TYPE_ID((tenzir::active_partition_actor))
   TENZIR_ADD_TYPE_ID((tenzir::analyzer_plugin_actor))
   TENZIR_ADD_TYPE_ID((tenzir::catalog_actor))
@@ -513,6 +513,7 @@ CAF_BEGIN_TYPE_ID_BLOCK(tenzir_actors, caf::id_block::tenzir_atoms::end)
   TENZIR_ADD_TYPE_ID((tenzir::importer_actor))
   TENZIR_ADD_TYPE_ID((tenzir::index_actor))
   TENZIR_ADD_TYPE_ID((tenzir::indexer_actor))
+  TENZIR_ADD_TYPE_ID((tenzir::live_query_hub_actor))
   TENZIR_ADD_TYPE_ID((tenzir::node_actor))
   TENZIR_ADD_TYPE_ID((tenzir::partition_actor))
   TENZIR_ADD_TYPE_ID((tenzir::partition_creation_listener_actor))
@@ -133,6 +133,18 @@ public:
     });
   }
 
+  /// Adds a named argument that may be given multiple times.
+  template <class T>
+  void add(std::string_view names, std::vector<T>& x, std::string meta) {
+    named_.push_back(named_t{
+      split_names(names),
+      std::move(meta),
+      [&x](located<std::string> y) {
+        x.push_back(convert_or_throw<T>(std::move(y)).inner);
+      },
+    });
+  }
+
   template <class T>
   void
   add(std::string_view names, std::optional<located<T>>& x, std::string meta) {
@@ -14,6 +14,7 @@
 #include "tenzir/detail/type_traits.hpp"
 #include "tenzir/ewah_bitmap.hpp"
 #include "tenzir/null_bitmap.hpp"
+#include "tenzir/roaring_bitmap.hpp"
 #include "tenzir/wah_bitmap.hpp"
 
 #include <caf/detail/type_list.hpp>
@@ -24,20 +25,50 @@ namespace tenzir {
 
 class bitmap_bit_range;
 
+/// The encoding of default-constructed bitmaps.
+enum class bitmap_encoding {
+  ewah,
+  roaring,
+};
+
+/// @returns The encoding of default-constructed bitmaps on the current thread.
+bitmap_encoding default_bitmap_encoding();
+
+/// Sets the encoding of default-constructed bitmaps on the current thread for
+/// the lifetime of the guard, and restores the previous encoding afterwards.
+/// Bitmaps that already exist keep their encoding.
+class bitmap_encoding_guard {
+public:
+  explicit bitmap_encoding_guard(bitmap_encoding encoding) noexcept;
+  ~bitmap_encoding_guard() noexcept;
+
+  bitmap_encoding_guard(const bitmap_encoding_guard&) = delete;
+  bitmap_encoding_guard& operator=(const bitmap_encoding_guard&) = delete;
+  bitmap_encoding_guard(bitmap_encoding_guard&&) = delete;
+  bitmap_encoding_guard& operator=(bitmap_encoding_guard&&) = delete;
+
+private:
+  bitmap_encoding previous_;
+};
+
 /// A type-erased bitmap. This type wraps a concrete bitmap instance and models
 /// the Bitmap concept at the same time.
 class bitmap : public bitmap_base<bitmap>, detail::equality_comparable<bitmap> {
   friend bitmap_bit_range;
 
 public:
-  using types = caf::detail::type_list<ewah_bitmap, null_bitmap, wah_bitmap>;
+  using types = caf::detail::type_list<ewah_bitmap, null_bitmap, wah_bitmap,
+                                       roaring_bitmap>;
 
   using variant = caf::detail::tl_apply_t<types, caf::variant>;
 
-  /// The concrete bitmap type to be used for default construction.
+  /// The concrete bitmap type to be used for default construction, unless
+  /// a `bitmap_encoding_guard` selects `bitmap_encoding::roaring`.
   using default_bitmap = ewah_bitmap;
 
-  /// Default-constructs a bitmap of type ::default_bitmap.
+  /// Default-constructs a bitmap of type ::default_bitmap or
+  /// ::roaring_bitmap, depending on the default bitmap encoding of the current
+  /// thread.
   bitmap();
 
   /// Constructs a bitmap from a concrete bitmap type.
@@ -60,6 +91,14 @@ public:
 
   [[nodiscard]] size_t memusage() const;
 
+  // -- element access --------------------------------------------------------
+
+  /// Accesses the *i*-th bit of the bitmap.
+  /// @param i The index into the bitmap.
+  /// @returns `true` iff bit *i* is 1.
+  /// @pre `i < size()`
+  bool operator[](size_type i) const;
+
   // -- modifiers ------------------------------------------------------------
 
   void append_bit(bool bit);
@@ -89,10 +128,33 @@ public:
 
   friend auto unpack(const fbs::Bitmap& from, bitmap& to) -> caf::error;
 
+  // -- bitwise operations ----------------------------------------------------
+  //
+  // These overloads dispatch to the container-wise algorithms if both operands
+  // are Roaring bitmaps, and fall back to the generic algorithms otherwise.
+
+  friend bitmap binary_and(const bitmap& lhs, const bitmap& rhs);
+
+  friend bitmap binary_or(const bitmap& lhs, const bitmap& rhs);
+
+  friend bitmap binary_xor(const bitmap& lhs, const bitmap& rhs);
+
+  friend bitmap binary_nand(const bitmap& lhs, const bitmap& rhs);
+
 private:
   variant bitmap_;
 };
 
+/// Computes the *rank* of a type-erased bitmap, using the container
+/// cardinalities for Roaring bitmaps.
+/// @relates bitmap
+template <bool Bit = true>
+bitmap::size_type rank(const bitmap& bm) {
+  if (const auto* roaring = caf::get_if<roaring_bitmap>(&bm.get_data()))
+    return rank<Bit>(*roaring);
+  return rank<Bit, bitmap>(bm);
+}
+
 /// @relates bitmap
 class bitmap_bit_range
   : public bit_range_base<bitmap_bit_range, bitmap::block_type> {
@@ -104,7 +166,8 @@ public:
 
 private:
   using range_variant
-    = caf::variant<ewah_bitmap_range, null_bitmap_range, wah_bitmap_range>;
+    = caf::variant<ewah_bitmap_range, null_bitmap_range, wah_bitmap_range,
+                   roaring_bitmap_range>;
 
   range_variant range_;
 };
@@ -15,6 +15,17 @@
 
 namespace tenzir {
 
+/// The arrangement of bits in a Bloom filter.
+/// @relates bloom_filter_parameters
+enum class bloom_filter_layout {
+  /// Every hash function sets a bit anywhere in the bitvector. See
+  /// `bloom_filter`.
+  classic,
+  /// All bits of an element are in a single block. See
+  /// `split_block_bloom_filter`.
+  split_block,
+};
+
 /// The parameters to construct a Bloom filter. Only a subset of parameter
 /// combinations is viable in practice. One of the following 4 combinations can
 /// determine all other paramters:
@@ -37,6 +48,7 @@ struct bloom_filter_parameters {
   std::optional<size_t> n; ///< Set cardinality.
   std::optional<size_t> k; ///< Number of hash functions.
   std::optional<double> p; ///< False-positive probability.
+  bloom_filter_layout layout = bloom_filter_layout::classic; ///< Bit layout.
 
   friend bool operator==(const bloom_filter_parameters& x,
                          const bloom_filter_parameters& y);
@@ -51,8 +63,9 @@ struct bloom_filter_parameters {
 /// @returns The complete set of parameters
 std::optional<bloom_filter_parameters> evaluate(bloom_filter_parameters xs);
 
-/// Attempts to Bloom filter parameters of the form `bloom_filter(n,p)`, where
-/// `n` and `p` are floating-point values.
+/// Attempts to Bloom filter parameters of the form `bloomfilter(n,p)` or
+/// `splitblockbloomfilter(n,p)` for the split-block layout, where `n` and `p`
+/// are floating-point values.
 /// @param x The input to parse.
 /// @returns The parsed Bloom filter parameters.
 /// @relates evaluate
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "tenzir/bloom_filter.hpp"
+#include "tenzir/split_block_bloom_filter.hpp"
 #include "tenzir/synopsis.hpp"
 #include "tenzir/type.hpp"
 
@@ -17,11 +18,14 @@
 namespace tenzir {
 
 /// A Bloom filter synopsis.
-template <class T, class HashFunction>
+/// @tparam T The type of the elements.
+/// @tparam HashFunction The hash function to use for the Bloom filter.
+/// @tparam BloomFilter The Bloom filter type, which determines the layout.
+template <class T, class HashFunction,
+          class BloomFilter = bloom_filter<HashFunction>>
 class bloom_filter_synopsis : public synopsis {
 public:
-  using bloom_filter_type = bloom_filter<HashFunction>;
-  using hasher_type = typename bloom_filter_type::hasher_type;
+  using bloom_filter_type = BloomFilter;
 
   bloom_filter_synopsis(tenzir::type x, bloom_filter_type bf)
     : synopsis{std::move(x)}, bloom_filter_{std::move(bf)} {
@@ -29,7 +33,7 @@ public:
   }
 
   [[nodiscard]] synopsis_ptr clone() const override {
-    using self = bloom_filter_synopsis<T, HashFunction>;
+    using self = bloom_filter_synopsis<T, HashFunction, BloomFilter>;
     return std::make_unique<self>(type(), bloom_filter_);
   }
 
@@ -92,12 +96,12 @@ public:
       inspector);
   }
 
-  const bloom_filter<HashFunction>& filter() const {
+  const bloom_filter_type& filter() const {
     return bloom_filter_;
   }
 
 protected:
-  bloom_filter<HashFunction> bloom_filter_;
+  bloom_filter_type bloom_filter_;
 };
 
 // Because Tenzir deserializes a synopsis with empty options and
@@ -105,13 +109,15 @@ protected:
 // information, we augment the type with the synopsis options.
 
 /// Creates a new type annotation from a set of bloom filter parameters.
-/// @returns The provided type with a new `#synopsis=bloom_filter(n,p)`
-///          attribute. Note that all previous attributes are discarded.
+/// @returns The provided type with a new `#synopsis=bloomfilter(n,p)`
+///          attribute, or `#synopsis=splitblockbloomfilter(n,p)` for the
+///          split-block layout. Note that all previous attributes are
+///          discarded.
 type annotate_parameters(const type& type,
                          const bloom_filter_parameters& params);
 
 /// Parses Bloom filter parameters from type attributes of the form
-/// `#synopsis=bloom_filter(n,p)`.
+/// `#synopsis=bloomfilter(n,p)` or `#synopsis=splitblockbloomfilter(n,p)`.
 /// @param x The type whose attributes to parse.
 /// @returns The parsed and evaluated Bloom filter parameters.
 /// @relates bloom_filter_synopsis
@@ -41,12 +41,14 @@ public:
   using element_type = T;
   using view_type = view<T>;
 
-  buffered_synopsis(tenzir::type x, double p) : synopsis{std::move(x)}, p_{p} {
+  buffered_synopsis(tenzir::type x, double p,
+                    bloom_filter_layout layout = bloom_filter_layout::classic)
+    : synopsis{std::move(x)}, p_{p}, layout_{layout} {
     // nop
   }
 
   [[nodiscard]] synopsis_ptr clone() const override {
-    auto copy = std::make_unique<buffered_synopsis>(type(), p_);
+    auto copy = std::make_unique<buffered_synopsis>(type(), p_, layout_);
     copy->data_ = data_;
     return copy;
   }
@@ -58,6 +60,7 @@ public:
     bloom_filter_parameters params;
     params.p = p_;
     params.n = next_power_of_two;
+    params.layout = layout_;
     TENZIR_DEBUG("shrinks buffered synopsis to {} elements", params.n);
     auto type = annotate_parameters(this->type(), params);
     // TODO: If we can get rid completely of the `ip_synopsis` and
@@ -121,6 +124,7 @@ public:
 
 private:
   double p_;
+  bloom_filter_layout layout_;
   std::unordered_set<T> data_;
 };
 
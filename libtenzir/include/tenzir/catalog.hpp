@@ -104,16 +104,28 @@ public:
   void erase(const uuid& partition);
 
   /// Retrieves the list of candidate partition IDs for a given expression.
+  /// Unpacks the synopses of lazily loaded partitions for the schemas whose
+  /// fields the expression references, and unloads the least recently used
+  /// ones afterwards if they exceed their memory budget.
   /// @param expr The expression to lookup.
   /// @returns A lookup result of candidate partitions categorized by type.
-  [[nodiscard]] caf::expected<catalog_lookup_result>
-  lookup(expression expr) const;
+  [[nodiscard]] caf::expected<catalog_lookup_result> lookup(expression expr);
 
   [[nodiscard]] catalog_lookup_result::candidate_info
   lookup_impl(const expression& expr, const type& schema) const;
 
+  /// Unpacks the field and type synopses of all lazily loaded partitions with
+  /// the given schema. Drops partitions whose synopses fail to unpack.
+  void load_synopses(const type& schema);
+
+  /// Unloads the synopses of the least recently used schemas until the
+  /// unpacked synopses fit into `defaults::catalog::max_unpacked_synopses_size`
+  /// again. Never unloads the synopses used by the most recent lookup.
+  void evict_synopses();
+
   /// @returns A best-effort estimate of the amount of memory used for this
-  /// catalog (in bytes).
+  /// catalog (in bytes). Synopses that are not unpacked are not included, as
+  /// they remain on disk.
   [[nodiscard]] size_t memusage() const;
 
   /// Update the list of fields that should not be touched by the pruner.
@@ -156,6 +168,13 @@ public:
   /// The set of fields that should not be touched by the pruner.
   detail::heterogeneous_string_hashset unprunable_fields;
 
+  /// For each schema with lazily unpacked synopses, the number of the lookup
+  /// that used them most recently.
+  std::unordered_map<tenzir::type, uint64_t> unpacked_synopses_last_used = {};
+
+  /// The number of lookups so far.
+  uint64_t num_lookups = 0;
+
   std::map<std::string, type_set> type_data = {};
   tenzir::module configuration_module = {};
   tenzir::taxonomies taxonomies = {};
@@ -30,10 +30,14 @@ namespace tenzir {
 struct chunk_metadata {
   std::optional<std::string> content_type = {};
 
+  /// Where the data came from, e.g., the address of a remote peer.
+  std::optional<std::string> origin = {};
+
   friend auto inspect(auto& f, chunk_metadata& x) -> bool {
     return f.object(x)
       .pretty_name("tenzir.chunk_metadata")
-      .fields(f.field("content_type", x.content_type));
+      .fields(f.field("content_type", x.content_type),
+              f.field("origin", x.origin));
   }
 };
 
@@ -342,6 +346,13 @@ auto split(const chunk_ptr& chunk, size_t partition_point)
 auto split(std::vector<chunk_ptr> chunks, size_t partition_point)
   -> std::pair<std::vector<chunk_ptr>, std::vector<chunk_ptr>>;
 
+/// Joins a batch of messages into a single chunk, terminating each of them
+/// with a newline unless it already ends in one. A single message that ends
+/// in a newline is returned as is without copying.
+/// @param messages The messages to join.
+/// @pre `not messages.empty()`
+auto join_lines(std::vector<chunk_ptr> messages) -> chunk_ptr;
+
 } // namespace tenzir
 
 namespace fmt {
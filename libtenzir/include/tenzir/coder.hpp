@@ -167,10 +167,12 @@ public:
     } else {
       using concrete_bitmap_type = std::conditional_t<
         std::is_same_v<Bitmap, ewah_bitmap>, fbs::bitmap::EWAHBitmap,
-        std::conditional_t<std::is_same_v<Bitmap, null_bitmap>,
-                           fbs::bitmap::NullBitmap,
-                           std::conditional_t<std::is_same_v<Bitmap, wah_bitmap>,
-                                              fbs::bitmap::WAHBitmap, void>>>;
+        std::conditional_t<
+          std::is_same_v<Bitmap, null_bitmap>, fbs::bitmap::NullBitmap,
+          std::conditional_t<
+            std::is_same_v<Bitmap, wah_bitmap>, fbs::bitmap::WAHBitmap,
+            std::conditional_t<std::is_same_v<Bitmap, roaring_bitmap>,
+                               fbs::bitmap::RoaringBitmap, void>>>>;
       static_assert(!std::is_void_v<concrete_bitmap_type>);
       if (const auto* from_concrete
           = from.bitmap()->bitmap_as<concrete_bitmap_type>())
@@ -256,8 +258,10 @@ public:
           std::is_same_v<Bitmap, ewah_bitmap>, fbs::bitmap::EWAHBitmap,
           std::conditional_t<
             std::is_same_v<Bitmap, null_bitmap>, fbs::bitmap::NullBitmap,
-            std::conditional_t<std::is_same_v<Bitmap, wah_bitmap>,
-                               fbs::bitmap::WAHBitmap, void>>>;
+            std::conditional_t<
+              std::is_same_v<Bitmap, wah_bitmap>, fbs::bitmap::WAHBitmap,
+              std::conditional_t<std::is_same_v<Bitmap, roaring_bitmap>,
+                                 fbs::bitmap::RoaringBitmap, void>>>>;
         static_assert(!std::is_void_v<concrete_bitmap_type>);
         const auto* from_concrete
           = from_bitmap->bitmap_as<concrete_bitmap_type>();
@@ -117,8 +117,23 @@ inline constexpr size_t max_string_size = 1024;
 /// or table).
 inline constexpr size_t max_container_elements = 256;
 
+/// The maximum memory usage of the postings of a trigram index in bytes before
+/// it stops indexing and answers all lookups with all positions.
+inline constexpr size_t max_trigram_index_size = 16 * 1024 * 1024;
+
 } // namespace index
 
+// -- constants for the catalog ------------------------------------------------
+
+/// Contains constants for the catalog.
+namespace catalog {
+
+/// The estimated memory usage of the lazily unpacked partition synopses in
+/// bytes above which the catalog unloads the least recently used ones.
+inline constexpr size_t max_unpacked_synopses_size = 1024 * 1024 * 1024;
+
+} // namespace catalog
+
 // -- constants for the logger -------------------------------------------------
 namespace logger {
 
@@ -236,6 +251,10 @@ inline constexpr size_t taste_partitions = 5;
 /// Maximum number of concurrent INDEX queries.
 inline constexpr size_t num_query_supervisors = 10;
 
+/// Maximum number of events buffered per live query before the LIVE QUERY HUB
+/// starts dropping events for it.
+inline constexpr uint64_t max_buffered_live_events = 1 << 22;
+
 /// The store backend to use.
 inline constexpr const char* store_backend = "feather";
 
@@ -269,9 +288,18 @@ inline constexpr std::chrono::seconds shutdown_kill_timeout
 /// The allowed false positive rate for a synopsis.
 inline constexpr double fp_rate = 0.01;
 
+/// Whether synopses use split-block Bloom filters instead of classic ones.
+inline constexpr bool split_block_bloom_filters = false;
+
+/// Whether value indexes and ID sets use Roaring bitmaps instead of EWAH.
+inline constexpr bool roaring_bitmaps = false;
+
 /// Flag that enables creation of partition indexes in the database.
 inline constexpr bool create_partition_index = true;
 
+/// Flag that enables creation of trigram indexes for string fields.
+inline constexpr bool create_trigram_index = false;
+
 /// Whether to spawn central components in separate threads.
 inline constexpr bool detach_components = true;
 
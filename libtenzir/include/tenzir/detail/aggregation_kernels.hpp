@@ -0,0 +1,86 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/arrow_table_slice.hpp"
+#include "tenzir/detail/assert.hpp"
+#include "tenzir/detail/type_traits.hpp"
+#include "tenzir/type.hpp"
+
+#include <arrow/array.h>
+#include <arrow/util/bit_run_reader.h>
+
+#include <optional>
+#include <type_traits>
+
+namespace tenzir::detail {
+
+/// Whether `select_extremum` supports arrays of type `Type`.
+template <class Type>
+constexpr auto has_extremum_kernel_v
+  = is_any_v<Type, int64_type, uint64_type, double_type, duration_type,
+             time_type>;
+
+/// Selects the valid value of `array` that no other value precedes according
+/// to `less`, e.g., the minimum for `std::less<>`.
+/// @returns The selected value, or `std::nullopt` if all values are null.
+template <class Type, class Less>
+  requires has_extremum_kernel_v<Type>
+auto select_extremum(const arrow::Array& array, Less less)
+  -> std::optional<type_to_data_t<Type>> {
+  const auto& typed_array = caf::get<type_to_arrow_array_t<Type>>(array);
+  if (typed_array.null_count() == typed_array.length())
+    return std::nullopt;
+  using value_type = std::remove_cvref_t<decltype(*typed_array.raw_values())>;
+  auto result = std::optional<value_type>{};
+  arrow::internal::VisitSetBitRunsVoid(
+    typed_array.null_bitmap_data(), typed_array.offset(), typed_array.length(),
+    [&](int64_t position, int64_t length) {
+      const auto* values = typed_array.raw_values() + position;
+      // The branchless selection keeps the semantics of the row-wise
+      // comparison for NaN and lets the compiler vectorize the loop.
+      auto run_result = result.value_or(values[0]);
+      for (auto i = int64_t{0}; i < length; ++i) {
+        run_result = less(values[i], run_result) ? values[i] : run_result;
+      }
+      result = run_result;
+    });
+  TENZIR_ASSERT(result);
+  if constexpr (std::is_same_v<Type, time_type>)
+    return time{duration{*result}};
+  else
+    return type_to_data_t<Type>{*result};
+}
+
+/// Inserts the valid values of `array` into `set`, which must support lookup
+/// with views of the values.
+template <concrete_type Type, class Set>
+void insert_distinct(const Type& type, const arrow::Array& array, Set& set) {
+  if (array.null_count() == array.length())
+    return;
+  auto previous = std::optional<view<type_to_data_t<Type>>>{};
+  arrow::internal::VisitSetBitRunsVoid(
+    array.null_bitmap_data(), array.offset(), array.length(),
+    [&](int64_t position, int64_t length) {
+      for (auto row = position; row < position + length; ++row) {
+        const auto value = value_at(type, array, row);
+        // Runs of repeated values are common, and comparing with the
+        // previous value is much cheaper than a hash lookup.
+        if constexpr (basic_type<Type>) {
+          if (previous and *previous == value)
+            continue;
+          previous = value;
+        }
+        if (!set.contains(value))
+          set.insert(materialize(value));
+      }
+    });
+}
+
+} // namespace tenzir::detail
@@ -128,6 +128,7 @@ namespace tenzir {
 
 class active_store;
 class aggregation_function;
+class argument_parser;
 class bitmap;
 class blob_type;
 class bool_type;
@@ -165,6 +166,7 @@ class plugin_ptr;
 class plugin;
 class port;
 class record_type;
+class roaring_bitmap;
 class segment;
 class shared_diagnostic_handler;
 class string_type;
@@ -326,6 +328,7 @@ namespace bitmap {
 
 struct EWAHBitmap;
 struct NullBitmap;
+struct RoaringBitmap;
 struct WAHBitmap;
 
 } // namespace bitmap
@@ -501,6 +504,8 @@ CAF_BEGIN_TYPE_ID_BLOCK(tenzir_types, first_tenzir_type_id)
   TENZIR_ADD_TYPE_ID((caf::inbound_stream_slot<tenzir::table_slice>))
   TENZIR_ADD_TYPE_ID((caf::outbound_stream_slot<tenzir::table_slice>))
 
+  TENZIR_ADD_TYPE_ID((tenzir::roaring_bitmap))
+
 CAF_END_TYPE_ID_BLOCK(tenzir_types)
 
 #undef TENZIR_CAF_ATOM_ALIAS
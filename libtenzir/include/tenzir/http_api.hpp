@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <tenzir/chunk.hpp>
 #include <tenzir/data.hpp>
 #include <tenzir/detail/inspection_common.hpp>
 #include <tenzir/detail/stable_map.hpp>
@@ -36,6 +37,7 @@ auto http_method_from_string(const std::string& str)
 enum class http_content_type : uint16_t {
   json,
   ldjson,
+  arrow_stream,
 };
 
 enum class http_status_code : uint16_t {
@@ -132,18 +134,33 @@ struct rest_response {
   static auto make_error_raw(uint16_t error_code, std::string body,
                              caf::error detail = {}) -> rest_response;
 
+  /// Create a response from a sequence of binary chunks that are written to
+  /// the client one after another without concatenating them first.
+  static auto from_chunks(std::vector<chunk_ptr> chunks,
+                          http_content_type content_type) -> rest_response;
+
+  /// Adds a custom header to the response.
+  void add_header(std::string field, std::string value);
+
   auto is_error() const -> bool;
   auto body() const -> const std::string&;
+  auto chunks() const -> const std::vector<chunk_ptr>&;
   auto code() const -> size_t;
+  auto content_type() const -> const std::optional<http_content_type>&;
+  auto headers() const
+    -> const std::vector<std::pair<std::string, std::string>>&;
   auto error_detail() const -> const caf::error&;
   auto release() && -> std::string;
+  auto release_chunks() && -> std::vector<chunk_ptr>;
 
   template <class Inspector>
   friend auto inspect(Inspector& f, rest_response& r) {
     return f.object(r)
       .pretty_name("tenzir.rest_response")
       .fields(f.field("code", r.code_), f.field("body", r.body_),
-              f.field("detail", r.detail_));
+              f.field("chunks", r.chunks_),
+              f.field("content_type", r.content_type_),
+              f.field("headers", r.headers_), f.field("detail", r.detail_));
   }
 
 private:
@@ -153,6 +170,17 @@ private:
   // The response body
   std::string body_ = "{}";
 
+  // The response body for binary responses, which takes precedence over
+  // `body_` if non-empty.
+  std::vector<chunk_ptr> chunks_ = {};
+
+  // The content type of the response, if it differs from the content type of
+  // the endpoint.
+  std::optional<http_content_type> content_type_ = {};
+
+  // Additional response headers.
+  std::vector<std::pair<std::string, std::string>> headers_ = {};
+
   // Whether this is an error response. We can't just check `code_` because
   // HTTP defines many different "success" values, and we can't just check
   // `detail_` because some call sites may not be able to provide a detailed
@@ -90,6 +90,10 @@ struct importer_state {
   /// A list of subscribers for incoming events.
   std::vector<receiver_actor<table_slice>> subscribers = {};
 
+  /// The hub evaluating live queries, spawned on first use. It is also
+  /// contained in the list of subscribers.
+  live_query_hub_actor live_query_hub = {};
+
   /// Name of this actor in log events.
   static inline const char* name = "importer";
 };
@@ -98,7 +98,12 @@ public:
   /// @param opts Runtime context for index parameterization.
   explicit arithmetic_index(tenzir::type t, caf::settings opts = {})
     : value_index{std::move(t), std::move(opts)} {
-    if constexpr (std::is_same_v<coder_type, multi_level_range_coder>) {
+    // The coders create their bitmaps up front, so we must reconstruct them
+    // with the encoding from the options.
+    auto guard = bitmap_encoding_guard{encoding()};
+    if constexpr (std::is_same_v<coder_type, singleton_coder<bitmap>>) {
+      bmi_ = bitmap_index_type{};
+    } else {
       auto i = options().find("base");
       if (i == options().end()) {
         // Some early experiments found that 8 yields the best average
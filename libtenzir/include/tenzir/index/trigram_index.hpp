@@ -0,0 +1,83 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/ewah_bitmap.hpp"
+#include "tenzir/ids.hpp"
+#include "tenzir/value_index.hpp"
+#include "tenzir/view.hpp"
+
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/settings.hpp>
+#include <tsl/robin_map.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace tenzir {
+
+/// An inverted index from the trigrams of strings to the positions of the
+/// strings that contain them. Unlike the `string_index`, lookups are not exact:
+/// the result contains all positions that *may* satisfy the predicate, which
+/// makes the index useful for producing candidate IDs for substring, equality,
+/// and regular expression queries that are then evaluated against the store.
+///
+/// The index supports the following options:
+/// - `max-size`: The maximum memory usage of the postings in bytes. When the
+///   index grows beyond that, it drops all postings and answers all lookups
+///   with all positions.
+class trigram_index : public value_index {
+public:
+  /// Constructs a trigram index.
+  /// @param t An instance of `string_type`.
+  /// @param opts Runtime context for index parameterization.
+  explicit trigram_index(tenzir::type t, caf::settings opts = {});
+
+  bool inspect_impl(supported_inspectors& inspector) override;
+
+  /// @returns Whether the index exceeded its maximum size.
+  [[nodiscard]] bool saturated() const;
+
+private:
+  bool append_impl(data_view x, id pos) override;
+
+  caf::expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  size_t memusage_impl() const override;
+
+  flatbuffers::Offset<fbs::ValueIndex>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder,
+            flatbuffers::Offset<fbs::value_index::detail::ValueIndexBase>
+              base_offset) override;
+
+  caf::error unpack_impl(const fbs::ValueIndex& from) override;
+
+  /// Computes the positions of all strings that contain every trigram of
+  /// *needle*.
+  [[nodiscard]] ids candidates(std::string_view needle) const;
+
+  /// Drops all postings once the index exceeds its maximum size.
+  void saturate();
+
+  bool serialize(auto& serializer);
+
+  bool deserialize(auto& deserializer);
+
+  size_t max_size_;
+  size_t postings_size_ = 0;
+  bool saturated_ = false;
+  tsl::robin_map<uint32_t, ewah_bitmap> postings_;
+  std::vector<uint32_t> scratch_;
+};
+
+} // namespace tenzir
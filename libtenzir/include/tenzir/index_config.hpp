@@ -27,11 +27,13 @@ struct index_config {
     std::vector<std::string> targets = {};
     double fp_rate = defaults::fp_rate;
     bool create_partition_index = defaults::create_partition_index;
+    bool create_trigram_index = defaults::create_trigram_index;
 
     template <class Inspector>
     friend auto inspect(Inspector& f, rule& x) {
       return detail::apply_all(f, x.targets, x.fp_rate,
-                               x.create_partition_index);
+                               x.create_partition_index,
+                               x.create_trigram_index);
     }
 
     static inline const record_type& schema() noexcept {
@@ -39,6 +41,7 @@ struct index_config {
         {"targets", list_type{string_type{}}},
         {"fp-rate", double_type{}},
         {"partition-index", bool_type{}},
+        {"trigram-index", bool_type{}},
       };
       return result;
     }
@@ -46,16 +49,24 @@ struct index_config {
 
   std::vector<rule> rules = {};
   double default_fp_rate = defaults::fp_rate;
+  bool split_block_bloom_filters = defaults::split_block_bloom_filters;
+  bool roaring_bitmaps = defaults::roaring_bitmaps;
+  uint64_t trigram_index_max_size = defaults::index::max_trigram_index_size;
 
   template <class Inspector>
   friend auto inspect(Inspector& f, index_config& x) {
-    return detail::apply_all(f, x.rules, x.default_fp_rate);
+    return detail::apply_all(f, x.rules, x.default_fp_rate,
+                             x.split_block_bloom_filters, x.roaring_bitmaps,
+                             x.trigram_index_max_size);
   }
 
   static inline const record_type& schema() noexcept {
     static auto result = record_type{
       {"rules", list_type{rule::schema()}},
       {"default-fp-rate", double_type{}},
+      {"split-block-bloom-filters", bool_type{}},
+      {"roaring-bitmaps", bool_type{}},
+      {"trigram-index-max-size", uint64_type{}},
     };
     return result;
   }
@@ -64,4 +75,9 @@ struct index_config {
 bool should_create_partition_index(const qualified_record_field& index_qf,
                                    const std::vector<index_config::rule>& rules);
 
+/// Determines whether a field gets a trigram index in its partition, which is
+/// the case for string fields targeted by any rule with `trigram-index: true`.
+bool should_create_trigram_index(const qualified_record_field& index_qf,
+                                 const std::vector<index_config::rule>& rules);
+
 } // namespace tenzir
@@ -28,10 +28,11 @@ synopsis_ptr make_ip_synopsis(tenzir::type type, bloom_filter_parameters params,
                               std::vector<size_t> seeds = {});
 
 /// A synopsis for IP addresses.
-template <class HashFunction>
-class ip_synopsis final : public bloom_filter_synopsis<ip, HashFunction> {
+template <class HashFunction, class BloomFilter = bloom_filter<HashFunction>>
+class ip_synopsis final
+  : public bloom_filter_synopsis<ip, HashFunction, BloomFilter> {
 public:
-  using super = bloom_filter_synopsis<ip, HashFunction>;
+  using super = bloom_filter_synopsis<ip, HashFunction, BloomFilter>;
 
   /// Constructs an IP address synopsis from an `ip_type` and a
   /// Bloom filter.
@@ -85,6 +86,16 @@ template <class HashFunction>
 synopsis_ptr make_ip_synopsis(tenzir::type type, bloom_filter_parameters params,
                               std::vector<size_t> seeds) {
   TENZIR_ASSERT(caf::holds_alternative<ip_type>(type));
+  if (params.layout == bloom_filter_layout::split_block) {
+    auto x = make_split_block_bloom_filter<HashFunction>(params);
+    if (!x) {
+      TENZIR_WARN("{} failed to construct split-block Bloom filter", __func__);
+      return nullptr;
+    }
+    using synopsis_type
+      = ip_synopsis<HashFunction, split_block_bloom_filter<HashFunction>>;
+    return std::make_unique<synopsis_type>(std::move(type), std::move(*x));
+  }
   auto x = make_bloom_filter<HashFunction>(params, std::move(seeds));
   if (!x) {
     TENZIR_WARN("{} failed to construct Bloom filter", __func__);
@@ -110,7 +121,8 @@ make_buffered_ip_synopsis(tenzir::type type, bloom_filter_parameters params) {
     return nullptr;
   }
   using synopsis_type = buffered_ip_synopsis<HashFunction>;
-  return std::make_unique<synopsis_type>(std::move(type), *params.p);
+  return std::make_unique<synopsis_type>(std::move(type), *params.p,
+                                         params.layout);
 }
 
 /// Factory to construct an IP address synopsis. This overload looks for a type
@@ -137,6 +149,8 @@ synopsis_ptr make_ip_synopsis(tenzir::type type, const caf::settings& opts) {
   bloom_filter_parameters params;
   params.n = *max_part_size;
   params.p = caf::get_or(opts, "address-synopsis-fp-rate", defaults::fp_rate);
+  if (caf::get_or(opts, "split-block-bloom-filter", false))
+    params.layout = bloom_filter_layout::split_block;
   auto annotated_type = annotate_parameters(type, params);
   // Create either a a buffered_ip_synopsis or a plain address synopsis
   // depending on the callers preference.
@@ -0,0 +1,81 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/fwd.hpp"
+
+#include "tenzir/actors.hpp"
+#include "tenzir/expression.hpp"
+#include "tenzir/multi_query_filter.hpp"
+#include "tenzir/table_slice.hpp"
+
+#include <caf/typed_response_promise.hpp>
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace tenzir {
+
+/// A live query registered with the LIVE QUERY HUB.
+struct live_query_subscriber {
+  /// The actor that registered the query; the query is removed when it
+  /// terminates.
+  caf::actor_addr client = {};
+
+  /// The original expression, for reporting.
+  expression expr = {};
+
+  /// Matching events not yet fetched by the client.
+  std::deque<table_slice> buffer = {};
+  uint64_t num_buffered = {};
+
+  /// Events delivered to and dropped for the client since the last report.
+  uint64_t num_delivered = {};
+  uint64_t num_dropped = {};
+
+  /// Whether events were dropped since the client last caught up.
+  bool dropping = false;
+
+  /// The pending request of the client for more events, if any.
+  caf::typed_response_promise<table_slice> rp = {};
+};
+
+struct live_query_hub_state {
+  static constexpr auto name = "live-query-hub";
+
+  live_query_hub_actor::pointer self = {};
+
+  /// The importer to send metrics to.
+  importer_actor importer = {};
+
+  /// The fused filter over all registered queries.
+  multi_query_filter filter = {};
+
+  /// The registered queries by id.
+  std::unordered_map<uint64_t, live_query_subscriber> subscribers = {};
+
+  /// The id of the next registered query.
+  uint64_t next_id = {};
+
+  /// Sends a `tenzir.metrics.live` event per registered query to the
+  /// importer.
+  void send_metrics();
+};
+
+/// Spawns a LIVE QUERY HUB that receives all imported events from the
+/// IMPORTER and distributes them to the registered live queries.
+/// @param self The actor handle.
+/// @param importer The importer to report metrics to.
+auto live_query_hub(live_query_hub_actor::stateful_pointer<live_query_hub_state>
+                      self,
+                    importer_actor importer)
+  -> live_query_hub_actor::behavior_type;
+
+} // namespace tenzir
@@ -0,0 +1,56 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/fwd.hpp"
+
+#include "tenzir/expression.hpp"
+#include "tenzir/table_slice.hpp"
+#include "tenzir/type.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace tenzir {
+
+/// Evaluates many expressions over the same table slices at once. Predicates
+/// that occur in multiple expressions are evaluated only once per slice, and
+/// tailoring of the expressions is cached per schema.
+class multi_query_filter {
+public:
+  /// Adds an expression under the given id.
+  void add(uint64_t id, expression expr);
+
+  /// Removes the expression with the given id.
+  void erase(uint64_t id);
+
+  /// Returns the number of registered expressions.
+  auto size() const -> size_t;
+
+  /// Returns the matching rows of *slice* for every expression that matches
+  /// at least one row, in the order the expressions were added.
+  auto apply(const table_slice& slice)
+    -> std::vector<std::pair<uint64_t, table_slice>>;
+
+private:
+  /// The expressions tailored to a single schema, with their predicates
+  /// deduplicated.
+  struct bound_queries {
+    std::vector<std::pair<uint64_t, expression>> queries = {};
+    std::vector<expression> predicates = {};
+    std::unordered_map<predicate, size_t> predicate_indices = {};
+  };
+
+  auto bind(const type& schema) -> const bound_queries&;
+
+  std::vector<std::pair<uint64_t, expression>> queries_ = {};
+  std::unordered_map<type, bound_queries> bound_ = {};
+};
+
+} // namespace tenzir
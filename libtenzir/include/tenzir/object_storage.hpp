@@ -0,0 +1,105 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/fwd.hpp"
+
+#include "tenzir/chunk.hpp"
+#include "tenzir/generator.hpp"
+#include "tenzir/location.hpp"
+
+#include <arrow/filesystem/filesystem.h>
+#include <caf/expected.hpp>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace tenzir {
+
+/// Options for reading objects from an Arrow filesystem.
+struct object_read_options {
+  /// The number of bytes to request per ranged read.
+  uint64_t range_size = uint64_t{1} << 20;
+
+  /// The number of ranged reads per object that may be in flight at once.
+  uint64_t prefetch = 8;
+
+  /// The number of objects to read from concurrently.
+  uint64_t concurrency = 4;
+
+  /// Whether to emit objects in the order in which their data arrives rather
+  /// than in the order of their paths. The data of an object is always
+  /// emitted contiguously.
+  bool unordered = false;
+
+  /// The number of times to retry a failed request.
+  uint64_t max_retries = 3;
+
+  /// The delay before the first retry, which doubles with every further retry.
+  duration initial_backoff = std::chrono::milliseconds{100};
+};
+
+/// The upper bound for `object_read_options::prefetch`.
+constexpr auto max_object_prefetch = uint64_t{64};
+
+/// The upper bound for `object_read_options::concurrency`.
+constexpr auto max_object_concurrency = uint64_t{64};
+
+/// The loader options that configure `object_read_options`.
+struct object_read_args {
+  std::optional<located<uint64_t>> prefetch = {};
+  std::optional<located<uint64_t>> concurrency = {};
+  bool unordered = false;
+
+  /// Adds `--prefetch`, `--concurrency`, and `--unordered` to `parser`.
+  void add_to(argument_parser& parser);
+
+  /// Throws a diagnostic for options that are out of bounds.
+  void validate() const;
+
+  /// Returns the options for reading ranges of `range_size` bytes.
+  auto to_options(uint64_t range_size) const -> object_read_options;
+
+  friend auto inspect(auto& f, object_read_args& x) -> bool {
+    return f.object(x)
+      .pretty_name("tenzir.object_read_args")
+      .fields(f.field("prefetch", x.prefetch),
+              f.field("concurrency", x.concurrency),
+              f.field("unordered", x.unordered));
+  }
+};
+
+/// Resolves a path to the files it refers to. A `*` in the path matches any
+/// characters except `/`, and a `**` matches any characters including `/`. A
+/// `**/` also matches no directory at all. All other characters match
+/// themselves. A path without wildcards that refers to a directory or ends in
+/// `/` refers to all files below it.
+/// @param fs The filesystem to resolve the path in.
+/// @param path The path, possibly with wildcards.
+/// @returns The matching files, sorted by their path, or an error if no file
+/// matches.
+auto expand_object_paths(arrow::fs::FileSystem& fs, std::string path)
+  -> caf::expected<std::vector<arrow::fs::FileInfo>>;
+
+/// Reads files with concurrent ranged reads. Yields the data of every file
+/// contiguously, split into chunks of at most `options.range_size` bytes.
+/// Yields an empty chunk while waiting for data, so that the caller does not
+/// block. Stops after yielding the first error.
+/// @param fs The filesystem to read from.
+/// @param files The files to read, e.g., from `expand_object_paths`.
+/// @param options The options for reading.
+auto read_objects(std::shared_ptr<arrow::fs::FileSystem> fs,
+                  std::vector<arrow::fs::FileInfo> files,
+                  object_read_options options)
+  -> generator<caf::expected<chunk_ptr>>;
+
+} // namespace tenzir
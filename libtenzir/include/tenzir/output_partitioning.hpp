@@ -0,0 +1,101 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/fwd.hpp"
+
+#include "tenzir/detail/inspection_common.hpp"
+#include "tenzir/table_slice.hpp"
+#include "tenzir/time.hpp"
+
+#include <caf/expected.hpp>
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace tenzir {
+
+/// The granularity at which a partition key splits its values.
+enum class partition_granularity {
+  /// One partition per distinct value.
+  value,
+  /// One partition per calendar year, month, day, or hour of a time value.
+  year,
+  month,
+  day,
+  hour,
+};
+
+template <class Inspector>
+auto inspect(Inspector& f, partition_granularity& x) {
+  return detail::inspect_enum(f, x);
+}
+
+/// A field whose values determine the partition of an event.
+struct partition_key {
+  std::string field = {};
+  partition_granularity granularity = partition_granularity::value;
+
+  friend auto inspect(auto& f, partition_key& x) -> bool {
+    return f.object(x)
+      .pretty_name("tenzir.partition_key")
+      .fields(f.field("field", x.field),
+              f.field("granularity", x.granularity));
+  }
+};
+
+/// Parses a partition key of the form `<field>[:year|month|day|hour]`.
+auto parse_partition_key(std::string_view str) -> caf::expected<partition_key>;
+
+/// Describes how a saver wants its input split across files. Limits of zero
+/// are unbounded.
+struct output_partitioning {
+  /// The keys to partition by, in the order of the path components.
+  std::vector<partition_key> keys = {};
+
+  /// The number of rows after which to start a new file.
+  uint64_t max_rows = 0;
+
+  /// The number of bytes after which to start a new file.
+  uint64_t max_bytes = 0;
+
+  /// The time after which to start a new file.
+  std::optional<duration> max_age = {};
+
+  /// The number of files that may be open at once. When exceeded, the least
+  /// recently written file gets closed.
+  uint64_t max_open_files = 64;
+
+  friend auto inspect(auto& f, output_partitioning& x) -> bool {
+    return f.object(x)
+      .pretty_name("tenzir.output_partitioning")
+      .fields(f.field("keys", x.keys), f.field("max_rows", x.max_rows),
+              f.field("max_bytes", x.max_bytes),
+              f.field("max_age", x.max_age),
+              f.field("max_open_files", x.max_open_files));
+  }
+};
+
+/// Splits a table slice by partition. A partition is named by a Hive-style
+/// relative path, e.g., `year=2023/month=10/proto=tcp`, that contains one
+/// `key=value` component per partition key. Values are percent-encoded, and
+/// missing or null values map to `__HIVE_DEFAULT_PARTITION__`.
+/// @param slice The events to split.
+/// @param keys The keys to partition by.
+/// @returns The partitions in the order of their first occurrence, each with
+/// its events in their original order.
+auto split_by_partition(const table_slice& slice,
+                        std::span<const partition_key> keys)
+  -> std::vector<std::pair<std::string, table_slice>>;
+
+} // namespace tenzir
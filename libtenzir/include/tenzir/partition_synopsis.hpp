@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "tenzir/chunk.hpp"
 #include "tenzir/detail/friend_attribute.hpp"
 #include "tenzir/fbs/partition_synopsis.hpp"
 #include "tenzir/index_config.hpp"
@@ -17,6 +18,8 @@
 #include "tenzir/table_slice.hpp"
 #include "tenzir/uuid.hpp"
 
+#include <filesystem>
+
 namespace caf {
 
 // Forward declaration to be able to befriend the unshare implementation.
@@ -52,6 +55,25 @@ struct partition_synopsis final : public caf::ref_counted {
   ///          synopsis.
   size_t memusage() const;
 
+  /// Checks whether the field and type synopses are yet to be unpacked from
+  /// the file that this partition synopsis was lazily unpacked from.
+  [[nodiscard]] bool is_lazy() const;
+
+  /// Unpacks the field and type synopses of a lazily unpacked partition
+  /// synopsis from its file. The file is only mapped for the duration of the
+  /// call. Does nothing if the synopses are already available.
+  [[nodiscard]] caf::error load_synopses();
+
+  /// Checks whether the field and type synopses were unpacked from a file and
+  /// can be unloaded again.
+  [[nodiscard]] bool has_unloadable_synopses() const;
+
+  /// Drops the field and type synopses of a lazily unpacked partition
+  /// synopsis, such that the next call to `load_synopses` unpacks them from
+  /// its file again. Does nothing for partition synopses that were not
+  /// unpacked lazily.
+  void unload_synopses();
+
   // Information about the raw data storage.
   resource store_file = {};
 
@@ -93,6 +115,16 @@ struct partition_synopsis final : public caf::ref_counted {
   unpack(const fbs::partition_synopsis::LegacyPartitionSynopsis&,
          partition_synopsis&);
 
+  /// Unpacks only the metadata of a partition synopsis, i.e., everything but
+  /// the field and type synopses. These remain on disk until they are needed,
+  /// which keeps neither a deserialized copy nor a memory mapping per
+  /// partition around.
+  /// @param path The file containing a `tenzir.fbs.PartitionSynopsis`.
+  /// @param ps The partition synopsis to unpack into.
+  /// @relates load_synopses unload_synopses
+  FRIEND_ATTRIBUTE_NODISCARD friend caf::error
+  unpack_lazily(const std::filesystem::path& path, partition_synopsis& ps);
+
 private:
   // Returns a raw pointer to a deep copy of this partition synopsis.
   // For use by the `caf::intrusive_cow_ptr`.
@@ -100,6 +132,14 @@ private:
     partition_synopsis>(partition_synopsis*& ptr);
   partition_synopsis* copy() const;
 
+  // The file to unpack the field and type synopses from, or an empty path if
+  // the synopses were not unpacked lazily.
+  std::filesystem::path synopses_path_ = {};
+
+  // Whether the field and type synopses are yet to be unpacked from
+  // `synopses_path_`.
+  bool lazy_ = false;
+
   // Cached memory usage.
   mutable std::atomic<size_t> memusage_ = 0ull;
 };
@@ -14,7 +14,9 @@
 
 #include <caf/expected.hpp>
 
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace tenzir {
 
@@ -60,6 +62,15 @@ public:
 
   [[nodiscard]] const pattern_options& options() const;
 
+  /// Returns the string the pattern matches if the pattern consists of
+  /// literal characters only, i.e., if matching is plain string comparison.
+  [[nodiscard]] const std::optional<std::string>& literal() const;
+
+  /// Returns a string that every string the pattern matches or finds must
+  /// contain, which may be empty. Checking for this string is a lot cheaper
+  /// than running the regular expression engine.
+  [[nodiscard]] std::string_view required_literal() const;
+
   // -- concepts // ------------------------------------------------------------
 
   friend bool operator==(const pattern& lhs, const pattern& rhs) noexcept;
@@ -85,6 +96,20 @@ private:
   std::string str_ = {};
   pattern_options options_ = {};
   std::shared_ptr<regex_impl> regex_ = {};
+  std::optional<std::string> literal_ = {};
+  std::string required_literal_ = {};
 };
 
+namespace detail {
+
+/// Returns the string that the regular expression *regex* matches if it
+/// contains no metacharacters, and `std::nullopt` otherwise.
+auto regex_literal(std::string_view regex) -> std::optional<std::string>;
+
+/// Returns the longest string that every match of the regular expression
+/// *regex* must contain, or the empty string if we cannot determine one.
+auto regex_required_literal(std::string_view regex) -> std::string;
+
+} // namespace detail
+
 } // namespace tenzir
@@ -160,6 +160,25 @@ auto inspect(auto& f, event_order& x) -> bool {
 
 struct optimize_result;
 
+/// A bound on the number of events of an operator's output that are observable
+/// downstream. See `operator_base::push_down_limit` for a description of this.
+struct event_limit {
+  /// The number of events that suffice downstream.
+  uint64_t count = {};
+
+  /// Whether the last rather than the first `count` events are observed.
+  bool latest = false;
+
+  friend auto operator==(const event_limit&, const event_limit&) -> bool
+    = default;
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, event_limit& x) -> bool {
+    return f.object(x).pretty_name("event_limit").fields(
+      f.field("count", x.count), f.field("latest", x.latest));
+  }
+};
+
 struct operator_measurement {
   std::string unit = std::string{operator_type_name<void>()};
   uint64_t num_elements = {};
@@ -321,6 +340,24 @@ public:
     -> optimize_result
     = 0;
 
+  /// Informs the operator that only `limit` events of its output are
+  /// observable downstream, and returns the limit that applies to its input
+  /// in turn.
+  ///
+  /// This is called by `pipeline::optimize` on the replacement returned from
+  /// `optimize`, where `limit` refers to the output after applying the filter
+  /// that was passed to `optimize`. Sources may use the limit to stop producing
+  /// events early, e.g., by not loading further partitions. Operators must
+  /// still produce correct results if they ignore the limit, i.e., the operator
+  /// that introduced the limit continues to enforce it.
+  ///
+  /// The default implementation acts as a barrier for limits.
+  virtual auto push_down_limit(std::optional<event_limit> limit)
+    -> std::optional<event_limit> {
+    (void)limit;
+    return std::nullopt;
+  }
+
   /// Returns the location of the operator.
   virtual auto location() const -> operator_location {
     return operator_location::anywhere;
@@ -21,6 +21,7 @@
 #include "tenzir/expression.hpp"
 #include "tenzir/http_api.hpp"
 #include "tenzir/operator_control_plane.hpp"
+#include "tenzir/output_partitioning.hpp"
 #include "tenzir/pipeline.hpp"
 #include "tenzir/series.hpp"
 #include "tenzir/type.hpp"
@@ -517,6 +518,12 @@ class printer_plugin : public virtual printer_inspection_plugin<Printer>,
 struct printer_info {
   type input_schema{};
   std::string format{};
+  /// The partition that the output belongs to, e.g., `year=2023/month=10`,
+  /// or empty if the saver does not partition its input.
+  std::string partition{};
+  /// The number of files that came before this one for the same schema and
+  /// partition. Only non-zero for savers that partition their input.
+  uint64_t sequence_number{};
 };
 
 class plugin_saver {
@@ -534,6 +541,13 @@ public:
   /// so, `instantiate()` will only be called once.
   virtual auto is_joining() const -> bool = 0;
 
+  /// Returns how the saver wants its input split across files, if at all. If
+  /// so, `instantiate()` will be called once per file, and the saver must not
+  /// be joining.
+  virtual auto partitioning() const -> std::optional<output_partitioning> {
+    return std::nullopt;
+  }
+
   virtual auto default_printer() const -> std::string {
     return "json";
   }
@@ -117,7 +117,8 @@ struct query_context {
       .pretty_name("tenzir.query")
       .fields(f.field("id", q.id), f.field("cmd", q.cmd),
               f.field("expr", q.expr), f.field("ids", q.ids),
-              f.field("priority", q.priority), f.field("issuer", q.issuer));
+              f.field("priority", q.priority), f.field("issuer", q.issuer),
+              f.field("limit", q.limit), f.field("latest", q.latest));
   }
 
   std::size_t memusage() const {
@@ -151,6 +152,16 @@ struct query_context {
 
   /// The issuer of the query.
   std::string issuer = {};
+
+  /// The number of results after which the client loses interest, if set. The
+  /// index stops scheduling partitions for the query once the partitions that
+  /// completed delivered at least this many results.
+  std::optional<uint64_t> limit = std::nullopt;
+
+  /// Whether the client is interested in the most recent results. The index
+  /// schedules the most recently imported candidate partitions first for such
+  /// queries.
+  bool latest = false;
 };
 
 } // namespace tenzir
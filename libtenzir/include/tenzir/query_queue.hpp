@@ -41,6 +41,9 @@ struct query_state {
   /// The number of partitions that are processed already.
   uint32_t completed_partitions = 0;
 
+  /// The number of results that the completed partitions delivered.
+  uint64_t num_results = 0;
+
   template <class Inspector>
   friend auto inspect(Inspector& f, query_state& x) {
     return f.object(x)
@@ -50,7 +53,8 @@ struct query_state {
               f.field("candidate-partitions", x.candidate_partitions),
               f.field("requested-partitions", x.requested_partitions),
               f.field("scheduled-partitions", x.scheduled_partitions),
-              f.field("completed-partitions", x.completed_partitions));
+              f.field("completed-partitions", x.completed_partitions),
+              f.field("num-results", x.num_results));
   }
 
   std::size_t memusage() const {
@@ -84,6 +88,11 @@ public:
     std::vector<uuid> queries;
     bool erased = false;
 
+    /// The import time of the partition if any of its queries asks for the
+    /// latest results; among partitions with the same priority, those with a
+    /// higher recency are scheduled first.
+    time recency = {};
+
     friend bool operator<(const entry& lhs, const entry& rhs) noexcept;
     friend bool operator==(const entry& lhs, const uuid& rhs) noexcept;
 
@@ -136,6 +145,12 @@ public:
   [[nodiscard]] std::optional<receiver_actor<atom::done>>
   handle_completion(const uuid& qid);
 
+  /// Accounts for the results that a partition delivered for a query. Removes
+  /// the query and returns its client handle in case the query has a limit
+  /// that is now reached.
+  [[nodiscard]] std::optional<receiver_actor<atom::done>>
+  handle_results(const uuid& qid, uint64_t num_results);
+
   std::size_t memusage() const;
 
 private:
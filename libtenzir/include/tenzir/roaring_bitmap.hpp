@@ -0,0 +1,205 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/bitmap_base.hpp"
+#include "tenzir/detail/inspection_common.hpp"
+#include "tenzir/detail/operators.hpp"
+
+#include <caf/error.hpp>
+#include <flatbuffers/flatbuffers.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace tenzir {
+
+class roaring_bitmap_range;
+
+namespace detail {
+
+/// A container of a Roaring bitmap that holds the 1-bits of a chunk of 2^16
+/// consecutive bits.
+struct roaring_container : equality_comparable<roaring_container> {
+  /// The number of bits in a chunk.
+  static constexpr uint64_t chunk_bits = uint64_t{1} << 16;
+
+  /// The number of words of a bitset container.
+  static constexpr size_t bitset_words = chunk_bits / 64;
+
+  /// The maximum cardinality of an array container.
+  static constexpr size_t max_array_size = 4096;
+
+  /// The representation of the container.
+  enum class kind : uint8_t {
+    /// `values` holds the sorted positions of all 1-bits.
+    array,
+    /// `words` holds all bits of the chunk.
+    bitset,
+    /// `values` holds sorted runs of 1-bits as pairs of start and length
+    /// minus one.
+    run,
+  };
+
+  /// The index of the chunk, i.e., the position of the first bit in the chunk
+  /// divided by 2^16.
+  uint64_t key = 0;
+
+  kind type = kind::array;
+
+  /// The number of 1-bits in the container.
+  uint32_t cardinality = 0;
+
+  std::vector<uint16_t> values = {};
+
+  std::vector<uint64_t> words = {};
+
+  friend bool
+  operator==(const roaring_container& x, const roaring_container& y);
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, roaring_container& x) {
+    return f.apply(x.key) && inspect_enum(f, x.type)
+           && apply_all(f, x.cardinality, x.values, x.words);
+  }
+};
+
+} // namespace detail
+
+/// A bitmap that partitions the bits into chunks of 2^16 bits and stores the
+/// 1-bits of each non-empty chunk in a container, following the design of
+/// *Roaring* bitmaps by Chambi et al. A container is either a sorted array of
+/// positions for sparse chunks, an uncompressed bitset for dense chunks, or a
+/// sequence of runs for chunks with long stretches of 1-bits.
+///
+/// Unlike run-length word codings like EWAH, a Roaring bitmap supports random
+/// access in logarithmic time and computes bitwise operations by combining
+/// only the containers of matching chunks.
+class roaring_bitmap : public bitmap_base<roaring_bitmap>,
+                       detail::equality_comparable<roaring_bitmap> {
+  friend roaring_bitmap_range;
+
+public:
+  using container = detail::roaring_container;
+  using container_vector = std::vector<container>;
+
+  roaring_bitmap() = default;
+
+  explicit roaring_bitmap(size_type n, bool bit = false);
+
+  // -- inspectors -----------------------------------------------------------
+
+  [[nodiscard]] bool empty() const;
+
+  [[nodiscard]] size_type size() const;
+
+  [[nodiscard]] size_t memusage() const;
+
+  [[nodiscard]] const container_vector& containers() const;
+
+  /// Computes the number of 1-bits in the bitmap.
+  [[nodiscard]] size_type cardinality() const;
+
+  // -- element access --------------------------------------------------------
+
+  /// Accesses the *i*-th bit of the bitmap.
+  /// @param i The index into the bitmap.
+  /// @returns `true` iff bit *i* is 1.
+  /// @pre `i < size()`
+  bool operator[](size_type i) const;
+
+  // -- modifiers ------------------------------------------------------------
+
+  void append_bit(bool bit);
+
+  void append_bits(bool bit, size_type n);
+
+  void append_block(block_type bits, size_type n = word_type::width);
+
+  void flip();
+
+  // -- concepts -------------------------------------------------------------
+
+  friend bool operator==(const roaring_bitmap& x, const roaring_bitmap& y);
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, roaring_bitmap& bm) {
+    return detail::apply_all(f, bm.containers_, bm.num_bits_);
+  }
+
+  friend roaring_bitmap_range bit_range(const roaring_bitmap& bm);
+
+  friend auto
+  pack(flatbuffers::FlatBufferBuilder& builder, const roaring_bitmap& from)
+    -> flatbuffers::Offset<fbs::bitmap::RoaringBitmap>;
+
+  friend auto unpack(const fbs::bitmap::RoaringBitmap& from, roaring_bitmap& to)
+    -> caf::error;
+
+  // -- bitwise operations ----------------------------------------------------
+  //
+  // These overloads take precedence over the generic algorithms in
+  // bitmap_algorithms.hpp and operate on pairs of containers.
+
+  friend roaring_bitmap
+  binary_and(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+  friend roaring_bitmap
+  binary_or(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+  friend roaring_bitmap
+  binary_xor(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+  friend roaring_bitmap
+  binary_nand(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+private:
+  /// Sets the bits *[first, last)* to 1.
+  /// @pre `first >= num_bits_`
+  void add_range(size_type first, size_type last);
+
+  /// Sorted by key, and no container is empty.
+  container_vector containers_;
+  size_type num_bits_ = 0;
+};
+
+/// Computes the *rank* of a Roaring bitmap from the cardinalities of its
+/// containers.
+/// @relates roaring_bitmap
+template <bool Bit = true>
+roaring_bitmap::size_type rank(const roaring_bitmap& bm) {
+  return Bit ? bm.cardinality() : bm.size() - bm.cardinality();
+}
+
+class roaring_bitmap_range
+  : public bit_range_base<roaring_bitmap_range, roaring_bitmap::block_type> {
+public:
+  using word_type = roaring_bitmap::word_type;
+
+  roaring_bitmap_range() = default;
+
+  explicit roaring_bitmap_range(const roaring_bitmap& bm);
+
+  void next();
+  [[nodiscard]] bool done() const;
+
+private:
+  void scan();
+
+  const roaring_bitmap* bm_ = nullptr;
+  /// The next container to process.
+  size_t next_ = 0;
+  /// The position of the next bit to produce.
+  roaring_bitmap::size_type position_ = 0;
+  /// The bits of the container that `position_` points into, if any.
+  std::vector<uint64_t> words_ = {};
+  bool done_ = true;
+};
+
+} // namespace tenzir
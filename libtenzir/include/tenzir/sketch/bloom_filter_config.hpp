@@ -64,4 +64,13 @@ struct bloom_filter_params {
 /// @returns The complete set of parameters
 std::optional<bloom_filter_params> evaluate(bloom_filter_config cfg);
 
+/// Evaluates a set of Bloom filter parameters for a split-block Bloom filter.
+/// Split-block Bloom filters always use 8 hash functions and a multiple of 256
+/// bits, so *k* must be either unset or 8, and *m* gets rounded up to the next
+/// multiple of 256. The false-positive probability takes into account that
+/// all bits of an element are in the same block.
+/// @returns The complete set of parameters
+std::optional<bloom_filter_params>
+evaluate_split_block(bloom_filter_config cfg);
+
 } // namespace tenzir::sketch
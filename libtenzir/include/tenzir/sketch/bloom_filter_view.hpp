@@ -10,6 +10,7 @@
 
 #include "tenzir/detail/assert.hpp"
 #include "tenzir/detail/worm.hpp"
+#include "tenzir/error.hpp"
 #include "tenzir/fbs/bloom_filter.hpp"
 #include "tenzir/sketch/bloom_filter_config.hpp"
 
@@ -90,6 +91,9 @@ struct bloom_filter_view {
 
   friend caf::error
   unpack(const fbs::BloomFilter& table, bloom_filter_view& x) noexcept {
+    if (table.layout() != fbs::BloomFilterLayout::classic)
+      return caf::make_error(ec::format_error,
+                             "expected Bloom filter with classic layout");
     x.params_.m = table.parameters()->m();
     x.params_.n = table.parameters()->n();
     x.params_.k = table.parameters()->k();
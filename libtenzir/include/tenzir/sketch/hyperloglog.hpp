@@ -0,0 +1,74 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// This HyperLogLog sketch follows the HyperLogLog++ improvements by Heule et
+// al.: it operates on 64-bit hash digests, so no large-range correction is
+// necessary, and it falls back to linear counting below empirically determined
+// thresholds where the raw estimate is heavily biased.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tenzir::sketch {
+
+/// A fixed-size sketch for estimating the number of distinct elements.
+class hyperloglog {
+public:
+  /// The smallest and largest supported precision.
+  static constexpr uint8_t min_precision = 4;
+  static constexpr uint8_t max_precision = 18;
+
+  /// The default precision, which yields a standard error of about 0.8%
+  /// using 16 KiB of memory.
+  static constexpr uint8_t default_precision = 14;
+
+  /// Constructs an empty sketch.
+  /// @param precision The number of hash bits used to select a register.
+  /// @pre `min_precision <= precision && precision <= max_precision`
+  explicit hyperloglog(uint8_t precision = default_precision);
+
+  /// Adds a hash digest to the sketch.
+  /// @param digest The digest to add.
+  void add(uint64_t digest) noexcept;
+
+  /// Merges another sketch into this one. The result is identical to a sketch
+  /// that saw the elements of both sketches.
+  /// @pre `precision() == other.precision()`
+  void merge(const hyperloglog& other) noexcept;
+
+  /// Estimates the number of distinct digests added.
+  auto estimate() const noexcept -> double;
+
+  /// Returns the precision of the sketch.
+  auto precision() const noexcept -> uint8_t;
+
+  // -- concepts --------------------------------------------------------------
+
+  friend auto mem_usage(const hyperloglog& x) noexcept -> size_t;
+
+  friend auto operator==(const hyperloglog&, const hyperloglog&) noexcept
+    -> bool
+    = default;
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, hyperloglog& x) {
+    return f.object(x)
+      .pretty_name("tenzir.sketch.hyperloglog")
+      .fields(f.field("precision", x.precision_),
+              f.field("registers", x.registers_));
+  }
+
+private:
+  uint8_t precision_ = default_precision;
+  std::vector<uint8_t> registers_ = {};
+};
+
+} // namespace tenzir::sketch
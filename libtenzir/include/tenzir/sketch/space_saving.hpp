@@ -0,0 +1,198 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// The Space-Saving algorithm by Metwally et al. tracks the most frequent
+// elements of a stream with a fixed number of counters. When an untracked
+// element arrives and all counters are in use, it replaces the element with
+// the smallest count and inherits that count as its overestimation error.
+// Merging follows the mergeable summaries by Agarwal et al.
+//
+#pragma once
+
+#include "tenzir/error.hpp"
+
+#include <tsl/robin_map.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace tenzir::sketch {
+
+/// A fixed-size sketch for finding the most frequent elements of a stream.
+/// @tparam T The element type.
+/// @tparam Hash The hash function, which may be transparent.
+/// @tparam Equal The equality comparison, which may be transparent.
+template <class T, class Hash = std::hash<T>, class Equal = std::equal_to<T>>
+class space_saving {
+public:
+  /// A tracked element.
+  struct counter {
+    T value;
+
+    /// An upper bound on the true frequency of *value*.
+    uint64_t count;
+
+    /// The maximum overestimation of *count*.
+    uint64_t error;
+  };
+
+  /// The default number of counters.
+  static constexpr size_t default_capacity = 1'024;
+
+  /// Constructs an empty sketch.
+  /// @param capacity The number of elements to track.
+  /// @pre `capacity > 0`
+  explicit space_saving(size_t capacity = default_capacity)
+    : capacity_{capacity} {
+    TENZIR_ASSERT(capacity_ > 0);
+  }
+
+  /// Adds an occurrence of an element.
+  /// @param value The element, which must be comparable to `T` with `Equal`.
+  /// @param make A function that materializes *value* into a `T` when the
+  /// element is not yet tracked.
+  template <class Key, class Make>
+  void add(const Key& value, Make&& make, uint64_t count = 1) {
+    if (auto it = positions_.find(value); it != positions_.end()) {
+      const auto position = it->second;
+      heap_[position].count += count;
+      sift_down(position);
+      return;
+    }
+    if (heap_.size() < capacity_) {
+      heap_.push_back({std::invoke(std::forward<Make>(make), value), count, 0});
+      positions_.emplace(heap_.back().value, heap_.size() - 1);
+      sift_up(heap_.size() - 1);
+      return;
+    }
+    // Replace the element with the smallest count.
+    auto& min = heap_.front();
+    positions_.erase(min.value);
+    min.value = std::invoke(std::forward<Make>(make), value);
+    min.error = min.count;
+    min.count += count;
+    positions_.emplace(min.value, 0);
+    sift_down(0);
+  }
+
+  /// Adds an occurrence of an element.
+  void add(const T& value, uint64_t count = 1) {
+    add(
+      value,
+      [](const T& x) {
+        return x;
+      },
+      count);
+  }
+
+  /// Merges another sketch into this one.
+  void merge(const space_saving& other) {
+    // Elements that are untracked in a full sketch may have occurred up to
+    // its minimum count times.
+    const auto min_count = [](const space_saving& x) -> uint64_t {
+      return x.heap_.size() < x.capacity_ ? 0 : x.heap_.front().count;
+    };
+    const auto this_min = min_count(*this);
+    const auto other_min = min_count(other);
+    auto merged = std::vector<counter>{};
+    merged.reserve(heap_.size() + other.heap_.size());
+    for (auto& entry : heap_) {
+      if (auto it = other.positions_.find(entry.value);
+          it != other.positions_.end()) {
+        const auto& match = other.heap_[it->second];
+        entry.count += match.count;
+        entry.error += match.error;
+      } else {
+        entry.count += other_min;
+        entry.error += other_min;
+      }
+      merged.push_back(std::move(entry));
+    }
+    for (const auto& entry : other.heap_) {
+      if (not positions_.contains(entry.value)) {
+        merged.push_back(
+          {entry.value, entry.count + this_min, entry.error + this_min});
+      }
+    }
+    if (merged.size() > capacity_) {
+      std::nth_element(merged.begin(), merged.begin() + capacity_,
+                       merged.end(), [](const auto& lhs, const auto& rhs) {
+                         return lhs.count > rhs.count;
+                       });
+      merged.resize(capacity_);
+    }
+    heap_ = std::move(merged);
+    positions_.clear();
+    std::make_heap(heap_.begin(), heap_.end(), greater);
+    for (size_t i = 0; i < heap_.size(); ++i)
+      positions_.emplace(heap_[i].value, i);
+  }
+
+  /// Returns the tracked elements ordered by descending count.
+  auto top() const -> std::vector<counter> {
+    auto result = heap_;
+    std::sort(result.begin(), result.end(),
+              [](const auto& lhs, const auto& rhs) {
+                return lhs.count > rhs.count;
+              });
+    return result;
+  }
+
+  /// Returns the number of counters.
+  auto capacity() const noexcept -> size_t {
+    return capacity_;
+  }
+
+private:
+  // The heap is a binary min-heap over the counts, with `positions_` mapping
+  // every element to its index in the heap.
+  static constexpr auto greater = [](const counter& lhs, const counter& rhs) {
+    return lhs.count > rhs.count;
+  };
+
+  void swap_entries(size_t lhs, size_t rhs) {
+    std::swap(heap_[lhs], heap_[rhs]);
+    positions_[heap_[lhs].value] = lhs;
+    positions_[heap_[rhs].value] = rhs;
+  }
+
+  void sift_up(size_t position) {
+    while (position > 0) {
+      const auto parent = (position - 1) / 2;
+      if (heap_[parent].count <= heap_[position].count)
+        return;
+      swap_entries(parent, position);
+      position = parent;
+    }
+  }
+
+  void sift_down(size_t position) {
+    while (true) {
+      const auto left = 2 * position + 1;
+      const auto right = left + 1;
+      auto smallest = position;
+      if (left < heap_.size() and heap_[left].count < heap_[smallest].count)
+        smallest = left;
+      if (right < heap_.size() and heap_[right].count < heap_[smallest].count)
+        smallest = right;
+      if (smallest == position)
+        return;
+      swap_entries(smallest, position);
+      position = smallest;
+    }
+  }
+
+  size_t capacity_ = default_capacity;
+  std::vector<counter> heap_ = {};
+  tsl::robin_map<T, size_t, Hash, Equal> positions_ = {};
+};
+
+} // namespace tenzir::sketch
@@ -0,0 +1,125 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// This Bloom filter takes as input an existing hash digest and sets all bits
+// for it in a single block of 256 bits, i.e., within a single cache line. The
+// layout matches the split-block Bloom filter from the Parquet specification.
+//
+#pragma once
+
+#include "tenzir/chunk.hpp"
+#include "tenzir/sketch/bloom_filter_config.hpp"
+#include "tenzir/sketch/split_block_bloom_filter_view.hpp"
+
+#include <caf/expected.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tenzir::sketch {
+
+class split_block_bloom_filter;
+
+/// An immutable split-block Bloom filter wrapped in a contiguous chunk of
+/// memory.
+class frozen_split_block_bloom_filter {
+public:
+  /// Constructs a frozen split-block Bloom filter from a chunk that may come
+  /// from an untrusted source.
+  /// @param table The chunk containing the Bloom filter flatbuffer.
+  /// @returns The frozen Bloom filter iff *table* contains a valid Bloom
+  /// filter with the split-block layout.
+  static caf::expected<frozen_split_block_bloom_filter> make(chunk_ptr table);
+
+  /// Test whether a hash digest is in the Bloom filter.
+  /// @param digest The digest to test.
+  /// @returns `false` if the *digest* is not in the set and `true` if *digest*
+  /// may exist according to the false-positive probability of the filter.
+  bool lookup(uint64_t digest) const noexcept;
+
+  /// Retrieves the parameters of the filter.
+  const bloom_filter_params& parameters() const noexcept;
+
+  /// Retrieves the number of distinct digests in the filter.
+  uint64_t num_elements() const noexcept;
+
+  /// Retrieves the underlying flatbuffer.
+  const chunk_ptr& table() const noexcept;
+
+  // -- concepts --------------------------------------------------------------
+
+  friend size_t mem_usage(const frozen_split_block_bloom_filter& x) noexcept;
+
+  friend split_block_bloom_filter
+  thaw(const frozen_split_block_bloom_filter& x);
+
+private:
+  friend caf::expected<frozen_split_block_bloom_filter>
+  freeze(const split_block_bloom_filter& x);
+
+  /// Constructs a frozen Bloom filter from a flatbuffer.
+  /// @pre *table* must be a valid split-block Bloom filter flatbuffer.
+  explicit frozen_split_block_bloom_filter(chunk_ptr table) noexcept;
+
+  immutable_split_block_bloom_filter_view view_;
+  chunk_ptr table_;
+};
+
+/// A mutable split-block Bloom filter.
+class split_block_bloom_filter {
+public:
+  /// Constructs a split-block Bloom filter from a set of evaluated parameters.
+  /// @param *cfg* The desired Bloom filter configuration.
+  /// @returns The Bloom filter for *cfg* iff the parameterization is valid.
+  static caf::expected<split_block_bloom_filter> make(bloom_filter_config cfg);
+
+  split_block_bloom_filter(const split_block_bloom_filter& other);
+  split_block_bloom_filter& operator=(const split_block_bloom_filter& other);
+  split_block_bloom_filter(split_block_bloom_filter&& other) noexcept = default;
+  split_block_bloom_filter& operator=(split_block_bloom_filter&& other) noexcept
+    = default;
+  ~split_block_bloom_filter() noexcept = default;
+
+  /// Adds a hash digest to the Bloom filter.
+  /// @param digest The digest to add.
+  /// @returns `true` iff the digest did not exist in the filter before.
+  bool add(uint64_t digest) noexcept;
+
+  /// Test whether a hash digest is in the Bloom filter.
+  /// @param digest The digest to test.
+  /// @returns `false` if the *digest* is not in the set and `true` if *digest*
+  /// may exist according to the false-positive probability of the filter.
+  bool lookup(uint64_t digest) const noexcept;
+
+  /// Retrieves the parameters of the filter.
+  const bloom_filter_params& parameters() const noexcept;
+
+  /// Retrieves the number of distinct digests in the filter. This may
+  /// undercount due to false positives when adding.
+  uint64_t num_elements() const noexcept;
+
+  // -- concepts --------------------------------------------------------------
+
+  friend size_t mem_usage(const split_block_bloom_filter& x);
+
+  friend caf::expected<frozen_split_block_bloom_filter>
+  freeze(const split_block_bloom_filter& x);
+
+  friend split_block_bloom_filter
+  thaw(const frozen_split_block_bloom_filter& x);
+
+private:
+  split_block_bloom_filter(bloom_filter_params params,
+                           std::vector<uint64_t> bits, uint64_t num_elements);
+
+  mutable_split_block_bloom_filter_view view_;
+  std::vector<uint64_t> bits_;
+};
+
+} // namespace tenzir::sketch
@@ -0,0 +1,224 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/detail/assert.hpp"
+#include "tenzir/detail/worm.hpp"
+#include "tenzir/error.hpp"
+#include "tenzir/fbs/bloom_filter.hpp"
+#include "tenzir/sketch/bloom_filter_config.hpp"
+
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <flatbuffers/flatbuffers.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#endif
+
+namespace tenzir::sketch {
+
+namespace detail {
+
+/// The number of bits in a block of a split-block Bloom filter.
+inline constexpr uint64_t split_block_bits = 256;
+
+/// The number of 64-bit words in a block of a split-block Bloom filter.
+inline constexpr size_t split_block_words = split_block_bits / 64;
+
+/// The number of bits that a split-block Bloom filter sets per element.
+inline constexpr uint64_t split_block_k = 8;
+
+/// The odd constants that derive one bit position per 32-bit word of a block
+/// from a single key, as specified for split-block Bloom filters in Parquet.
+inline constexpr auto split_block_salts = std::array<uint32_t, split_block_k>{
+  0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+  0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+/// Computes the bits to set within a block. The i-th 32-bit word of the block
+/// is the lower half of the (i/2)-th 64-bit word for even i, and the upper half
+/// otherwise, which matches the memory order on little-endian machines.
+inline auto split_block_mask(uint32_t key) noexcept
+  -> std::array<uint64_t, split_block_words> {
+  auto result = std::array<uint64_t, split_block_words>{};
+  for (size_t i = 0; i < split_block_salts.size(); ++i) {
+    const auto bit = (key * split_block_salts[i]) >> 27;
+    result[i / 2] |= uint64_t{1} << (bit + 32 * (i % 2));
+  }
+  return result;
+}
+
+/// Locates the block for a digest. The upper bits of the digest select the
+/// block, and its lower 32 bits are the key for the bits within the block.
+template <class Word>
+auto split_block_of(std::span<Word> bits, uint64_t digest) noexcept -> Word* {
+  const auto num_blocks = bits.size() / split_block_words;
+  return bits.data()
+         + tenzir::detail::fastrange64(num_blocks, digest) * split_block_words;
+}
+
+/// Sets the bits for a digest.
+/// @returns `true` iff at least one of the bits was not set before.
+inline auto split_block_add(std::span<uint64_t> bits, uint64_t digest) noexcept
+  -> bool {
+  auto* block = split_block_of(bits, digest);
+  const auto mask = split_block_mask(static_cast<uint32_t>(digest));
+  auto added = uint64_t{0};
+  for (size_t i = 0; i < split_block_words; ++i) {
+    added |= mask[i] & ~block[i];
+    block[i] |= mask[i];
+  }
+  return added != 0;
+}
+
+/// Checks whether all bits for a digest are set. This touches exactly one
+/// cache line and, if available, tests all bits with a single AVX2 compare.
+inline auto
+split_block_lookup(std::span<const uint64_t> bits, uint64_t digest) noexcept
+  -> bool {
+  const auto* block = split_block_of(bits, digest);
+  const auto key = static_cast<uint32_t>(digest);
+#if defined(__AVX2__)
+  const auto salts = _mm256_setr_epi32(
+    static_cast<int>(split_block_salts[0]),
+    static_cast<int>(split_block_salts[1]),
+    static_cast<int>(split_block_salts[2]),
+    static_cast<int>(split_block_salts[3]),
+    static_cast<int>(split_block_salts[4]),
+    static_cast<int>(split_block_salts[5]),
+    static_cast<int>(split_block_salts[6]),
+    static_cast<int>(split_block_salts[7]));
+  const auto positions = _mm256_srli_epi32(
+    _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(key)), salts), 27);
+  const auto mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), positions);
+  const auto words
+    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+  return _mm256_testc_si256(words, mask) != 0;
+#else
+  const auto mask = split_block_mask(key);
+  auto missing = uint64_t{0};
+  for (size_t i = 0; i < split_block_words; ++i)
+    missing |= mask[i] & ~block[i];
+  return missing == 0;
+#endif
+}
+
+} // namespace detail
+
+/// A split-block Bloom filter view, used by mutable and frozen split-block
+/// Bloom filters.
+///
+/// Unlike the classic Bloom filter that sets k bits anywhere in the bitvector,
+/// this filter sets all 8 bits of an element within a single block of 256
+/// bits. This trades a slightly higher false-positive rate for the same space
+/// for operations that touch only a single cache line.
+template <class Word>
+struct split_block_bloom_filter_view {
+  static_assert(
+    std::is_same_v<Word, uint64_t> || std::is_same_v<Word, const uint64_t>);
+
+  /// Default-constructs an invalid view.
+  split_block_bloom_filter_view() {
+    params_.m = 0;
+    params_.n = 0;
+    params_.k = 0;
+    params_.p = 1;
+  };
+
+  /// Constructs a view from Bloom filter parameters and a span of bytes.
+  split_block_bloom_filter_view(bloom_filter_params params,
+                                std::span<Word> bits, uint64_t num_elements = 0)
+    : params_{params}, bits_{bits}, num_elements_{num_elements} {
+    TENZIR_ASSERT(params.k == detail::split_block_k);
+    TENZIR_ASSERT(params.m > 0 && params.m % detail::split_block_bits == 0);
+    TENZIR_ASSERT(bits.size() * 64 == params.m);
+  }
+
+  /// Adds a hash digest to the filter.
+  /// @returns `true` iff the digest did not exist in the filter before.
+  auto add(uint64_t digest) noexcept -> bool
+    requires(!std::is_const_v<Word>)
+  {
+    if (!detail::split_block_add(bits_, digest))
+      return false;
+    ++num_elements_;
+    return true;
+  }
+
+  /// Checks whether a hash digest exists in the filter.
+  auto lookup(uint64_t digest) const noexcept -> bool {
+    return detail::split_block_lookup(bits_, digest);
+  }
+
+  /// Retrieves the Bloom filter paramers.
+  auto parameters() const noexcept -> const bloom_filter_params& {
+    return params_;
+  }
+
+  /// Retrieves the number of distinct digests in the filter. This may
+  /// undercount due to false positives when adding.
+  auto num_elements() const noexcept -> uint64_t {
+    return num_elements_;
+  }
+
+  friend auto mem_usage(const split_block_bloom_filter_view& x) noexcept
+    -> size_t {
+    return sizeof(x.params_) + sizeof(x.bits_) + sizeof(x.num_elements_);
+  }
+
+  friend auto pack(flatbuffers::FlatBufferBuilder& builder,
+                   const split_block_bloom_filter_view& x) noexcept
+    -> caf::expected<flatbuffers::Offset<fbs::BloomFilter>> {
+    auto params = fbs::BloomFilterParameters{x.params_.m, x.params_.n,
+                                             x.params_.k, x.params_.p};
+    auto bits_offset = builder.CreateVector(x.bits_.data(), x.bits_.size());
+    return fbs::CreateBloomFilter(builder, &params, bits_offset,
+                                  fbs::BloomFilterLayout::split_block,
+                                  x.num_elements_);
+  }
+
+  friend auto unpack(const fbs::BloomFilter& table,
+                     split_block_bloom_filter_view& x) noexcept -> caf::error {
+    if (table.layout() != fbs::BloomFilterLayout::split_block)
+      return caf::make_error(ec::format_error,
+                             "expected Bloom filter with split-block layout");
+    const auto& params = *table.parameters();
+    const auto& bits = *table.bits();
+    if (params.k() != detail::split_block_k || bits.size() == 0
+        || bits.size() % detail::split_block_words != 0
+        || bits.size() * 64 != params.m())
+      return caf::make_error(ec::format_error,
+                             "invalid split-block Bloom filter parameters");
+    x.params_.m = params.m();
+    x.params_.n = params.n();
+    x.params_.k = params.k();
+    x.params_.p = params.p();
+    x.bits_ = std::span{bits.data(), bits.size()};
+    x.num_elements_ = table.num_elements();
+    return {};
+  }
+
+  bloom_filter_params params_;
+  std::span<Word> bits_;
+  uint64_t num_elements_ = 0;
+};
+
+using mutable_split_block_bloom_filter_view
+  = split_block_bloom_filter_view<uint64_t>;
+using immutable_split_block_bloom_filter_view
+  = split_block_bloom_filter_view<const uint64_t>;
+
+} // namespace tenzir::sketch
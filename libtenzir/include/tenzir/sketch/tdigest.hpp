@@ -0,0 +1,96 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// This is a merging t-digest as described by Dunning and Ertl. Incoming values
+// are buffered and periodically merged into a sorted list of centroids whose
+// sizes are bounded by the arcsine scale function, which keeps centroids near
+// the tails small and thus makes extreme quantiles particularly accurate.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace tenzir::sketch {
+
+/// A fixed-size sketch for estimating quantiles of a stream of numbers.
+class tdigest {
+public:
+  /// A cluster of values represented by their mean.
+  struct centroid {
+    double mean = {};
+    double weight = {};
+
+    friend auto operator==(const centroid&, const centroid&) noexcept -> bool
+      = default;
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, centroid& x) {
+      return f.object(x)
+        .pretty_name("tenzir.sketch.tdigest.centroid")
+        .fields(f.field("mean", x.mean), f.field("weight", x.weight));
+    }
+  };
+
+  /// The default compression, which bounds the number of centroids to
+  /// roughly this number.
+  static constexpr double default_compression = 100.0;
+
+  /// Constructs an empty digest.
+  /// @param compression The compression factor; higher values trade memory
+  /// for accuracy.
+  /// @pre `compression >= 10`
+  explicit tdigest(double compression = default_compression);
+
+  /// Adds a value to the digest.
+  void add(double value, double weight = 1.0);
+
+  /// Merges another digest into this one.
+  void merge(const tdigest& other);
+
+  /// Estimates the value at the given quantile.
+  /// @pre `0 <= q && q <= 1`
+  /// @returns The estimate, or *nullopt* if no values were added.
+  auto quantile(double q) -> std::optional<double>;
+
+  /// Returns the total weight of all values added.
+  auto total_weight() const noexcept -> double;
+
+  /// Returns the merged centroids.
+  auto centroids() -> const std::vector<centroid>&;
+
+  // -- concepts --------------------------------------------------------------
+
+  friend auto mem_usage(const tdigest& x) noexcept -> size_t;
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, tdigest& x) {
+    if constexpr (!Inspector::is_loading)
+      x.compress();
+    return f.object(x)
+      .pretty_name("tenzir.sketch.tdigest")
+      .fields(f.field("compression", x.compression_),
+              f.field("centroids", x.centroids_), f.field("min", x.min_),
+              f.field("max", x.max_), f.field("total-weight", x.total_weight_));
+  }
+
+private:
+  /// Merges all buffered values into the centroids.
+  void compress();
+
+  double compression_ = default_compression;
+  std::vector<centroid> centroids_ = {};
+  std::vector<centroid> buffer_ = {};
+  double min_ = {};
+  double max_ = {};
+  double total_weight_ = {};
+};
+
+} // namespace tenzir::sketch
@@ -0,0 +1,137 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/bloom_filter_parameters.hpp"
+#include "tenzir/detail/assert.hpp"
+#include "tenzir/detail/operators.hpp"
+#include "tenzir/hash/hash.hpp"
+#include "tenzir/logger.hpp"
+#include "tenzir/sketch/bloom_filter_config.hpp"
+#include "tenzir/sketch/split_block_bloom_filter_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace tenzir {
+
+/// A data structure for probabilistic set membership that sets all bits of an
+/// element within a single block of 256 bits. Compared to the classic
+/// `bloom_filter`, this requires slightly more space for the same
+/// false-positive probability, but adding and looking up an element touches
+/// only a single cache line.
+/// @tparam HashFunction The hash function to compute the digest of an element.
+template <class HashFunction>
+class split_block_bloom_filter
+  : detail::equality_comparable<split_block_bloom_filter<HashFunction>> {
+public:
+  using hash_function = HashFunction;
+
+  /// Constructs a split-block Bloom filter with a fixed size.
+  /// @param size The number of cells/bits in the Bloom filter. This gets
+  ///             rounded up to the next multiple of the block size.
+  explicit split_block_bloom_filter(size_t size = 0)
+    : bits_((size + sketch::detail::split_block_bits - 1)
+              / sketch::detail::split_block_bits
+              * sketch::detail::split_block_words,
+            0) {
+    // nop
+  }
+
+  /// Adds an element to the Bloom filter.
+  /// @param x The element to add.
+  /// @returns `false` iff *x* already exists in the filter.
+  template <class T>
+  bool add(const T& x) {
+    TENZIR_ASSERT_EXPENSIVE(!bits_.empty());
+    return sketch::detail::split_block_add(bits_, digest(x));
+  }
+
+  /// Test whether an element exists in the Bloom filter.
+  /// @param x The element to test.
+  /// @returns `false` if the *x* is not in the set and `true` if *x* may exist
+  ///          according to the false-positive probability of the filter.
+  template <class T>
+  bool lookup(const T& x) const {
+    TENZIR_ASSERT_EXPENSIVE(!bits_.empty());
+    return sketch::detail::split_block_lookup(bits_, digest(x));
+  }
+
+  /// @returns The number of cells in the underlying bit vector.
+  [[nodiscard]] size_t size() const {
+    return bits_.size() * 64;
+  }
+
+  /// @returns An estimate for amount of memory (in bytes) used by this filter.
+  [[nodiscard]] size_t memusage() const {
+    return sizeof(split_block_bloom_filter)
+           + bits_.capacity() * sizeof(uint64_t);
+  }
+
+  /// @returns The number of bits set per element.
+  [[nodiscard]] size_t num_hash_functions() const {
+    return sketch::detail::split_block_k;
+  }
+
+  // -- concepts --------------------------------------------------------------
+
+  friend bool operator==(const split_block_bloom_filter& x,
+                         const split_block_bloom_filter& y) {
+    return x.bits_ == y.bits_;
+  }
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, split_block_bloom_filter& x) {
+    auto load_callback = [&x]() {
+      // When deserializing into a vector that was already bigger than
+      // required, CAF will reuse the storage but not release the
+      // excess afterwards.
+      x.bits_.shrink_to_fit();
+      return x.bits_.size() % sketch::detail::split_block_words == 0;
+    };
+    return f.object(x)
+      .pretty_name("tenzir.split-block-bloom-filter")
+      .on_load(load_callback)
+      .fields(f.field("bits", x.bits_));
+  }
+
+private:
+  template <class T>
+  static uint64_t digest(const T& x) {
+    return static_cast<uint64_t>(hash<HashFunction>(x));
+  }
+
+  std::vector<uint64_t> bits_;
+};
+
+/// Constructs a split-block Bloom filter for a given set of parameters.
+/// @tparam HashFunction The hash function to use.
+/// @param xs The Bloom filter parameters.
+/// @relates split_block_bloom_filter bloom_filter_parameters
+template <class HashFunction>
+std::optional<split_block_bloom_filter<HashFunction>>
+make_split_block_bloom_filter(bloom_filter_parameters xs) {
+  auto cfg = sketch::bloom_filter_config{};
+  cfg.m = xs.m;
+  cfg.n = xs.n;
+  cfg.k = xs.k;
+  cfg.p = xs.p;
+  auto params = sketch::evaluate_split_block(cfg);
+  if (!params)
+    return {};
+  TENZIR_TRACE("evaluated split-block bloom filter parameters: {} {} {} {}",
+               TENZIR_ARG(params->k), TENZIR_ARG(params->m),
+               TENZIR_ARG(params->n), TENZIR_ARG(params->p));
+  return split_block_bloom_filter<HashFunction>{params->m};
+}
+
+} // namespace tenzir
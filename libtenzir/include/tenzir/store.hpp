@@ -62,6 +62,16 @@ public:
   /// @param chunk The chunk pointing to the store's persisted data.
   /// @returns An error on failure.
   [[nodiscard]] virtual caf::error load(chunk_ptr chunk) = 0;
+
+  /// Decode the store contents incrementally from a stream of chunks, which
+  /// allows for using stores as parsers without buffering their entire input.
+  /// The default implementation concatenates all chunks and calls `load`.
+  /// @param input The chunks containing the store's persisted data.
+  /// @param dh The diagnostic handler for reporting decoding errors.
+  /// @returns A generator that yields slices as soon as they are decoded, and
+  /// an empty slice whenever it waits for more input.
+  [[nodiscard]] virtual generator<table_slice>
+  load_incrementally(generator<chunk_ptr> input, diagnostic_handler& dh);
 };
 
 /// A base class for active stores used by the store plugin.
@@ -28,11 +28,11 @@ make_string_synopsis(tenzir::type type, bloom_filter_parameters params,
                      std::vector<size_t> seeds = {});
 
 /// A synopsis for strings.
-template <class HashFunction>
+template <class HashFunction, class BloomFilter = bloom_filter<HashFunction>>
 class string_synopsis final
-  : public bloom_filter_synopsis<std::string, HashFunction> {
+  : public bloom_filter_synopsis<std::string, HashFunction, BloomFilter> {
 public:
-  using super = bloom_filter_synopsis<std::string, HashFunction>;
+  using super = bloom_filter_synopsis<std::string, HashFunction, BloomFilter>;
 
   /// Constructs a string synopsis from an `string_type` and a Bloom
   /// filter.
@@ -89,6 +89,16 @@ synopsis_ptr
 make_string_synopsis(tenzir::type type, bloom_filter_parameters params,
                      std::vector<size_t> seeds) {
   TENZIR_ASSERT(caf::holds_alternative<string_type>(type));
+  if (params.layout == bloom_filter_layout::split_block) {
+    auto x = make_split_block_bloom_filter<HashFunction>(std::move(params));
+    if (!x) {
+      TENZIR_WARN("{} failed to construct split-block Bloom filter", __func__);
+      return nullptr;
+    }
+    using synopsis_type
+      = string_synopsis<HashFunction, split_block_bloom_filter<HashFunction>>;
+    return std::make_unique<synopsis_type>(std::move(type), std::move(*x));
+  }
   auto x = make_bloom_filter<HashFunction>(std::move(params), std::move(seeds));
   if (!x) {
     TENZIR_WARN("{} failed to construct Bloom filter", __func__);
@@ -114,7 +124,8 @@ synopsis_ptr make_buffered_string_synopsis(tenzir::type type,
     return nullptr;
   }
   using synopsis_type = buffered_string_synopsis<HashFunction>;
-  return std::make_unique<synopsis_type>(std::move(type), *params.p);
+  return std::make_unique<synopsis_type>(std::move(type), *params.p,
+                                         params.layout);
 }
 
 /// Factory to construct a string synopsis. This overload looks for a type
@@ -142,6 +153,8 @@ make_string_synopsis(tenzir::type type, const caf::settings& opts) {
   bloom_filter_parameters params;
   params.n = *max_part_size;
   params.p = caf::get_or(opts, "string-synopsis-fp-rate", defaults::fp_rate);
+  if (caf::get_or(opts, "split-block-bloom-filter", false))
+    params.layout = bloom_filter_layout::split_block;
   auto annotated_type = annotate_parameters(type, params);
   // Create either a a buffered_string_synopsis or a plain string synopsis
   // depending on the callers preference.
@@ -0,0 +1,83 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <caf/expected.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace tenzir {
+
+/// Determines how the `tcp` loader splits the byte stream of a connection into
+/// chunks when listening.
+enum class tcp_framing {
+  /// Forward data as it arrives.
+  none,
+  /// Only cut chunks after a newline.
+  newline,
+  /// Decode octet-counted frames as described in RFC 6587, Section 3.4.1, and
+  /// forward them as newline-delimited messages.
+  octet_counting,
+};
+
+/// Parses `none`, `newline`, or `octet-counting`.
+auto parse_tcp_framing(std::string_view str) -> std::optional<tcp_framing>;
+
+/// Splits the byte stream of a single connection such that chunks end at frame
+/// boundaries. This makes it possible to interleave the chunks of concurrent
+/// connections without tearing messages apart.
+///
+/// Usage: Acquire a buffer of at least `read_size()` bytes, call `prepare` to
+/// place the bytes carried over from the previous read at its beginning, read
+/// into the buffer after them, and call `frame` on the result.
+class tcp_framer {
+public:
+  /// The minimum number of bytes to read at once.
+  static constexpr auto min_read_size = size_t{4'096};
+
+  /// The maximum size of an octet-counted frame, and the size at which
+  /// newline framing cuts lines.
+  static constexpr auto max_frame_size = size_t{1} << 20;
+
+  explicit tcp_framer(tcp_framing framing);
+
+  /// Returns the minimum size of the buffer for the next read.
+  auto read_size() const -> size_t;
+
+  /// Moves the bytes carried over from the previous read to the beginning of
+  /// `buffer`, which must hold at least `read_size()` bytes.
+  /// @returns The offset at which to read into `buffer`.
+  auto prepare(std::span<std::byte> buffer) -> size_t;
+
+  /// Frames the first `size` bytes of `buffer`, potentially rewriting them in
+  /// place, and carries over incomplete frames to the next read.
+  /// @returns The number of bytes at the beginning of `buffer` that consist of
+  /// complete frames.
+  auto frame(std::span<std::byte> buffer, size_t size)
+    -> caf::expected<size_t>;
+
+  /// Returns the bytes that remain after the connection was closed.
+  auto finish() -> caf::expected<std::vector<std::byte>>;
+
+private:
+  auto frame_newline(std::span<std::byte> buffer, size_t size) -> size_t;
+
+  auto frame_octet_counting(std::span<std::byte> buffer, size_t size)
+    -> caf::expected<size_t>;
+
+  tcp_framing framing_ = {};
+  std::vector<std::byte> carry_ = {};
+  size_t required_ = 0;
+};
+
+} // namespace tenzir
@@ -86,6 +86,10 @@ public:
   /// @returns the options of the index.
   [[nodiscard]] const caf::settings& options() const;
 
+  /// @returns the encoding of the bitmaps that the index creates, which is
+  /// Roaring if the option `roaring-bitmaps` is set, and EWAH otherwise.
+  [[nodiscard]] bitmap_encoding encoding() const;
+
   // -- persistence -----------------------------------------------------------
 
   virtual bool inspect_impl(supported_inspectors& inspector);
@@ -118,6 +122,9 @@ private:
   ewah_bitmap none_;         ///< The positions of null values.
   const tenzir::type type_;  ///< The type of this index.
   const caf::settings opts_; ///< Runtime context with additional parameters.
+
+  /// The encoding of the bitmaps that the index creates.
+  const bitmap_encoding encoding_;
 };
 
 /// Serialize the value index into a chunk.
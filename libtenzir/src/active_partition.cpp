@@ -18,7 +18,6 @@
 #include "tenzir/concept/printable/to_string.hpp"
 #include "tenzir/detail/assert.hpp"
 #include "tenzir/detail/fill_status_map.hpp"
-#include "tenzir/detail/narrow.hpp"
 #include "tenzir/detail/notifying_stream_manager.hpp"
 #include "tenzir/detail/partition_common.hpp"
 #include "tenzir/detail/settings.hpp"
@@ -31,14 +30,12 @@
 #include "tenzir/fbs/uuid.hpp"
 #include "tenzir/hash/xxhash.hpp"
 #include "tenzir/ids.hpp"
-#include "tenzir/indexer.hpp"
 #include "tenzir/ip_synopsis.hpp"
 #include "tenzir/logger.hpp"
 #include "tenzir/plugin.hpp"
 #include "tenzir/qualified_record_field.hpp"
 #include "tenzir/report.hpp"
 #include "tenzir/resource.hpp"
-#include "tenzir/shutdown.hpp"
 #include "tenzir/status.hpp"
 #include "tenzir/synopsis.hpp"
 #include "tenzir/table_slice.hpp"
@@ -89,27 +86,20 @@ void serialize(
   // TODO: It would probably make more sense if the partition
   // synopsis keeps track of offset/events internally.
   mutable_synopsis.events = self->state.data.events;
-  for (auto& [qf, actor] : self->state.indexers) {
-    if (actor == nullptr) {
-      self->state.data.indexer_chunks.emplace_back(qf.name(), nullptr);
-      continue;
-    }
-    auto actor_id = actor.id();
-    auto chunk_it = self->state.chunks.find(actor_id);
-    if (chunk_it == self->state.chunks.end()) {
-      auto error = caf::make_error(ec::logic_error, "no chunk for for actor id "
-                                                      + to_string(actor_id));
-      TENZIR_ERROR("{} failed to serialize: {}", *self, render(error));
-      self->state.persistence_promise.deliver(error);
-      return;
-    }
+  for (auto& [qf, idx] : self->state.indexers) {
+    auto chunk = chunk_ptr{};
+    // Note that `chunkify(nullptr)` returns a chunk of size > 0.
+    if (idx)
+      chunk = chunkify(idx);
+    // We defensively treat every empty chunk as non-existing.
+    if (chunk && chunk->size() == 0)
+      chunk = nullptr;
     // TODO: Consider storing indexer chunks by the fully qualified
     // field instead of just its fully qualified name in a future
     // partition version. As-is, this breaks if multiple fields with
     // the same fully qualified name but different types exist in
     // the same partition.
-    self->state.data.indexer_chunks.emplace_back(
-      std::make_pair(qf.name(), chunk_it->second));
+    self->state.data.indexer_chunks.emplace_back(qf.name(), std::move(chunk));
   }
   // Create the partition flatbuffer.
   auto combined_schema = self->state.combined_schema();
@@ -196,18 +186,19 @@ bool should_skip_index_creation(const type& type,
   // We no longer build dense indexes as of Tenzir v4.3. Over time, they've lost
   // much of their appeal with partition sizes growing and columnar scanning of
   // stores becoming more effective.
-  // TODO: Rip out the parts of the code base relating to value indexes, the
-  // value index factory, and active and passive indexer actors.
+  // The only exception are trigram indexes for string fields that users opt
+  // into explicitly, as they turn substring searches into index lookups.
+  // TODO: Rip out the parts of the code base relating to the remaining value
+  // indexes.
   (void)type;
-  (void)qf;
-  (void)rules;
-  return true;
+  return !should_create_trigram_index(qf, rules);
 }
 
-/// Gets the ACTIVE INDEXER at a certain position.
-active_indexer_actor active_partition_state::indexer_at(size_t position) const {
-  TENZIR_ASSERT(position < indexers.size());
-  return as_vector(indexers)[position].second;
+value_index_ptr make_field_index(const type& type, caf::settings index_opts,
+                                 const index_config& config) {
+  index_opts["max-size"] = config.trigram_index_max_size;
+  return factory<tenzir::value_index>::make(
+    tenzir::type{type, {{"index", "trigram"}}}, std::move(index_opts));
 }
 
 std::optional<record_type> active_partition_state::combined_schema() const {
@@ -403,31 +394,37 @@ active_partition_actor::behavior_type active_partition(
         self->state.data.events += x.rows();
         self->state.data.synopsis.unshared().add(
           x, self->state.partition_capacity, self->state.synopsis_index_config);
-        size_t column_idx = -1;
-        for (const auto& [field, offset] :
+        // Update all value indexes of the slice in a single pass over its
+        // columns. This used to fan out every slice to one indexer actor per
+        // field, which caused a lot of messaging overhead for wide schemas.
+        TENZIR_ASSERT_EXPENSIVE(x.columns()
+                                == caf::get<record_type>(schema).num_leaves());
+        for (size_t column_idx = 0;
+             const auto& [field, offset] :
              caf::get<record_type>(schema).leaves()) {
-          column_idx++;
           // TODO: The qualified record field is a leftover from heterogeneous
           // partitions, the indexers can be indexed by the offset instead.
           const auto qf = qualified_record_field{schema, offset};
-          auto& idx = self->state.indexers[qf];
-          if (idx)
-            continue;
-          if (should_skip_index_creation(
-                field.type, qf, self->state.synopsis_index_config.rules))
-            continue;
-          auto value_index
-            = factory<tenzir::value_index>::make(field.type, index_opts);
-          if (!value_index) {
-            TENZIR_WARN("{} failed to spawn active indexer with options {} for "
-                        "field {}: value index missing",
-                        *self, index_opts, field);
-            continue;
+          auto it = self->state.indexers.find(qf);
+          if (it == self->state.indexers.end()) {
+            auto idx = value_index_ptr{};
+            if (!should_skip_index_creation(
+                  field.type, qf, self->state.synopsis_index_config.rules)) {
+              idx = make_field_index(field.type, index_opts,
+                                     self->state.synopsis_index_config);
+              if (!idx)
+                TENZIR_WARN("{} failed to create value index with options {} "
+                            "for field {}",
+                            *self, index_opts, field);
+              else
+                TENZIR_DEBUG("{} created value index for field {}", *self,
+                             field.name);
+            }
+            it = self->state.indexers.emplace(qf, std::move(idx)).first;
           }
-          idx = self->spawn(active_indexer, column_idx, std::move(value_index));
-          auto slot = self->state.stage->add_outbound_path(idx);
-          TENZIR_DEBUG("{} spawned new active indexer for field {} at slot {}",
-                       *self, field.name, slot);
+          if (it->second)
+            x.append_column_to_index(column_idx, *it->second);
+          ++column_idx;
         }
         out.push(x);
       },
@@ -486,15 +483,7 @@ active_partition_actor::behavior_type active_partition(
       return;
     }
     TENZIR_VERBOSE("{} shuts down after persisting partition state", *self);
-    // TODO: We must actor_cast to caf::actor here because 'shutdown' operates
-    // on 'std::vector<caf::actor>' only. That should probably be generalized
-    // in the future.
-    auto indexers = std::vector<caf::actor>{};
-    indexers.reserve(self->state.indexers.size());
-    auto copy = std::exchange(self->state.indexers, {});
-    for ([[maybe_unused]] auto&& [qf, indexer] : std::move(copy))
-      indexers.push_back(caf::actor_cast<caf::actor>(std::move(indexer)));
-    shutdown<policy::parallel>(self, std::move(indexers));
+    self->quit(msg.reason);
   });
   return {
     [self](atom::erase) -> caf::result<atom::done> {
@@ -520,7 +509,6 @@ active_partition_actor::behavior_type active_partition(
       TENZIR_ASSERT(!self->state.persistence_promise.source());
       self->state.persist_path = part_path;
       self->state.synopsis_path = synopsis_path;
-      self->state.persisted_indexers = 0;
       self->state.persistence_promise
         = self->make_response_promise<partition_synopsis_ptr>();
       self->request(self->state.store_builder, caf::infinite, atom::persist_v)
@@ -528,16 +516,11 @@ active_partition_actor::behavior_type active_partition(
           [self](resource& store_file) {
             self->state.data.synopsis.unshared().store_file
               = std::move(store_file);
-            auto& indexers = self->state.indexers;
-            auto valid_count
-              = std::count_if(indexers.begin(), indexers.end(), [](auto& idx) {
-                  return idx.second != nullptr;
-                });
-            if (self->state.persistence_promise.pending()
-                && self->state.persisted_indexers
-                     == detail::narrow_cast<size_t>(valid_count)) {
+            // The store builder sits downstream of the stream stage that
+            // updates the value indexes, so once it persisted all events the
+            // value indexes are complete as well.
+            if (self->state.persistence_promise.pending())
               serialize(self);
-            }
           },
           [self](caf::error err) {
             TENZIR_ERROR("{} failed to get the store info {}", *self, err);
@@ -564,67 +547,10 @@ active_partition_actor::behavior_type active_partition(
           return rp;
         }
       }
-      if (self->state.indexers.empty()) {
+      if (self->state.indexers.empty()
+          && self->state.persistence_promise.pending())
         self->state.persistence_promise.deliver(
           caf::make_error(ec::logic_error, "partition has no indexers"));
-        return {};
-      }
-      auto& indexers = self->state.indexers;
-      auto valid_count
-        = std::count_if(indexers.begin(), indexers.end(), [](auto& idx) {
-            return idx.second != nullptr;
-          });
-
-      if (0u == valid_count) {
-        // We call serialize from the response handler of persist request to the
-        // store in this case.
-        return {};
-      }
-      TENZIR_DEBUG("{} sends 'snapshot' to {} indexers", *self, valid_count);
-      for (auto& [field, indexer] : self->state.indexers) {
-        if (indexer == nullptr)
-          continue;
-        self->request(indexer, caf::infinite, atom::snapshot_v)
-          .then(
-            [=](chunk_ptr chunk) {
-              ++self->state.persisted_indexers;
-              if (!self->state.persistence_promise.pending()) {
-                TENZIR_WARN("{} ignores persisted indexer because the "
-                            "persistence promise is already fulfilled",
-                            *self);
-                return;
-              }
-              auto sender = self->current_sender()->id();
-              if (!chunk) {
-                TENZIR_ERROR("{} failed to persist indexer {}", *self, sender);
-                self->state.persistence_promise.deliver(caf::make_error(
-                  ec::unspecified, "failed to persist indexer", sender));
-                return;
-              }
-              TENZIR_DEBUG("{} got chunk from {}", *self, sender);
-              self->state.chunks.emplace(sender, chunk);
-              if (self->state.persisted_indexers
-                  < detail::narrow_cast<size_t>(valid_count)) {
-                TENZIR_DEBUG(
-                  "{} waits for more chunks after receiving {} out of "
-                  "{}",
-                  *self, self->state.persisted_indexers, valid_count);
-                return;
-              }
-              if (self->state.data.synopsis->store_file.url.empty()) {
-                TENZIR_DEBUG("{} waits for the store to persist", *self);
-                return;
-              }
-              serialize(self);
-            },
-            [=, field_ = field](caf::error err) {
-              TENZIR_ERROR("{} failed to persist indexer for {} with error: {}",
-                           *self, field_.name(), err);
-              ++self->state.persisted_indexers;
-              if (!self->state.persistence_promise.pending())
-                self->state.persistence_promise.deliver(std::move(err));
-            });
-      }
       return {};
     },
     [self](atom::query, query_context query_context) -> caf::result<uint64_t> {
@@ -640,7 +566,7 @@ active_partition_actor::behavior_type active_partition(
                             std::move(query_context));
     },
     [self](atom::status, status_verbosity v,
-           duration d) -> caf::typed_response_promise<record> {
+           duration) -> caf::typed_response_promise<record> {
       struct extra_state {
         size_t memory_usage = 0;
         void deliver(caf::typed_response_promise<record>&& promise,
@@ -651,33 +577,17 @@ active_partition_actor::behavior_type active_partition(
       };
       auto rs = make_status_request_state<extra_state>(self);
       auto indexer_states = list{};
-      // Reservation is necessary to make sure the entries don't get relocated
-      // as the underlying vector grows - `ps` would refer to the wrong memory
-      // otherwise.
-      const auto timeout = d / 10 * 9;
-      indexer_states.reserve(self->state.indexers.size());
-      for (auto& i : self->state.indexers) {
-        if (!i.second)
+      for (const auto& [field, idx] : self->state.indexers) {
+        if (!idx)
           continue;
-        auto& ps = caf::get<record>(indexer_states.emplace_back(record{}));
-        collect_status(
-          rs, timeout, v, i.second,
-          [rs, v, &ps, &field = i.first](record& response) {
-            ps["field"] = field.name();
-            ps["type"] = fmt::to_string(field.type());
-            auto it = response.find("memory-usage");
-            if (it != response.end()) {
-              if (const auto* s = caf::get_if<uint64_t>(&it->second))
-                rs->memory_usage += *s;
-            }
-            if (v >= status_verbosity::debug)
-              merge(response, ps, policy::merge_lists::no);
-          },
-          [rs, &ps, &field = i.first](caf::error& err) {
-            TENZIR_WARN("{} failed to retrieve status from {}: {}", *rs->self,
-                        field.name(), err);
-            ps["error"] = fmt::to_string(err);
-          });
+        const auto memory_usage = idx->memusage();
+        rs->memory_usage += memory_usage;
+        auto ps = record{};
+        ps["field"] = field.name();
+        ps["type"] = fmt::to_string(field.type());
+        if (v >= status_verbosity::debug)
+          ps["memory-usage"] = uint64_t{memory_usage};
+        indexer_states.emplace_back(std::move(ps));
       }
       rs->content["indexers"] = std::move(indexer_states);
       if (v >= status_verbosity::debug)
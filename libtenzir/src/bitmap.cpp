@@ -12,9 +12,31 @@
 #include "tenzir/error.hpp"
 #include "tenzir/fbs/bitmap.hpp"
 
+#include <utility>
+
 namespace tenzir {
 
+namespace {
+
+thread_local bitmap_encoding default_encoding = bitmap_encoding::ewah;
+
+} // namespace
+
+bitmap_encoding default_bitmap_encoding() {
+  return default_encoding;
+}
+
+bitmap_encoding_guard::bitmap_encoding_guard(bitmap_encoding encoding) noexcept
+  : previous_{std::exchange(default_encoding, encoding)} {
+}
+
+bitmap_encoding_guard::~bitmap_encoding_guard() noexcept {
+  default_encoding = previous_;
+}
+
 bitmap::bitmap() : bitmap_{default_bitmap{}} {
+  if (default_bitmap_encoding() == bitmap_encoding::roaring)
+    bitmap_ = roaring_bitmap{};
 }
 
 bitmap::bitmap(size_type n, bool bit) : bitmap{} {
@@ -45,6 +67,12 @@ size_t bitmap::memusage() const {
     bitmap_);
 }
 
+bool bitmap::operator[](size_type i) const {
+  if (const auto* roaring = caf::get_if<roaring_bitmap>(&bitmap_))
+    return (*roaring)[i];
+  return super::operator[](i);
+}
+
 void bitmap::append_bit(bool bit) {
   caf::visit(
     [=](auto& bm) {
@@ -107,6 +135,11 @@ auto pack(flatbuffers::FlatBufferBuilder& builder, const bitmap& from)
       return fbs::CreateBitmap(builder, fbs::bitmap::Bitmap::wah,
                                wah_offset.Union());
     },
+    [&](const roaring_bitmap& roaring) {
+      const auto roaring_offset = pack(builder, roaring).Union();
+      return fbs::CreateBitmap(builder, fbs::bitmap::Bitmap::roaring,
+                               roaring_offset.Union());
+    },
   };
   return caf::visit(f, from.bitmap_);
 }
@@ -128,10 +161,62 @@ auto unpack(const fbs::Bitmap& from, bitmap& to) -> caf::error {
       return do_unpack(*from.bitmap_as_null(), null_bitmap{});
     case fbs::bitmap::Bitmap::wah:
       return do_unpack(*from.bitmap_as_wah(), wah_bitmap{});
+    case fbs::bitmap::Bitmap::roaring:
+      return do_unpack(*from.bitmap_as_roaring(), roaring_bitmap{});
   }
   __builtin_unreachable();
 }
 
+namespace {
+
+template <class Operation, class Fallback>
+bitmap dispatch_roaring(const bitmap& lhs, const bitmap& rhs, Operation op,
+                        Fallback fallback) {
+  const auto* x = caf::get_if<roaring_bitmap>(&lhs.get_data());
+  const auto* y = caf::get_if<roaring_bitmap>(&rhs.get_data());
+  if (x && y)
+    return op(*x, *y);
+  return fallback(lhs, rhs);
+}
+
+} // namespace
+
+bitmap binary_and(const bitmap& lhs, const bitmap& rhs) {
+  return dispatch_roaring(
+    lhs, rhs,
+    [](const roaring_bitmap& x, const roaring_bitmap& y) {
+      return binary_and(x, y);
+    },
+    binary_and<bitmap, bitmap>);
+}
+
+bitmap binary_or(const bitmap& lhs, const bitmap& rhs) {
+  return dispatch_roaring(
+    lhs, rhs,
+    [](const roaring_bitmap& x, const roaring_bitmap& y) {
+      return binary_or(x, y);
+    },
+    binary_or<bitmap, bitmap>);
+}
+
+bitmap binary_xor(const bitmap& lhs, const bitmap& rhs) {
+  return dispatch_roaring(
+    lhs, rhs,
+    [](const roaring_bitmap& x, const roaring_bitmap& y) {
+      return binary_xor(x, y);
+    },
+    binary_xor<bitmap, bitmap>);
+}
+
+bitmap binary_nand(const bitmap& lhs, const bitmap& rhs) {
+  return dispatch_roaring(
+    lhs, rhs,
+    [](const roaring_bitmap& x, const roaring_bitmap& y) {
+      return binary_nand(x, y);
+    },
+    binary_nand<bitmap, bitmap>);
+}
+
 bitmap_bit_range::bitmap_bit_range(const bitmap& bm) {
   auto visitor = [&](auto& b) {
     auto r = bit_range(b);
@@ -80,6 +80,10 @@ std::optional<bloom_filter_parameters> parse_parameters(std::string_view x) {
   bloom_filter_parameters xs;
   xs.n = 0;
   xs.p = 0;
+  if (x.starts_with("splitblock")) {
+    x.remove_prefix(std::string_view{"splitblock"}.size());
+    xs.layout = bloom_filter_layout::split_block;
+  }
   if (parser(x, *xs.n, *xs.p))
     return xs;
   return {};
@@ -87,7 +91,8 @@ std::optional<bloom_filter_parameters> parse_parameters(std::string_view x) {
 
 bool operator==(const bloom_filter_parameters& x,
                 const bloom_filter_parameters& y) {
-  return x.m == y.m && x.n == y.n && x.k == y.k && x.p == y.p;
+  return x.m == y.m && x.n == y.n && x.k == y.k && x.p == y.p
+         && x.layout == y.layout;
 }
 
 bool operator!=(const bloom_filter_parameters& x,
@@ -13,7 +13,9 @@
 namespace tenzir {
 
 type annotate_parameters(const type& x, const bloom_filter_parameters& params) {
-  auto v = fmt::format("bloomfilter({},{})", *params.n, *params.p);
+  auto prefix
+    = params.layout == bloom_filter_layout::split_block ? "splitblock" : "";
+  auto v = fmt::format("{}bloomfilter({},{})", prefix, *params.n, *params.p);
   return type{x, {{"synopsis", std::move(v)}}};
 }
 
@@ -22,6 +22,7 @@
 #include "tenzir/detail/weak_run_delayed.hpp"
 #include "tenzir/error.hpp"
 #include "tenzir/expression.hpp"
+#include "tenzir/expression_visitors.hpp"
 #include "tenzir/fbs/type_registry.hpp"
 #include "tenzir/flatbuffer.hpp"
 #include "tenzir/instrumentation.hpp"
@@ -43,10 +44,34 @@
 #include <caf/detail/set_thread_name.hpp>
 #include <caf/expected.hpp>
 
+#include <algorithm>
+#include <tuple>
 #include <type_traits>
 
 namespace tenzir {
 
+namespace {
+
+/// Checks whether the lookup of an expression requires the field and type
+/// synopses of the partitions of a schema, or whether their metadata suffices.
+/// Predicates that do not resolve to any field of the schema select none of its
+/// partitions regardless, because the partitions only have synopses for the
+/// fields of their schema.
+bool requires_synopses(const expression& expr, const type& schema) {
+  for (const auto& pred : caf::visit(predicatizer{}, expr)) {
+    if (caf::holds_alternative<meta_extractor>(pred.lhs))
+      continue;
+    if (!caf::holds_alternative<record_type>(schema))
+      return true;
+    auto resolved = type_resolver{schema}(pred);
+    if (!resolved || !caf::holds_alternative<caf::none_t>(*resolved))
+      return true;
+  }
+  return false;
+}
+
+} // namespace
+
 void catalog_state::create_from(
   std::unordered_map<uuid, partition_synopsis_ptr>&& ps) {
   std::unordered_map<tenzir::type,
@@ -79,6 +104,7 @@ void catalog_state::erase(const uuid& partition) {
     auto erased = uuid_synopsis_map.erase(partition);
     if (erased) {
       if (uuid_synopsis_map.empty()) {
+        unpacked_synopses_last_used.erase(type);
         synopses_per_type.erase(type);
       }
       return;
@@ -86,8 +112,62 @@ void catalog_state::erase(const uuid& partition) {
   }
 }
 
-caf::expected<catalog_lookup_result>
-catalog_state::lookup(expression expr) const {
+void catalog_state::load_synopses(const type& schema) {
+  auto it = synopses_per_type.find(schema);
+  if (it == synopses_per_type.end())
+    return;
+  auto failed = std::vector<uuid>{};
+  for (auto& [partition, synopsis] : it->second) {
+    if (!synopsis->is_lazy())
+      continue;
+    if (auto err = synopsis.unshared().load_synopses()) {
+      TENZIR_ERROR("{} drops partition {} because its synopses failed to "
+                   "load: {}",
+                   *self, partition, err);
+      failed.push_back(partition);
+      continue;
+    }
+    update_unprunable_fields(*synopsis);
+  }
+  for (const auto& partition : failed)
+    it->second.erase(partition);
+}
+
+void catalog_state::evict_synopses() {
+  auto unpacked = std::vector<std::tuple<uint64_t, type, size_t>>{};
+  auto total_size = size_t{0};
+  for (const auto& [schema, last_used] : unpacked_synopses_last_used) {
+    auto it = synopses_per_type.find(schema);
+    if (it == synopses_per_type.end())
+      continue;
+    auto size = size_t{0};
+    for (const auto& [_, synopsis] : it->second)
+      if (synopsis->has_unloadable_synopses())
+        size += synopsis->memusage();
+    unpacked.emplace_back(last_used, schema, size);
+    total_size += size;
+  }
+  if (total_size <= defaults::catalog::max_unpacked_synopses_size)
+    return;
+  std::sort(unpacked.begin(), unpacked.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return std::get<0>(lhs) < std::get<0>(rhs);
+            });
+  for (const auto& [last_used, schema, size] : unpacked) {
+    if (total_size <= defaults::catalog::max_unpacked_synopses_size
+        || last_used == num_lookups)
+      break;
+    TENZIR_DEBUG("{} unloads the synopses of schema {} to free {} bytes",
+                 *self, schema, size);
+    for (auto& [_, synopsis] : synopses_per_type[schema])
+      if (synopsis->has_unloadable_synopses())
+        synopsis.unshared().unload_synopses();
+    unpacked_synopses_last_used.erase(schema);
+    total_size -= size;
+  }
+}
+
+caf::expected<catalog_lookup_result> catalog_state::lookup(expression expr) {
   auto start = stopwatch::now();
   auto total_candidates = catalog_lookup_result{};
   auto num_candidate_partitions = size_t{0};
@@ -102,7 +182,9 @@ catalog_state::lookup(expression expr) const {
                                        "epxression {}: {}",
                                        *self, expr, normalized.error()));
   }
-  for (const auto& [type, _] : synopses_per_type) {
+  ++num_lookups;
+  auto failed_schemas = std::vector<type>{};
+  for (const auto& [type, synopses] : synopses_per_type) {
     auto resolved = resolve(taxonomies, *normalized, type);
     if (not resolved) {
       return caf::make_error(ec::invalid_argument,
@@ -110,6 +192,17 @@ catalog_state::lookup(expression expr) const {
                                          "{}",
                                          *self, expr, resolved.error()));
     }
+    // Only unpack the synopses of schemas that the expression references. We
+    // must do so before pruning, which relies on the unpacked synopses to
+    // determine the unprunable fields.
+    if (requires_synopses(*resolved, type)) {
+      load_synopses(type);
+      unpacked_synopses_last_used[type] = num_lookups;
+      if (synopses.empty()) {
+        failed_schemas.push_back(type);
+        continue;
+      }
+    }
     auto pruned = prune(*resolved, unprunable_fields);
     auto candidates_per_type = lookup_impl(pruned, type);
     // Sort partitions by their max import time, returning the most recent
@@ -129,6 +222,11 @@ catalog_state::lookup(expression expr) const {
                                });
     total_candidates.candidate_infos[type] = std::move(candidates_per_type);
   }
+  for (const auto& schema : failed_schemas) {
+    synopses_per_type.erase(schema);
+    unpacked_synopses_last_used.erase(schema);
+  }
+  evict_synopses();
   auto delta = std::chrono::duration_cast<std::chrono::microseconds>(
     stopwatch::now() - start);
   TENZIR_VERBOSE("catalog found {} candidate partitions ({} events) in "
@@ -273,6 +371,13 @@ catalog_state::lookup_impl(const expression& expr, const type& schema) const {
               // at the schema names.
               catalog_lookup_result::candidate_info result;
               for (const auto& [part_id, part_syn] : partition_synopses) {
+                // Partition synopses with a schema are homogeneous, so we can
+                // avoid looking at their field synopses altogether.
+                if (part_syn->schema) {
+                  if (evaluate(std::string{part_syn->schema.name()}, x.op, d))
+                    result.partition_infos.emplace_back(part_id, *part_syn);
+                  continue;
+                }
                 for (const auto& [fqf, _] : part_syn->field_synopses_) {
                   // TODO: provide an overload for view of evaluate() so that
                   // we can use string_view here. Fortunately type names are
@@ -493,4 +493,25 @@ auto split(std::vector<chunk_ptr> chunks, size_t partition_point)
   };
 }
 
+auto join_lines(std::vector<chunk_ptr> messages) -> chunk_ptr {
+  TENZIR_ASSERT(not messages.empty());
+  if (messages.size() == 1) {
+    const auto& message = messages.front();
+    if (message->size() > 0
+        && message->data()[message->size() - 1] == std::byte{'\n'})
+      return std::move(messages.front());
+  }
+  auto size = size_t{0};
+  for (const auto& message : messages)
+    size += message->size() + 1;
+  auto buffer = std::vector<std::byte>{};
+  buffer.reserve(size);
+  for (const auto& message : messages) {
+    buffer.insert(buffer.end(), message->begin(), message->end());
+    if (message->size() == 0 || buffer.back() != std::byte{'\n'})
+      buffer.push_back(std::byte{'\n'});
+  }
+  return chunk::make(std::move(buffer));
+}
+
 } // namespace tenzir
@@ -18,8 +18,14 @@
 #include "tenzir/type.hpp"
 
 #include <arrow/record_batch.h>
+#include <arrow/util/bit_run_reader.h>
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
 #include <regex>
 #include <span>
 
@@ -214,26 +220,208 @@ struct cell_evaluator<relational_operator::not_ni> {
   }
 };
 
+// Dispatches to the cell evaluator for every relevant row.
+template <relational_operator Op, concrete_type LhsType, class Rhs>
+ids evaluate_cellwise(LhsType type, id offset, const arrow::Array& array,
+                      const Rhs& rhs, const ids& selection) noexcept {
+  ids result{};
+  for (auto id : select(selection)) {
+    TENZIR_ASSERT(id >= offset);
+    const auto row = detail::narrow_cast<int64_t>(id - offset);
+    // TODO: Instead of this in the loop, do selection &= array.null_bitmap
+    // outside of it.
+    if (array.IsNull(row))
+      continue;
+    result.append(false, id - result.size());
+    result.append(cell_evaluator<Op>::evaluate(value_at(type, array, row), rhs),
+                  1u);
+  }
+  result.append(false, offset + array.length() - result.size());
+  return result;
+}
+
 // The default implementation for the column evaluator that dispatches to the
 // cell evaluator for every relevant row.
 template <relational_operator Op, concrete_type LhsType, class Rhs>
 struct column_evaluator {
   static ids evaluate(LhsType type, id offset, const arrow::Array& array,
                       const Rhs& rhs, const ids& selection) noexcept {
-    ids result{};
-    for (auto id : select(selection)) {
-      TENZIR_ASSERT(id >= offset);
-      const auto row = detail::narrow_cast<int64_t>(id - offset);
-      // TODO: Instead of this in the loop, do selection &= array.null_bitmap
-      // outside of it.
-      if (array.IsNull(row))
+    return evaluate_cellwise<Op>(type, offset, array, rhs, selection);
+  }
+};
+
+// Returns the selected rows that are not null.
+ids valid_selection(id offset, const arrow::Array& array,
+                    const ids& selection) {
+  if (array.null_count() == 0)
+    return selection;
+  ids valid{};
+  arrow::internal::VisitSetBitRunsVoid(
+    array.null_bitmap_data(), array.offset(), array.length(),
+    [&](int64_t position, int64_t length) {
+      valid.append(false, offset + position - valid.size());
+      valid.append(true, length);
+    });
+  valid.append(false, offset + array.length() - valid.size());
+  return selection & valid;
+}
+
+// Evaluates a predicate on every selected non-null string, accessing the
+// Arrow buffers directly rather than going through data views.
+template <class Predicate>
+ids evaluate_strings(id offset, const arrow::StringArray& array,
+                     const ids& selection, Predicate predicate) {
+  ids result{};
+  for (auto id : select(selection)) {
+    const auto row = detail::narrow_cast<int64_t>(id - offset);
+    if (array.IsNull(row))
+      continue;
+    result.append(false, id - result.size());
+    result.append(predicate(array.GetView(row)), 1u);
+  }
+  result.append(false, offset + array.length() - result.size());
+  return result;
+}
+
+// Evaluates a predicate on every selected non-null string that contains the
+// non-empty `needle`. Instead of searching every string separately, this scans
+// the contiguous value buffer of the array with a Boyer-Moore-Horspool
+// searcher, which skips over large parts of the input and is most effective
+// when only few strings contain the needle.
+template <class Predicate>
+ids evaluate_strings_containing(id offset, const arrow::StringArray& array,
+                                std::string_view needle, const ids& selection,
+                                Predicate predicate) {
+  TENZIR_ASSERT(!needle.empty());
+  ids result{};
+  const auto length = array.length();
+  const auto* offsets = array.raw_value_offsets();
+  if (length > 0 && offsets[0] != offsets[length]) {
+    const auto* data = reinterpret_cast<const char*>(array.raw_data());
+    const auto* const last = data + offsets[length];
+    const auto searcher
+      = std::boyer_moore_horspool_searcher{needle.begin(), needle.end()};
+    const auto* it = data + offsets[0];
+    auto row = int64_t{0};
+    while (it != last) {
+      const auto* match = searcher(it, last).first;
+      if (match == last)
+        break;
+      const auto position = match - data;
+      // Find the row that the match starts in, and make sure that the match
+      // does not extend into the next row.
+      row = std::upper_bound(offsets + row + 1, offsets + length + 1, position)
+            - offsets - 1;
+      const auto row_end = offsets[row + 1];
+      if (position + std::ssize(needle) > row_end) {
+        it = match + 1;
         continue;
-      result.append(false, id - result.size());
-      result.append(
-        cell_evaluator<Op>::evaluate(value_at(type, array, row), rhs), 1u);
+      }
+      if (array.IsValid(row) && predicate(array.GetView(row))) {
+        result.append(false, offset + row - result.size());
+        result.append(true, 1u);
+      }
+      it = data + row_end;
+    }
+  }
+  result.append(false, offset + length - result.size());
+  return selection & result;
+}
+
+// For operations comparing string arrays with strings we use kernels that
+// operate on the Arrow buffers directly, and scan the entire array at once for
+// substring searches.
+template <relational_operator Op>
+struct column_evaluator<Op, string_type, std::string> {
+  static ids evaluate(string_type type, id offset, const arrow::Array& array,
+                      const std::string& rhs, const ids& selection) noexcept {
+    const auto& strings = caf::get<arrow::StringArray>(array);
+    if constexpr (Op == relational_operator::equal) {
+      return evaluate_strings(offset, strings, selection,
+                              [&](std::string_view value) {
+                                return value == rhs;
+                              });
+    } else if constexpr (Op == relational_operator::in) {
+      return evaluate_strings(offset, strings, selection,
+                              [&](std::string_view value) {
+                                return rhs.find(value) != std::string::npos;
+                              });
+    } else if constexpr (Op == relational_operator::ni) {
+      if (rhs.empty())
+        return valid_selection(offset, array, selection);
+      return evaluate_strings_containing(offset, strings, rhs, selection,
+                                         [](std::string_view) {
+                                           return true;
+                                         });
+    } else if constexpr (Op == relational_operator::not_equal) {
+      return valid_selection(offset, array, selection)
+             ^ column_evaluator<relational_operator::equal, string_type,
+                                std::string>::evaluate(type, offset, array, rhs,
+                                                       selection);
+    } else if constexpr (Op == relational_operator::not_in) {
+      return valid_selection(offset, array, selection)
+             ^ column_evaluator<relational_operator::in, string_type,
+                                std::string>::evaluate(type, offset, array, rhs,
+                                                       selection);
+    } else if constexpr (Op == relational_operator::not_ni) {
+      return valid_selection(offset, array, selection)
+             ^ column_evaluator<relational_operator::ni, string_type,
+                                std::string>::evaluate(type, offset, array, rhs,
+                                                       selection);
+    } else {
+      return evaluate_cellwise<Op>(type, offset, array, rhs, selection);
+    }
+  }
+};
+
+// For operations comparing string arrays with patterns we first look for the
+// literal that all matching strings must contain, and only run the regular
+// expression engine for the strings that contain it.
+template <relational_operator Op>
+struct column_evaluator<Op, string_type, pattern> {
+  static ids evaluate(string_type type, id offset, const arrow::Array& array,
+                      const pattern& rhs, const ids& selection) noexcept {
+    const auto& strings = caf::get<arrow::StringArray>(array);
+    const auto evaluate_pattern = [&](auto predicate) {
+      if (rhs.required_literal().empty())
+        return evaluate_strings(offset, strings, selection, predicate);
+      return evaluate_strings_containing(offset, strings,
+                                         rhs.required_literal(), selection,
+                                         predicate);
+    };
+    if constexpr (Op == relational_operator::equal) {
+      if (rhs.literal())
+        return column_evaluator<relational_operator::equal, string_type,
+                                std::string>::evaluate(type, offset, array,
+                                                       *rhs.literal(),
+                                                       selection);
+      return evaluate_pattern([&](std::string_view value) {
+        return rhs.match(value);
+      });
+    } else if constexpr (Op == relational_operator::in) {
+      // Note that `x in /pattern/` holds if the pattern matches a part of `x`,
+      // which makes this a plain substring search for literal patterns.
+      if (rhs.literal())
+        return column_evaluator<relational_operator::ni, string_type,
+                                std::string>::evaluate(type, offset, array,
+                                                       *rhs.literal(),
+                                                       selection);
+      return evaluate_pattern([&](std::string_view value) {
+        return rhs.search(value);
+      });
+    } else if constexpr (Op == relational_operator::not_equal) {
+      return valid_selection(offset, array, selection)
+             ^ column_evaluator<relational_operator::equal, string_type,
+                                pattern>::evaluate(type, offset, array, rhs,
+                                                   selection);
+    } else if constexpr (Op == relational_operator::not_in) {
+      return valid_selection(offset, array, selection)
+             ^ column_evaluator<relational_operator::in, string_type,
+                                pattern>::evaluate(type, offset, array, rhs,
+                                                   selection);
+    } else {
+      return evaluate_cellwise<Op>(type, offset, array, rhs, selection);
     }
-    result.append(false, offset + array.length() - result.size());
-    return result;
   }
 };
 
@@ -312,6 +500,38 @@ struct column_evaluator<Op, enumeration_type, std::string> {
   }
 };
 
+// For operations comparing enumeration arrays with a pattern we evaluate the
+// pattern at most once per distinct enumeration value, and then only look at
+// the dictionary indices.
+template <relational_operator Op>
+struct column_evaluator<Op, enumeration_type, pattern> {
+  static ids
+  evaluate(enumeration_type type, id offset, const arrow::Array& array,
+           const pattern& rhs, const ids& selection) noexcept {
+    const auto dictionary
+      = caf::get<type_to_arrow_array_t<enumeration_type>>(array).storage();
+    constexpr auto num_keys
+      = size_t{std::numeric_limits<view<enumeration>>::max()} + 1;
+    auto results = std::array<std::optional<bool>, num_keys>{};
+    ids result{};
+    for (auto id : select(selection)) {
+      TENZIR_ASSERT(id >= offset);
+      const auto row = detail::narrow_cast<int64_t>(id - offset);
+      if (array.IsNull(row))
+        continue;
+      const auto key = detail::narrow_cast<view<enumeration>>(
+        dictionary->GetValueIndex(row));
+      auto& matches = results[key];
+      if (!matches)
+        matches = cell_evaluator<Op>::evaluate(type.field(key), rhs);
+      result.append(false, id - result.size());
+      result.append(*matches, 1u);
+    }
+    result.append(false, offset + array.length() - result.size());
+    return result;
+  }
+};
+
 // A utility function for evaluating meta extractors in predicates. This is
 // always a yes or no question per batch, so the function does not have to deal
 // with bitmaps at all.
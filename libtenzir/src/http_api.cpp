@@ -297,6 +297,21 @@ auto rest_response::from_json_string(std::string json) -> rest_response {
   return result;
 }
 
+auto rest_response::from_chunks(std::vector<chunk_ptr> chunks,
+                                http_content_type content_type)
+  -> rest_response {
+  auto result = rest_response{};
+  result.code_ = 200;
+  result.body_.clear();
+  result.chunks_ = std::move(chunks);
+  result.content_type_ = content_type;
+  return result;
+}
+
+void rest_response::add_header(std::string field, std::string value) {
+  headers_.emplace_back(std::move(field), std::move(value));
+}
+
 auto rest_response::is_error() const -> bool {
   return is_error_;
 }
@@ -305,10 +320,24 @@ auto rest_response::body() const -> const std::string& {
   return body_;
 }
 
+auto rest_response::chunks() const -> const std::vector<chunk_ptr>& {
+  return chunks_;
+}
+
 auto rest_response::code() const -> size_t {
   return code_;
 }
 
+auto rest_response::content_type() const
+  -> const std::optional<http_content_type>& {
+  return content_type_;
+}
+
+auto rest_response::headers() const
+  -> const std::vector<std::pair<std::string, std::string>>& {
+  return headers_;
+}
+
 auto rest_response::error_detail() const -> const caf::error& {
   return detail_;
 }
@@ -317,6 +346,10 @@ auto rest_response::release() && -> std::string {
   return std::move(body_);
 }
 
+auto rest_response::release_chunks() && -> std::vector<chunk_ptr> {
+  return std::move(chunks_);
+}
+
 auto rest_response::make_error(uint16_t error_code, std::string_view message,
                                caf::error detail) -> rest_response {
   return make_error_raw(error_code,
@@ -20,6 +20,7 @@
 #include "tenzir/detail/shutdown_stream_stage.hpp"
 #include "tenzir/detail/weak_run_delayed.hpp"
 #include "tenzir/error.hpp"
+#include "tenzir/live_query_hub.hpp"
 #include "tenzir/logger.hpp"
 #include "tenzir/plugin.hpp"
 #include "tenzir/report.hpp"
@@ -203,6 +204,9 @@ importer(importer_actor::stateful_pointer<importer_state> self,
   namespace defs = defaults;
   self->set_exit_handler([=](const caf::exit_msg& msg) {
     self->state.send_report();
+    if (self->state.live_query_hub) {
+      self->send_exit(self->state.live_query_hub, msg.reason);
+    }
     for (auto* inbound : self->state.stage->inbound_paths()) {
       self->send_exit(inbound->hdl, msg.reason);
     }
@@ -229,6 +233,10 @@ importer(importer_actor::stateful_pointer<importer_state> self,
                          return subscriber.address() == msg.source;
                        });
     self->state.subscribers.erase(subscriber, self->state.subscribers.end());
+    if (self->state.live_query_hub
+        and self->state.live_query_hub.address() == msg.source) {
+      self->state.live_query_hub = {};
+    }
   });
   return {
     // Add a new sink.
@@ -248,6 +256,16 @@ importer(importer_actor::stateful_pointer<importer_state> self,
       self->monitor(subscriber);
       self->state.subscribers.push_back(subscriber);
     },
+    [self](atom::get, atom::query) -> caf::result<live_query_hub_actor> {
+      if (not self->state.live_query_hub) {
+        self->state.live_query_hub
+          = self->spawn(tenzir::live_query_hub,
+                       caf::actor_cast<importer_actor>(self));
+        self->monitor(self->state.live_query_hub);
+        self->state.subscribers.push_back(self->state.live_query_hub);
+      }
+      return self->state.live_query_hub;
+    },
     // Push buffered slices downstream to make the data available.
     [self](atom::flush) -> caf::result<void> {
       auto rp = self->make_response_promise<void>();
@@ -537,19 +537,12 @@ caf::error index_state::load_from_disk() {
         if (auto error = extract_partition_synopsis(part_path, synopsis_path))
           return error;
       }
-      auto chunk = chunk::mmap(synopsis_path);
-      if (!chunk)
-        return chunk.error();
-      const auto* ps_flatbuffer
-        = fbs::GetPartitionSynopsis(chunk->get()->data());
+      // We only unpack the partition metadata here and leave the field and
+      // type synopses on disk. The catalog unpacks them when a query needs
+      // them, which keeps startup fast and the memory usage of the catalog low
+      // regardless of the number of partitions.
       partition_synopsis_ptr ps = caf::make_copy_on_write<partition_synopsis>();
-      if (ps_flatbuffer->partition_synopsis_type()
-          != fbs::partition_synopsis::PartitionSynopsis::legacy)
-        return caf::make_error(ec::format_error, "invalid partition synopsis "
-                                                 "version");
-      const auto& synopsis_legacy
-        = *ps_flatbuffer->partition_synopsis_as_legacy();
-      if (auto error = unpack(synopsis_legacy, ps.unshared()))
+      if (auto error = unpack_lazily(synopsis_path, ps.unshared()))
         return error;
       // Add partition file sizes.
       {
@@ -564,9 +557,17 @@ caf::error index_state::load_from_disk() {
           .url = fmt::format("file://{}", canonical(part_path)),
           .size = bitmap_file_size,
         };
+        uint64_t synopsis_file_size
+          = std::filesystem::file_size(synopsis_path, err);
+        if (err) {
+          TENZIR_WARN("failed to get the size of the partition synopsis file "
+                      "at {}: {}",
+                      synopsis_path, err.message());
+          synopsis_file_size = 0u;
+        }
         ps.unshared().sketches_file = {
           .url = fmt::format("file://{}", canonical(synopsis_path)),
-          .size = chunk->get()->size(),
+          .size = synopsis_file_size,
         };
         auto f = store_map.find(partition_uuid);
         if (f == store_map.end()) {
@@ -954,6 +955,12 @@ auto index_state::schedule_lookups() -> size_t {
             TENZIR_DEBUG("{} received {} results for query {} from partition "
                          "{}",
                          *self, n, qid, pid);
+            if (auto client = pending_queries.handle_results(qid, n)) {
+              TENZIR_DEBUG("{} completes query {} early because it reached "
+                           "its limit",
+                           *self, qid);
+              self->send(*client, atom::done_v);
+            }
             handle_completion();
           },
           [this, handle_completion, qid,
@@ -1183,6 +1190,7 @@ index(index_actor::stateful_pointer<index_state> self,
                  "size of {} events and {} resident partitions",
                  *self, dir, partition_capacity, max_inmem_partitions);
   self->state.index_opts["cardinality"] = partition_capacity;
+  self->state.index_opts["roaring-bitmaps"] = index_config.roaring_bitmaps;
   self->state.synopsis_opts = std::move(index_config);
   if (dir != catalog_dir)
     TENZIR_VERBOSE("{} uses {} for catalog data", *self, catalog_dir);
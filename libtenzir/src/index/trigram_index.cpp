@@ -0,0 +1,240 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/index/trigram_index.hpp"
+
+#include "tenzir/bitmap_algorithms.hpp"
+#include "tenzir/defaults.hpp"
+#include "tenzir/detail/assert.hpp"
+#include "tenzir/detail/inspection_common.hpp"
+#include "tenzir/detail/legacy_deserialize.hpp"
+#include "tenzir/detail/overload.hpp"
+#include "tenzir/fbs/value_index.hpp"
+#include "tenzir/index/container_lookup.hpp"
+#include "tenzir/logger.hpp"
+#include "tenzir/pattern.hpp"
+#include "tenzir/type.hpp"
+
+#include <caf/binary_serializer.hpp>
+#include <caf/serializer.hpp>
+#include <caf/settings.hpp>
+
+#include <algorithm>
+
+namespace tenzir {
+
+namespace {
+
+/// The approximate memory overhead of a trigram in addition to its postings.
+constexpr auto trigram_overhead = sizeof(uint32_t) + sizeof(ewah_bitmap);
+
+/// Collects the unique trigrams of a string, each packed into the lower three
+/// bytes of an integer.
+void make_trigrams(std::string_view str, std::vector<uint32_t>& result) {
+  result.clear();
+  if (str.size() < 3)
+    return;
+  result.reserve(str.size() - 2);
+  for (size_t i = 0; i + 2 < str.size(); ++i)
+    result.push_back(uint32_t{static_cast<uint8_t>(str[i])} << 16
+                     | uint32_t{static_cast<uint8_t>(str[i + 1])} << 8
+                     | uint32_t{static_cast<uint8_t>(str[i + 2])});
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+} // namespace
+
+trigram_index::trigram_index(tenzir::type t, caf::settings opts)
+  : value_index{std::move(t), std::move(opts)} {
+  max_size_ = caf::get_or(options(), "max-size",
+                          defaults::index::max_trigram_index_size);
+}
+
+bool trigram_index::serialize(auto& serializer) {
+  auto trigrams = std::vector<uint32_t>{};
+  auto postings = std::vector<ewah_bitmap>{};
+  trigrams.reserve(postings_.size());
+  postings.reserve(postings_.size());
+  for (const auto& [trigram, posting] : postings_) {
+    trigrams.push_back(trigram);
+    postings.push_back(posting);
+  }
+  return detail::apply_all(serializer, saturated_, trigrams, postings);
+}
+
+bool trigram_index::deserialize(auto& deserializer) {
+  auto trigrams = std::vector<uint32_t>{};
+  auto postings = std::vector<ewah_bitmap>{};
+  if (!detail::apply_all(deserializer, saturated_, trigrams, postings))
+    return false;
+  if (trigrams.size() != postings.size())
+    return false;
+  postings_.clear();
+  postings_.reserve(trigrams.size());
+  postings_size_ = 0;
+  for (size_t i = 0; i < trigrams.size(); ++i) {
+    postings_size_ += postings[i].memusage() + trigram_overhead;
+    postings_.emplace(trigrams[i], std::move(postings[i]));
+  }
+  return true;
+}
+
+bool trigram_index::inspect_impl(supported_inspectors& inspector) {
+  return value_index::inspect_impl(inspector)
+         && std::visit(
+           [this]<class Inspector>(std::reference_wrapper<Inspector> visitor) {
+             if constexpr (Inspector::is_loading) {
+               return this->deserialize(visitor.get());
+             } else {
+               return this->serialize(visitor.get());
+             }
+           },
+           inspector);
+}
+
+bool trigram_index::saturated() const {
+  return saturated_;
+}
+
+bool trigram_index::append_impl(data_view x, id pos) {
+  auto str = caf::get_if<view<std::string>>(&x);
+  if (!str)
+    return false;
+  if (saturated_)
+    return true;
+  make_trigrams(*str, scratch_);
+  for (auto trigram : scratch_) {
+    auto [it, inserted] = postings_.try_emplace(trigram);
+    auto& posting = it.value();
+    const auto old_size = posting.memusage();
+    posting.append_bits(false, pos - posting.size());
+    posting.append_bit(true);
+    postings_size_ += posting.memusage() - old_size;
+    if (inserted)
+      postings_size_ += trigram_overhead;
+  }
+  if (postings_size_ > max_size_)
+    saturate();
+  return true;
+}
+
+caf::expected<ids>
+trigram_index::lookup_impl(relational_operator op, data_view x) const {
+  auto f = detail::overload{
+    [&](auto x) -> caf::expected<ids> {
+      return caf::make_error(ec::type_clash, materialize(x));
+    },
+    [&](view<pattern> x) -> caf::expected<ids> {
+      switch (op) {
+        default:
+          return caf::make_error(ec::unsupported_operator, op);
+        case relational_operator::equal:
+          if (x.case_insensitive())
+            return ids{offset(), true};
+          return candidates(detail::regex_required_literal(x.string()));
+        case relational_operator::not_equal:
+          return ids{offset(), true};
+      }
+    },
+    [&](view<std::string> str) -> caf::expected<ids> {
+      switch (op) {
+        case relational_operator::equal:
+        case relational_operator::ni:
+          // Every string that equals or contains *str* must contain all of
+          // its trigrams.
+          return candidates(str);
+        default:
+          // The index cannot rule out any position for the remaining
+          // operators, so we leave the evaluation to the store.
+          return ids{offset(), true};
+      }
+    },
+    [&](view<list> xs) {
+      return detail::container_lookup(*this, op, xs);
+    },
+  };
+  return caf::visit(f, x);
+}
+
+size_t trigram_index::memusage_impl() const {
+  return postings_size_ + scratch_.capacity() * sizeof(uint32_t);
+}
+
+flatbuffers::Offset<fbs::ValueIndex> trigram_index::pack_impl(
+  flatbuffers::FlatBufferBuilder& builder,
+  flatbuffers::Offset<fbs::value_index::detail::ValueIndexBase> base_offset) {
+  auto trigrams = std::vector<uint32_t>{};
+  trigrams.reserve(postings_.size());
+  for (const auto& [trigram, _] : postings_)
+    trigrams.push_back(trigram);
+  std::sort(trigrams.begin(), trigrams.end());
+  auto posting_offsets
+    = std::vector<flatbuffers::Offset<fbs::bitmap::EWAHBitmap>>{};
+  posting_offsets.reserve(trigrams.size());
+  for (auto trigram : trigrams)
+    posting_offsets.push_back(pack(builder, postings_.at(trigram)));
+  const auto trigram_index_offset = fbs::value_index::CreateTrigramIndexDirect(
+    builder, base_offset, &trigrams, &posting_offsets, saturated_);
+  return fbs::CreateValueIndex(builder, fbs::value_index::ValueIndex::trigram,
+                               trigram_index_offset.Union());
+}
+
+caf::error trigram_index::unpack_impl(const fbs::ValueIndex& from) {
+  const auto* from_trigram = from.value_index_as_trigram();
+  TENZIR_ASSERT(from_trigram);
+  if (from_trigram->trigrams()->size() != from_trigram->postings()->size())
+    return caf::make_error(ec::format_error,
+                           "invalid tenzir.fbs.value_index.TrigramIndex: "
+                           "mismatching number of trigrams and postings");
+  saturated_ = from_trigram->saturated();
+  postings_.clear();
+  postings_.reserve(from_trigram->trigrams()->size());
+  postings_size_ = 0;
+  for (size_t i = 0; i < from_trigram->trigrams()->size(); ++i) {
+    auto& posting = postings_[from_trigram->trigrams()->Get(i)];
+    if (auto err = unpack(*from_trigram->postings()->Get(i), posting))
+      return err;
+    postings_size_ += posting.memusage() + trigram_overhead;
+  }
+  return caf::none;
+}
+
+ids trigram_index::candidates(std::string_view needle) const {
+  if (saturated_ || needle.size() < 3)
+    return ids{offset(), true};
+  auto trigrams = std::vector<uint32_t>{};
+  make_trigrams(needle, trigrams);
+  auto postings = std::vector<const ewah_bitmap*>{};
+  postings.reserve(trigrams.size());
+  for (auto trigram : trigrams) {
+    auto it = postings_.find(trigram);
+    if (it == postings_.end())
+      return ids{offset(), false};
+    postings.push_back(&it->second);
+  }
+  // Intersecting the smallest postings first keeps intermediate results small
+  // and allows for stopping early.
+  std::sort(postings.begin(), postings.end(), [](const auto* x, const auto* y) {
+    return x->memusage() < y->memusage();
+  });
+  auto result = *postings.front();
+  for (size_t i = 1; i < postings.size() && any<1>(result); ++i)
+    result = binary_and(result, *postings[i]);
+  return ids{std::move(result)};
+}
+
+void trigram_index::saturate() {
+  TENZIR_DEBUG("trigram index exceeded its maximum size of {} bytes",
+               max_size_);
+  saturated_ = true;
+  postings_ = {};
+  postings_size_ = 0;
+}
+
+} // namespace tenzir
@@ -65,4 +65,13 @@ bool should_create_partition_index(
   return true;
 }
 
+bool should_create_trigram_index(const qualified_record_field& index_qf,
+                                 const std::vector<index_config::rule>& rules) {
+  if (!caf::holds_alternative<string_type>(index_qf.type()))
+    return false;
+  return std::any_of(rules.begin(), rules.end(), [&](const auto& rule) {
+    return rule.create_trigram_index && should_use_rule(rule.targets, index_qf);
+  });
+}
+
 } // namespace tenzir
@@ -12,91 +12,13 @@
 
 #include "tenzir/concept/printable/tenzir/expression.hpp"
 #include "tenzir/detail/assert.hpp"
-#include "tenzir/detail/fill_status_map.hpp"
 #include "tenzir/logger.hpp"
-#include "tenzir/status.hpp"
-#include "tenzir/table_slice.hpp"
 #include "tenzir/type.hpp"
 #include "tenzir/value_index.hpp"
 #include "tenzir/view.hpp"
 
-#include <caf/attach_stream_sink.hpp>
-
 namespace tenzir {
 
-active_indexer_actor::behavior_type
-active_indexer(active_indexer_actor::stateful_pointer<indexer_state> self,
-               size_t column, value_index_ptr index) {
-  TENZIR_ASSERT(index);
-  TENZIR_DEBUG("{} spawned as active indexer for type {}", *self,
-               index->type());
-  self->state.column = column;
-  self->state.idx = std::move(index);
-  return {
-    [self](caf::stream<table_slice> in)
-      -> caf::result<caf::inbound_stream_slot<table_slice>> {
-      TENZIR_TRACE("{} got a new stream", *self);
-      self->state.stream_initiated = true;
-      auto result = caf::attach_stream_sink(
-        self, in,
-        [=](caf::unit_t&) {
-          TENZIR_TRACE("{} initializes stream", *self);
-        },
-        [self](caf::unit_t&, const std::vector<table_slice>& slices) {
-          TENZIR_ASSERT(self->state.idx != nullptr);
-          for (const auto& slice : slices)
-            slice.append_column_to_index(self->state.column, *self->state.idx);
-        },
-        [self, id = self->id()](caf::unit_t&, const caf::error& err) {
-          TENZIR_TRACE("indexer-{} is closing stream", id);
-          if (err) {
-            // Exit reason `unreachable` is generated by CAF and will arrive
-            // after that the actor state was destroyed, so we can't safely
-            // access `self->state` here.
-            // TODO: We also need to deliver the promise here *if* self
-            // still exists and the promise is already pending.
-            TENZIR_ERROR("indexer got a stream error: {}", render(err));
-            return;
-          }
-          if (self->state.promise.pending())
-            self->state.promise.deliver(chunkify(self->state.idx));
-        });
-      return result.inbound_slot();
-    },
-    [self](atom::evaluate, const curried_predicate& pred) -> caf::result<ids> {
-      TENZIR_DEBUG("{} got predicate: {}", *self, pred);
-      TENZIR_ASSERT(self->state.idx);
-      auto& idx = *self->state.idx;
-      auto rep = to_internal(idx.type(), make_view(pred.rhs));
-      return idx.lookup(pred.op, rep);
-    },
-    [self](atom::snapshot) {
-      // The partition is only allowed to send a single snapshot atom.
-      TENZIR_ASSERT(!self->state.promise.pending());
-      self->state.promise = self->make_response_promise<chunk_ptr>();
-      // Checking 'idle()' is not enough, since we emprically can
-      // have data that was flushed in the upstream stage but is not
-      // yet visible to the sink.
-      if (self->state.stream_initiated
-          && (self->stream_managers().empty()
-              || self->stream_managers().begin()->second->done())) {
-        self->state.promise.deliver(chunkify(self->state.idx));
-      }
-      return self->state.promise;
-    },
-    [self](atom::shutdown) {
-      self->quit(caf::exit_reason::user_shutdown);
-    },
-    [self](atom::status, status_verbosity v, duration /*d*/) {
-      record result;
-      result["memory-usage"] = uint64_t{self->state.idx->memusage()};
-      if (v >= status_verbosity::debug)
-        detail::fill_status_map(result, self);
-      return result;
-    },
-  };
-}
-
 indexer_actor::behavior_type
 passive_indexer(indexer_actor::stateful_pointer<indexer_state> self,
                 uuid partition_id, value_index_ptr index) {
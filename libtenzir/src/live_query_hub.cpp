@@ -0,0 +1,137 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/live_query_hub.hpp"
+
+#include "tenzir/atoms.hpp"
+#include "tenzir/defaults.hpp"
+#include "tenzir/detail/weak_run_delayed.hpp"
+#include "tenzir/error.hpp"
+#include "tenzir/logger.hpp"
+#include "tenzir/series_builder.hpp"
+
+#include <caf/typed_event_based_actor.hpp>
+
+namespace tenzir {
+
+void live_query_hub_state::send_metrics() {
+  if (not importer or subscribers.empty()) {
+    return;
+  }
+  auto builder = series_builder{
+    type{"tenzir.metrics.live", record_type{}, {{"internal", ""}}}};
+  const auto now = time{std::chrono::system_clock::now()};
+  for (auto& [id, subscriber] : subscribers) {
+    auto event = builder.record();
+    event.field("timestamp", now);
+    event.field("id", id);
+    const auto expr = fmt::to_string(subscriber.expr);
+    event.field("expression", std::string_view{expr});
+    event.field("buffered", subscriber.num_buffered);
+    event.field("delivered", std::exchange(subscriber.num_delivered, 0));
+    event.field("dropped", std::exchange(subscriber.num_dropped, 0));
+  }
+  for (auto& slice : builder.finish_as_table_slice()) {
+    self->send(importer, std::move(slice));
+  }
+}
+
+auto live_query_hub(live_query_hub_actor::stateful_pointer<live_query_hub_state>
+                      self,
+                    importer_actor importer)
+  -> live_query_hub_actor::behavior_type {
+  self->state.self = self;
+  self->state.importer = std::move(importer);
+  self->set_down_handler([self](const caf::down_msg& msg) {
+    auto& subscribers = self->state.subscribers;
+    for (auto it = subscribers.begin(); it != subscribers.end();) {
+      if (it->second.client == msg.source) {
+        TENZIR_DEBUG("{} removes live query {}", *self, it->first);
+        self->state.filter.erase(it->first);
+        it = subscribers.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  });
+  detail::weak_run_delayed_loop(self, defaults::telemetry_rate, [self] {
+    self->state.send_metrics();
+  });
+  return {
+    [self](atom::subscribe, expression& expr) -> caf::result<uint64_t> {
+      const auto id = self->state.next_id++;
+      auto client = self->current_sender();
+      if (client) {
+        self->monitor(client);
+      }
+      TENZIR_DEBUG("{} adds live query {}: {}", *self, id, expr);
+      self->state.filter.add(id, expr);
+      self->state.subscribers.emplace(
+        id, live_query_subscriber{
+              .client = caf::actor_cast<caf::actor_addr>(client),
+              .expr = std::move(expr),
+            });
+      return id;
+    },
+    [self](atom::get, uint64_t id) -> caf::result<table_slice> {
+      auto it = self->state.subscribers.find(id);
+      if (it == self->state.subscribers.end()) {
+        return caf::make_error(ec::lookup_error,
+                               fmt::format("unknown live query {}", id));
+      }
+      auto& subscriber = it->second;
+      if (subscriber.rp.pending()) {
+        return caf::make_error(ec::logic_error,
+                               "live query hub promise out of sync");
+      }
+      if (subscriber.buffer.empty()) {
+        subscriber.dropping = false;
+        subscriber.rp = self->make_response_promise<table_slice>();
+        return subscriber.rp;
+      }
+      auto result = std::move(subscriber.buffer.front());
+      subscriber.buffer.pop_front();
+      subscriber.num_buffered -= result.rows();
+      subscriber.num_delivered += result.rows();
+      return result;
+    },
+    [self](atom::erase, uint64_t id) -> caf::result<void> {
+      self->state.filter.erase(id);
+      self->state.subscribers.erase(id);
+      return {};
+    },
+    [self](table_slice& slice) -> caf::result<void> {
+      for (auto& [id, matching] : self->state.filter.apply(slice)) {
+        auto it = self->state.subscribers.find(id);
+        TENZIR_ASSERT(it != self->state.subscribers.end());
+        auto& subscriber = it->second;
+        if (subscriber.rp.pending()) {
+          subscriber.num_delivered += matching.rows();
+          subscriber.rp.deliver(std::move(matching));
+          continue;
+        }
+        if (subscriber.num_buffered + matching.rows()
+            > defaults::max_buffered_live_events) {
+          if (not subscriber.dropping) {
+            TENZIR_WARN("{} drops events for live query {} because it failed "
+                        "to keep up",
+                        *self, id);
+            subscriber.dropping = true;
+          }
+          subscriber.num_dropped += matching.rows();
+          continue;
+        }
+        subscriber.num_buffered += matching.rows();
+        subscriber.buffer.push_back(std::move(matching));
+      }
+      return {};
+    },
+  };
+}
+
+} // namespace tenzir
@@ -0,0 +1,163 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/multi_query_filter.hpp"
+
+#include "tenzir/detail/overload.hpp"
+#include "tenzir/ids.hpp"
+
+#include <algorithm>
+
+namespace tenzir {
+
+void multi_query_filter::add(uint64_t id, expression expr) {
+  queries_.emplace_back(id, std::move(expr));
+  bound_.clear();
+}
+
+void multi_query_filter::erase(uint64_t id) {
+  const auto it = std::remove_if(queries_.begin(), queries_.end(),
+                                 [&](const auto& query) {
+                                   return query.first == id;
+                                 });
+  if (it == queries_.end()) {
+    return;
+  }
+  queries_.erase(it, queries_.end());
+  bound_.clear();
+}
+
+auto multi_query_filter::size() const -> size_t {
+  return queries_.size();
+}
+
+auto multi_query_filter::bind(const type& schema) -> const bound_queries& {
+  if (auto it = bound_.find(schema); it != bound_.end()) {
+    return it->second;
+  }
+  auto result = bound_queries{};
+  const auto collect_predicates = [&](const auto& self,
+                                      const expression& expr) -> void {
+    caf::visit(detail::overload{
+                 [](const caf::none_t&) {},
+                 [&](const negation& x) {
+                   self(self, x.expr());
+                 },
+                 [&](const conjunction& x) {
+                   for (const auto& operand : x) {
+                     self(self, operand);
+                   }
+                 },
+                 [&](const disjunction& x) {
+                   for (const auto& operand : x) {
+                     self(self, operand);
+                   }
+                 },
+                 [&](const predicate& x) {
+                   const auto [_, inserted] = result.predicate_indices.emplace(
+                     x, result.predicates.size());
+                   if (inserted) {
+                     result.predicates.emplace_back(x);
+                   }
+                 },
+               },
+               expr);
+  };
+  for (const auto& [id, expr] : queries_) {
+    if (caf::holds_alternative<caf::none_t>(expr)) {
+      result.queries.emplace_back(id, expr);
+      continue;
+    }
+    // Queries that cannot be tailored to the schema never match.
+    auto tailored = tailor(expr, schema);
+    if (not tailored) {
+      continue;
+    }
+    collect_predicates(collect_predicates, *tailored);
+    result.queries.emplace_back(id, std::move(*tailored));
+  }
+  return bound_.emplace(schema, std::move(result)).first->second;
+}
+
+auto multi_query_filter::apply(const table_slice& slice)
+  -> std::vector<std::pair<uint64_t, table_slice>> {
+  auto result = std::vector<std::pair<uint64_t, table_slice>>{};
+  if (slice.rows() == 0 or queries_.empty()) {
+    return result;
+  }
+  const auto& bound = bind(slice.schema());
+  const auto offset = slice.offset() == invalid_id ? 0 : slice.offset();
+  auto all = ids{};
+  all.append(false, offset);
+  all.append(true, slice.rows());
+  const auto none = ids{offset + slice.rows(), false};
+  // Every distinct predicate is evaluated at most once over the entire slice,
+  // and only once an expression actually needs it.
+  auto predicate_results = std::vector<std::optional<ids>>(
+    bound.predicates.size());
+  const auto evaluate_predicate = [&](const predicate& x) -> const ids& {
+    const auto index = bound.predicate_indices.find(x);
+    TENZIR_ASSERT(index != bound.predicate_indices.end());
+    auto& cached = predicate_results[index->second];
+    if (not cached) {
+      cached = evaluate(bound.predicates[index->second], slice, {});
+    }
+    return *cached;
+  };
+  const auto evaluate_expression
+    = [&](const auto& self, const expression& expr) -> ids {
+    return caf::visit(detail::overload{
+                        [&](const caf::none_t&) -> ids {
+                          return all;
+                        },
+                        [&](const negation& x) -> ids {
+                          return all ^ self(self, x.expr());
+                        },
+                        [&](const conjunction& x) -> ids {
+                          auto selection = all;
+                          for (const auto& operand : x) {
+                            if (not any(selection)) {
+                              break;
+                            }
+                            selection &= self(self, operand);
+                          }
+                          return selection;
+                        },
+                        [&](const disjunction& x) -> ids {
+                          auto selection = none;
+                          for (const auto& operand : x) {
+                            if (rank(selection) == slice.rows()) {
+                              break;
+                            }
+                            selection |= self(self, operand);
+                          }
+                          return selection;
+                        },
+                        [&](const predicate& x) -> ids {
+                          return evaluate_predicate(x);
+                        },
+                      },
+                      expr);
+  };
+  for (const auto& [id, expr] : bound.queries) {
+    auto selection = evaluate_expression(evaluate_expression, expr);
+    if (not any(selection)) {
+      continue;
+    }
+    if (rank(selection) == slice.rows()) {
+      result.emplace_back(id, slice);
+      continue;
+    }
+    if (auto filtered = filter(slice, selection)) {
+      result.emplace_back(id, std::move(*filtered));
+    }
+  }
+  return result;
+}
+
+} // namespace tenzir
@@ -0,0 +1,355 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/object_storage.hpp"
+
+#include "tenzir/argument_parser.hpp"
+#include "tenzir/data.hpp"
+#include "tenzir/detail/assert.hpp"
+#include "tenzir/detail/narrow.hpp"
+#include "tenzir/diagnostics.hpp"
+#include "tenzir/error.hpp"
+#include "tenzir/logger.hpp"
+
+#include <arrow/buffer.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/util/future.h>
+#include <arrow/util/thread_pool.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <deque>
+#include <string_view>
+#include <thread>
+
+namespace tenzir {
+
+namespace {
+
+/// The maximum number of threads that perform the requests of a single call to
+/// `read_objects`. Further requests queue up.
+constexpr auto max_read_threads = uint64_t{32};
+
+/// How long `read_objects` waits for a request before yielding an empty
+/// chunk, in seconds.
+constexpr auto poll_timeout = 0.1;
+
+/// An object that we are reading from.
+struct active_object {
+  arrow::fs::FileInfo info = {};
+  arrow::Future<std::shared_ptr<arrow::io::RandomAccessFile>> opened = {};
+  std::shared_ptr<arrow::io::RandomAccessFile> file = {};
+  int64_t size = {};
+  int64_t next_offset = {};
+  std::deque<arrow::Future<std::shared_ptr<arrow::Buffer>>> pending = {};
+
+  /// Returns whether the object has data or an error available, or is done.
+  auto is_ready() const -> bool {
+    if (not file)
+      return opened.is_finished();
+    return pending.empty() || pending.front().is_finished();
+  }
+
+  /// Waits up to `seconds` for the object to become ready.
+  auto wait(double seconds) const -> bool {
+    if (not file)
+      return opened.Wait(seconds);
+    return pending.empty() || pending.front().Wait(seconds);
+  }
+};
+
+/// Calls `f` until it succeeds or the retries are exhausted, backing off
+/// exponentially in between. This blocks, so it must run on the thread pool
+/// of `read_objects` rather than on the pipeline thread.
+template <class F>
+auto with_retries(const object_read_options& options, std::string_view what,
+                  F f) -> decltype(f()) {
+  auto result = f();
+  auto backoff = options.initial_backoff;
+  for (uint64_t i = 0; i < options.max_retries && not result.ok(); ++i) {
+    TENZIR_DEBUG("retrying to {} in {}: {}", what, data{backoff},
+                 result.status().ToString());
+    std::this_thread::sleep_for(backoff);
+    backoff *= 2;
+    result = f();
+  }
+  return result;
+}
+
+/// Matches `path` against `pattern`, where `*` matches any characters except
+/// `/`, `**` matches any characters including `/`, and `**/` also matches the
+/// empty string. All other characters match themselves.
+auto matches_glob(std::string_view pattern, std::string_view path) -> bool {
+  while (not pattern.empty()) {
+    if (pattern.starts_with("**")) {
+      if (pattern.starts_with("**/") && matches_glob(pattern.substr(3), path))
+        return true;
+      pattern.remove_prefix(2);
+      for (auto i = size_t{0}; i <= path.size(); ++i)
+        if (matches_glob(pattern, path.substr(i)))
+          return true;
+      return false;
+    }
+    if (pattern.front() == '*') {
+      pattern.remove_prefix(1);
+      for (auto i = size_t{0}; i <= path.size(); ++i) {
+        if (matches_glob(pattern, path.substr(i)))
+          return true;
+        if (i < path.size() && path[i] == '/')
+          return false;
+      }
+      return false;
+    }
+    if (path.empty() || pattern.front() != path.front())
+      return false;
+    pattern.remove_prefix(1);
+    path.remove_prefix(1);
+  }
+  return path.empty();
+}
+
+} // namespace
+
+void object_read_args::add_to(argument_parser& parser) {
+  parser.add("--prefetch", prefetch, "<count>");
+  parser.add("--concurrency", concurrency, "<count>");
+  parser.add("--unordered", unordered);
+}
+
+void object_read_args::validate() const {
+  const auto check = [](const std::optional<located<uint64_t>>& option,
+                        uint64_t max) {
+    if (option and (option->inner == 0 or option->inner > max)) {
+      diagnostic::error("value must be between 1 and {}", max)
+        .primary(option->source)
+        .throw_();
+    }
+  };
+  check(prefetch, max_object_prefetch);
+  check(concurrency, max_object_concurrency);
+}
+
+auto object_read_args::to_options(uint64_t range_size) const
+  -> object_read_options {
+  auto result = object_read_options{};
+  result.range_size = range_size;
+  if (prefetch)
+    result.prefetch = prefetch->inner;
+  if (concurrency)
+    result.concurrency = concurrency->inner;
+  result.unordered = unordered;
+  return result;
+}
+
+auto expand_object_paths(arrow::fs::FileSystem& fs, std::string path)
+  -> caf::expected<std::vector<arrow::fs::FileInfo>> {
+  auto result = std::vector<arrow::fs::FileInfo>{};
+  const auto list = [&](arrow::fs::FileSelector selector)
+    -> caf::expected<std::vector<arrow::fs::FileInfo>> {
+    auto infos = fs.GetFileInfo(selector);
+    if (not infos.ok())
+      return caf::make_error(ec::filesystem_error,
+                             fmt::format("failed to list `{}`: {}",
+                                         selector.base_dir,
+                                         infos.status().ToString()));
+    return infos.MoveValueUnsafe();
+  };
+  const auto wildcard = path.find('*');
+  if (wildcard == std::string::npos) {
+    while (path.size() > 1 && path.ends_with('/'))
+      path.pop_back();
+    auto info = fs.GetFileInfo(path);
+    if (not info.ok())
+      return caf::make_error(ec::filesystem_error,
+                             fmt::format("failed to get file info for `{}`: {}",
+                                         path, info.status().ToString()));
+    switch (info->type()) {
+      case arrow::fs::FileType::File:
+        result.push_back(info.MoveValueUnsafe());
+        break;
+      case arrow::fs::FileType::Directory: {
+        auto selector = arrow::fs::FileSelector{};
+        selector.base_dir = path;
+        selector.recursive = true;
+        auto infos = list(std::move(selector));
+        if (not infos)
+          return std::move(infos.error());
+        for (auto& x : *infos)
+          if (x.IsFile())
+            result.push_back(std::move(x));
+        break;
+      }
+      default:
+        return caf::make_error(ec::filesystem_error,
+                               fmt::format("`{}` does not exist", path));
+    }
+  } else {
+    // List everything below the last directory without wildcards, and match
+    // the listed paths against the pattern.
+    const auto slash = path.rfind('/', wildcard);
+    auto selector = arrow::fs::FileSelector{};
+    selector.base_dir = slash == std::string::npos ? "" : path.substr(0, slash);
+    const auto crosses_directories
+      = path.find("**") != std::string::npos
+        || path.find('/', wildcard) != std::string::npos;
+    selector.recursive = crosses_directories;
+    auto infos = list(std::move(selector));
+    if (not infos)
+      return std::move(infos.error());
+    for (auto& x : *infos)
+      if (x.IsFile() && matches_glob(path, x.path()))
+        result.push_back(std::move(x));
+  }
+  if (result.empty())
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("no files match `{}`", path));
+  std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.path() < rhs.path();
+  });
+  return result;
+}
+
+auto read_objects(std::shared_ptr<arrow::fs::FileSystem> fs,
+                  std::vector<arrow::fs::FileInfo> files,
+                  object_read_options options)
+  -> generator<caf::expected<chunk_ptr>> {
+  TENZIR_ASSERT(fs);
+  TENZIR_ASSERT(options.range_size > 0);
+  TENZIR_ASSERT(options.prefetch > 0);
+  TENZIR_ASSERT(options.concurrency > 0);
+  // All requests, including their retries, run on a thread pool of our own,
+  // so that neither the pipeline thread nor Arrow's global IO thread pool
+  // block on them. The pool must outlive the pending requests.
+  const auto num_threads
+    = std::min(options.prefetch * options.concurrency, max_read_threads);
+  auto pool = arrow::internal::ThreadPool::Make(
+    detail::narrow_cast<int>(num_threads));
+  if (not pool.ok()) {
+    co_yield caf::make_error(ec::system_error,
+                             fmt::format("failed to create thread pool: {}",
+                                         pool.status().ToString()));
+    co_return;
+  }
+  const auto submit = [&](auto f) {
+    auto future = (*pool)->Submit(std::move(f));
+    TENZIR_ASSERT(future.ok(), future.status().ToString().c_str());
+    return future.MoveValueUnsafe();
+  };
+  const auto range_size = detail::narrow_cast<int64_t>(options.range_size);
+  auto next_file = size_t{0};
+  auto active = std::deque<active_object>{};
+  // Opens objects until we read from as many as configured, and fills the
+  // prefetch window of every opened object.
+  const auto refill = [&]() -> caf::error {
+    while (active.size() < options.concurrency && next_file < files.size()) {
+      auto& info = files[next_file++];
+      auto opened = submit([fs, info, options] {
+        return with_retries(options, "open object", [&] {
+          return fs->OpenInputFile(info);
+        });
+      });
+      active.push_back(active_object{
+        .info = std::move(info),
+        .opened = std::move(opened),
+      });
+    }
+    for (auto& object : active) {
+      if (not object.file) {
+        if (not object.opened.is_finished())
+          continue;
+        const auto& file = object.opened.result();
+        if (not file.ok())
+          return caf::make_error(ec::filesystem_error,
+                                 fmt::format("failed to open `{}`: {}",
+                                             object.info.path(),
+                                             file.status().ToString()));
+        auto size = object.info.size();
+        if (size == arrow::fs::kNoSize) {
+          auto file_size = (*file)->GetSize();
+          if (not file_size.ok())
+            return caf::make_error(
+              ec::filesystem_error,
+              fmt::format("failed to get size of `{}`: {}", object.info.path(),
+                          file_size.status().ToString()));
+          size = *file_size;
+        }
+        object.file = *file;
+        object.size = size;
+      }
+      while (object.pending.size() < options.prefetch
+             && object.next_offset < object.size) {
+        const auto offset = object.next_offset;
+        const auto length = std::min(range_size, object.size - offset);
+        object.pending.push_back(
+          submit([file = object.file, offset, length, options] {
+            return with_retries(options, "read object", [&] {
+              return file->ReadAt(offset, length);
+            });
+          }));
+        object.next_offset += length;
+      }
+    }
+    return {};
+  };
+  // The object that we currently emit. Objects opened in between get
+  // appended, so the index remains valid until we erase the object.
+  auto current = std::optional<size_t>{};
+  while (true) {
+    if (auto err = refill()) {
+      co_yield std::move(err);
+      co_return;
+    }
+    if (active.empty())
+      co_return;
+    // Pick the object to emit next. In unordered mode, that is the first
+    // object with data available. We then emit it in its entirety, while
+    // continuing to prefetch for the other objects.
+    if (not current) {
+      if (not options.unordered) {
+        current = 0;
+      } else {
+        auto it = std::find_if(active.begin(), active.end(),
+                               [](const active_object& object) {
+                                 return object.is_ready();
+                               });
+        if (it == active.end()) {
+          if (not active.front().wait(poll_timeout))
+            co_yield chunk_ptr{};
+          continue;
+        }
+        current = std::distance(active.begin(), it);
+      }
+    }
+    auto& object = active[*current];
+    if (not object.is_ready()) {
+      if (not object.wait(poll_timeout))
+        co_yield chunk_ptr{};
+      continue;
+    }
+    if (not object.file)
+      continue;
+    if (object.pending.empty()) {
+      active.erase(active.begin() + detail::narrow_cast<ptrdiff_t>(*current));
+      current.reset();
+      continue;
+    }
+    auto buffer = object.pending.front().result();
+    object.pending.pop_front();
+    if (not buffer.ok()) {
+      co_yield caf::make_error(ec::filesystem_error,
+                               fmt::format("failed to read `{}`: {}",
+                                           object.info.path(),
+                                           buffer.status().ToString()));
+      co_return;
+    }
+    if ((*buffer)->size() > 0)
+      co_yield chunk::make(buffer.MoveValueUnsafe());
+  }
+}
+
+} // namespace tenzir
@@ -0,0 +1,175 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/output_partitioning.hpp"
+
+#include "tenzir/arrow_table_slice.hpp"
+#include "tenzir/error.hpp"
+#include "tenzir/type.hpp"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <unordered_map>
+
+namespace tenzir {
+
+namespace {
+
+/// The value that Hive uses for missing and null partition values.
+constexpr auto default_partition = std::string_view{
+  "__HIVE_DEFAULT_PARTITION__"};
+
+/// Appends a percent-encoded value, escaping the characters that Hive escapes
+/// in partition paths.
+void append_escaped(std::string& out, std::string_view value) {
+  constexpr auto special = std::string_view{"\"#%'*/:=?\\{[]^"};
+  for (auto c : value) {
+    const auto byte = static_cast<unsigned char>(c);
+    if (byte < 0x20 || byte == 0x7f || special.find(c) != special.npos)
+      fmt::format_to(std::back_inserter(out), "%{:02X}", byte);
+    else
+      out.push_back(c);
+  }
+}
+
+void append_component(std::string& path, std::string_view key,
+                      std::string_view value) {
+  if (not path.empty())
+    path.push_back('/');
+  append_escaped(path, key);
+  path.push_back('=');
+  append_escaped(path, value);
+}
+
+void append_value(std::string& path, std::string_view key,
+                  const data_view& value) {
+  if (caf::holds_alternative<caf::none_t>(value)) {
+    append_component(path, key, default_partition);
+  } else if (const auto* str = caf::get_if<view<std::string>>(&value)) {
+    append_component(path, key, *str);
+  } else {
+    append_component(path, key, fmt::to_string(value));
+  }
+}
+
+void append_time(std::string& path, std::optional<time> value,
+                 partition_granularity granularity) {
+  TENZIR_ASSERT(granularity != partition_granularity::value);
+  const auto append = [&](std::string_view key, auto x) {
+    append_component(path, key, x ? fmt::format("{:02}", *x)
+                                  : std::string{default_partition});
+  };
+  auto ymd = std::optional<std::chrono::year_month_day>{};
+  auto hour = std::optional<int64_t>{};
+  if (value) {
+    const auto day = std::chrono::floor<std::chrono::days>(*value);
+    ymd = std::chrono::year_month_day{day};
+    hour = std::chrono::floor<std::chrono::hours>(*value - day).count();
+  }
+  append("year", ymd ? std::optional{static_cast<int>(ymd->year())}
+                     : std::nullopt);
+  if (granularity == partition_granularity::year)
+    return;
+  append("month", ymd ? std::optional{static_cast<unsigned>(ymd->month())}
+                      : std::nullopt);
+  if (granularity == partition_granularity::month)
+    return;
+  append("day", ymd ? std::optional{static_cast<unsigned>(ymd->day())}
+                    : std::nullopt);
+  if (granularity == partition_granularity::day)
+    return;
+  append("hour", hour);
+}
+
+} // namespace
+
+auto parse_partition_key(std::string_view str)
+  -> caf::expected<partition_key> {
+  auto result = partition_key{};
+  const auto colon = str.rfind(':');
+  result.field = std::string{str.substr(0, colon)};
+  if (colon != std::string_view::npos) {
+    const auto granularity = str.substr(colon + 1);
+    if (granularity == "year")
+      result.granularity = partition_granularity::year;
+    else if (granularity == "month")
+      result.granularity = partition_granularity::month;
+    else if (granularity == "day")
+      result.granularity = partition_granularity::day;
+    else if (granularity == "hour")
+      result.granularity = partition_granularity::hour;
+    else
+      return caf::make_error(ec::parse_error,
+                             fmt::format("invalid granularity `{}` in "
+                                         "partition key `{}`; expected one "
+                                         "of year, month, day, or hour",
+                                         granularity, str));
+  }
+  if (result.field.empty())
+    return caf::make_error(ec::parse_error,
+                           fmt::format("partition key `{}` has no field",
+                                       str));
+  return result;
+}
+
+auto split_by_partition(const table_slice& slice,
+                        std::span<const partition_key> keys)
+  -> std::vector<std::pair<std::string, table_slice>> {
+  if (keys.empty() || slice.rows() == 0)
+    return {{std::string{}, slice}};
+  auto paths = std::vector<std::string>(slice.rows());
+  for (const auto& key : keys) {
+    const auto index = slice.schema().resolve_key_or_concept(key.field);
+    if (not index) {
+      for (auto& path : paths) {
+        if (key.granularity == partition_granularity::value)
+          append_component(path, key.field, default_partition);
+        else
+          append_time(path, std::nullopt, key.granularity);
+      }
+      continue;
+    }
+    auto [type, array] = index->get(slice);
+    auto row = size_t{0};
+    if (key.granularity != partition_granularity::value
+        && caf::holds_alternative<time_type>(type)) {
+      for (auto&& element : values(
+             time_type{},
+             static_cast<const type_to_arrow_array_t<time_type>&>(*array)))
+        append_time(paths[row++], element, key.granularity);
+      continue;
+    }
+    for (auto&& element : values(type, *array))
+      append_value(paths[row++], key.field, element);
+  }
+  // Gather the runs of consecutive rows per partition, and concatenate them
+  // so that every partition gets a single slice.
+  auto runs = std::vector<std::pair<std::string, std::vector<table_slice>>>{};
+  auto run_index = std::unordered_map<std::string, size_t>{};
+  auto begin = size_t{0};
+  for (auto row = size_t{1}; row <= paths.size(); ++row) {
+    if (row < paths.size() && paths[row] == paths[begin])
+      continue;
+    auto [it, inserted] = run_index.try_emplace(paths[begin], runs.size());
+    if (inserted)
+      runs.emplace_back(std::move(paths[begin]), std::vector<table_slice>{});
+    runs[it->second].second.push_back(subslice(slice, begin, row));
+    begin = row;
+  }
+  auto result = std::vector<std::pair<std::string, table_slice>>{};
+  result.reserve(runs.size());
+  for (auto& [path, slices] : runs) {
+    auto partition = slices.size() == 1 ? std::move(slices.front())
+                                        : concatenate(std::move(slices));
+    result.emplace_back(std::move(path), std::move(partition));
+  }
+  return result;
+}
+
+} // namespace tenzir
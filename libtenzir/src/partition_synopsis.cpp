@@ -9,11 +9,14 @@
 #include "tenzir/partition_synopsis.hpp"
 
 #include "tenzir/collect.hpp"
+#include "tenzir/detail/assert.hpp"
 #include "tenzir/error.hpp"
 #include "tenzir/fbs/utils.hpp"
 #include "tenzir/index_config.hpp"
 #include "tenzir/synopsis_factory.hpp"
 
+#include <fmt/format.h>
+
 namespace tenzir {
 
 partition_synopsis::partition_synopsis(partition_synopsis&& that) noexcept {
@@ -24,6 +27,8 @@ partition_synopsis::partition_synopsis(partition_synopsis&& that) noexcept {
   schema = std::exchange(that.schema, {});
   type_synopses_ = std::exchange(that.type_synopses_, {});
   field_synopses_ = std::exchange(that.field_synopses_, {});
+  synopses_path_ = std::exchange(that.synopses_path_, {});
+  lazy_ = std::exchange(that.lazy_, false);
   memusage_.store(that.memusage_.exchange(0));
 }
 
@@ -37,6 +42,8 @@ partition_synopsis::operator=(partition_synopsis&& that) noexcept {
     schema = std::exchange(that.schema, {});
     type_synopses_ = std::exchange(that.type_synopses_, {});
     field_synopses_ = std::exchange(that.field_synopses_, {});
+    synopses_path_ = std::exchange(that.synopses_path_, {});
+    lazy_ = std::exchange(that.lazy_, false);
     memusage_.store(that.memusage_.exchange(0));
   }
   return *this;
@@ -121,6 +128,8 @@ void partition_synopsis::add(const table_slice& slice,
     = get_type_fprate(fp_rates, tenzir::type{string_type{}});
   synopsis_opts["address-synopsis-fp-rate"]
     = get_type_fprate(fp_rates, tenzir::type{ip_type{}});
+  synopsis_opts["split-block-bloom-filter"]
+    = fp_rates.split_block_bloom_filters;
   for (size_t col = 0; col < slice.columns(); ++col, ++leaf_it) {
     auto&& leaf = *leaf_it;
     auto add_column = [&](const synopsis_ptr& syn) {
@@ -185,6 +194,120 @@ size_t partition_synopsis::memusage() const {
   return result;
 }
 
+namespace {
+
+// Not publicly exposed because it doesn't fully initialize `ps`.
+caf::error unpack_(
+  const flatbuffers::Vector<flatbuffers::Offset<fbs::synopsis::LegacySynopsis>>&
+    synopses,
+  partition_synopsis& ps) {
+  for (const auto* synopsis : synopses) {
+    if (!synopsis)
+      return caf::make_error(ec::format_error, "synopsis is null");
+    qualified_record_field qf;
+    if (auto error
+        = fbs::deserialize_bytes(synopsis->qualified_record_field(), qf))
+      return error;
+    synopsis_ptr ptr;
+    if (auto error = unpack(*synopsis, ptr))
+      return error;
+    // We mark type-level synopses by using an empty string as name.
+    if (qf.is_standalone_type())
+      ps.type_synopses_[qf.type()] = std::move(ptr);
+    else
+      ps.field_synopses_[qf] = std::move(ptr);
+  }
+  return caf::none;
+}
+
+// Unpacks everything but the synopses. The schema is copied such that it does
+// not hold on to the underlying buffer.
+caf::error
+unpack_metadata_(const fbs::partition_synopsis::LegacyPartitionSynopsis& x,
+                 partition_synopsis& ps) {
+  if (!x.id_range())
+    return caf::make_error(ec::format_error, "missing id range");
+  if (x.id_range()->begin() != 0)
+    return caf::make_error(ec::format_error,
+                           "partitions with an ID range not starting at zero "
+                           "are no longer supported");
+  ps.events = x.id_range()->end();
+  if (x.import_time_range()) {
+    ps.min_import_time = time{} + duration{x.import_time_range()->begin()};
+    ps.max_import_time = time{} + duration{x.import_time_range()->end()};
+  } else {
+    ps.min_import_time = time{};
+    ps.max_import_time = time{};
+  }
+  ps.version = x.version();
+  if (const auto* schema = x.schema())
+    ps.schema = type{chunk::copy(as_bytes(*schema))};
+  if (!x.synopses())
+    return caf::make_error(ec::format_error, "missing synopses");
+  return caf::none;
+}
+
+// Maps a partition synopsis file and returns the legacy partition synopsis
+// within, which is valid for as long as *chunk* is alive.
+caf::expected<const fbs::partition_synopsis::LegacyPartitionSynopsis*>
+map_synopsis_(const std::filesystem::path& path, chunk_ptr& chunk) {
+  auto mapped = chunk::mmap(path);
+  if (!mapped)
+    return mapped.error();
+  chunk = std::move(*mapped);
+  const auto* ps_flatbuffer = fbs::GetPartitionSynopsis(chunk->data());
+  if (ps_flatbuffer->partition_synopsis_type()
+      != fbs::partition_synopsis::PartitionSynopsis::legacy)
+    return caf::make_error(ec::format_error,
+                           fmt::format("invalid partition synopsis version in "
+                                       "{}",
+                                       path.string()));
+  const auto* synopsis_legacy = ps_flatbuffer->partition_synopsis_as_legacy();
+  if (!synopsis_legacy || !synopsis_legacy->synopses())
+    return caf::make_error(ec::format_error, fmt::format("missing synopses in "
+                                                         "{}",
+                                                         path.string()));
+  return synopsis_legacy;
+}
+
+} // namespace
+
+bool partition_synopsis::is_lazy() const {
+  return lazy_;
+}
+
+caf::error partition_synopsis::load_synopses() {
+  if (!lazy_)
+    return caf::none;
+  // The mapping is released when we return, as the unpacked synopses do not
+  // reference the buffer.
+  auto chunk = chunk_ptr{};
+  auto synopsis_legacy = map_synopsis_(synopses_path_, chunk);
+  if (!synopsis_legacy)
+    return synopsis_legacy.error();
+  memusage_ = 0; // Invalidate cached size.
+  if (auto err = unpack_(*(*synopsis_legacy)->synopses(), *this)) {
+    type_synopses_.clear();
+    field_synopses_.clear();
+    return err;
+  }
+  lazy_ = false;
+  return caf::none;
+}
+
+bool partition_synopsis::has_unloadable_synopses() const {
+  return !lazy_ && !synopses_path_.empty();
+}
+
+void partition_synopsis::unload_synopses() {
+  if (!has_unloadable_synopses())
+    return;
+  type_synopses_.clear();
+  field_synopses_.clear();
+  lazy_ = true;
+  memusage_ = 0; // Invalidate cached size.
+}
+
 partition_synopsis* partition_synopsis::copy() const {
   auto result = std::make_unique<partition_synopsis>();
   result->events = events;
@@ -192,6 +315,8 @@ partition_synopsis* partition_synopsis::copy() const {
   result->max_import_time = max_import_time;
   result->version = version;
   result->schema = schema;
+  result->synopses_path_ = synopses_path_;
+  result->lazy_ = lazy_;
   result->memusage_ = memusage_.load();
   result->type_synopses_.reserve(type_synopses_.size());
   result->field_synopses_.reserve(field_synopses_.size());
@@ -214,6 +339,12 @@ partition_synopsis* partition_synopsis::copy() const {
 caf::expected<
   flatbuffers::Offset<fbs::partition_synopsis::LegacyPartitionSynopsis>>
 pack(flatbuffers::FlatBufferBuilder& builder, const partition_synopsis& x) {
+  if (x.is_lazy()) {
+    auto loaded = std::unique_ptr<partition_synopsis>{x.copy()};
+    if (auto err = loaded->load_synopses())
+      return err;
+    return pack(builder, *loaded);
+  }
   std::vector<flatbuffers::Offset<fbs::synopsis::LegacySynopsis>> synopses;
   for (const auto& [fqf, synopsis] : x.field_synopses_) {
     auto maybe_synopsis = pack(builder, synopsis, fqf);
@@ -245,56 +376,31 @@ pack(flatbuffers::FlatBufferBuilder& builder, const partition_synopsis& x) {
   return ps_builder.Finish();
 }
 
-namespace {
-
-// Not publicly exposed because it doesn't fully initialize `ps`.
-caf::error unpack_(
-  const flatbuffers::Vector<flatbuffers::Offset<fbs::synopsis::LegacySynopsis>>&
-    synopses,
-  partition_synopsis& ps) {
-  for (const auto* synopsis : synopses) {
-    if (!synopsis)
-      return caf::make_error(ec::format_error, "synopsis is null");
-    qualified_record_field qf;
-    if (auto error
-        = fbs::deserialize_bytes(synopsis->qualified_record_field(), qf))
-      return error;
-    synopsis_ptr ptr;
-    if (auto error = unpack(*synopsis, ptr))
-      return error;
-    // We mark type-level synopses by using an empty string as name.
-    if (qf.is_standalone_type())
-      ps.type_synopses_[qf.type()] = std::move(ptr);
-    else
-      ps.field_synopses_[qf] = std::move(ptr);
-  }
-  return caf::none;
-}
-
-} // namespace
-
 caf::error unpack(const fbs::partition_synopsis::LegacyPartitionSynopsis& x,
                   partition_synopsis& ps) {
-  if (!x.id_range())
-    return caf::make_error(ec::format_error, "missing id range");
-  if (x.id_range()->begin() != 0)
-    return caf::make_error(ec::format_error,
-                           "partitions with an ID range not starting at zero "
-                           "are no longer supported");
-  ps.events = x.id_range()->end();
-  if (x.import_time_range()) {
-    ps.min_import_time = time{} + duration{x.import_time_range()->begin()};
-    ps.max_import_time = time{} + duration{x.import_time_range()->end()};
-  } else {
-    ps.min_import_time = time{};
-    ps.max_import_time = time{};
-  }
-  ps.version = x.version();
-  if (const auto* schema = x.schema())
-    ps.schema = type{chunk::copy(as_bytes(*schema))};
-  if (!x.synopses())
-    return caf::make_error(ec::format_error, "missing synopses");
+  if (auto err = unpack_metadata_(x, ps))
+    return err;
   return unpack_(*x.synopses(), ps);
 }
 
+caf::error
+unpack_lazily(const std::filesystem::path& path, partition_synopsis& ps) {
+  auto chunk = chunk_ptr{};
+  auto synopsis_legacy = map_synopsis_(path, chunk);
+  if (!synopsis_legacy)
+    return synopsis_legacy.error();
+  if (auto err = unpack_metadata_(**synopsis_legacy, ps))
+    return err;
+  ps.type_synopses_.clear();
+  ps.field_synopses_.clear();
+  ps.memusage_ = 0;
+  // Partition synopses without a schema predate homogeneous partitions, so we
+  // cannot answer queries for schema names without their field synopses.
+  if (!ps.schema)
+    return unpack_(*(*synopsis_legacy)->synopses(), ps);
+  ps.synopses_path_ = path;
+  ps.lazy_ = true;
+  return caf::none;
+}
+
 } // namespace tenzir
@@ -515,6 +515,10 @@ partition_actor::behavior_type passive_partition(
             if (count && count->mode == count_query_context::estimate) {
               self->send(count->sink, rank(hits));
               rp.deliver(rank(hits));
+            } else if (!hits.empty() && !any<1>(hits)) {
+              // The indexes ruled out all events of this partition, so there
+              // is no need to load the store.
+              rp.deliver(uint64_t{0});
             } else {
               query_context.ids = hits;
               rp.delegate(self->state.store, atom::query_v,
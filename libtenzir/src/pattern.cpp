@@ -11,11 +11,14 @@
 #include "tenzir/concept/printable/tenzir/pattern.hpp"
 #include "tenzir/concept/printable/to_string.hpp"
 #include "tenzir/data.hpp"
+#include "tenzir/detail/assert.hpp"
 #include "tenzir/error.hpp"
 #include "tenzir/view.hpp"
 
 #include <re2/re2.h>
 
+#include <cctype>
+
 namespace tenzir {
 
 struct regex_impl : re2::RE2 {
@@ -35,18 +38,33 @@ auto pattern::make(std::string str, pattern_options options) noexcept
     return caf::make_error(ec::syntax_error,
                            fmt::format("failed to create regex from '{}'",
                                        result.str_));
+  // Literals are only meaningful for case-sensitive comparisons.
+  if (!options.case_insensitive) {
+    result.literal_ = detail::regex_literal(result.str_);
+    result.required_literal_ = result.literal_
+                                 ? *result.literal_
+                                 : detail::regex_required_literal(result.str_);
+  }
   return result;
 }
 
 bool pattern::match(std::string_view str) const {
   if (!regex_)
     return false;
+  if (literal_)
+    return str == *literal_;
+  if (str.find(required_literal_) == std::string_view::npos)
+    return false;
   return re2::RE2::FullMatch(str, *regex_);
 }
 
 bool pattern::search(std::string_view str) const {
   if (!regex_)
     return false;
+  if (literal_)
+    return str.find(*literal_) != std::string_view::npos;
+  if (str.find(required_literal_) == std::string_view::npos)
+    return false;
   return re2::RE2::PartialMatch(str, *regex_);
 }
 
@@ -58,6 +76,14 @@ const pattern_options& pattern::options() const {
   return options_;
 }
 
+const std::optional<std::string>& pattern::literal() const {
+  return literal_;
+}
+
+std::string_view pattern::required_literal() const {
+  return required_literal_;
+}
+
 bool operator==(const pattern& lhs, const pattern& rhs) noexcept {
   return pattern_view{lhs} == pattern_view{rhs};
 }
@@ -76,4 +102,165 @@ bool convert(const pattern& p, data& d) {
   return true;
 }
 
+namespace detail {
+
+namespace {
+
+/// Returns the position of the closing brace if the regular expression has a
+/// counted repetition such as `{3}`, `{3,}`, or `{3,5}` at position *i*.
+auto counted_repetition_end(std::string_view regex, size_t i)
+  -> std::optional<size_t> {
+  TENZIR_ASSERT(regex[i] == '{');
+  auto j = i + 1;
+  const auto skip_digits = [&] {
+    const auto begin = j;
+    while (j < regex.size()
+           && std::isdigit(static_cast<unsigned char>(regex[j])))
+      ++j;
+    return j > begin;
+  };
+  if (not skip_digits())
+    return std::nullopt;
+  if (j < regex.size() && regex[j] == ',') {
+    ++j;
+    skip_digits();
+  }
+  if (j < regex.size() && regex[j] == '}')
+    return j;
+  return std::nullopt;
+}
+
+} // namespace
+
+auto regex_literal(std::string_view regex) -> std::optional<std::string> {
+  auto result = std::string{};
+  result.reserve(regex.size());
+  for (auto i = size_t{0}; i < regex.size(); ++i) {
+    const auto c = regex[i];
+    if (c == '\\') {
+      // Only escaped punctuation is literal; `\d`, `\x41`, and friends are
+      // not.
+      if (i + 1 == regex.size()
+          || !std::ispunct(static_cast<unsigned char>(regex[i + 1])))
+        return std::nullopt;
+      result.push_back(regex[++i]);
+      continue;
+    }
+    if (std::string_view{".^$|?*+()[]{}"}.find(c) != std::string_view::npos)
+      return std::nullopt;
+    result.push_back(c);
+  }
+  return result;
+}
+
+// This only considers literals outside of groups, and gives up for
+// alternations at the top level.
+auto regex_required_literal(std::string_view regex) -> std::string {
+  auto best = std::string{};
+  auto current = std::string{};
+  const auto flush = [&] {
+    if (current.size() > best.size())
+      best = current;
+    current.clear();
+  };
+  auto depth = 0;
+  for (auto i = size_t{0}; i < regex.size(); ++i) {
+    const auto c = regex[i];
+    if (c == '\\') {
+      if (i + 1 == regex.size())
+        return {};
+      const auto escaped = regex[i + 1];
+      ++i;
+      // Give up for quoting and for escapes that consume further characters,
+      // e.g., `\x41` or `\p{L}`.
+      if (std::isdigit(static_cast<unsigned char>(escaped))
+          || std::string_view{"QxcpPNkgouU"}.find(escaped)
+               != std::string_view::npos)
+        return {};
+      if (depth > 0)
+        continue;
+      if (std::isalnum(static_cast<unsigned char>(escaped))) {
+        // Character classes and anchors.
+        flush();
+        continue;
+      }
+      current.push_back(escaped);
+    } else if (c == '[') {
+      // Skip the character class.
+      auto j = i + 1;
+      if (j < regex.size() && regex[j] == '^')
+        ++j;
+      if (j < regex.size() && regex[j] == ']')
+        ++j;
+      while (j < regex.size() && regex[j] != ']') {
+        // POSIX classes, equivalence classes, and collating symbols such as
+        // `[:digit:]` contain a `]` that does not close the bracket
+        // expression.
+        if (regex[j] == '[' && j + 1 < regex.size()
+            && std::string_view{":=."}.find(regex[j + 1])
+                 != std::string_view::npos) {
+          const auto close = std::string{regex[j + 1], ']'};
+          const auto end = regex.find(close, j + 2);
+          if (end == std::string_view::npos)
+            return {};
+          j = end + 2;
+          continue;
+        }
+        j += regex[j] == '\\' ? 2 : 1;
+      }
+      i = j;
+      if (depth == 0)
+        flush();
+      continue;
+    } else if (c == '(') {
+      if (depth == 0) {
+        // Inline flags such as `(?i)` may change the meaning of literals.
+        const auto rest = regex.substr(i);
+        if (rest.size() > 2 && rest[1] == '?'
+            && (std::isalpha(static_cast<unsigned char>(rest[2]))
+                 || rest[2] == '-')
+            && rest[2] != 'P')
+          return {};
+        flush();
+      }
+      ++depth;
+      continue;
+    } else if (c == ')') {
+      depth = std::max(0, depth - 1);
+      continue;
+    } else if (depth > 0) {
+      continue;
+    } else if (c == '|') {
+      return {};
+    } else if (c == '{') {
+      // The atom that a counted repetition applies to was already dropped
+      // from the literal below, and the repetition itself is no literal.
+      flush();
+      if (auto end = counted_repetition_end(regex, i))
+        i = *end;
+      continue;
+    } else if (std::string_view{".^$*+?"}.find(c)
+               != std::string_view::npos) {
+      flush();
+      continue;
+    } else {
+      current.push_back(c);
+    }
+    // A quantifier applies to the last literal only.
+    if (i + 1 < regex.size()) {
+      const auto next = regex[i + 1];
+      if (next == '?' || next == '*' || next == '{') {
+        current.pop_back();
+        flush();
+      } else if (next == '+') {
+        flush();
+      }
+    }
+  }
+  flush();
+  return best;
+}
+
+} // namespace detail
+
 } // namespace tenzir
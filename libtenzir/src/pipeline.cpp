@@ -184,6 +184,8 @@ auto pipeline::optimize(expression const& filter, event_order order) const
   -> optimize_result {
   auto current_filter = filter;
   auto current_order = order;
+  // The limit always refers to the events after applying `current_filter`.
+  auto current_limit = std::optional<event_limit>{};
   // Collect the optimized pipeline in reversed order.
   auto result = std::vector<operator_ptr>{};
   for (auto it = operators_.rbegin(); it != operators_.rend(); ++it) {
@@ -201,8 +203,11 @@ auto pipeline::optimize(expression const& filter, event_order order) const
       TENZIR_ASSERT(ops.size() == 1);
       result.push_back(std::move(ops[0]));
       current_filter = trivially_true_expression();
+      // A limit cannot be pushed through a filter that we materialize here.
+      current_limit = std::nullopt;
     }
     if (opt.replacement) {
+      current_limit = opt.replacement->push_down_limit(current_limit);
       result.push_back(std::move(opt.replacement));
     }
     current_order = opt.order;
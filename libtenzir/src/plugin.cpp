@@ -499,44 +499,11 @@ static auto
 store_parser_impl(generator<chunk_ptr> loader, operator_control_plane& ctrl,
                   std::unique_ptr<passive_store> store)
   -> generator<table_slice> {
-  // TODO: Loading everything into memory here is far from ideal. We should
-  // instead load passive stores incrementally. For now we at least warn the
-  // user that this is experimental.
-  auto chunks = std::vector<chunk_ptr>{};
-  for (auto&& chunk : loader) {
-    if (not chunk || chunk->size() == 0) {
-      co_yield {};
-      continue;
-    }
-    chunks.push_back(std::move(chunk));
-    co_yield {};
-  }
-  if (chunks.size() == 1) {
-    if (auto err = store->load(std::move(chunks.front()))) {
-      diagnostic::error(err)
-        .note("parser failed to load")
-        .emit(ctrl.diagnostics());
-      co_return;
-    }
-  } else {
-    diagnostic::warning("loading files incrementally is not currently "
-                        "supported; parser may use excessive amounts of memory")
-      .hint("consider using `from file --mmap` to load the file")
-      .emit(ctrl.diagnostics());
-    auto buffer = std::vector<std::byte>{};
-    for (auto&& chunk : chunks) {
-      buffer.insert(buffer.end(), chunk->begin(), chunk->end());
-    }
-    if (auto err = store->load(chunk::make(std::move(buffer)))) {
-      diagnostic::error(err)
-        .note("parser failed to load")
-        .emit(ctrl.diagnostics());
-      co_return;
-    }
-  }
-  for (auto&& slice : store->slices()) {
+  // The store must outlive the generator that decodes its input, so we cannot
+  // return the generator directly.
+  for (auto&& slice :
+       store->load_incrementally(std::move(loader), ctrl.diagnostics()))
     co_yield std::move(slice);
-  }
 }
 
 class store_parser final : public plugin_parser {
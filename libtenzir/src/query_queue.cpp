@@ -26,8 +26,11 @@ bool operator<(const query_queue::entry& lhs,
                const query_queue::entry& rhs) noexcept {
   const auto lhs_num_queries = lhs.queries.size();
   const auto rhs_num_queries = rhs.queries.size();
-  return std::tie(lhs.priority, lhs_num_queries)
-         < std::tie(rhs.priority, rhs_num_queries);
+  // Recency breaks ties between partitions of the same priority, so that
+  // queries for the latest results see their candidate partitions newest
+  // first. It is zero for all other partitions.
+  return std::tie(lhs.priority, lhs.recency, lhs_num_queries)
+         < std::tie(rhs.priority, rhs.recency, rhs_num_queries);
 }
 
 bool operator==(const query_queue::entry& lhs, const uuid& rhs) noexcept {
@@ -82,6 +85,8 @@ query_queue::insert(query_state&& query_state,
     return caf::make_error(ec::unspecified, "the candidate set size must match "
                                             "the query state");
   auto qid = query_state.query_contexts_per_type.begin()->second.id;
+  const auto latest
+    = query_state.query_contexts_per_type.begin()->second.latest;
   auto [query_state_it, emplace_success]
     = queries_.emplace(qid, std::move(query_state));
   if (!emplace_success)
@@ -89,11 +94,13 @@ query_queue::insert(query_state&& query_state,
                                             "already");
   for (const auto& [schema, cand_info] : candidates.candidate_infos) {
     for (const auto& cand : cand_info.partition_infos) {
+      const auto recency = latest ? cand.max_import_time : time{};
       auto it = std::find(partitions.begin(), partitions.end(), cand.uuid);
       if (it != partitions.end()) {
         it->priority += query_state_it->second.query_contexts_per_type.begin()
                           ->second.priority;
         it->queries.push_back(qid);
+        it->recency = std::max(it->recency, recency);
         TENZIR_ASSERT_EXPENSIVE(
           !detail::contains(inactive_partitions, cand.uuid),
           "A partition must not be active and inactive at the same "
@@ -106,15 +113,17 @@ query_queue::insert(query_state&& query_state,
         it->priority += query_state_it->second.query_contexts_per_type.begin()
                           ->second.priority;
         it->queries.push_back(qid);
+        it->recency = std::max(it->recency, recency);
         partitions.push_back(std::move(*it));
 
         inactive_partitions.erase(it);
         continue;
       }
-      partitions.push_back(query_queue::entry{
+      auto& inserted = partitions.emplace_back(
         cand.uuid, schema,
         query_state_it->second.query_contexts_per_type.begin()->second.priority,
-        std::vector{qid}, false});
+        std::vector{qid}, false);
+      inserted.recency = recency;
     }
   }
   // TODO: Insertion sort should be better.
@@ -196,6 +205,8 @@ std::optional<query_queue::entry> query_queue::next() {
       = entry{result.partition, result.schema, 0ull, {}, result.erased};
     auto inactive
       = entry{result.partition, result.schema, 0ull, {}, result.erased};
+    active.recency = result.recency;
+    inactive.recency = result.recency;
     std::partition_copy(
       std::make_move_iterator(result.queries.begin()),
       std::make_move_iterator(result.queries.end()),
@@ -262,6 +273,30 @@ query_queue::handle_completion(const uuid& qid) {
   return result;
 }
 
+[[nodiscard]] std::optional<receiver_actor<atom::done>>
+query_queue::handle_results(const uuid& qid, uint64_t num_results) {
+  auto it = queries_.find(qid);
+  if (it == queries_.end()) {
+    return std::nullopt;
+  }
+  auto& query_state = it->second;
+  query_state.num_results += num_results;
+  const auto& limit
+    = query_state.query_contexts_per_type.begin()->second.limit;
+  if (not limit or query_state.num_results < *limit) {
+    return std::nullopt;
+  }
+  TENZIR_DEBUG("index reached the limit of {} results for query {}", *limit,
+               qid);
+  auto result = query_state.client;
+  // Removing the query drops it from all partitions that have not yet been
+  // scheduled; in-flight partition lookups no longer report back to the
+  // client on completion.
+  auto err = remove_query(qid);
+  TENZIR_ASSERT(not err);
+  return result;
+}
+
 std::size_t query_queue::entry::memusage() const {
   return sizeof(*this) + queries.size() * sizeof(decltype(queries)::value_type);
 }
@@ -0,0 +1,761 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/roaring_bitmap.hpp"
+
+#include "tenzir/error.hpp"
+#include "tenzir/fbs/bitmap.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <iterator>
+#include <span>
+
+#if defined(__SSE4_2__)
+#  include <nmmintrin.h>
+#endif
+
+namespace tenzir {
+
+namespace {
+
+using container = detail::roaring_container;
+using kind = container::kind;
+
+constexpr auto chunk_bits = container::chunk_bits;
+constexpr auto bitset_words = container::bitset_words;
+constexpr auto max_array_size = container::max_array_size;
+
+/// Sets the bits *[first, last)* of a bitset.
+void set_range(std::span<uint64_t> words, uint32_t first, uint32_t last) {
+  if (first >= last)
+    return;
+  const auto first_word = first / 64;
+  const auto last_word = (last - 1) / 64;
+  const auto first_mask = ~uint64_t{0} << (first % 64);
+  const auto last_mask = ~uint64_t{0} >> (63 - (last - 1) % 64);
+  if (first_word == last_word) {
+    words[first_word] |= first_mask & last_mask;
+    return;
+  }
+  words[first_word] |= first_mask;
+  for (auto i = first_word + 1; i < last_word; ++i)
+    words[i] = ~uint64_t{0};
+  words[last_word] |= last_mask;
+}
+
+/// Finds the position of the next bit with a given value in a bitset,
+/// starting at *first*.
+/// @returns The position of the bit or `chunk_bits` if none exists.
+uint32_t find_next(std::span<const uint64_t> words, uint32_t first, bool bit) {
+  auto i = first / 64;
+  if (i >= words.size())
+    return chunk_bits;
+  auto x = (bit ? words[i] : ~words[i]) & (~uint64_t{0} << (first % 64));
+  while (x == 0) {
+    if (++i == words.size())
+      return chunk_bits;
+    x = bit ? words[i] : ~words[i];
+  }
+  return i * 64 + std::countr_zero(x);
+}
+
+uint32_t popcount(std::span<const uint64_t> words) {
+  auto result = uint32_t{0};
+  for (auto x : words)
+    result += std::popcount(x);
+  return result;
+}
+
+/// Counts the runs of 1-bits in a bitset.
+size_t count_runs(std::span<const uint64_t> words) {
+  auto result = size_t{0};
+  auto carry = uint64_t{0};
+  for (auto x : words) {
+    // A run starts at every 1-bit whose predecessor is a 0-bit.
+    result += std::popcount(x & ~((x << 1) | carry));
+    carry = x >> 63;
+  }
+  return result;
+}
+
+/// Materializes the bits of a container.
+std::vector<uint64_t> to_words(const container& x) {
+  if (x.type == kind::bitset)
+    return x.words;
+  auto result = std::vector<uint64_t>(bitset_words, 0);
+  if (x.type == kind::array) {
+    for (auto value : x.values)
+      result[value / 64] |= uint64_t{1} << (value % 64);
+  } else {
+    for (size_t i = 0; i < x.values.size(); i += 2)
+      set_range(result, x.values[i], x.values[i] + x.values[i + 1] + 1);
+  }
+  return result;
+}
+
+/// Checks the invariants of a container that was read from an untrusted
+/// buffer. All other functions rely on them to stay within the bounds of the
+/// container.
+bool is_valid(const container& x, uint64_t num_bits) {
+  if (x.cardinality == 0 || x.key >= (num_bits + chunk_bits - 1) / chunk_bits)
+    return false;
+  // No bits may be set past the end of the bitmap.
+  const auto limit
+    = static_cast<uint32_t>(std::min(uint64_t{chunk_bits},
+                                     num_bits - x.key * chunk_bits));
+  switch (x.type) {
+    case kind::array:
+      return x.words.empty() && x.values.size() == x.cardinality
+             && x.values.size() <= max_array_size && x.values.back() < limit
+             && std::adjacent_find(x.values.begin(), x.values.end(),
+                                   std::greater_equal<>{})
+                  == x.values.end();
+    case kind::bitset:
+      return x.values.empty() && x.words.size() == bitset_words
+             && popcount(x.words) == x.cardinality
+             && (limit == chunk_bits
+                 || find_next(x.words, limit, true) == chunk_bits);
+    case kind::run: {
+      if (!x.words.empty() || x.values.empty() || x.values.size() % 2 != 0)
+        return false;
+      // Runs must be sorted, must not overlap, and must end within the chunk.
+      auto cardinality = uint64_t{0};
+      auto first_free = uint32_t{0};
+      for (size_t i = 0; i < x.values.size(); i += 2) {
+        const auto start = uint32_t{x.values[i]};
+        const auto last = start + x.values[i + 1];
+        if (start < first_free || last >= limit)
+          return false;
+        cardinality += last - start + 1;
+        first_free = last + 1;
+      }
+      return cardinality == x.cardinality;
+    }
+  }
+  return false;
+}
+
+/// Creates a container from a bitset, choosing the representation that
+/// requires the least space.
+container make_container(uint64_t key, std::vector<uint64_t> words) {
+  auto result = container{};
+  result.key = key;
+  result.cardinality = popcount(words);
+  if (result.cardinality == 0)
+    return result;
+  const auto num_runs = count_runs(words);
+  const auto array_bytes = result.cardinality * sizeof(uint16_t);
+  const auto bitset_bytes = bitset_words * sizeof(uint64_t);
+  const auto run_bytes = num_runs * 2 * sizeof(uint16_t);
+  if (run_bytes < std::min(array_bytes, bitset_bytes)) {
+    result.type = kind::run;
+    result.values.reserve(num_runs * 2);
+    auto first = find_next(words, 0, true);
+    while (first < chunk_bits) {
+      const auto last = find_next(words, first, false);
+      result.values.push_back(static_cast<uint16_t>(first));
+      result.values.push_back(static_cast<uint16_t>(last - first - 1));
+      first = find_next(words, last, true);
+    }
+  } else if (result.cardinality <= max_array_size) {
+    result.type = kind::array;
+    result.values.reserve(result.cardinality);
+    for (size_t i = 0; i < words.size(); ++i) {
+      for (auto x = words[i]; x != 0; x &= x - 1)
+        result.values.push_back(
+          static_cast<uint16_t>(i * 64 + std::countr_zero(x)));
+    }
+  } else {
+    result.type = kind::bitset;
+    result.words = std::move(words);
+  }
+  return result;
+}
+
+container make_array_container(uint64_t key, std::vector<uint16_t> values) {
+  auto result = container{};
+  result.key = key;
+  result.type = kind::array;
+  result.cardinality = static_cast<uint32_t>(values.size());
+  result.values = std::move(values);
+  return result;
+}
+
+/// Creates a container with all bits *[0, last)* set.
+container make_full_container(uint64_t key, uint32_t last) {
+  auto result = container{};
+  result.key = key;
+  result.type = kind::run;
+  result.cardinality = last;
+  result.values = {0, static_cast<uint16_t>(last - 1)};
+  return result;
+}
+
+bool container_contains(const container& x, uint16_t value) {
+  switch (x.type) {
+    case kind::array:
+      return std::binary_search(x.values.begin(), x.values.end(), value);
+    case kind::bitset:
+      return (x.words[value / 64] >> (value % 64)) & 1;
+    case kind::run: {
+      // Find the last run that starts at or before the value.
+      auto first = size_t{0};
+      auto last = x.values.size() / 2;
+      while (first < last) {
+        const auto mid = first + (last - first) / 2;
+        if (x.values[mid * 2] <= value)
+          first = mid + 1;
+        else
+          last = mid;
+      }
+      if (first == 0)
+        return false;
+      const auto start = x.values[(first - 1) * 2];
+      const auto length = x.values[(first - 1) * 2 + 1];
+      return value - start <= length;
+    }
+  }
+  __builtin_unreachable();
+}
+
+/// Sets the bits *[first, last)* of a container, which must be past all bits
+/// that the container has set already.
+void append_range(container& x, uint32_t first, uint32_t last) {
+  TENZIR_ASSERT(first < last && last <= chunk_bits);
+  const auto n = last - first;
+  switch (x.type) {
+    case kind::array:
+      if (x.cardinality + n <= max_array_size) {
+        for (auto i = first; i < last; ++i)
+          x.values.push_back(static_cast<uint16_t>(i));
+        x.cardinality += n;
+        return;
+      }
+      x.words = to_words(x);
+      x.values = {};
+      x.type = kind::bitset;
+      [[fallthrough]];
+    case kind::bitset:
+      set_range(x.words, first, last);
+      x.cardinality += n;
+      return;
+    case kind::run:
+      if (!x.values.empty()
+          && x.values.end()[-2] + x.values.back() + 1u == first)
+        x.values.back() += static_cast<uint16_t>(n);
+      else
+        x.values.insert(x.values.end(), {static_cast<uint16_t>(first),
+                                         static_cast<uint16_t>(n - 1)});
+      x.cardinality += n;
+      // Switch to a bitset once the runs occupy more space.
+      if (x.values.size() * sizeof(uint16_t)
+          > bitset_words * sizeof(uint64_t)) {
+        x.words = to_words(x);
+        x.values = {};
+        x.type = kind::bitset;
+      }
+      return;
+  }
+}
+
+/// Intersects two sorted arrays. If SSE 4.2 is available, this compares
+/// blocks of eight values at a time, as described by Schlegel et al. in
+/// *Fast Sorted-Set Intersection using SIMD Instructions*.
+std::vector<uint16_t>
+intersect_arrays(std::span<const uint16_t> lhs, std::span<const uint16_t> rhs) {
+  auto result = std::vector<uint16_t>{};
+  if (lhs.size() > rhs.size())
+    std::swap(lhs, rhs);
+  result.reserve(lhs.size());
+  // For very different sizes, searching for the values of the smaller array in
+  // the larger one is faster than merging.
+  if (lhs.size() * 64 < rhs.size()) {
+    auto it = rhs.begin();
+    for (auto value : lhs) {
+      it = std::lower_bound(it, rhs.end(), value);
+      if (it == rhs.end())
+        break;
+      if (*it == value)
+        result.push_back(value);
+    }
+    return result;
+  }
+  auto i = size_t{0};
+  auto j = size_t{0};
+#if defined(__SSE4_2__)
+  constexpr auto lanes = size_t{8};
+  const auto lhs_end = lhs.size() / lanes * lanes;
+  const auto rhs_end = rhs.size() / lanes * lanes;
+  if (lhs_end > 0 && rhs_end > 0) {
+    auto load = [](const uint16_t* ptr) {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    };
+    auto x = load(lhs.data());
+    auto y = load(rhs.data());
+    while (true) {
+      // Bit k of the mask is set iff the k-th value of x occurs in y.
+      const auto mask = _mm_cvtsi128_si32(
+        _mm_cmpestrm(y, lanes, x, lanes,
+                     _SIDD_UWORD_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK));
+      for (auto m = static_cast<uint32_t>(mask); m != 0; m &= m - 1)
+        result.push_back(lhs[i + std::countr_zero(m)]);
+      const auto lhs_max = lhs[i + lanes - 1];
+      const auto rhs_max = rhs[j + lanes - 1];
+      if (lhs_max <= rhs_max) {
+        i += lanes;
+        if (i == lhs_end)
+          break;
+        x = load(lhs.data() + i);
+      }
+      if (rhs_max <= lhs_max) {
+        j += lanes;
+        if (j == rhs_end)
+          break;
+        y = load(rhs.data() + j);
+      }
+    }
+  }
+#endif
+  while (i < lhs.size() && j < rhs.size()) {
+    if (lhs[i] < rhs[j]) {
+      ++i;
+    } else if (rhs[j] < lhs[i]) {
+      ++j;
+    } else {
+      result.push_back(lhs[i]);
+      ++i;
+      ++j;
+    }
+  }
+  return result;
+}
+
+/// Applies a bitwise operation to the materialized bits of two containers.
+template <class Operation>
+container combine_words(const container& x, const container& y,
+                        Operation op) {
+  auto words = to_words(x);
+  const auto other = to_words(y);
+  for (size_t i = 0; i < words.size(); ++i)
+    words[i] = op(words[i], other[i]);
+  return make_container(x.key, std::move(words));
+}
+
+/// Keeps the values of an array container for which a predicate holds.
+template <class Predicate>
+container filter_array(const container& x, Predicate pred) {
+  TENZIR_ASSERT(x.type == kind::array);
+  auto values = std::vector<uint16_t>{};
+  values.reserve(x.values.size());
+  std::copy_if(x.values.begin(), x.values.end(), std::back_inserter(values),
+               pred);
+  return make_array_container(x.key, std::move(values));
+}
+
+container container_and(const container& x, const container& y) {
+  if (x.type == kind::array && y.type == kind::array)
+    return make_array_container(x.key, intersect_arrays(x.values, y.values));
+  if (x.type == kind::array || y.type == kind::array) {
+    const auto& array = x.type == kind::array ? x : y;
+    const auto& other = x.type == kind::array ? y : x;
+    return filter_array(array, [&](uint16_t value) {
+      return container_contains(other, value);
+    });
+  }
+  return combine_words(x, y, [](uint64_t lhs, uint64_t rhs) {
+    return lhs & rhs;
+  });
+}
+
+container container_or(const container& x, const container& y) {
+  if (x.type == kind::array && y.type == kind::array
+      && x.values.size() + y.values.size() <= max_array_size) {
+    auto values = std::vector<uint16_t>{};
+    values.reserve(x.values.size() + y.values.size());
+    std::set_union(x.values.begin(), x.values.end(), y.values.begin(),
+                   y.values.end(), std::back_inserter(values));
+    return make_array_container(x.key, std::move(values));
+  }
+  return combine_words(x, y, [](uint64_t lhs, uint64_t rhs) {
+    return lhs | rhs;
+  });
+}
+
+container container_xor(const container& x, const container& y) {
+  if (x.type == kind::array && y.type == kind::array
+      && x.values.size() + y.values.size() <= max_array_size) {
+    auto values = std::vector<uint16_t>{};
+    values.reserve(x.values.size() + y.values.size());
+    std::set_symmetric_difference(x.values.begin(), x.values.end(),
+                                  y.values.begin(), y.values.end(),
+                                  std::back_inserter(values));
+    return make_array_container(x.key, std::move(values));
+  }
+  return combine_words(x, y, [](uint64_t lhs, uint64_t rhs) {
+    return lhs ^ rhs;
+  });
+}
+
+container container_nand(const container& x, const container& y) {
+  if (x.type == kind::array)
+    return filter_array(x, [&](uint16_t value) {
+      return !container_contains(y, value);
+    });
+  return combine_words(x, y, [](uint64_t lhs, uint64_t rhs) {
+    return lhs & ~rhs;
+  });
+}
+
+/// Combines the containers of two bitmaps chunk by chunk.
+/// @param KeepLHS Whether to keep containers of *lhs* without a matching
+///                container in *rhs*.
+/// @param KeepRHS Whether to keep containers of *rhs* without a matching
+///                container in *lhs*.
+template <bool KeepLHS, bool KeepRHS, class Operation>
+std::vector<container>
+combine(const std::vector<container>& lhs, const std::vector<container>& rhs,
+        Operation op) {
+  auto result = std::vector<container>{};
+  auto i = lhs.begin();
+  auto j = rhs.begin();
+  while (i != lhs.end() && j != rhs.end()) {
+    if (i->key < j->key) {
+      if constexpr (KeepLHS)
+        result.push_back(*i);
+      ++i;
+    } else if (j->key < i->key) {
+      if constexpr (KeepRHS)
+        result.push_back(*j);
+      ++j;
+    } else {
+      auto x = op(*i, *j);
+      if (x.cardinality > 0)
+        result.push_back(std::move(x));
+      ++i;
+      ++j;
+    }
+  }
+  if constexpr (KeepLHS)
+    result.insert(result.end(), i, lhs.end());
+  if constexpr (KeepRHS)
+    result.insert(result.end(), j, rhs.end());
+  return result;
+}
+
+auto to_fbs(kind x) -> fbs::bitmap::detail::RoaringContainerType {
+  switch (x) {
+    case kind::array:
+      return fbs::bitmap::detail::RoaringContainerType::array;
+    case kind::bitset:
+      return fbs::bitmap::detail::RoaringContainerType::bitset;
+    case kind::run:
+      return fbs::bitmap::detail::RoaringContainerType::run;
+  }
+  __builtin_unreachable();
+}
+
+} // namespace
+
+namespace detail {
+
+bool operator==(const roaring_container& x, const roaring_container& y) {
+  if (x.key != y.key || x.cardinality != y.cardinality)
+    return false;
+  if (x.type == y.type)
+    return x.values == y.values && x.words == y.words;
+  return to_words(x) == to_words(y);
+}
+
+} // namespace detail
+
+roaring_bitmap::roaring_bitmap(size_type n, bool bit) {
+  append_bits(bit, n);
+}
+
+bool roaring_bitmap::empty() const {
+  return num_bits_ == 0;
+}
+
+roaring_bitmap::size_type roaring_bitmap::size() const {
+  return num_bits_;
+}
+
+size_t roaring_bitmap::memusage() const {
+  auto result = containers_.capacity() * sizeof(container);
+  for (const auto& x : containers_)
+    result += x.values.capacity() * sizeof(uint16_t)
+              + x.words.capacity() * sizeof(uint64_t);
+  return result;
+}
+
+const roaring_bitmap::container_vector& roaring_bitmap::containers() const {
+  return containers_;
+}
+
+roaring_bitmap::size_type roaring_bitmap::cardinality() const {
+  auto result = size_type{0};
+  for (const auto& x : containers_)
+    result += x.cardinality;
+  return result;
+}
+
+bool roaring_bitmap::operator[](size_type i) const {
+  TENZIR_ASSERT(i < num_bits_);
+  const auto key = i / chunk_bits;
+  const auto it
+    = std::lower_bound(containers_.begin(), containers_.end(), key,
+                       [](const container& x, uint64_t key) {
+                         return x.key < key;
+                       });
+  if (it == containers_.end() || it->key != key)
+    return false;
+  return container_contains(*it, static_cast<uint16_t>(i % chunk_bits));
+}
+
+void roaring_bitmap::append_bit(bool bit) {
+  TENZIR_ASSERT(num_bits_ < max_size);
+  if (bit)
+    add_range(num_bits_, num_bits_ + 1);
+  ++num_bits_;
+}
+
+void roaring_bitmap::append_bits(bool bit, size_type n) {
+  TENZIR_ASSERT(max_size - num_bits_ >= n);
+  if (bit)
+    add_range(num_bits_, num_bits_ + n);
+  num_bits_ += n;
+}
+
+void roaring_bitmap::append_block(block_type value, size_type n) {
+  TENZIR_ASSERT(n <= word_type::width);
+  TENZIR_ASSERT(max_size - num_bits_ >= n);
+  auto x = n < word_type::width ? value & word_type::lsb_mask(n) : value;
+  // Append the runs of 1-bits in the block.
+  while (x != 0) {
+    const auto first = static_cast<size_type>(std::countr_zero(x));
+    const auto length = static_cast<size_type>(std::countr_one(x >> first));
+    add_range(num_bits_ + first, num_bits_ + first + length);
+    x = first + length == word_type::width
+          ? 0
+          : x & (word_type::all << (first + length));
+  }
+  num_bits_ += n;
+}
+
+void roaring_bitmap::flip() {
+  auto result = container_vector{};
+  const auto num_chunks = (num_bits_ + chunk_bits - 1) / chunk_bits;
+  auto it = containers_.begin();
+  for (auto key = uint64_t{0}; key < num_chunks; ++key) {
+    const auto last = static_cast<uint32_t>(
+      std::min(chunk_bits, num_bits_ - key * chunk_bits));
+    if (it == containers_.end() || it->key != key) {
+      result.push_back(make_full_container(key, last));
+      continue;
+    }
+    auto words = to_words(*it++);
+    for (auto& x : words)
+      x = ~x;
+    // Clear the bits past the end of the bitmap.
+    if (last % 64 != 0)
+      words[last / 64] &= word_type::lsb_mask(last % 64);
+    std::fill(words.begin() + (last + 63) / 64, words.end(), 0);
+    auto x = make_container(key, std::move(words));
+    if (x.cardinality > 0)
+      result.push_back(std::move(x));
+  }
+  containers_ = std::move(result);
+}
+
+void roaring_bitmap::add_range(size_type first, size_type last) {
+  TENZIR_ASSERT(first >= num_bits_);
+  while (first < last) {
+    const auto key = first / chunk_bits;
+    const auto chunk_first = key * chunk_bits;
+    const auto chunk_last = std::min(last, chunk_first + chunk_bits);
+    if (containers_.empty() || containers_.back().key != key) {
+      // The previous container is complete, so we can pick its final
+      // representation.
+      if (!containers_.empty()) {
+        auto& previous = containers_.back();
+        previous = make_container(previous.key, to_words(previous));
+      }
+      auto& x = containers_.emplace_back();
+      x.key = key;
+      // Long ranges of 1-bits are a common pattern, e.g., for the IDs of a
+      // partition, so we start with runs for those.
+      x.type = chunk_last - first >= word_type::width ? kind::run : kind::array;
+    }
+    append_range(containers_.back(), first - chunk_first,
+                 chunk_last - chunk_first);
+    first = chunk_last;
+  }
+}
+
+bool operator==(const roaring_bitmap& x, const roaring_bitmap& y) {
+  return x.num_bits_ == y.num_bits_ && x.containers_ == y.containers_;
+}
+
+roaring_bitmap_range bit_range(const roaring_bitmap& bm) {
+  return roaring_bitmap_range{bm};
+}
+
+auto pack(flatbuffers::FlatBufferBuilder& builder, const roaring_bitmap& from)
+  -> flatbuffers::Offset<fbs::bitmap::RoaringBitmap> {
+  auto container_offsets = std::vector<
+    flatbuffers::Offset<fbs::bitmap::detail::RoaringContainer>>{};
+  container_offsets.reserve(from.containers_.size());
+  for (const auto& x : from.containers_) {
+    auto values_offset = flatbuffers::Offset<flatbuffers::Vector<uint16_t>>{};
+    if (!x.values.empty())
+      values_offset = builder.CreateVector(x.values);
+    auto words_offset = flatbuffers::Offset<flatbuffers::Vector<uint64_t>>{};
+    if (!x.words.empty())
+      words_offset = builder.CreateVector(x.words);
+    container_offsets.push_back(fbs::bitmap::detail::CreateRoaringContainer(
+      builder, x.key, to_fbs(x.type), x.cardinality, values_offset,
+      words_offset));
+  }
+  return fbs::bitmap::CreateRoaringBitmapDirect(builder, &container_offsets,
+                                                from.num_bits_);
+}
+
+auto unpack(const fbs::bitmap::RoaringBitmap& from, roaring_bitmap& to)
+  -> caf::error {
+  to.containers_.clear();
+  to.containers_.reserve(from.containers()->size());
+  to.num_bits_ = from.num_bits();
+  for (const auto* from_container : *from.containers()) {
+    auto& x = to.containers_.emplace_back();
+    x.key = from_container->key();
+    x.cardinality = from_container->cardinality();
+    if (const auto* values = from_container->values())
+      x.values.assign(values->begin(), values->end());
+    if (const auto* words = from_container->words())
+      x.words.assign(words->begin(), words->end());
+    auto valid = true;
+    if (to.containers_.size() > 1)
+      valid = to.containers_.end()[-2].key < x.key;
+    switch (from_container->type()) {
+      case fbs::bitmap::detail::RoaringContainerType::array:
+        x.type = kind::array;
+        break;
+      case fbs::bitmap::detail::RoaringContainerType::bitset:
+        x.type = kind::bitset;
+        break;
+      case fbs::bitmap::detail::RoaringContainerType::run:
+        x.type = kind::run;
+        break;
+      default:
+        valid = false;
+    }
+    valid = valid && is_valid(x, to.num_bits_);
+    if (!valid)
+      return caf::make_error(ec::format_error,
+                             "invalid tenzir.fbs.bitmap.RoaringBitmap "
+                             "container");
+  }
+  return caf::none;
+}
+
+roaring_bitmap
+binary_and(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+  auto result = roaring_bitmap{};
+  result.containers_
+    = combine<false, false>(lhs.containers_, rhs.containers_, container_and);
+  result.num_bits_ = std::max(lhs.num_bits_, rhs.num_bits_);
+  return result;
+}
+
+roaring_bitmap binary_or(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+  auto result = roaring_bitmap{};
+  result.containers_
+    = combine<true, true>(lhs.containers_, rhs.containers_, container_or);
+  result.num_bits_ = std::max(lhs.num_bits_, rhs.num_bits_);
+  return result;
+}
+
+roaring_bitmap
+binary_xor(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+  auto result = roaring_bitmap{};
+  result.containers_
+    = combine<true, true>(lhs.containers_, rhs.containers_, container_xor);
+  result.num_bits_ = std::max(lhs.num_bits_, rhs.num_bits_);
+  return result;
+}
+
+roaring_bitmap
+binary_nand(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+  auto result = roaring_bitmap{};
+  result.containers_
+    = combine<true, false>(lhs.containers_, rhs.containers_, container_nand);
+  result.num_bits_ = std::max(lhs.num_bits_, rhs.num_bits_);
+  return result;
+}
+
+roaring_bitmap_range::roaring_bitmap_range(const roaring_bitmap& bm)
+  : bm_{&bm}, done_{bm.empty()} {
+  if (!done_)
+    scan();
+}
+
+void roaring_bitmap_range::next() {
+  TENZIR_ASSERT(!done());
+  if (position_ == bm_->num_bits_)
+    done_ = true;
+  else
+    scan();
+}
+
+bool roaring_bitmap_range::done() const {
+  return done_;
+}
+
+void roaring_bitmap_range::scan() {
+  const auto& containers = bm_->containers_;
+  const auto size = bm_->num_bits_;
+  TENZIR_ASSERT(position_ < size);
+  const auto key = position_ / chunk_bits;
+  if (words_.empty() && next_ < containers.size()
+      && containers[next_].key == key)
+    words_ = to_words(containers[next_++]);
+  if (words_.empty()) {
+    // Produce a run of 0-bits up to the next container.
+    auto last = size;
+    if (next_ < containers.size())
+      last = std::min(last, containers[next_].key * chunk_bits);
+    bits_ = {word_type::none, last - position_};
+    position_ = last;
+    return;
+  }
+  const auto chunk_first = key * chunk_bits;
+  auto i = (position_ - chunk_first) / word_type::width;
+  const auto remaining = size - position_;
+  if (remaining < word_type::width) {
+    bits_ = {words_[i], remaining};
+    position_ = size;
+    return;
+  }
+  // Merge consecutive homogeneous words into a single run.
+  const auto data = words_[i];
+  auto n = word_type::width;
+  if (word_type::all_or_none(data))
+    while (i + 1 < words_.size() && words_[i + 1] == data
+           && remaining - n >= word_type::width) {
+      ++i;
+      n += word_type::width;
+    }
+  bits_ = {data, n};
+  position_ += n;
+  if (position_ - chunk_first == chunk_bits)
+    words_.clear();
+}
+
+} // namespace tenzir
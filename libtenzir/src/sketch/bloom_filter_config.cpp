@@ -8,6 +8,7 @@
 
 #include "tenzir/sketch/bloom_filter_config.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 
@@ -21,6 +22,52 @@ bloom_filter_params make(uint64_t m, uint64_t n, uint64_t k, double p) {
   return {m, n, k, p};
 }
 
+/// The number of bits in a block of a split-block Bloom filter, and the number
+/// of bits per 32-bit word in the block.
+constexpr auto split_block_bits = uint64_t{256};
+constexpr auto split_block_word_bits = 32.0;
+constexpr auto split_block_k = uint64_t{8};
+
+/// Computes the false-positive probability of a split-block Bloom filter. The
+/// number of elements per block follows a Poisson distribution, and a block
+/// with *i* elements has a false-positive probability of (1 - (31/32)^i)^8,
+/// because every element sets one bit in each of the 8 words of the block.
+double split_block_fp_rate(uint64_t num_blocks, uint64_t n) {
+  const auto lambda = static_cast<double>(n) / static_cast<double>(num_blocks);
+  const auto sd = std::sqrt(lambda);
+  const auto first = std::max(0.0, std::floor(lambda - 10 * sd - 10));
+  const auto last = std::ceil(lambda + 10 * sd + 10);
+  const auto unset = 1.0 - 1.0 / split_block_word_bits;
+  auto result = 0.0;
+  for (auto i = first; i <= last; ++i) {
+    const auto log_pmf = -lambda + i * std::log(lambda) - std::lgamma(i + 1);
+    result += std::exp(log_pmf)
+              * std::pow(1.0 - std::pow(unset, i),
+                         static_cast<double>(split_block_k));
+  }
+  return std::min(1.0, result);
+}
+
+/// Finds the smallest positive value for which a monotonic predicate holds.
+template <class Predicate>
+std::optional<uint64_t> find_smallest(Predicate predicate) {
+  auto hi = uint64_t{1};
+  while (!predicate(hi)) {
+    if (hi > (uint64_t{1} << 56))
+      return {};
+    hi *= 2;
+  }
+  auto lo = hi / 2;
+  while (lo + 1 < hi) {
+    const auto mid = lo + (hi - lo) / 2;
+    if (predicate(mid))
+      hi = mid;
+    else
+      lo = mid;
+  }
+  return hi;
+}
+
 } // namespace
 
 std::optional<bloom_filter_params> evaluate(bloom_filter_config cfg) {
@@ -71,4 +118,44 @@ std::optional<bloom_filter_params> evaluate(bloom_filter_config cfg) {
   return {};
 }
 
+std::optional<bloom_filter_params>
+evaluate_split_block(bloom_filter_config cfg) {
+  if (cfg.m && *cfg.m <= 0)
+    return {};
+  if (cfg.n && *cfg.n <= 0)
+    return {};
+  if (cfg.k && *cfg.k != split_block_k)
+    return {};
+  if (cfg.p && (*cfg.p <= 0 || *cfg.p >= 1))
+    return {};
+  if (cfg.m && cfg.n && !cfg.p) {
+    auto num_blocks = (*cfg.m + split_block_bits - 1) / split_block_bits;
+    auto p = split_block_fp_rate(num_blocks, *cfg.n);
+    return bloom_filter_params{num_blocks * split_block_bits, *cfg.n,
+                               split_block_k, p};
+  } else if (!cfg.m && cfg.n && cfg.p) {
+    auto num_blocks = find_smallest([&](uint64_t num_blocks) {
+      return split_block_fp_rate(num_blocks, *cfg.n) <= *cfg.p;
+    });
+    if (!num_blocks)
+      return {};
+    auto p = split_block_fp_rate(*num_blocks, *cfg.n);
+    return bloom_filter_params{*num_blocks * split_block_bits, *cfg.n,
+                               split_block_k, p};
+  } else if (cfg.m && !cfg.n && cfg.p) {
+    auto num_blocks = (*cfg.m + split_block_bits - 1) / split_block_bits;
+    // The largest n that satisfies p is one less than the smallest n that
+    // does not.
+    auto n = find_smallest([&](uint64_t n) {
+      return split_block_fp_rate(num_blocks, n) > *cfg.p;
+    });
+    if (!n || *n == 1)
+      return {};
+    auto p = split_block_fp_rate(num_blocks, *n - 1);
+    return bloom_filter_params{num_blocks * split_block_bits, *n - 1,
+                               split_block_k, p};
+  }
+  return {};
+}
+
 } // namespace tenzir::sketch
@@ -0,0 +1,79 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/sketch/hyperloglog.hpp"
+
+#include "tenzir/error.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+namespace tenzir::sketch {
+
+namespace {
+
+/// The cardinalities below which linear counting is more accurate than the
+/// raw HyperLogLog estimate, indexed by `precision - min_precision`. Taken from
+/// the HyperLogLog++ paper.
+constexpr auto linear_counting_thresholds = std::array<double, 15>{
+  10,    20,    40,    80,     220,    400,    900,    1'800,
+  3'100, 6'500, 11'500, 20'000, 50'000, 120'000, 350'000,
+};
+
+} // namespace
+
+hyperloglog::hyperloglog(uint8_t precision)
+  : precision_{precision}, registers_(size_t{1} << precision, 0) {
+  TENZIR_ASSERT(precision >= min_precision);
+  TENZIR_ASSERT(precision <= max_precision);
+}
+
+void hyperloglog::add(uint64_t digest) noexcept {
+  const auto index = digest >> (64 - precision_);
+  // The sentinel bit bounds the rank if all remaining bits are zero.
+  const auto remainder = (digest << precision_)
+                         | (uint64_t{1} << (precision_ - 1));
+  const auto rank = static_cast<uint8_t>(std::countl_zero(remainder) + 1);
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+void hyperloglog::merge(const hyperloglog& other) noexcept {
+  TENZIR_ASSERT(precision_ == other.precision_);
+  for (size_t i = 0; i < registers_.size(); ++i) {
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+  }
+}
+
+auto hyperloglog::estimate() const noexcept -> double {
+  const auto m = static_cast<double>(registers_.size());
+  auto sum = 0.0;
+  auto zeros = size_t{0};
+  for (auto value : registers_) {
+    sum += std::ldexp(1.0, -value);
+    zeros += value == 0 ? 1 : 0;
+  }
+  if (zeros > 0) {
+    const auto linear_count = m * std::log(m / static_cast<double>(zeros));
+    if (linear_count <= linear_counting_thresholds[precision_ - min_precision])
+      return linear_count;
+  }
+  const auto alpha = 0.7213 / (1.0 + 1.079 / m);
+  return alpha * m * m / sum;
+}
+
+auto hyperloglog::precision() const noexcept -> uint8_t {
+  return precision_;
+}
+
+auto mem_usage(const hyperloglog& x) noexcept -> size_t {
+  return sizeof(x) + x.registers_.size();
+}
+
+} // namespace tenzir::sketch
@@ -0,0 +1,141 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/sketch/split_block_bloom_filter.hpp"
+
+#include "tenzir/error.hpp"
+#include "tenzir/fbs/utils.hpp"
+
+#include <fmt/format.h>
+
+namespace tenzir::sketch {
+
+caf::expected<frozen_split_block_bloom_filter>
+frozen_split_block_bloom_filter::make(chunk_ptr table) {
+  if (!table || table->size() == 0)
+    return caf::make_error(ec::format_error, "empty Bloom filter");
+  auto verifier = fbs::make_verifier(as_bytes(table));
+  if (!fbs::VerifyBloomFilterBuffer(verifier))
+    return caf::make_error(ec::format_error,
+                           "failed to verify Bloom filter flatbuffer");
+  auto view = immutable_split_block_bloom_filter_view{};
+  if (auto err = unpack(*fbs::GetBloomFilter(table->data()), view))
+    return err;
+  return frozen_split_block_bloom_filter{std::move(table)};
+}
+
+frozen_split_block_bloom_filter::frozen_split_block_bloom_filter(
+  chunk_ptr table) noexcept
+  : table_{std::move(table)} {
+  TENZIR_ASSERT(table_ != nullptr);
+  TENZIR_ASSERT(table_->data() != nullptr);
+  auto root = fbs::GetBloomFilter(table_->data());
+  auto err = unpack(*root, view_);
+  TENZIR_ASSERT(!err);
+}
+
+bool frozen_split_block_bloom_filter::lookup(uint64_t digest) const noexcept {
+  return view_.lookup(digest);
+}
+
+const bloom_filter_params&
+frozen_split_block_bloom_filter::parameters() const noexcept {
+  return view_.parameters();
+}
+
+uint64_t frozen_split_block_bloom_filter::num_elements() const noexcept {
+  return view_.num_elements();
+}
+
+const chunk_ptr& frozen_split_block_bloom_filter::table() const noexcept {
+  return table_;
+}
+
+size_t mem_usage(const frozen_split_block_bloom_filter& x) noexcept {
+  return mem_usage(x.view_) + x.table_->size();
+}
+
+split_block_bloom_filter thaw(const frozen_split_block_bloom_filter& x) {
+  const auto& bits = x.view_.bits_;
+  return split_block_bloom_filter{x.parameters(),
+                                  {bits.begin(), bits.end()},
+                                  x.num_elements()};
+}
+
+caf::expected<split_block_bloom_filter>
+split_block_bloom_filter::make(bloom_filter_config cfg) {
+  if (auto params = evaluate_split_block(cfg)) {
+    auto bits = std::vector<uint64_t>(params->m / 64, 0);
+    return split_block_bloom_filter{*params, std::move(bits), 0};
+  }
+  return caf::make_error(ec::invalid_argument, "failed to evaluate parameters");
+}
+
+split_block_bloom_filter::split_block_bloom_filter(
+  const split_block_bloom_filter& other)
+  : split_block_bloom_filter{other.parameters(), other.bits_,
+                             other.num_elements()} {
+  // nop
+}
+
+split_block_bloom_filter&
+split_block_bloom_filter::operator=(const split_block_bloom_filter& other) {
+  if (this != &other)
+    *this = split_block_bloom_filter{other};
+  return *this;
+}
+
+bool split_block_bloom_filter::add(uint64_t digest) noexcept {
+  return view_.add(digest);
+}
+
+bool split_block_bloom_filter::lookup(uint64_t digest) const noexcept {
+  return view_.lookup(digest);
+}
+
+const bloom_filter_params&
+split_block_bloom_filter::parameters() const noexcept {
+  return view_.parameters();
+}
+
+uint64_t split_block_bloom_filter::num_elements() const noexcept {
+  return view_.num_elements();
+}
+
+size_t mem_usage(const split_block_bloom_filter& x) {
+  return sizeof(x) + x.bits_.size() * 8;
+}
+
+caf::expected<frozen_split_block_bloom_filter>
+freeze(const split_block_bloom_filter& x) {
+  constexpr auto fixed_size = 80;
+  const auto expected_size = fixed_size + x.bits_.size() * sizeof(uint64_t);
+  // FlatBuffers <= 1.11 does not correctly use '::flatbuffers::soffset_t' over
+  // 'soffset_t' in FLATBUFFERS_MAX_BUFFER_SIZE.
+  using ::flatbuffers::soffset_t;
+  if (expected_size >= FLATBUFFERS_MAX_BUFFER_SIZE)
+    return caf::make_error(
+      ec::invalid_argument,
+      fmt::format("frozen size {} exceeds max flatbuffer size of {} bytes",
+                  expected_size, FLATBUFFERS_MAX_BUFFER_SIZE));
+  flatbuffers::FlatBufferBuilder builder{expected_size};
+  auto bloom_filter_offset = pack(builder, x.view_);
+  if (!bloom_filter_offset)
+    return bloom_filter_offset.error();
+  builder.Finish(*bloom_filter_offset);
+  return frozen_split_block_bloom_filter{chunk::make(builder.Release())};
+}
+
+split_block_bloom_filter::split_block_bloom_filter(bloom_filter_params params,
+                                                   std::vector<uint64_t> bits,
+                                                   uint64_t num_elements)
+  : bits_{std::move(bits)} {
+  view_ = {params, std::span{bits_.data(), bits_.size()}, num_elements};
+}
+
+} // namespace tenzir::sketch
@@ -0,0 +1,142 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/sketch/tdigest.hpp"
+
+#include "tenzir/error.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace tenzir::sketch {
+
+tdigest::tdigest(double compression) : compression_{compression} {
+  TENZIR_ASSERT(compression >= 10.0);
+}
+
+void tdigest::add(double value, double weight) {
+  if (std::isnan(value) or weight <= 0.0)
+    return;
+  if (total_weight_ == 0.0) {
+    min_ = value;
+    max_ = value;
+  } else {
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+  total_weight_ += weight;
+  buffer_.push_back({value, weight});
+  // Buffering a multiple of the compression amortizes the cost of sorting.
+  if (static_cast<double>(buffer_.size()) >= 5.0 * compression_)
+    compress();
+}
+
+void tdigest::merge(const tdigest& other) {
+  if (other.total_weight_ == 0.0)
+    return;
+  if (total_weight_ == 0.0) {
+    min_ = other.min_;
+    max_ = other.max_;
+  } else {
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+  total_weight_ += other.total_weight_;
+  buffer_.insert(buffer_.end(), other.centroids_.begin(),
+                 other.centroids_.end());
+  buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+  compress();
+}
+
+void tdigest::compress() {
+  if (buffer_.empty())
+    return;
+  buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+  std::sort(buffer_.begin(), buffer_.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return lhs.mean < rhs.mean;
+            });
+  centroids_.clear();
+  // The arcsine scale function k(q) and its inverse. A centroid may span at
+  // most one unit of k.
+  const auto normalizer = compression_ / (2.0 * std::numbers::pi);
+  const auto k_max = normalizer * std::numbers::pi / 2.0;
+  const auto k = [&](double q) {
+    return normalizer * std::asin(2.0 * std::clamp(q, 0.0, 1.0) - 1.0);
+  };
+  const auto k_inverse = [&](double x) {
+    return (std::sin(std::min(x, k_max) / normalizer) + 1.0) / 2.0;
+  };
+  auto weight_so_far = 0.0;
+  auto weight_limit = k_inverse(k(0.0) + 1.0) * total_weight_;
+  auto current = buffer_.front();
+  for (auto it = std::next(buffer_.begin()); it != buffer_.end(); ++it) {
+    if (weight_so_far + current.weight + it->weight <= weight_limit) {
+      current.weight += it->weight;
+      current.mean += (it->mean - current.mean) * it->weight / current.weight;
+      continue;
+    }
+    weight_so_far += current.weight;
+    centroids_.push_back(current);
+    weight_limit
+      = k_inverse(k(weight_so_far / total_weight_) + 1.0) * total_weight_;
+    current = *it;
+  }
+  centroids_.push_back(current);
+  buffer_.clear();
+}
+
+auto tdigest::quantile(double q) -> std::optional<double> {
+  TENZIR_ASSERT(q >= 0.0 and q <= 1.0);
+  compress();
+  if (centroids_.empty())
+    return std::nullopt;
+  if (q == 0.0)
+    return min_;
+  if (q == 1.0)
+    return max_;
+  if (centroids_.size() == 1)
+    return centroids_.front().mean;
+  // We interpolate linearly between the centers of adjacent centroids, and
+  // between the outermost centroids and the observed extremes.
+  const auto rank = q * total_weight_;
+  const auto& first = centroids_.front();
+  if (rank < first.weight / 2.0)
+    return min_ + rank / (first.weight / 2.0) * (first.mean - min_);
+  auto cumulative = first.weight / 2.0;
+  for (size_t i = 0; i + 1 < centroids_.size(); ++i) {
+    const auto& lhs = centroids_[i];
+    const auto& rhs = centroids_[i + 1];
+    const auto distance = (lhs.weight + rhs.weight) / 2.0;
+    if (rank < cumulative + distance)
+      return lhs.mean + (rank - cumulative) / distance * (rhs.mean - lhs.mean);
+    cumulative += distance;
+  }
+  const auto& last = centroids_.back();
+  const auto fraction
+    = std::min(1.0, (rank - cumulative) / (last.weight / 2.0));
+  return last.mean + fraction * (max_ - last.mean);
+}
+
+auto tdigest::total_weight() const noexcept -> double {
+  return total_weight_;
+}
+
+auto tdigest::centroids() -> const std::vector<centroid>& {
+  compress();
+  return centroids_;
+}
+
+auto mem_usage(const tdigest& x) noexcept -> size_t {
+  return sizeof(x)
+         + (x.centroids_.capacity() + x.buffer_.capacity())
+             * sizeof(tdigest::centroid);
+}
+
+} // namespace tenzir::sketch
@@ -9,7 +9,9 @@
 #include "tenzir/store.hpp"
 
 #include "tenzir/atoms.hpp"
+#include "tenzir/chunk.hpp"
 #include "tenzir/detail/narrow.hpp"
+#include "tenzir/diagnostics.hpp"
 #include "tenzir/error.hpp"
 #include "tenzir/ids.hpp"
 #include "tenzir/query_context.hpp"
@@ -236,6 +238,40 @@ base_store::extract(expression expr, ids selection) const {
   }
 }
 
+generator<table_slice>
+passive_store::load_incrementally(generator<chunk_ptr> input,
+                                  diagnostic_handler& dh) {
+  auto chunks = std::vector<chunk_ptr>{};
+  for (auto&& chunk : input) {
+    if (chunk && chunk->size() > 0)
+      chunks.push_back(std::move(chunk));
+    co_yield {};
+  }
+  if (chunks.empty())
+    co_return;
+  if (chunks.size() == 1) {
+    if (auto err = load(std::move(chunks.front()))) {
+      diagnostic::error(err).note("parser failed to load").emit(dh);
+      co_return;
+    }
+  } else {
+    diagnostic::warning("loading files incrementally is not currently "
+                        "supported; parser may use excessive amounts of memory")
+      .hint("consider using `from file --mmap` to load the file")
+      .emit(dh);
+    auto buffer = std::vector<std::byte>{};
+    for (auto&& chunk : chunks)
+      buffer.insert(buffer.end(), chunk->begin(), chunk->end());
+    chunks.clear();
+    if (auto err = load(chunk::make(std::move(buffer)))) {
+      diagnostic::error(err).note("parser failed to load").emit(dh);
+      co_return;
+    }
+  }
+  for (auto&& slice : slices())
+    co_yield std::move(slice);
+}
+
 default_passive_store_actor::behavior_type default_passive_store(
   default_passive_store_actor::stateful_pointer<default_passive_store_state>
     self,
@@ -0,0 +1,131 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/tcp_framing.hpp"
+
+#include "tenzir/detail/assert.hpp"
+#include "tenzir/error.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace tenzir {
+
+auto parse_tcp_framing(std::string_view str) -> std::optional<tcp_framing> {
+  if (str == "none")
+    return tcp_framing::none;
+  if (str == "newline")
+    return tcp_framing::newline;
+  if (str == "octet-counting")
+    return tcp_framing::octet_counting;
+  return std::nullopt;
+}
+
+tcp_framer::tcp_framer(tcp_framing framing) : framing_{framing} {
+}
+
+auto tcp_framer::read_size() const -> size_t {
+  return std::max(carry_.size() + min_read_size, required_);
+}
+
+auto tcp_framer::prepare(std::span<std::byte> buffer) -> size_t {
+  TENZIR_ASSERT(buffer.size() >= read_size());
+  std::copy(carry_.begin(), carry_.end(), buffer.begin());
+  const auto offset = carry_.size();
+  carry_.clear();
+  return offset;
+}
+
+auto tcp_framer::frame(std::span<std::byte> buffer, size_t size)
+  -> caf::expected<size_t> {
+  TENZIR_ASSERT(size <= buffer.size());
+  switch (framing_) {
+    case tcp_framing::none:
+      return size;
+    case tcp_framing::newline:
+      return frame_newline(buffer, size);
+    case tcp_framing::octet_counting:
+      return frame_octet_counting(buffer, size);
+  }
+  TENZIR_UNREACHABLE();
+}
+
+auto tcp_framer::finish() -> caf::expected<std::vector<std::byte>> {
+  if (framing_ == tcp_framing::octet_counting && not carry_.empty())
+    return caf::make_error(ec::end_of_input,
+                           "connection closed within an octet-counted frame");
+  return std::exchange(carry_, {});
+}
+
+auto tcp_framer::frame_newline(std::span<std::byte> buffer, size_t size)
+  -> size_t {
+  auto data = buffer.first(size);
+  auto last = std::find(data.rbegin(), data.rend(), std::byte{'\n'});
+  // If a single line exceeds the entire buffer or the maximum frame size, we
+  // have to cut it. Otherwise, a peer that never sends a newline makes the
+  // carried-over bytes grow without bounds.
+  auto end = last != data.rend() ? static_cast<size_t>(data.rend() - last)
+             : size == buffer.size() || size >= max_frame_size ? size
+                                                               : 0;
+  carry_.assign(data.begin() + end, data.end());
+  return end;
+}
+
+auto tcp_framer::frame_octet_counting(std::span<std::byte> buffer, size_t size)
+  -> caf::expected<size_t> {
+  // Every frame is prefixed with its length and a space, so writing the
+  // frames back with a trailing newline never overtakes the input.
+  const auto is_digit = [](std::byte x) {
+    return x >= std::byte{'0'} && x <= std::byte{'9'};
+  };
+  auto in = size_t{0};
+  auto out = size_t{0};
+  required_ = 0;
+  while (in < size) {
+    // Tolerate newlines in between frames, which some senders emit.
+    if (buffer[in] == std::byte{'\n'} || buffer[in] == std::byte{'\r'}) {
+      ++in;
+      continue;
+    }
+    auto header_end = in;
+    while (header_end < size && header_end - in < 8
+           && is_digit(buffer[header_end]))
+      ++header_end;
+    if (header_end == size)
+      break;
+    if (header_end == in || buffer[header_end] != std::byte{' '})
+      return caf::make_error(ec::parse_error,
+                             "invalid octet-counted frame: expected message "
+                             "length followed by a space");
+    auto length = size_t{0};
+    for (auto i = in; i < header_end; ++i)
+      length = length * 10 + (static_cast<size_t>(buffer[i]) - '0');
+    if (length == 0 || length > max_frame_size)
+      return caf::make_error(ec::parse_error,
+                             fmt::format("invalid octet-counted frame: "
+                                         "message length {} is out of "
+                                         "bounds",
+                                         length));
+    const auto frame_end = header_end + 1 + length;
+    if (frame_end > size) {
+      required_ = frame_end - in;
+      break;
+    }
+    std::memmove(buffer.data() + out, buffer.data() + header_end + 1, length);
+    out += length;
+    buffer[out++] = std::byte{'\n'};
+    in = frame_end;
+  }
+  carry_.assign(buffer.begin() + in, buffer.begin() + size);
+  return out;
+}
+
+} // namespace tenzir
@@ -21,7 +21,11 @@
 namespace tenzir {
 
 value_index::value_index(tenzir::type t, caf::settings opts)
-  : type_{std::move(t)}, opts_{std::move(opts)} {
+  : type_{std::move(t)},
+    opts_{std::move(opts)},
+    encoding_{caf::get_or(opts_, "roaring-bitmaps", false)
+                ? bitmap_encoding::roaring
+                : bitmap_encoding::ewah} {
   // nop
 }
 
@@ -30,6 +34,7 @@ caf::expected<void> value_index::append(data_view x) {
 }
 
 caf::expected<void> value_index::append(data_view x, id pos) {
+  auto guard = bitmap_encoding_guard{encoding_};
   auto off = offset();
   if (pos < off)
     // Can only append at the end
@@ -49,6 +54,7 @@ caf::expected<void> value_index::append(data_view x, id pos) {
 
 caf::expected<ids>
 value_index::lookup(relational_operator op, data_view x) const {
+  auto guard = bitmap_encoding_guard{encoding_};
   // When x is null, we can answer the query right here.
   if (caf::holds_alternative<caf::none_t>(x)) {
     if (!(op == relational_operator::equal
@@ -97,6 +103,10 @@ const caf::settings& value_index::options() const {
   return opts_;
 }
 
+bitmap_encoding value_index::encoding() const {
+  return encoding_;
+}
+
 bool value_index::inspect_impl(supported_inspectors& inspector) {
   return std::visit(
     [this](auto visitor) {
@@ -164,6 +174,8 @@ caf::error unpack(const fbs::ValueIndex& from, value_index_ptr& to) {
       return do_unpack(*from.value_index_as_subnet()->base());
     case fbs::value_index::ValueIndex::string:
       return do_unpack(*from.value_index_as_string()->base());
+    case fbs::value_index::ValueIndex::trigram:
+      return do_unpack(*from.value_index_as_trigram()->base());
   }
   return caf::make_error(ec::format_error, "unexpected value index type");
 }
@@ -19,6 +19,7 @@
 #include "tenzir/index/list_index.hpp"
 #include "tenzir/index/string_index.hpp"
 #include "tenzir/index/subnet_index.hpp"
+#include "tenzir/index/trigram_index.hpp"
 #include "tenzir/logger.hpp"
 #include "tenzir/type.hpp"
 #include "tenzir/value_index.hpp"
@@ -57,6 +58,13 @@ value_index_ptr make(type x, caf::settings opts) {
     }
   }
   if (auto index = x.attribute("index")) {
+    if (*index == "trigram"sv) {
+      if (!caf::holds_alternative<string_type>(x)) {
+        TENZIR_ERROR("{} trigram index requires a string type", __func__);
+        return nullptr;
+      }
+      return std::make_unique<trigram_index>(std::move(x), std::move(opts));
+    }
     if (*index == "hash"sv) {
       auto i = opts.find("cardinality");
       if (i == opts.end())
@@ -0,0 +1,182 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/detail/aggregation_kernels.hpp"
+
+#include "tenzir/aggregation_function.hpp"
+#include "tenzir/data.hpp"
+#include "tenzir/plugin.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <arrow/builder.h>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string_view>
+#include <vector>
+
+using namespace tenzir;
+
+namespace {
+
+using array_ptr = std::shared_ptr<arrow::Array>;
+
+/// Creates an array from `xs`, where `std::nullopt` denotes a null value.
+template <class Builder, class T>
+auto make_array(const std::vector<std::optional<T>>& xs) -> array_ptr {
+  auto b = Builder{};
+  for (const auto& x : xs) {
+    auto status = x ? b.Append(*x) : b.AppendNull();
+    REQUIRE(status.ok());
+  }
+  return b.Finish().ValueOrDie();
+}
+
+auto int64s(const std::vector<std::optional<int64_t>>& xs) -> array_ptr {
+  return make_array<arrow::Int64Builder>(xs);
+}
+
+auto uint64s(const std::vector<std::optional<uint64_t>>& xs) -> array_ptr {
+  return make_array<arrow::UInt64Builder>(xs);
+}
+
+auto doubles(const std::vector<std::optional<double>>& xs) -> array_ptr {
+  return make_array<arrow::DoubleBuilder>(xs);
+}
+
+/// Runs the aggregation function `name` over `arrays` using the batch API.
+auto aggregate(std::string_view name, const type& input_type,
+               const std::vector<array_ptr>& arrays) -> data {
+  const auto* plugin = plugins::find<aggregation_function_plugin>(name);
+  REQUIRE(plugin);
+  auto function = unbox(plugin->make_aggregation_function(input_type));
+  for (const auto& array : arrays)
+    function->add(*array);
+  return unbox(std::move(*function).finish());
+}
+
+} // namespace
+
+TEST(select extremum skips nulls) {
+  const auto xs = int64s({std::nullopt, 3, -7, std::nullopt, 12, 5});
+  CHECK_EQUAL(detail::select_extremum<int64_type>(*xs, std::less<>{}),
+              int64_t{-7});
+  CHECK_EQUAL(detail::select_extremum<int64_type>(*xs, std::greater<>{}),
+              int64_t{12});
+  const auto ys = uint64s({std::numeric_limits<uint64_t>::max(), std::nullopt,
+                           uint64_t{1}});
+  CHECK_EQUAL(detail::select_extremum<uint64_type>(*ys, std::less<>{}),
+              uint64_t{1});
+  CHECK_EQUAL(detail::select_extremum<uint64_type>(*ys, std::greater<>{}),
+              std::numeric_limits<uint64_t>::max());
+  const auto zs = doubles({std::nullopt, 0.5, -1.5, std::nullopt});
+  CHECK_EQUAL(detail::select_extremum<double_type>(*zs, std::less<>{}), -1.5);
+  CHECK_EQUAL(detail::select_extremum<double_type>(*zs, std::greater<>{}),
+              0.5);
+}
+
+TEST(select extremum of empty and null arrays) {
+  CHECK(!detail::select_extremum<int64_type>(*int64s({}), std::less<>{}));
+  CHECK(!detail::select_extremum<uint64_type>(
+    *uint64s({std::nullopt, std::nullopt}), std::less<>{}));
+  CHECK(!detail::select_extremum<double_type>(*doubles({std::nullopt}),
+                                              std::greater<>{}));
+}
+
+TEST(select extremum respects the array offset) {
+  const auto xs = int64s({-100, 4, std::nullopt, 2, 100});
+  const auto slice = xs->Slice(1, 3);
+  CHECK_EQUAL(detail::select_extremum<int64_type>(*slice, std::less<>{}),
+              int64_t{2});
+  CHECK_EQUAL(detail::select_extremum<int64_type>(*slice, std::greater<>{}),
+              int64_t{4});
+}
+
+TEST(insert distinct skips nulls and repeated values) {
+  auto xs = std::set<int64_t>{};
+  detail::insert_distinct(
+    int64_type{}, *int64s({1, 1, std::nullopt, 1, 2, 2, std::nullopt, 3}), xs);
+  CHECK_EQUAL(xs, (std::set<int64_t>{1, 2, 3}));
+  auto ys = std::set<uint64_t>{};
+  detail::insert_distinct(uint64_type{}, *uint64s({7, std::nullopt, 7}), ys);
+  CHECK_EQUAL(ys, (std::set<uint64_t>{7}));
+  auto zs = std::set<double>{};
+  detail::insert_distinct(double_type{}, *doubles({0.5, 1.5, 0.5}), zs);
+  CHECK_EQUAL(zs, (std::set<double>{0.5, 1.5}));
+}
+
+TEST(insert distinct of empty and null arrays) {
+  auto xs = std::set<int64_t>{};
+  detail::insert_distinct(int64_type{}, *int64s({}), xs);
+  detail::insert_distinct(int64_type{}, *int64s({std::nullopt}), xs);
+  CHECK(xs.empty());
+}
+
+TEST(sum batches) {
+  // The runs of two and five values exercise both the unrolled loop and its
+  // remainder.
+  CHECK_EQUAL(aggregate("sum", type{int64_type{}},
+                        {int64s({1, 2, std::nullopt, 3, 4, 5, 6, -7}),
+                         int64s({}), int64s({std::nullopt})}),
+              data{int64_t{14}});
+  CHECK_EQUAL(aggregate("sum", type{uint64_type{}},
+                        {uint64s({std::nullopt, 10}), uint64s({20, 30})}),
+              data{uint64_t{60}});
+  CHECK_EQUAL(aggregate("sum", type{double_type{}},
+                        {doubles({0.5, std::nullopt, 1.25}), doubles({})}),
+              data{1.75});
+  CHECK_EQUAL(aggregate("sum", type{int64_type{}},
+                        {int64s({}), int64s({std::nullopt, std::nullopt})}),
+              data{});
+}
+
+TEST(min and max batches) {
+  CHECK_EQUAL(aggregate("min", type{int64_type{}},
+                        {int64s({3, std::nullopt}), int64s({-1, 8})}),
+              data{int64_t{-1}});
+  CHECK_EQUAL(aggregate("max", type{uint64_type{}},
+                        {uint64s({}), uint64s({std::nullopt, 4, 9})}),
+              data{uint64_t{9}});
+  CHECK_EQUAL(aggregate("min", type{double_type{}},
+                        {doubles({2.5}), doubles({std::nullopt, -0.5})}),
+              data{-0.5});
+  CHECK_EQUAL(aggregate("max", type{double_type{}},
+                        {doubles({}), doubles({std::nullopt})}),
+              data{});
+}
+
+TEST(distinct and count_distinct batches) {
+  const auto xs = std::vector<array_ptr>{
+    int64s({2, 1, std::nullopt, 2}),
+    int64s({}),
+    int64s({1, 3, std::nullopt}),
+  };
+  CHECK_EQUAL(aggregate("distinct", type{int64_type{}}, xs),
+              data{list{int64_t{1}, int64_t{2}, int64_t{3}}});
+  CHECK_EQUAL(aggregate("count_distinct", type{int64_type{}}, xs),
+              data{uint64_t{3}});
+  const auto ys = std::vector<array_ptr>{
+    uint64s({5, 5, std::nullopt}),
+    uint64s({6}),
+  };
+  CHECK_EQUAL(aggregate("count_distinct", type{uint64_type{}}, ys),
+              data{uint64_t{2}});
+  const auto zs = std::vector<array_ptr>{
+    doubles({0.5, std::nullopt}),
+    doubles({0.5, 1.0}),
+  };
+  CHECK_EQUAL(aggregate("distinct", type{double_type{}}, zs),
+              data{list{0.5, 1.0}});
+  CHECK_EQUAL(aggregate("count_distinct", type{double_type{}},
+                        {doubles({}), doubles({std::nullopt})}),
+              data{uint64_t{0}});
+}
@@ -15,10 +15,13 @@
 #include "tenzir/flatbuffer.hpp"
 #include "tenzir/ids.hpp"
 #include "tenzir/null_bitmap.hpp"
+#include "tenzir/roaring_bitmap.hpp"
 #include "tenzir/test/test.hpp"
 
 #include <caf/test/dsl.hpp>
 
+#include <random>
+
 using namespace tenzir;
 using namespace std::string_literals;
 
@@ -486,6 +489,14 @@ TEST(wah_bitmap) {
 
 FIXTURE_SCOPE_END()
 
+FIXTURE_SCOPE(roaring_bitmap_tests, bitmap_test_harness<roaring_bitmap>)
+
+TEST(roaring_bitmap) {
+  execute();
+}
+
+FIXTURE_SCOPE_END()
+
 FIXTURE_SCOPE(bitmap_tests, bitmap_test_harness<bitmap>)
 
 TEST(bitmap) {
@@ -913,3 +924,195 @@ TEST(EWAH RLE print 2) {
   // CHECK_EQUAL(str, "1F1T421F2T");
   CHECK_EQUAL(str, "1F1T62F320F39F2T");
 }
+
+namespace {
+
+// Appends the same random sequence of bits to a Roaring and an EWAH bitmap,
+// mixing sparse stretches, dense stretches, and long runs across multiple
+// Roaring chunks.
+void append_random(roaring_bitmap& roaring, ewah_bitmap& ewah, uint64_t seed) {
+  auto gen = std::mt19937_64{seed};
+  while (roaring.size() < 300'000) {
+    switch (gen() % 3) {
+      case 0: {
+        auto n = gen() % 100'000;
+        auto bit = gen() % 2 == 0;
+        roaring.append_bits(bit, n);
+        ewah.append_bits(bit, n);
+        break;
+      }
+      case 1: {
+        for (auto i = 0; i < 1'000; ++i) {
+          auto block = gen() & gen() & gen();
+          roaring.append_block(block);
+          ewah.append_block(block);
+        }
+        break;
+      }
+      case 2: {
+        for (auto i = 0; i < 10'000; ++i) {
+          auto bit = gen() % 64 == 0;
+          roaring.append_bit(bit);
+          ewah.append_bit(bit);
+        }
+        break;
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST(Roaring container types) {
+  using container = roaring_bitmap::container;
+  roaring_bitmap bm;
+  bm.append_bits(false, 10);
+  bm.append_bit(true);
+  bm.append_bits(false, 65'525);
+  bm.append_bits(true, 65'536);
+  for (auto i = 0; i < 65'536; ++i)
+    bm.append_bit(i % 2 == 0);
+  bm.append_bit(true);
+  const auto& containers = bm.containers();
+  REQUIRE_EQUAL(containers.size(), 4u);
+  CHECK(containers[0].type == container::kind::array);
+  CHECK_EQUAL(containers[0].cardinality, 1u);
+  CHECK(containers[1].type == container::kind::run);
+  CHECK_EQUAL(containers[1].cardinality, 65'536u);
+  CHECK(containers[2].type == container::kind::bitset);
+  CHECK_EQUAL(containers[2].cardinality, 32'768u);
+  CHECK(containers[3].type == container::kind::array);
+  CHECK_EQUAL(rank(bm), 1u + 65'536u + 32'768u + 1u);
+}
+
+TEST(Roaring element access) {
+  roaring_bitmap roaring;
+  ewah_bitmap ewah;
+  append_random(roaring, ewah, 42);
+  REQUIRE_EQUAL(roaring.size(), ewah.size());
+  CHECK_EQUAL(rank(roaring), rank(ewah));
+  for (auto i = ewah_bitmap::size_type{0}; i < ewah.size(); i += 997)
+    CHECK_EQUAL(roaring[i], ewah[i]);
+}
+
+TEST(Roaring bitwise operations) {
+  roaring_bitmap x;
+  roaring_bitmap y;
+  ewah_bitmap ex;
+  ewah_bitmap ey;
+  append_random(x, ex, 1);
+  append_random(y, ey, 2);
+  CHECK_EQUAL(to_string(x), to_string(ex));
+  CHECK_EQUAL(to_string(~x), to_string(~ex));
+  CHECK_EQUAL(to_string(x & y), to_string(ex & ey));
+  CHECK_EQUAL(to_string(x | y), to_string(ex | ey));
+  CHECK_EQUAL(to_string(x ^ y), to_string(ex ^ ey));
+  CHECK_EQUAL(to_string(x - y), to_string(ex - ey));
+  CHECK_EQUAL(rank(x & y), rank(ex & ey));
+}
+
+namespace {
+
+/// Unpacks a Roaring bitmap with a single container from a flatbuffer.
+caf::error unpack_roaring(fbs::bitmap::detail::RoaringContainerType type,
+                          uint32_t cardinality, std::vector<uint16_t> values,
+                          std::vector<uint64_t> words,
+                          uint64_t num_bits = 65'536) {
+  auto builder = flatbuffers::FlatBufferBuilder{};
+  auto container = fbs::bitmap::detail::CreateRoaringContainerDirect(
+    builder, 0, type, cardinality, values.empty() ? nullptr : &values,
+    words.empty() ? nullptr : &words);
+  auto containers = std::vector{container};
+  auto roaring
+    = fbs::bitmap::CreateRoaringBitmapDirect(builder, &containers, num_bits);
+  builder.Finish(fbs::CreateBitmap(builder, fbs::bitmap::Bitmap::roaring,
+                                   roaring.Union()));
+  auto fb = unbox(flatbuffer<fbs::Bitmap>::make(builder.Release()));
+  auto bm = bitmap{};
+  return unpack(*fb, bm);
+}
+
+} // namespace
+
+TEST(Roaring flatbuffers validation) {
+  using fbs::bitmap::detail::RoaringContainerType;
+  MESSAGE("array containers");
+  CHECK_EQUAL(unpack_roaring(RoaringContainerType::array, 2, {1, 3}, {}, 10),
+              caf::none);
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::array, 2, {3, 1}, {},
+                                 10),
+                  caf::none);
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::array, 2, {1, 10}, {},
+                                 10),
+                  caf::none);
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::array, 3, {1, 3}, {},
+                                 10),
+                  caf::none);
+  MESSAGE("run containers");
+  CHECK_EQUAL(unpack_roaring(RoaringContainerType::run, 6, {0, 1, 10, 3}, {}),
+              caf::none);
+  CHECK_EQUAL(unpack_roaring(RoaringContainerType::run, 65'536, {0, 65'535},
+                             {}),
+              caf::none);
+  // Unsorted runs.
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::run, 6, {10, 3, 0, 1},
+                                 {}),
+                  caf::none);
+  // Overlapping runs.
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::run, 8, {0, 3, 2, 3},
+                                 {}),
+                  caf::none);
+  // A run past the end of the chunk.
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::run, 10,
+                                 {65'530, 9}, {}),
+                  caf::none);
+  // A run past the end of the bitmap.
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::run, 10, {0, 9}, {},
+                                 5),
+                  caf::none);
+  // A cardinality that does not match the runs.
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::run, 5, {0, 1, 10, 3},
+                                 {}),
+                  caf::none);
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::run, 6, {0, 1, 10}, {}),
+                  caf::none);
+  MESSAGE("bitset containers");
+  auto words = std::vector<uint64_t>(1024, 0);
+  words[0] = 0b1011;
+  CHECK_EQUAL(unpack_roaring(RoaringContainerType::bitset, 3, {}, words),
+              caf::none);
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::bitset, 4, {}, words),
+                  caf::none);
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::bitset, 3, {}, words,
+                                 3),
+                  caf::none);
+  words.pop_back();
+  CHECK_NOT_EQUAL(unpack_roaring(RoaringContainerType::bitset, 3, {}, words),
+                  caf::none);
+}
+
+TEST(bitmap encoding guard) {
+  CHECK(caf::holds_alternative<ewah_bitmap>(bitmap{}.get_data()));
+  auto x = bitmap{};
+  auto y = bitmap{};
+  {
+    auto guard = bitmap_encoding_guard{bitmap_encoding::roaring};
+    x = bitmap{};
+    {
+      auto nested = bitmap_encoding_guard{bitmap_encoding::ewah};
+      CHECK(caf::holds_alternative<ewah_bitmap>(bitmap{}.get_data()));
+    }
+    y = bitmap{};
+  }
+  CHECK(caf::holds_alternative<ewah_bitmap>(bitmap{}.get_data()));
+  CHECK(caf::holds_alternative<roaring_bitmap>(x.get_data()));
+  CHECK(caf::holds_alternative<roaring_bitmap>(y.get_data()));
+  x.append_bits(false, 100'000);
+  x.append_bits(true, 100);
+  y.append_bits(true, 100'050);
+  auto z = x & y;
+  CHECK(caf::holds_alternative<roaring_bitmap>(z.get_data()));
+  CHECK_EQUAL(rank(z), 50u);
+  CHECK(z[100'049]);
+  CHECK(!z[100'050]);
+}
@@ -0,0 +1,78 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/data.hpp"
+#include "tenzir/plugin.hpp"
+#include "tenzir/series.hpp"
+#include "tenzir/series_builder.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace tenzir;
+
+namespace {
+
+auto make_context(bool split_block) -> std::unique_ptr<context> {
+  const auto* plugin = plugins::find<context_plugin>("bloom-filter");
+  REQUIRE(plugin);
+  auto parameters = context::parameter_map{
+    {"capacity", "100"},
+    {"fp-probability", "0.01"},
+  };
+  if (split_block)
+    parameters.emplace("split-block", std::nullopt);
+  return unbox(plugin->make_context(std::move(parameters)));
+}
+
+auto make_keys(const std::vector<std::string_view>& keys) -> table_slice {
+  auto b = series_builder{};
+  for (auto key : keys)
+    b.record().field("key", key);
+  return b.finish_assert_one_slice("test");
+}
+
+/// Looks up `key` in `ctx` and returns the enrichment.
+auto apply(const context& ctx, std::string_view key) -> data {
+  auto b = series_builder{};
+  b.data(key);
+  auto results = unbox(ctx.apply(b.finish_assert_one_array()));
+  REQUIRE_EQUAL(results.size(), size_t{1});
+  auto values = std::vector<data>{};
+  for (auto&& value : results.front().values())
+    values.push_back(materialize(value));
+  REQUIRE_EQUAL(values.size(), size_t{1});
+  return values.front();
+}
+
+} // namespace
+
+TEST(split-block context enriches without attached data) {
+  auto ctx = make_context(true);
+  unbox(ctx->update(make_keys({"foo", "bar"}), {{"key", "key"}}));
+  CHECK_EQUAL(ctx->show().at("layout"), data{"split-block"});
+  CHECK_EQUAL(ctx->show().at("data"), data{});
+  const auto result = apply(*ctx, "foo");
+  const auto* enrichment = caf::get_if<record>(&result);
+  REQUIRE(enrichment);
+  CHECK_EQUAL(enrichment->at("data"), data{});
+}
+
+TEST(classic context enriches with attached data) {
+  auto ctx = make_context(false);
+  unbox(ctx->update(make_keys({"foo", "bar"}), {{"key", "key"}}));
+  CHECK_EQUAL(ctx->show().at("layout"), data{"classic"});
+  CHECK_EQUAL(ctx->show().at("data"), data{blob{}});
+  const auto result = apply(*ctx, "foo");
+  const auto* enrichment = caf::get_if<record>(&result);
+  REQUIRE(enrichment);
+  CHECK_EQUAL(enrichment->at("data"), data{blob{}});
+}
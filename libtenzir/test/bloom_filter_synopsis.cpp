@@ -27,6 +27,15 @@ TEST(bloom filter parameters : from type) {
   CHECK_EQUAL(*xs.p, 0.01);
 }
 
+TEST(bloom filter parameters : split block from type) {
+  auto t
+    = type{ip_type{}, {{"synopsis", "splitblockbloomfilter(1000,0.01)"}}};
+  auto xs = unbox(parse_parameters(t));
+  CHECK_EQUAL(*xs.n, 1000u);
+  CHECK_EQUAL(*xs.p, 0.01);
+  CHECK(xs.layout == bloom_filter_layout::split_block);
+}
+
 TEST(bloom filter synopsis) {
   using namespace nft;
   bloom_filter_parameters xs;
@@ -45,6 +54,26 @@ TEST(bloom filter synopsis) {
   verify(make_data_view(int64_t{42}), {N, N, N, N, F, N, N, N, N, N});
 }
 
+TEST(split block bloom filter synopsis) {
+  using namespace nft;
+  bloom_filter_parameters xs;
+  xs.n = 100;
+  xs.p = 0.01;
+  auto bf = unbox(make_split_block_bloom_filter<xxh64>(std::move(xs)));
+  CHECK_EQUAL(bf.size() % 256, 0u);
+  bloom_filter_synopsis<int64_t, xxh64, split_block_bloom_filter<xxh64>> x{
+    type{int64_type{}}, std::move(bf)};
+  x.add(make_data_view(int64_t{0}));
+  x.add(make_data_view(int64_t{1}));
+  x.add(make_data_view(int64_t{2}));
+  auto verify = verifier{&x};
+  MESSAGE("{0, 1, 2}");
+  verify(make_data_view(int64_t{0}), {N, N, N, N, T, N, N, N, N, N});
+  verify(make_data_view(int64_t{1}), {N, N, N, N, T, N, N, N, N, N});
+  verify(make_data_view(int64_t{2}), {N, N, N, N, T, N, N, N, N, N});
+  verify(make_data_view(int64_t{42}), {N, N, N, N, F, N, N, N, N, N});
+}
+
 TEST(bloom filter synopsis - wrong lookup type) {
   bloom_filter_parameters xs;
   xs.m = 1_k;
@@ -17,6 +17,8 @@
 
 #include <cstddef>
 #include <span>
+#include <string>
+#include <vector>
 
 using namespace tenzir;
 
@@ -132,6 +134,36 @@ TEST(as_bytes) {
   CHECK_EQUAL(bytes, as_bytes(x));
 }
 
+TEST(join_lines) {
+  auto lines = [](std::vector<std::string> xs) {
+    auto result = std::vector<chunk_ptr>{};
+    for (auto& x : xs)
+      result.push_back(chunk::make(std::move(x)));
+    return result;
+  };
+  auto to_string = [](const chunk_ptr& x) {
+    return std::string{reinterpret_cast<const char*>(x->data()), x->size()};
+  };
+  MESSAGE("single messages with a trailing newline remain as is");
+  auto single = lines({"foo\n"});
+  auto single_ptr = single.front().get();
+  auto joined = join_lines(std::move(single));
+  CHECK_EQUAL(joined.get(), single_ptr);
+  CHECK_EQUAL(to_string(joined), "foo\n");
+  MESSAGE("single messages get a trailing newline");
+  CHECK_EQUAL(to_string(join_lines(lines({"foo"}))), "foo\n");
+  CHECK_EQUAL(to_string(join_lines(lines({""}))), "\n");
+  MESSAGE("multiple messages get joined with newlines");
+  CHECK_EQUAL(to_string(join_lines(lines({"foo", "bar"}))), "foo\nbar\n");
+  CHECK_EQUAL(to_string(join_lines(lines({"foo\n", "bar\n"}))),
+              "foo\nbar\n");
+  CHECK_EQUAL(to_string(join_lines(lines({"foo\n\n", "bar"}))),
+              "foo\n\nbar\n");
+  MESSAGE("empty messages become empty lines");
+  CHECK_EQUAL(to_string(join_lines(lines({"", "foo", ""}))), "\nfoo\n\n");
+  CHECK_EQUAL(to_string(join_lines(lines({"", ""}))), "\n\n");
+}
+
 namespace {
 
 struct fixture : public fixtures::filesystem {
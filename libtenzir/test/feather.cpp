@@ -13,7 +13,9 @@
 #include <tenzir/concept/parseable/to.hpp>
 #include <tenzir/detail/narrow.hpp>
 #include <tenzir/detail/spawn_container_source.hpp>
+#include <tenzir/diagnostics.hpp>
 #include <tenzir/expression.hpp>
+#include <tenzir/generator.hpp>
 #include <tenzir/ids.hpp>
 #include <tenzir/logger.hpp>
 #include <tenzir/plugin.hpp>
@@ -422,6 +424,58 @@ TEST(active feather store erase) {
   run();
 }
 
+TEST(passive feather store incremental load) {
+  auto f = table_slice_fixture();
+  const auto* plugin = tenzir::plugins::find<tenzir::store_plugin>("feather");
+  REQUIRE(plugin);
+  auto active = unbox(plugin->make_active_store());
+  auto slices = std::vector<table_slice>{f.slice, f.slice, f.slice};
+  REQUIRE_EQUAL(active->add(slices), caf::none);
+  auto chunk = unbox(active->finish());
+  REQUIRE(chunk);
+  // Feed the store in small chunks to exercise decoding across chunk
+  // boundaries, including a split file header.
+  auto input = [](chunk_ptr chunk) -> generator<chunk_ptr> {
+    constexpr auto chunk_size = size_t{5};
+    for (auto offset = size_t{0}; offset < chunk->size();
+         offset += chunk_size)
+      co_yield chunk->slice(offset, chunk_size);
+  };
+  auto passive = unbox(plugin->make_passive_store());
+  auto dh = collecting_diagnostic_handler{};
+  auto results = std::vector<table_slice>{};
+  for (auto&& slice : passive->load_incrementally(input(chunk), dh))
+    if (slice.rows() > 0)
+      results.push_back(std::move(slice));
+  CHECK(std::move(dh).collect().empty());
+  REQUIRE_EQUAL(results.size(), slices.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    CHECK_EQUAL(results[i].offset(), i * f.slice.rows());
+    compare_table_slices(results[i], slices[i]);
+  }
+}
+
+TEST(passive feather store incremental load truncated input) {
+  auto f = table_slice_fixture();
+  const auto* plugin = tenzir::plugins::find<tenzir::store_plugin>("feather");
+  REQUIRE(plugin);
+  auto active = unbox(plugin->make_active_store());
+  auto slices = std::vector<table_slice>{f.slice, f.slice, f.slice};
+  REQUIRE_EQUAL(active->add(slices), caf::none);
+  auto chunk = unbox(active->finish());
+  REQUIRE(chunk);
+  auto input = [](chunk_ptr chunk) -> generator<chunk_ptr> {
+    co_yield chunk->slice(0, chunk->size() / 2);
+  };
+  auto passive = unbox(plugin->make_passive_store());
+  auto dh = collecting_diagnostic_handler{};
+  auto rows = uint64_t{0};
+  for (auto&& slice : passive->load_incrementally(input(chunk), dh))
+    rows += slice.rows();
+  CHECK_LESS(rows, slices.size() * f.slice.rows());
+  CHECK(not std::move(dh).collect().empty());
+}
+
 TEST(active feather store status) {
   auto f = table_slice_fixture();
   auto slice = f.slice;
@@ -0,0 +1,126 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/index/trigram_index.hpp"
+
+#include "tenzir/concept/printable/tenzir/bitmap.hpp"
+#include "tenzir/concept/printable/to_string.hpp"
+#include "tenzir/detail/legacy_deserialize.hpp"
+#include "tenzir/detail/serialize.hpp"
+#include "tenzir/fbs/value_index.hpp"
+#include "tenzir/flatbuffer.hpp"
+#include "tenzir/pattern.hpp"
+#include "tenzir/test/test.hpp"
+#include "tenzir/value_index_factory.hpp"
+
+#include <caf/test/dsl.hpp>
+#include <fmt/format.h>
+
+using namespace tenzir;
+using namespace std::string_literals;
+
+namespace {
+
+struct fixture {
+  fixture() {
+    factory<value_index>::initialize();
+  }
+
+  static type trigram_type() {
+    return type{string_type{}, {{"index", "trigram"}}};
+  }
+};
+
+} // namespace
+
+FIXTURE_SCOPE(trigram_index_tests, fixture)
+
+TEST(trigram index lookup) {
+  auto idx = factory<value_index>::make(trigram_type(), caf::settings{});
+  REQUIRE_NOT_EQUAL(idx, nullptr);
+  REQUIRE_NOT_EQUAL(dynamic_cast<trigram_index*>(idx.get()), nullptr);
+  REQUIRE(idx->append(make_data_view("/index.html")));
+  REQUIRE(idx->append(make_data_view("cmd.exe /c whoami")));
+  REQUIRE(idx->append(make_data_view(caf::none)));
+  REQUIRE(idx->append(make_data_view("/images/index.png")));
+  REQUIRE(idx->append(make_data_view("ab")));
+  REQUIRE(idx->append(make_data_view("powershell -enc whoami")));
+  MESSAGE("substring search");
+  auto result = idx->lookup(relational_operator::ni, make_data_view("index"));
+  CHECK_EQUAL(to_string(unbox(result)), "100100");
+  result = idx->lookup(relational_operator::ni, make_data_view("whoami"));
+  CHECK_EQUAL(to_string(unbox(result)), "010001");
+  result = idx->lookup(relational_operator::ni, make_data_view("mimikatz"));
+  CHECK_EQUAL(to_string(unbox(result)), "000000");
+  MESSAGE("short needles cannot be ruled out");
+  result = idx->lookup(relational_operator::ni, make_data_view("ab"));
+  CHECK_EQUAL(to_string(unbox(result)), "110111");
+  MESSAGE("equality yields candidates");
+  result
+    = idx->lookup(relational_operator::equal, make_data_view("/index.html"));
+  CHECK_EQUAL(to_string(unbox(result)), "100000");
+  result = idx->lookup(relational_operator::not_equal,
+                       make_data_view("/index.html"));
+  CHECK_EQUAL(to_string(unbox(result)), "111111");
+  MESSAGE("regular expressions");
+  auto re = unbox(pattern::make("^/images/.*\\.png$"));
+  result = idx->lookup(relational_operator::equal, make_data_view(re));
+  CHECK_EQUAL(to_string(unbox(result)), "000100");
+  re = unbox(pattern::make("who(ami|is)"));
+  result = idx->lookup(relational_operator::equal, make_data_view(re));
+  CHECK_EQUAL(to_string(unbox(result)), "010001");
+  re = unbox(pattern::make("INDEX", {.case_insensitive = true}));
+  result = idx->lookup(relational_operator::equal, make_data_view(re));
+  CHECK_EQUAL(to_string(unbox(result)), "110111");
+  MESSAGE("regular expressions with counted repetitions");
+  re = unbox(pattern::make("[a-z]{4}\\.png"));
+  result = idx->lookup(relational_operator::equal, make_data_view(re));
+  CHECK_EQUAL(to_string(unbox(result)), "000100");
+  re = unbox(pattern::make("who{1,2}ami"));
+  result = idx->lookup(relational_operator::equal, make_data_view(re));
+  CHECK_EQUAL(to_string(unbox(result)), "010001");
+  re = unbox(pattern::make("[a-z]{5}/"));
+  result = idx->lookup(relational_operator::equal, make_data_view(re));
+  CHECK_EQUAL(to_string(unbox(result)), "110111");
+  MESSAGE("flatbuffers");
+  auto builder = flatbuffers::FlatBufferBuilder{};
+  builder.Finish(pack(builder, idx));
+  auto fb = unbox(flatbuffer<fbs::ValueIndex>::make(builder.Release()));
+  auto idx2 = value_index_ptr{};
+  REQUIRE_EQUAL(unpack(*fb, idx2), caf::none);
+  CHECK_EQUAL(idx->type(), idx2->type());
+  result = idx2->lookup(relational_operator::ni, make_data_view("index"));
+  CHECK_EQUAL(to_string(unbox(result)), "100100");
+  MESSAGE("serialization");
+  caf::byte_buffer buf;
+  CHECK(detail::serialize(buf, static_cast<trigram_index&>(*idx)));
+  auto idx3 = trigram_index{trigram_type()};
+  REQUIRE(detail::legacy_deserialize(buf, idx3));
+  result = idx3.lookup(relational_operator::ni, make_data_view("whoami"));
+  CHECK_EQUAL(to_string(unbox(result)), "010001");
+}
+
+TEST(trigram index saturation) {
+  caf::settings opts;
+  opts["max-size"] = 1024;
+  auto idx = trigram_index{trigram_type(), opts};
+  REQUIRE(idx.append(make_data_view("foobar")));
+  CHECK(!idx.saturated());
+  for (auto i = 0; i < 1'000; ++i)
+    REQUIRE(idx.append(make_data_view(fmt::format("{:08x}", i * 7919))));
+  CHECK(idx.saturated());
+  auto result = idx.lookup(relational_operator::ni, make_data_view("qux"));
+  CHECK_EQUAL(rank(unbox(result)), 1'001u);
+}
+
+TEST(trigram index rejects non-string types) {
+  auto t = type{int64_type{}, {{"index", "trigram"}}};
+  CHECK(factory<value_index>::make(t, caf::settings{}) == nullptr);
+}
+
+FIXTURE_SCOPE_END()
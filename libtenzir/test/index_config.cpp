@@ -20,6 +20,9 @@ using namespace tenzir;
 namespace {
 
 auto example_index_config = R"__(
+split-block-bloom-filters: true
+roaring-bitmaps: true
+trigram-index-max-size: 1048576
 rules:
   - targets:
       - suricata.dns.dns.rrname
@@ -28,6 +31,9 @@ rules:
   - targets:
       - zeek.conn.id.orig_h
     partition-index: false
+  - targets:
+      - zeek.http.uri
+    trigram-index: true
 )__";
 
 const tenzir::type schema{
@@ -44,7 +50,7 @@ TEST(example configuration) {
   const auto yaml = unbox(from_yaml(example_index_config));
   index_config config;
   REQUIRE_EQUAL(convert(yaml, config), caf::none);
-  REQUIRE_EQUAL(config.rules.size(), 2u);
+  REQUIRE_EQUAL(config.rules.size(), 3u);
   const auto& rule0 = config.rules[0];
   REQUIRE_EQUAL(rule0.targets.size(), 2u);
   CHECK_EQUAL(rule0.targets[0], "suricata.dns.dns.rrname");
@@ -55,6 +61,11 @@ TEST(example configuration) {
   CHECK_EQUAL(rule1.fp_rate, 0.01); // default
   CHECK_EQUAL(rule0.create_partition_index, true); // default
   CHECK_EQUAL(rule1.create_partition_index, false);
+  CHECK_EQUAL(config.split_block_bloom_filters, true);
+  CHECK_EQUAL(config.roaring_bitmaps, true);
+  CHECK_EQUAL(rule0.create_trigram_index, false); // default
+  CHECK_EQUAL(config.rules[2].create_trigram_index, true);
+  CHECK_EQUAL(config.trigram_index_max_size, 1'048'576u);
 }
 
 TEST(should_create_partition_index will return true for empty rules)
@@ -102,3 +113,23 @@ TEST(should_create_partition_index will will use create_partition_index from
   CHECK_EQUAL(should_create_partition_index(in_y, rules_x), true);
   CHECK_EQUAL(should_create_partition_index(in_y, rules_y), true);
 }
+
+TEST(should_create_trigram_index only applies to targeted string fields) {
+  const auto http_schema = tenzir::type{
+    "zeek.http",
+    tenzir::record_type{
+      {"uri", tenzir::string_type{}},
+      {"status_code", tenzir::uint64_type{}},
+    },
+  };
+  qualified_record_field uri{http_schema, {0u}};
+  qualified_record_field status_code{http_schema, {1u}};
+  auto rules = std::vector{
+    index_config::rule{.targets = {":uint64"}},
+    index_config::rule{.targets = {"zeek.http.uri", "zeek.http.status_code"},
+                       .create_trigram_index = true},
+  };
+  CHECK_EQUAL(should_create_trigram_index(uri, {}), false);
+  CHECK_EQUAL(should_create_trigram_index(uri, rules), true);
+  CHECK_EQUAL(should_create_trigram_index(status_code, rules), false);
+}
@@ -0,0 +1,86 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/multi_query_filter.hpp"
+
+#include "tenzir/concept/parseable/tenzir/expression.hpp"
+#include "tenzir/concept/parseable/to.hpp"
+#include "tenzir/expression.hpp"
+#include "tenzir/table_slice.hpp"
+#include "tenzir/test/fixtures/events.hpp"
+#include "tenzir/test/test.hpp"
+
+using namespace tenzir;
+
+namespace {
+
+struct fixture : fixtures::events {
+  fixture() {
+    slice = zeek_conn_log_full[0];
+    slice.offset(0);
+  }
+
+  expression make_expr(std::string_view str) const {
+    return unbox(to<expression>(str));
+  }
+
+  table_slice slice;
+};
+
+} // namespace
+
+FIXTURE_SCOPE(multi_query_filter_tests, fixture)
+
+TEST(multi query filter matches individual filters) {
+  const auto queries = std::vector<std::string_view>{
+    "orig_h != 192.168.1.102 && proto != \"udp\"",
+    "proto == \"udp\"",
+    "proto != \"udp\" || :uint64 == 350",
+    "! (proto == \"udp\")",
+    "\"http\" in :string && :duration > 30s",
+    "#schema == \"zeek.conn\"",
+    "#schema == \"zeek.dns\"",
+    "does_not_exist == 42",
+  };
+  auto filter = multi_query_filter{};
+  for (size_t i = 0; i < queries.size(); ++i) {
+    filter.add(i, make_expr(queries[i]));
+  }
+  CHECK_EQUAL(filter.size(), queries.size());
+  auto results = filter.apply(slice);
+  auto it = results.begin();
+  for (size_t i = 0; i < queries.size(); ++i) {
+    MESSAGE(fmt::format("checking {}", queries[i]));
+    auto expected = tenzir::filter(slice, make_expr(queries[i]));
+    if (not expected) {
+      CHECK(it == results.end() or it->first != i);
+      continue;
+    }
+    REQUIRE(it != results.end());
+    CHECK_EQUAL(it->first, i);
+    CHECK_EQUAL(it->second.rows(), expected->rows());
+    CHECK_EQUAL(it->second, *expected);
+    ++it;
+  }
+  CHECK(it == results.end());
+}
+
+TEST(multi query filter erase) {
+  auto filter = multi_query_filter{};
+  filter.add(1, make_expr("proto == \"udp\""));
+  filter.add(2, make_expr("proto != \"udp\""));
+  CHECK_EQUAL(filter.apply(slice).size(), 2u);
+  filter.erase(1);
+  auto results = filter.apply(slice);
+  REQUIRE_EQUAL(results.size(), 1u);
+  CHECK_EQUAL(results[0].first, 2u);
+  filter.erase(2);
+  CHECK(filter.apply(slice).empty());
+}
+
+FIXTURE_SCOPE_END()
@@ -0,0 +1,113 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/object_storage.hpp"
+
+#include "tenzir/test/fixtures/filesystem.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <arrow/filesystem/localfs.h>
+#include <caf/test/dsl.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+using namespace tenzir;
+
+namespace {
+
+struct fixture : public fixtures::filesystem {
+  fixture()
+    : fixtures::filesystem(TENZIR_PP_STRINGIFY(SUITE)),
+      root{std::filesystem::absolute(directory)},
+      fs{std::make_shared<arrow::fs::LocalFileSystem>()} {
+    write("a.json", "a");
+    write("b.json", std::string(10, 'b'));
+    write("c.csv", "c");
+    write("nested/d.json", "d");
+    write("nested/deeper/e.json", "e");
+  }
+
+  void write(const std::string& name, const std::string& content) const {
+    auto path = root / name;
+    std::filesystem::create_directories(path.parent_path());
+    auto out = std::ofstream{path};
+    out << content;
+  }
+
+  auto expand(const std::string& pattern) const -> std::vector<std::string> {
+    auto files = unbox(expand_object_paths(*fs, (root / pattern).string()));
+    auto result = std::vector<std::string>{};
+    for (const auto& file : files)
+      result.push_back(
+        std::filesystem::relative(file.path(), root).generic_string());
+    return result;
+  }
+
+  auto read(const std::string& pattern, object_read_options options) const
+    -> std::string {
+    auto files = unbox(expand_object_paths(*fs, (root / pattern).string()));
+    auto result = std::string{};
+    for (auto&& chunk : read_objects(fs, std::move(files), options)) {
+      REQUIRE_NOERROR(chunk);
+      // Empty chunks signal that no data is available yet.
+      if (not *chunk)
+        continue;
+      const auto* data = reinterpret_cast<const char*>((*chunk)->data());
+      result.append(data, (*chunk)->size());
+    }
+    return result;
+  }
+
+  const std::filesystem::path root;
+  std::shared_ptr<arrow::fs::LocalFileSystem> fs;
+};
+
+} // namespace
+
+FIXTURE_SCOPE(object_storage_tests, fixture)
+
+TEST(expand object paths) {
+  using strings = std::vector<std::string>;
+  CHECK_EQUAL(expand("a.json"), (strings{"a.json"}));
+  CHECK_EQUAL(expand("*.json"), (strings{"a.json", "b.json"}));
+  CHECK_EQUAL(expand("**.json"), (strings{"a.json", "b.json", "nested/d.json",
+                                          "nested/deeper/e.json"}));
+  CHECK_EQUAL(expand("nested/*/*.json"), (strings{"nested/deeper/e.json"}));
+  CHECK_EQUAL(expand("nested/"),
+              (strings{"nested/d.json", "nested/deeper/e.json"}));
+  // A `*` never crosses `/`, even if the path also contains `**`, and `**/`
+  // matches any number of directories, including none.
+  CHECK_EQUAL(expand("**/deeper/*.json"), (strings{"nested/deeper/e.json"}));
+  CHECK_EQUAL(expand("nested/**/d.json"), (strings{"nested/d.json"}));
+  CHECK(not expand_object_paths(*fs, (root / "**/n*/e.json").string()));
+  CHECK(not expand_object_paths(*fs, (root / "*.xml").string()));
+  CHECK(not expand_object_paths(*fs, (root / "missing").string()));
+}
+
+TEST(read objects) {
+  auto options = object_read_options{};
+  options.range_size = 3;
+  options.prefetch = 2;
+  options.concurrency = 2;
+  CHECK_EQUAL(read("*", options), "abbbbbbbbbbc");
+  options.unordered = true;
+  auto unordered = read("*", options);
+  std::sort(unordered.begin(), unordered.end());
+  CHECK_EQUAL(unordered, "abbbbbbbbbbc");
+  // The data of an object is emitted contiguously.
+  CHECK_NOT_EQUAL(read("*", options).find(std::string(10, 'b')),
+                  std::string::npos);
+  // More reads in flight than threads to perform them.
+  options.unordered = false;
+  options.prefetch = max_object_prefetch;
+  options.concurrency = max_object_concurrency;
+  CHECK_EQUAL(read("**", options), "abbbbbbbbbbcde");
+}
+
+FIXTURE_SCOPE_END()
@@ -0,0 +1,82 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/output_partitioning.hpp"
+
+#include "tenzir/concept/parseable/tenzir/time.hpp"
+#include "tenzir/concept/parseable/to.hpp"
+#include "tenzir/series_builder.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <caf/test/dsl.hpp>
+
+using namespace tenzir;
+
+namespace {
+
+auto make_events() -> table_slice {
+  auto b = series_builder{};
+  const auto add = [&](std::string_view ts, std::optional<std::string> proto) {
+    auto r = b.record();
+    r.field("ts", unbox(to<time>(ts)));
+    if (proto)
+      r.field("proto", std::string_view{*proto});
+    else
+      r.field("proto").null();
+  };
+  add("2023-10-19T05:30:00", "tcp");
+  add("2023-10-19T05:45:00", "udp");
+  add("2023-10-19T05:50:00", "tcp");
+  add("2023-10-19T06:10:00", "tcp");
+  add("2023-10-19T06:20:00", "a/b");
+  add("2023-10-19T06:30:00", std::nullopt);
+  return b.finish_assert_one_slice("test");
+}
+
+} // namespace
+
+TEST(parse partition key) {
+  auto key = unbox(parse_partition_key("ts:hour"));
+  CHECK_EQUAL(key.field, "ts");
+  CHECK(key.granularity == partition_granularity::hour);
+  key = unbox(parse_partition_key("proto"));
+  CHECK_EQUAL(key.field, "proto");
+  CHECK(key.granularity == partition_granularity::value);
+  CHECK(not parse_partition_key("ts:minute"));
+  CHECK(not parse_partition_key(":day"));
+}
+
+TEST(split by partition) {
+  const auto events = make_events();
+  auto keys = std::vector<partition_key>{
+    unbox(parse_partition_key("ts:hour")),
+  };
+  auto partitions = split_by_partition(events, keys);
+  REQUIRE_EQUAL(partitions.size(), size_t{2});
+  CHECK_EQUAL(partitions[0].first, "year=2023/month=10/day=19/hour=05");
+  CHECK_EQUAL(partitions[0].second.rows(), uint64_t{3});
+  CHECK_EQUAL(partitions[1].first, "year=2023/month=10/day=19/hour=06");
+  CHECK_EQUAL(partitions[1].second.rows(), uint64_t{3});
+  MESSAGE("non-consecutive rows of a partition get combined");
+  keys = {unbox(parse_partition_key("proto"))};
+  partitions = split_by_partition(events, keys);
+  REQUIRE_EQUAL(partitions.size(), size_t{4});
+  CHECK_EQUAL(partitions[0].first, "proto=tcp");
+  CHECK_EQUAL(partitions[0].second.rows(), uint64_t{3});
+  CHECK_EQUAL(partitions[1].first, "proto=udp");
+  CHECK_EQUAL(partitions[2].first, "proto=a%2Fb");
+  CHECK_EQUAL(partitions[3].first, "proto=__HIVE_DEFAULT_PARTITION__");
+  MESSAGE("missing fields map to the default partition");
+  keys = {unbox(parse_partition_key("ts:day")),
+          unbox(parse_partition_key("missing"))};
+  partitions = split_by_partition(events, keys);
+  REQUIRE_EQUAL(partitions.size(), size_t{1});
+  CHECK_EQUAL(partitions[0].first,
+              "year=2023/month=10/day=19/missing=__HIVE_DEFAULT_PARTITION__");
+  CHECK_EQUAL(partitions[0].second.rows(), events.rows());
+}
@@ -20,6 +20,7 @@
 #include "tenzir/fbs/uuid.hpp"
 #include "tenzir/index.hpp"
 #include "tenzir/passive_partition.hpp"
+#include "tenzir/pattern.hpp"
 #include "tenzir/posix_filesystem.hpp"
 #include "tenzir/query_context.hpp"
 #include "tenzir/table_slice.hpp"
@@ -28,6 +29,7 @@
 #include "tenzir/test/test.hpp"
 #include "tenzir/type.hpp"
 #include "tenzir/uuid.hpp"
+#include "tenzir/value_index_factory.hpp"
 
 #include <caf/make_copy_on_write.hpp>
 #include <flatbuffers/flatbuffers.h>
@@ -335,4 +337,98 @@ TEST(full partition roundtrip) {
   run();
 }
 
+TEST(trigram partition roundtrip) {
+  tenzir::factory<tenzir::value_index>::initialize();
+  auto schema = tenzir::type{
+    "y",
+    tenzir::record_type{
+      {"s", tenzir::string_type{}},
+    },
+  };
+  auto config = tenzir::index_config{};
+  config.rules.push_back({.targets = {"y.s"}, .create_trigram_index = true});
+  // Spawn a partition that builds a trigram index for `s`.
+  auto fs = self->spawn(tenzir::posix_filesystem, directory,
+                        tenzir::accountant_actor{});
+  auto partition_uuid = tenzir::uuid::random();
+  const auto* store_plugin = tenzir::plugins::find<tenzir::store_actor_plugin>(
+    tenzir::defaults::store_backend);
+  REQUIRE(store_plugin);
+  auto partition = sys.spawn(tenzir::active_partition, schema, partition_uuid,
+                             tenzir::accountant_actor{}, fs, caf::settings{},
+                             config, store_plugin,
+                             std::make_shared<tenzir::taxonomies>());
+  run();
+  REQUIRE(partition);
+  auto builder = std::make_shared<tenzir::table_slice_builder>(schema);
+  CHECK(builder->add("date 2023-10-19"));
+  CHECK(builder->add("no date"));
+  CHECK(builder->add("2024-01"));
+  auto slice = builder->finish();
+  slice.offset(0);
+  auto data = std::vector<tenzir::table_slice>{slice};
+  auto src = tenzir::detail::spawn_container_source(sys, data, partition);
+  REQUIRE(src);
+  run();
+  std::filesystem::path persist_path = "test-trigram-partition";
+  std::filesystem::path synopsis_path = "test-trigram-partition-synopsis";
+  auto persist_promise
+    = self->request(partition, caf::infinite, tenzir::atom::persist_v,
+                    persist_path, synopsis_path);
+  run();
+  persist_promise.receive(
+    [](tenzir::partition_synopsis_ptr&) {
+      CHECK("persisting done");
+    },
+    [](const caf::error& err) {
+      FAIL(err);
+    });
+  self->send_exit(partition, caf::exit_reason::user_shutdown);
+  auto readonly_partition
+    = sys.spawn(tenzir::passive_partition, partition_uuid,
+                tenzir::accountant_actor{}, fs, persist_path);
+  REQUIRE(readonly_partition);
+  run();
+  // Counts the candidates that the indexes of the partition yield.
+  auto dummy_client = [](std::shared_ptr<uint64_t> count)
+    -> tenzir::receiver_actor<uint64_t>::behavior_type {
+    return {
+      [count](uint64_t hits) {
+        *count += hits;
+      },
+    };
+  };
+  auto count_candidates = [&](std::string regex) {
+    auto expression = tenzir::expression{tenzir::predicate{
+      tenzir::field_extractor{"s"}, tenzir::relational_operator::equal,
+      tenzir::data{unbox(tenzir::pattern::make(std::move(regex)))}}};
+    auto result = std::make_shared<uint64_t>();
+    auto dummy = self->spawn(dummy_client, result);
+    auto rp = self->request(
+      readonly_partition, caf::infinite, tenzir::atom::query_v,
+      tenzir::query_context::make_count(
+        "test", dummy, tenzir::count_query_context::mode::estimate,
+        expression));
+    run();
+    rp.receive([](uint64_t) {},
+               [](caf::error& e) {
+                 REQUIRE_EQUAL(e, caf::error{});
+               });
+    run();
+    self->send_exit(dummy, caf::exit_reason::user_shutdown);
+    run();
+    return *result;
+  };
+  // The required literal of a quantified regex is too short to rule out any
+  // event, but must not rule out all of them either.
+  CHECK_EQUAL(count_candidates("[0-9]{4}-[0-9]{2}"), 3u);
+  CHECK_EQUAL(count_candidates("[0-9]{4}-"), 3u);
+  CHECK_EQUAL(count_candidates("date [0-9]{4}-"), 1u);
+  CHECK_EQUAL(count_candidates("date [0-9]{2,4}-1"), 1u);
+  CHECK_EQUAL(count_candidates("mimikatz"), 0u);
+  self->send_exit(readonly_partition, caf::exit_reason::user_shutdown);
+  self->send_exit(fs, caf::exit_reason::user_shutdown);
+  run();
+}
+
 FIXTURE_SCOPE_END()
@@ -11,12 +11,20 @@
 #include "tenzir/bloom_filter_synopsis.hpp"
 #include "tenzir/collect.hpp"
 #include "tenzir/defaults.hpp"
+#include "tenzir/fbs/utils.hpp"
+#include "tenzir/io/write.hpp"
 #include "tenzir/test/fixtures/events.hpp"
+#include "tenzir/test/fixtures/filesystem.hpp"
 #include "tenzir/test/test.hpp"
 
+#include <filesystem>
+
 namespace {
 
-struct fixture : fixtures::events {};
+struct fixture : fixtures::events, fixtures::filesystem {
+  fixture() : fixtures::filesystem(TENZIR_PP_STRINGIFY(SUITE)) {
+  }
+};
 
 } // namespace
 
@@ -73,4 +81,66 @@ TEST(custom index_config) {
   CHECK_EQUAL(address_parameters->p, 0.05);
 }
 
+TEST(lazy unpacking) {
+  auto ps = tenzir::partition_synopsis{};
+  for (const auto& slice : zeek_http_log)
+    ps.add(slice, tenzir::defaults::max_partition_size,
+           tenzir::index_config{});
+  ps.shrink();
+  ps.events = tenzir::rows(zeek_http_log);
+  auto pack_full = [&](const tenzir::partition_synopsis& ps,
+                       const std::filesystem::path& path) {
+    auto builder = flatbuffers::FlatBufferBuilder{};
+    auto offset = unbox(pack(builder, ps));
+    auto ps_offset = tenzir::fbs::CreatePartitionSynopsis(
+      builder, tenzir::fbs::partition_synopsis::PartitionSynopsis::legacy,
+      offset.Union());
+    tenzir::fbs::FinishPartitionSynopsisBuffer(builder, ps_offset);
+    auto chunk = tenzir::fbs::release(builder);
+    REQUIRE_EQUAL(tenzir::io::write(path, as_bytes(chunk)), caf::none);
+    return path;
+  };
+  auto lazy = tenzir::partition_synopsis{};
+  auto path = pack_full(ps, directory / "lazy.mdx");
+  REQUIRE_EQUAL(unpack_lazily(path, lazy), caf::none);
+  CHECK(lazy.is_lazy());
+  CHECK(!lazy.has_unloadable_synopses());
+  CHECK_EQUAL(lazy.events, ps.events);
+  CHECK_EQUAL(lazy.min_import_time, ps.min_import_time);
+  CHECK_EQUAL(lazy.max_import_time, ps.max_import_time);
+  CHECK_EQUAL(lazy.schema, ps.schema);
+  CHECK(lazy.field_synopses_.empty());
+  CHECK(lazy.type_synopses_.empty());
+  MESSAGE("packing a lazy partition synopsis retains its synopses");
+  auto repacked = tenzir::partition_synopsis{};
+  REQUIRE_EQUAL(unpack_lazily(pack_full(lazy, directory / "repacked.mdx"),
+                              repacked),
+                caf::none);
+  REQUIRE_EQUAL(repacked.load_synopses(), caf::none);
+  CHECK_EQUAL(repacked.field_synopses_.size(), ps.field_synopses_.size());
+  MESSAGE("loading the synopses");
+  REQUIRE_EQUAL(lazy.load_synopses(), caf::none);
+  CHECK(!lazy.is_lazy());
+  CHECK(lazy.has_unloadable_synopses());
+  CHECK_EQUAL(lazy.field_synopses_.size(), ps.field_synopses_.size());
+  CHECK_EQUAL(lazy.type_synopses_.size(), ps.type_synopses_.size());
+  MESSAGE("unloading and reloading the synopses");
+  lazy.unload_synopses();
+  CHECK(lazy.is_lazy());
+  CHECK(lazy.field_synopses_.empty());
+  CHECK(lazy.type_synopses_.empty());
+  REQUIRE_EQUAL(lazy.load_synopses(), caf::none);
+  CHECK_EQUAL(lazy.field_synopses_.size(), ps.field_synopses_.size());
+  MESSAGE("the metadata does not refer to the file");
+  lazy.unload_synopses();
+  std::filesystem::remove(path);
+  CHECK_EQUAL(lazy.schema, ps.schema);
+  CHECK_NOT_EQUAL(lazy.load_synopses(), caf::none);
+  CHECK(lazy.is_lazy());
+  MESSAGE("eagerly unpacked synopses cannot be unloaded");
+  ps.unload_synopses();
+  CHECK(!ps.is_lazy());
+  CHECK(!ps.field_synopses_.empty());
+}
+
 FIXTURE_SCOPE_END()
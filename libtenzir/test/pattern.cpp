@@ -52,6 +52,24 @@ TEST(comparison with string) {
 }
 
 TEST(case insensitive) {
+  MESSAGE("brackets within character classes");
+  auto digits = make_pattern("[[:digit:]]+x");
+  CHECK_EQUAL(digits.required_literal(), "x");
+  CHECK(digits.match("42x"));
+  auto space = make_pattern("[[:space:]]error");
+  CHECK_EQUAL(space.required_literal(), "error");
+  CHECK(space.search("fatal error"));
+  auto alpha = make_pattern("[[:alpha:]]foo");
+  CHECK_EQUAL(alpha.required_literal(), "foo");
+  CHECK(alpha.match("afoo"));
+  auto bracket = make_pattern("[]a]bc");
+  CHECK_EQUAL(bracket.required_literal(), "bc");
+  CHECK(bracket.match("]bc"));
+  auto negated = make_pattern("[^]a]bc");
+  CHECK_EQUAL(negated.required_literal(), "bc");
+  CHECK(negated.match("xbc"));
+  CHECK(not negated.match("]bc"));
+  CHECK_EQUAL(make_pattern("[a]]bc").required_literal(), "]bc");
   auto pat_opt = pattern_options{};
   pat_opt.case_insensitive = true;
   auto pat = make_pattern("bar", std::move(pat_opt));
@@ -71,6 +89,55 @@ TEST(case insensitive) {
   CHECK(pat.match("bAR"));
 }
 
+TEST(literals) {
+  CHECK_EQUAL(unbox(make_pattern("foo").literal()), "foo");
+  CHECK_EQUAL(unbox(make_pattern("foo\\.bar").literal()), "foo.bar");
+  CHECK(!make_pattern("foo.bar").literal());
+  CHECK(!make_pattern("foo\\d").literal());
+  CHECK_EQUAL(make_pattern("foo").required_literal(), "foo");
+  CHECK_EQUAL(make_pattern("^GET /index\\.html.*$").required_literal(),
+              "GET /index.html");
+  CHECK_EQUAL(make_pattern("\\w+ die Waldfe{2}.").required_literal(),
+              " die Waldf");
+  CHECK_EQUAL(make_pattern("ab*cdef").required_literal(), "cdef");
+  CHECK_EQUAL(make_pattern("foo|bar").required_literal(), "");
+  CHECK_EQUAL(make_pattern("(foo)bar").required_literal(), "bar");
+  CHECK_EQUAL(make_pattern("(?i)foo").required_literal(), "");
+  MESSAGE("counted repetitions are no literals");
+  CHECK_EQUAL(make_pattern("a{3}").required_literal(), "");
+  CHECK_EQUAL(make_pattern("abc{2,3}def").required_literal(), "def");
+  CHECK_EQUAL(make_pattern("foo{2,}bar").required_literal(), "bar");
+  auto date = make_pattern("[0-9]{4}-[0-9]{2}");
+  CHECK_EQUAL(date.required_literal(), "-");
+  CHECK(date.match("2023-10"));
+  CHECK(date.search("on 2023-10-19"));
+  CHECK(not date.match("2023/10"));
+  MESSAGE("brackets within character classes");
+  auto digits = make_pattern("[[:digit:]]+x");
+  CHECK_EQUAL(digits.required_literal(), "x");
+  CHECK(digits.match("42x"));
+  auto space = make_pattern("[[:space:]]error");
+  CHECK_EQUAL(space.required_literal(), "error");
+  CHECK(space.search("fatal error"));
+  auto alpha = make_pattern("[[:alpha:]]foo");
+  CHECK_EQUAL(alpha.required_literal(), "foo");
+  CHECK(alpha.match("afoo"));
+  auto bracket = make_pattern("[]a]bc");
+  CHECK_EQUAL(bracket.required_literal(), "bc");
+  CHECK(bracket.match("]bc"));
+  auto negated = make_pattern("[^]a]bc");
+  CHECK_EQUAL(negated.required_literal(), "bc");
+  CHECK(negated.match("xbc"));
+  CHECK(not negated.match("]bc"));
+  CHECK_EQUAL(make_pattern("[a]]bc").required_literal(), "]bc");
+  auto pat_opt = pattern_options{};
+  pat_opt.case_insensitive = true;
+  auto pat = make_pattern("foo", std::move(pat_opt));
+  CHECK(!pat.literal());
+  CHECK_EQUAL(pat.required_literal(), "");
+  CHECK(pat.match("FOO"));
+}
+
 TEST(printable) {
   auto p = make_pattern("(\\w+ \\/)");
   CHECK_EQUAL(to_string(p), "/(\\w+ \\/)/"sv);
@@ -0,0 +1,126 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/pipeline.hpp"
+
+#include "tenzir/expression.hpp"
+#include "tenzir/table_slice.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <caf/test/dsl.hpp>
+
+#include <memory>
+
+using namespace tenzir;
+
+namespace {
+
+/// A source that absorbs all filters and records the limit that
+/// `pipeline::optimize` pushes down to it.
+class limit_recorder final : public crtp_operator<limit_recorder> {
+public:
+  explicit limit_recorder(std::shared_ptr<std::optional<event_limit>> limit)
+    : limit_{std::move(limit)} {
+  }
+
+  auto operator()() const -> generator<table_slice> {
+    co_return;
+  }
+
+  auto name() const -> std::string override {
+    return "limit_recorder";
+  }
+
+  auto optimize(expression const& filter, event_order order) const
+    -> optimize_result override {
+    (void)filter;
+    (void)order;
+    return optimize_result{trivially_true_expression(), event_order::ordered,
+                           copy()};
+  }
+
+  auto push_down_limit(std::optional<event_limit> limit)
+    -> std::optional<event_limit> override {
+    *limit_ = limit;
+    return std::nullopt;
+  }
+
+private:
+  std::shared_ptr<std::optional<event_limit>> limit_;
+};
+
+auto push_down(std::string_view repr, std::optional<event_limit> limit)
+  -> std::optional<event_limit> {
+  auto op = unbox(pipeline::internal_parse_as_operator(repr));
+  return op->push_down_limit(limit);
+}
+
+auto optimized_limit(std::string_view repr) -> std::optional<event_limit> {
+  auto limit = std::make_shared<std::optional<event_limit>>();
+  auto ops = unbox(pipeline::internal_parse(repr)).unwrap();
+  ops.insert(ops.begin(), std::make_unique<limit_recorder>(limit));
+  auto result = pipeline{std::move(ops)}.optimize(trivially_true_expression(),
+                                                   event_order::ordered);
+  REQUIRE(result.replacement);
+  return *limit;
+}
+
+} // namespace
+
+TEST(slice introduces limits) {
+  CHECK_EQUAL(push_down("head 10", std::nullopt), (event_limit{10, false}));
+  CHECK_EQUAL(push_down("tail 5", std::nullopt), (event_limit{5, true}));
+  CHECK_EQUAL(push_down("slice --begin 2 --end 7", std::nullopt),
+              (event_limit{7, false}));
+  CHECK_EQUAL(push_down("slice --begin -5 --end -2", std::nullopt),
+              (event_limit{5, true}));
+  CHECK_EQUAL(push_down("slice --begin -5 --end 3", std::nullopt),
+              std::nullopt);
+  CHECK_EQUAL(push_down("slice --begin 2", std::nullopt), std::nullopt);
+  CHECK_EQUAL(push_down("slice --begin 2 --end -1", std::nullopt),
+              std::nullopt);
+}
+
+TEST(slice tightens downstream limits) {
+  CHECK_EQUAL(push_down("head 10", event_limit{3, false}),
+              (event_limit{3, false}));
+  CHECK_EQUAL(push_down("head 10", event_limit{30, false}),
+              (event_limit{10, false}));
+  CHECK_EQUAL(push_down("head 10", event_limit{3, true}),
+              (event_limit{10, false}));
+  CHECK_EQUAL(push_down("slice --begin 2", event_limit{3, false}),
+              (event_limit{5, false}));
+  CHECK_EQUAL(push_down("slice --begin 2", event_limit{3, true}),
+              std::nullopt);
+  CHECK_EQUAL(push_down("tail 5", event_limit{3, true}),
+              (event_limit{3, true}));
+  CHECK_EQUAL(push_down("tail 5", event_limit{3, false}),
+              (event_limit{5, true}));
+}
+
+TEST(optimize propagates limits to the source) {
+  CHECK_EQUAL(optimized_limit("head 10"), (event_limit{10, false}));
+  CHECK_EQUAL(optimized_limit("tail 5"), (event_limit{5, true}));
+  CHECK_EQUAL(optimized_limit("head 10 | head 3"), (event_limit{3, false}));
+  CHECK_EQUAL(optimized_limit("head 3 | tail 2"), (event_limit{3, false}));
+  CHECK_EQUAL(optimized_limit("tail 5 | tail 2"), (event_limit{2, true}));
+  // Filters that the source absorbs keep the limit intact.
+  CHECK_EQUAL(optimized_limit("where x == 1 | tail 5"), (event_limit{5, true}));
+  CHECK_EQUAL(optimized_limit("where x == 1 | head 2 | where y == 2"),
+              (event_limit{2, false}));
+}
+
+TEST(optimize stops limits at barriers) {
+  CHECK_EQUAL(optimized_limit("where x == 1"), std::nullopt);
+  // A filter that cannot move past the slice gets materialized in between.
+  CHECK_EQUAL(optimized_limit("tail 5 | where x == 1 | head 2"),
+              (event_limit{5, true}));
+  CHECK_EQUAL(optimized_limit("put y=1 | head 2"), std::nullopt);
+  CHECK_EQUAL(optimized_limit("sort x | head 2"), std::nullopt);
+}
+
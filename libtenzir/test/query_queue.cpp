@@ -16,6 +16,9 @@
 
 #include <caf/test/dsl.hpp>
 
+#include <algorithm>
+#include <vector>
+
 using namespace tenzir::test;
 
 namespace tenzir {
@@ -93,6 +96,23 @@ uuid make_insert(query_queue& q, catalog_lookup_result&& candidates,
   return query_context.id;
 }
 
+uuid make_limited_insert(query_queue& q, catalog_lookup_result&& candidates,
+                         uint64_t limit, bool latest,
+                         uint64_t priority = query_context::priority::normal) {
+  uint32_t cands_size = candidates.size();
+  auto query_context = make_random_query_context();
+  query_context.priority = priority;
+  query_context.limit = limit;
+  query_context.latest = latest;
+  REQUIRE_SUCCESS(q.insert(query_state{.query_contexts_per_type
+                                       = {{tenzir::type{}, query_context}},
+                                       .client = dummy_client,
+                                       .candidate_partitions = cands_size,
+                                       .requested_partitions = cands_size},
+                           std::move(candidates)));
+  return query_context.id;
+}
+
 } // namespace
 
 TEST(insert violating precondidtions) {
@@ -154,4 +174,73 @@ TEST(2 overlapping queries) {
   CHECK(q.queries().empty());
 }
 
+TEST(limit reached) {
+  query_queue q;
+  auto qid = make_limited_insert(q, cands(3), 10, false);
+  auto a = unbox(q.next());
+  CHECK_EQUAL(q.handle_results(qid, 4), std::nullopt);
+  CHECK_EQUAL(q.handle_completion(a.queries.at(0)), std::nullopt);
+  auto b = unbox(q.next());
+  CHECK_EQUAL(q.handle_results(qid, 6), dummy_client);
+  CHECK(q.queries().empty());
+  CHECK_EQUAL(q.handle_completion(b.queries.at(0)), std::nullopt);
+  CHECK_ERROR(q.next());
+}
+
+TEST(latest partitions first) {
+  query_queue q;
+  auto candidates = cands(3);
+  auto& infos = candidates.candidate_infos[tenzir::type{}].partition_infos;
+  infos[0].max_import_time = time{} + std::chrono::seconds{2};
+  infos[1].max_import_time = time{} + std::chrono::seconds{3};
+  infos[2].max_import_time = time{} + std::chrono::seconds{1};
+  make_limited_insert(q, std::move(candidates), 10, true);
+  CHECK_EQUAL(unbox(q.next()).partition, xs[1]);
+  CHECK_EQUAL(unbox(q.next()).partition, xs[0]);
+  CHECK_EQUAL(unbox(q.next()).partition, xs[2]);
+  CHECK_ERROR(q.next());
+}
+
+TEST(latest partitions first with overlapping queries) {
+  query_queue q;
+  auto candidates = cands(3);
+  auto& infos = candidates.candidate_infos[tenzir::type{}].partition_infos;
+  infos[0].max_import_time = time{} + std::chrono::seconds{2};
+  infos[1].max_import_time = time{} + std::chrono::seconds{3};
+  infos[2].max_import_time = time{} + std::chrono::seconds{1};
+  make_limited_insert(q, std::move(candidates), 10, true);
+  // The oldest partition is shared with another query, which gives it a
+  // higher priority. The remaining partitions still come newest first.
+  make_insert(q, cands(2, 3));
+  auto oldest = unbox(q.next());
+  CHECK_EQUAL(oldest.partition, xs[2]);
+  CHECK_EQUAL(oldest.queries.size(), 2u);
+  CHECK_EQUAL(unbox(q.next()).partition, xs[1]);
+  CHECK_EQUAL(unbox(q.next()).partition, xs[0]);
+  CHECK_ERROR(q.next());
+}
+
+TEST(priority before latest partitions) {
+  query_queue q;
+  auto candidates = cands(3);
+  auto& infos = candidates.candidate_infos[tenzir::type{}].partition_infos;
+  infos[0].max_import_time = time{} + std::chrono::seconds{2};
+  infos[1].max_import_time = time{} + std::chrono::seconds{3};
+  infos[2].max_import_time = time{} + std::chrono::seconds{1};
+  make_limited_insert(q, std::move(candidates), 10, true,
+                      query_context::priority::low);
+  make_insert(q, cands(3, 6));
+  // The normal-priority query runs first, even though the low-priority query
+  // asks for the latest results.
+  auto normal = std::vector<uuid>{};
+  for (auto i = 0; i < 3; ++i)
+    normal.push_back(unbox(q.next()).partition);
+  std::sort(normal.begin(), normal.end());
+  CHECK_EQUAL(normal, (std::vector<uuid>{xs[3], xs[4], xs[5]}));
+  CHECK_EQUAL(unbox(q.next()).partition, xs[1]);
+  CHECK_EQUAL(unbox(q.next()).partition, xs[0]);
+  CHECK_EQUAL(unbox(q.next()).partition, xs[2]);
+  CHECK_ERROR(q.next());
+}
+
 } // namespace tenzir
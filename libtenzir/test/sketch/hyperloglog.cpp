@@ -0,0 +1,62 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/sketch/hyperloglog.hpp"
+
+#include "tenzir/hash/hash.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <random>
+
+using namespace tenzir;
+using namespace tenzir::sketch;
+
+TEST(hyperloglog empty) {
+  auto sketch = hyperloglog{};
+  CHECK_EQUAL(sketch.estimate(), 0.0);
+}
+
+TEST(hyperloglog duplicates) {
+  auto sketch = hyperloglog{};
+  for (auto i = 0; i < 1'000; ++i) {
+    sketch.add(hash("foo"));
+    sketch.add(hash("bar"));
+  }
+  CHECK_EQUAL(std::llround(sketch.estimate()), 2);
+}
+
+TEST(hyperloglog accuracy) {
+  std::mt19937_64 r{0};
+  for (auto n : {100u, 10'000u, 1'000'000u}) {
+    auto sketch = hyperloglog{};
+    for (size_t i = 0; i < n; ++i)
+      sketch.add(hash(r()));
+    auto error = std::abs(sketch.estimate() - n) / n;
+    MESSAGE(fmt::format("n = {}, estimate = {}, error = {}", n,
+                        sketch.estimate(), error));
+    // The standard error at precision 14 is about 0.8%; allow four sigma.
+    CHECK_LESS(error, 0.033);
+  }
+}
+
+TEST(hyperloglog merge) {
+  std::mt19937_64 r{0};
+  auto lhs = hyperloglog{};
+  auto rhs = hyperloglog{};
+  auto both = hyperloglog{};
+  for (auto i = 0; i < 50'000; ++i) {
+    auto x = hash(r());
+    (i % 3 == 0 ? lhs : rhs).add(x);
+    both.add(x);
+  }
+  lhs.merge(rhs);
+  CHECK(lhs == both);
+}
@@ -0,0 +1,87 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/sketch/space_saving.hpp"
+
+#include "tenzir/test/test.hpp"
+
+#include <random>
+#include <string>
+#include <string_view>
+
+using namespace tenzir;
+using namespace tenzir::sketch;
+
+TEST(space saving exact below capacity) {
+  auto sketch = space_saving<uint64_t>{16};
+  for (uint64_t i = 0; i < 10; ++i)
+    for (uint64_t j = 0; j <= i; ++j)
+      sketch.add(i);
+  auto top = sketch.top();
+  REQUIRE_EQUAL(top.size(), 10u);
+  for (uint64_t i = 0; i < 10; ++i) {
+    CHECK_EQUAL(top[i].value, 9 - i);
+    CHECK_EQUAL(top[i].count, 10 - i);
+    CHECK_EQUAL(top[i].error, 0u);
+  }
+}
+
+TEST(space saving heavy hitters) {
+  // A Zipf-like stream: element k occurs roughly 1/k as often as element 1.
+  std::mt19937_64 r{0};
+  auto dist = std::uniform_real_distribution<double>{0.0, 1.0};
+  auto sketch = space_saving<uint64_t>{64};
+  for (auto i = 0; i < 100'000; ++i)
+    sketch.add(static_cast<uint64_t>(1.0 / (1.0 - dist(r))));
+  auto top = sketch.top();
+  REQUIRE_EQUAL(top.size(), 64u);
+  for (uint64_t i = 0; i < 5; ++i)
+    CHECK_EQUAL(top[i].value, i + 1);
+  for (const auto& counter : top)
+    CHECK_GREATER_EQUAL(counter.count, counter.error);
+}
+
+TEST(space saving heterogeneous lookup) {
+  struct string_hash {
+    using is_transparent = void;
+    auto operator()(std::string_view x) const -> size_t {
+      return std::hash<std::string_view>{}(x);
+    }
+  };
+  auto sketch = space_saving<std::string, string_hash, std::equal_to<>>{4};
+  auto make = [](std::string_view x) {
+    return std::string{x};
+  };
+  sketch.add(std::string_view{"foo"}, make, 3);
+  sketch.add(std::string_view{"bar"}, make);
+  sketch.add(std::string_view{"foo"}, make);
+  auto top = sketch.top();
+  REQUIRE_EQUAL(top.size(), 2u);
+  CHECK_EQUAL(top[0].value, "foo");
+  CHECK_EQUAL(top[0].count, 4u);
+  CHECK_EQUAL(top[1].value, "bar");
+  CHECK_EQUAL(top[1].count, 1u);
+}
+
+TEST(space saving merge) {
+  auto lhs = space_saving<uint64_t>{8};
+  auto rhs = space_saving<uint64_t>{8};
+  lhs.add(1, 10);
+  lhs.add(2, 5);
+  rhs.add(1, 7);
+  rhs.add(3, 9);
+  lhs.merge(rhs);
+  auto top = lhs.top();
+  REQUIRE_EQUAL(top.size(), 3u);
+  CHECK_EQUAL(top[0].value, 1u);
+  CHECK_EQUAL(top[0].count, 17u);
+  CHECK_EQUAL(top[1].value, 3u);
+  CHECK_EQUAL(top[1].count, 9u);
+  CHECK_EQUAL(top[2].value, 2u);
+  CHECK_EQUAL(top[2].count, 5u);
+}
@@ -0,0 +1,100 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/sketch/split_block_bloom_filter.hpp"
+
+#include "tenzir/hash/hash.hpp"
+#include "tenzir/si_literals.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <caf/test/dsl.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace tenzir;
+using namespace tenzir::sketch;
+using namespace si_literals;
+using namespace decimal_byte_literals;
+
+TEST(split block bloom filter api) {
+  bloom_filter_config cfg;
+  cfg.n = 1_k;
+  cfg.p = 0.1;
+  auto filter = unbox(split_block_bloom_filter::make(cfg));
+  CHECK(filter.add(hash("foo")));
+  CHECK(!filter.add(hash("foo")));
+  CHECK_EQUAL(filter.num_elements(), 1u);
+  CHECK(filter.lookup(hash("foo")));
+  CHECK(!filter.lookup(hash("bar")));
+}
+
+TEST(split block bloom filter parameters) {
+  bloom_filter_config cfg;
+  cfg.m = 1'000;
+  cfg.p = 0.1;
+  auto filter = unbox(split_block_bloom_filter::make(cfg));
+  CHECK_EQUAL(filter.parameters().m, 1'024u);
+  CHECK_EQUAL(filter.parameters().k, 8u);
+  cfg.k = 3;
+  CHECK(!split_block_bloom_filter::make(cfg));
+}
+
+TEST(split block bloom filter fp test) {
+  bloom_filter_config cfg;
+  cfg.n = 10_k;
+  cfg.p = 0.01;
+  auto filter = unbox(split_block_bloom_filter::make(cfg));
+  auto params = filter.parameters();
+  CHECK_LESS(params.p, 0.01);
+  std::mt19937_64 r{0};
+  auto num_fps = 0u;
+  auto num_queries = 1_M;
+  // Load filter to full capacity.
+  for (size_t i = 0; i < params.n; ++i)
+    filter.add(hash(r()));
+  // Sample true negatives.
+  for (size_t i = 0; i < num_queries; ++i)
+    if (filter.lookup(hash(r())))
+      ++num_fps;
+  auto p = params.p;
+  auto p_hat = static_cast<double>(num_fps) / num_queries;
+  auto epsilon = 0.001;
+  CHECK_LESS(std::abs(p_hat - p), epsilon);
+}
+
+TEST(frozen split block bloom filter) {
+  bloom_filter_config cfg;
+  cfg.m = 1_kB;
+  cfg.p = 0.1;
+  auto filter = unbox(split_block_bloom_filter::make(cfg));
+  filter.add(hash("foo"));
+  auto frozen = unbox(freeze(filter));
+  CHECK(frozen.lookup(hash("foo")));
+  CHECK_EQUAL(filter.parameters(), frozen.parameters());
+  auto restored
+    = unbox(frozen_split_block_bloom_filter::make(frozen.table()));
+  CHECK(restored.lookup(hash("foo")));
+  CHECK_EQUAL(restored.num_elements(), 1u);
+  auto thawed = thaw(restored);
+  CHECK(thawed.lookup(hash("foo")));
+  CHECK(thawed.add(hash("bar")));
+  CHECK_EQUAL(thawed.num_elements(), 2u);
+  CHECK(!restored.lookup(hash("bar")));
+}
+
+TEST(frozen split block bloom filter rejects classic layout) {
+  flatbuffers::FlatBufferBuilder builder;
+  auto params = fbs::BloomFilterParameters{1'024, 100, 8, 0.1};
+  auto bits = std::vector<uint64_t>(16, 0);
+  auto bits_offset = builder.CreateVector(bits.data(), bits.size());
+  builder.Finish(fbs::CreateBloomFilter(builder, &params, bits_offset));
+  auto table = chunk::make(builder.Release());
+  CHECK(!frozen_split_block_bloom_filter::make(std::move(table)));
+}
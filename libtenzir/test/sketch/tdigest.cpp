@@ -0,0 +1,89 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/sketch/tdigest.hpp"
+
+#include "tenzir/test/test.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace tenzir;
+using namespace tenzir::sketch;
+
+namespace {
+
+auto exact_quantile(std::vector<double> xs, double q) -> double {
+  std::sort(xs.begin(), xs.end());
+  auto index = static_cast<size_t>(q * static_cast<double>(xs.size() - 1));
+  return xs[index];
+}
+
+} // namespace
+
+TEST(tdigest empty) {
+  auto digest = tdigest{};
+  CHECK(not digest.quantile(0.5));
+  CHECK_EQUAL(digest.total_weight(), 0.0);
+}
+
+TEST(tdigest single value) {
+  auto digest = tdigest{};
+  digest.add(42.0);
+  CHECK_EQUAL(unbox(digest.quantile(0.0)), 42.0);
+  CHECK_EQUAL(unbox(digest.quantile(0.5)), 42.0);
+  CHECK_EQUAL(unbox(digest.quantile(1.0)), 42.0);
+}
+
+TEST(tdigest accuracy) {
+  std::mt19937_64 r{0};
+  auto dist = std::normal_distribution<double>{100.0, 15.0};
+  auto digest = tdigest{};
+  auto xs = std::vector<double>{};
+  for (auto i = 0; i < 100'000; ++i) {
+    xs.push_back(dist(r));
+    digest.add(xs.back());
+  }
+  CHECK_EQUAL(digest.total_weight(), 100'000.0);
+  CHECK_LESS(digest.centroids().size(), 200u);
+  for (auto q : {0.01, 0.1, 0.5, 0.9, 0.99}) {
+    auto expected = exact_quantile(xs, q);
+    auto estimate = unbox(digest.quantile(q));
+    MESSAGE(fmt::format("q = {}, expected = {}, estimate = {}", q, expected,
+                        estimate));
+    CHECK_LESS(std::abs(estimate - expected), 0.5);
+  }
+  CHECK_EQUAL(unbox(digest.quantile(0.0)),
+              *std::min_element(xs.begin(), xs.end()));
+  CHECK_EQUAL(unbox(digest.quantile(1.0)),
+              *std::max_element(xs.begin(), xs.end()));
+}
+
+TEST(tdigest merge) {
+  std::mt19937_64 r{0};
+  auto dist = std::uniform_real_distribution<double>{0.0, 1'000.0};
+  auto parts = std::vector<tdigest>(8);
+  auto xs = std::vector<double>{};
+  for (auto i = 0; i < 80'000; ++i) {
+    xs.push_back(dist(r));
+    parts[i % parts.size()].add(xs.back());
+  }
+  auto merged = tdigest{};
+  for (const auto& part : parts)
+    merged.merge(part);
+  CHECK_EQUAL(merged.total_weight(), 80'000.0);
+  for (auto q : {0.01, 0.5, 0.99}) {
+    auto expected = exact_quantile(xs, q);
+    auto estimate = unbox(merged.quantile(q));
+    CHECK_LESS(std::abs(estimate - expected), 5.0);
+  }
+}
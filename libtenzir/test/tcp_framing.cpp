@@ -0,0 +1,139 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/tcp_framing.hpp"
+
+#include "tenzir/test/test.hpp"
+
+#include <fmt/format.h>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+
+using namespace tenzir;
+
+namespace {
+
+/// Simulates reading `input` from a connection into a fresh buffer and returns
+/// the framed bytes.
+auto feed(tcp_framer& framer, std::string_view input)
+  -> caf::expected<std::string> {
+  auto buffer = std::vector<std::byte>(framer.read_size());
+  auto offset = framer.prepare(buffer);
+  REQUIRE_LESS_EQUAL(offset + input.size(), buffer.size());
+  std::memcpy(buffer.data() + offset, input.data(), input.size());
+  auto size = framer.frame(buffer, offset + input.size());
+  if (not size)
+    return size.error();
+  return std::string{reinterpret_cast<const char*>(buffer.data()), *size};
+}
+
+auto finish(tcp_framer& framer) -> caf::expected<std::string> {
+  auto remainder = framer.finish();
+  if (not remainder)
+    return remainder.error();
+  return std::string{reinterpret_cast<const char*>(remainder->data()),
+                     remainder->size()};
+}
+
+} // namespace
+
+TEST(parse framing) {
+  CHECK(parse_tcp_framing("none") == tcp_framing::none);
+  CHECK(parse_tcp_framing("newline") == tcp_framing::newline);
+  CHECK(parse_tcp_framing("octet-counting") == tcp_framing::octet_counting);
+  CHECK(not parse_tcp_framing("octet_counting"));
+}
+
+TEST(no framing) {
+  auto framer = tcp_framer{tcp_framing::none};
+  CHECK_EQUAL(unbox(feed(framer, "foo\nba")), "foo\nba");
+  CHECK_EQUAL(unbox(feed(framer, "r")), "r");
+  CHECK_EQUAL(unbox(finish(framer)), "");
+}
+
+TEST(newline framing) {
+  auto framer = tcp_framer{tcp_framing::newline};
+  CHECK_EQUAL(unbox(feed(framer, "foo\nba")), "foo\n");
+  CHECK_EQUAL(unbox(feed(framer, "r")), "");
+  CHECK_EQUAL(unbox(feed(framer, "\nbaz\nqux")), "bar\nbaz\n");
+  CHECK_EQUAL(unbox(finish(framer)), "qux");
+  CHECK_EQUAL(unbox(finish(framer)), "");
+}
+
+TEST(newline framing with empty lines) {
+  auto framer = tcp_framer{tcp_framing::newline};
+  CHECK_EQUAL(unbox(feed(framer, "\n\nfoo\n\n")), "\n\nfoo\n\n");
+  CHECK_EQUAL(unbox(feed(framer, "\r\n")), "\r\n");
+  CHECK_EQUAL(unbox(finish(framer)), "");
+}
+
+TEST(newline framing cuts lines that fill the entire buffer) {
+  auto framer = tcp_framer{tcp_framing::newline};
+  auto line = std::string(framer.read_size(), 'x');
+  CHECK_EQUAL(unbox(feed(framer, line)), line);
+  CHECK_EQUAL(unbox(feed(framer, "y\n")), "y\n");
+}
+
+TEST(newline framing cuts long lines that arrive in small reads) {
+  auto framer = tcp_framer{tcp_framing::newline};
+  // The pieces never fill the read buffer.
+  const auto piece = std::string(tcp_framer::min_read_size - 96, 'x');
+  auto line = std::string{};
+  auto fed = size_t{0};
+  while (line.empty() && fed < 2 * tcp_framer::max_frame_size) {
+    line = unbox(feed(framer, piece));
+    fed += piece.size();
+    CHECK_LESS_EQUAL(framer.read_size(),
+                     tcp_framer::max_frame_size + tcp_framer::min_read_size);
+  }
+  CHECK_EQUAL(line.size(), fed);
+  CHECK_GREATER_EQUAL(line.size(), tcp_framer::max_frame_size);
+  CHECK_EQUAL(framer.read_size(), tcp_framer::min_read_size);
+  CHECK_EQUAL(unbox(feed(framer, "y\n")), "y\n");
+}
+
+TEST(octet counting) {
+  auto framer = tcp_framer{tcp_framing::octet_counting};
+  CHECK_EQUAL(unbox(feed(framer, "3 abc4 defg")), "abc\ndefg\n");
+  // Tolerate newlines between frames.
+  CHECK_EQUAL(unbox(feed(framer, "\r\n1 x\n")), "x\n");
+  CHECK_EQUAL(unbox(finish(framer)), "");
+}
+
+TEST(octet counting across reads) {
+  auto framer = tcp_framer{tcp_framing::octet_counting};
+  // The frame ends in the next read.
+  CHECK_EQUAL(unbox(feed(framer, "3 abc5 hel")), "abc\n");
+  CHECK_EQUAL(unbox(feed(framer, "lo")), "hello\n");
+  // The length ends in the next read.
+  CHECK_EQUAL(unbox(feed(framer, "1")), "");
+  CHECK_EQUAL(unbox(feed(framer, "2 abcdefghijkl")), "abcdefghijkl\n");
+  // The frame does not fit into a single read.
+  auto message = std::string(tcp_framer::min_read_size * 2, 'x');
+  auto frame = fmt::format("{} {}", message.size(), message);
+  CHECK_EQUAL(unbox(feed(framer, std::string_view{frame}.substr(0, 10))), "");
+  CHECK_GREATER_EQUAL(framer.read_size(), frame.size());
+  CHECK_EQUAL(unbox(feed(framer, std::string_view{frame}.substr(10))),
+              message + "\n");
+  CHECK_EQUAL(unbox(finish(framer)), "");
+}
+
+TEST(octet counting errors) {
+  auto framer = tcp_framer{tcp_framing::octet_counting};
+  CHECK_ERROR(feed(framer, "abc"));
+  framer = tcp_framer{tcp_framing::octet_counting};
+  CHECK_ERROR(feed(framer, "0 "));
+  framer = tcp_framer{tcp_framing::octet_counting};
+  auto too_long = fmt::format("{} x", tcp_framer::max_frame_size + 1);
+  CHECK_ERROR(feed(framer, too_long));
+  framer = tcp_framer{tcp_framing::octet_counting};
+  CHECK_EQUAL(unbox(feed(framer, "5 abc")), "");
+  CHECK_ERROR(finish(framer));
+}
@@ -0,0 +1,224 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/diagnostics.hpp"
+#include "tenzir/operator_control_plane.hpp"
+#include "tenzir/plugin.hpp"
+#include "tenzir/series.hpp"
+#include "tenzir/test/test.hpp"
+#include "tenzir/tql/parser.hpp"
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace tenzir;
+using namespace std::chrono_literals;
+
+namespace {
+
+class control_plane final : public operator_control_plane {
+public:
+  auto self() noexcept -> exec_node_actor::base& override {
+    TENZIR_UNREACHABLE();
+  }
+
+  auto node() noexcept -> node_actor override {
+    return {};
+  }
+
+  auto diagnostics() noexcept -> diagnostic_handler& override {
+    return diag;
+  }
+
+  auto no_location_overrides() const noexcept -> bool override {
+    return false;
+  }
+
+  auto has_terminal() const noexcept -> bool override {
+    return false;
+  }
+
+  collecting_diagnostic_handler diag;
+};
+
+using strings = std::vector<std::optional<std::string>>;
+
+using timestamps = std::vector<std::optional<tenzir::time>>;
+
+/// Runs the `time` parser with `args` on `inputs`, or returns `std::nullopt`
+/// if it emits an error.
+auto parse(std::string args, const strings& inputs)
+  -> std::optional<timestamps> {
+  const auto* plugin = plugins::find<parser_parser_plugin>("time");
+  REQUIRE(plugin);
+  auto dh = collecting_diagnostic_handler{};
+  auto p = tql::make_parser_interface(std::move(args), dh);
+  auto parser = plugin->parse_parser(*p);
+  REQUIRE(parser);
+  REQUIRE(std::move(dh).collect().empty());
+  auto builder = arrow::StringBuilder{};
+  for (const auto& input : inputs) {
+    auto status = input ? builder.Append(*input) : builder.AppendNull();
+    REQUIRE(status.ok());
+  }
+  auto array = std::static_pointer_cast<arrow::StringArray>(
+    builder.Finish().ValueOrDie());
+  auto ctrl = control_plane{};
+  auto results = parser->parse_strings(array, ctrl);
+  if (not std::move(ctrl.diag).collect().empty())
+    return std::nullopt;
+  auto result = timestamps{};
+  for (const auto& series : results) {
+    for (auto i = int64_t{0}; i < series.array->length(); ++i) {
+      if (series.array->IsNull(i)) {
+        result.emplace_back();
+        continue;
+      }
+      const auto& record
+        = static_cast<const arrow::StructArray&>(*series.array);
+      REQUIRE_EQUAL(record.num_fields(), 1);
+      const auto& field
+        = static_cast<const arrow::TimestampArray&>(*record.field(0));
+      result.emplace_back(tenzir::time{tenzir::duration{field.Value(i)}});
+    }
+  }
+  REQUIRE_EQUAL(result.size(), inputs.size());
+  return result;
+}
+
+/// Checks that the compiled format `format` yields the same result as
+/// `fallback`, which is equivalent to `format` but forces the `strptime` path.
+/// The `O` modifier selects alternative digits, which are the regular digits
+/// in the "C" locale, and compiled formats do not support modifiers.
+auto check_same(std::string_view format, std::string_view fallback,
+                const strings& inputs, std::string_view options = "")
+  -> std::optional<timestamps> {
+  auto compiled = parse(fmt::format("\"{}\" {}", format, options), inputs);
+  auto strptime = parse(fmt::format("\"{}\" {}", fallback, options), inputs);
+  CHECK_EQUAL(compiled, strptime);
+  return compiled;
+}
+
+auto ymd_hms(int y, int m, int d, std::chrono::seconds tod) -> tenzir::time {
+  const auto ymd = std::chrono::year{y} / m / d;
+  return tenzir::time{std::chrono::sys_days{ymd} + tod};
+}
+
+} // namespace
+
+TEST(month names and padded days) {
+  auto result = check_same("%Y %b %e %H:%M:%S", "%Y %b %Oe %H:%M:%S",
+                           {"2023 Dec  5 10:11:12", "2023 dec 5 10:11:12",
+                            "2023 December 05 10:11:12", "2023 DEC 5 10:11:12",
+                            std::nullopt});
+  REQUIRE(result);
+  const auto expected = ymd_hms(2023, 12, 5, 10h + 11min + 12s);
+  CHECK_EQUAL(result->at(0), expected);
+  CHECK_EQUAL(result->at(1), expected);
+  CHECK_EQUAL(result->at(2), expected);
+  CHECK_EQUAL(result->at(3), expected);
+  CHECK_EQUAL(result->at(4), std::nullopt);
+  CHECK_EQUAL(check_same("%Y %b %e", "%Y %b %Oe", {"2023 Dex 5"}),
+              std::nullopt);
+}
+
+TEST(utc offsets) {
+  auto result = check_same(
+    "%Y-%m-%dT%H:%M:%S%z", "%Y-%m-%dT%H:%M:%OS%z",
+    {"2023-12-05T10:11:12Z", "2023-12-05T12:11:12+0200",
+     "2023-12-05T04:41:12-05:30", "2023-12-05T12:11:12+02",
+     "2023-12-05T00:11:12-10:00"});
+  REQUIRE(result);
+  for (const auto& x : *result)
+    CHECK_EQUAL(x, ymd_hms(2023, 12, 5, 10h + 11min + 12s));
+  CHECK_EQUAL(check_same("%Y-%m-%dT%H:%M:%S%z", "%Y-%m-%dT%H:%M:%OS%z",
+                         {"2023-12-05T10:11:12+2"}),
+              std::nullopt);
+}
+
+TEST(short years) {
+  auto result = check_same("%y-%m-%d", "%Oy-%m-%d",
+                           {"68-01-01", "69-01-01", "99-12-31", "00-02-29"});
+  REQUIRE(result);
+  CHECK_EQUAL(result->at(0), ymd_hms(2068, 1, 1, 0s));
+  CHECK_EQUAL(result->at(1), ymd_hms(1969, 1, 1, 0s));
+  CHECK_EQUAL(result->at(2), ymd_hms(1999, 12, 31, 0s));
+  CHECK_EQUAL(result->at(3), ymd_hms(2000, 2, 29, 0s));
+  CHECK_EQUAL(check_same("%y-%m-%d", "%Oy-%m-%d", {"01-02-29"}),
+              std::nullopt);
+}
+
+TEST(year inference) {
+  // The inferred year depends on the current date, so we only check that
+  // both paths agree and that no timestamp lies in the future.
+  auto inputs = strings{};
+  for (auto month : {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug",
+                     "Sep", "Oct", "Nov", "Dec"}) {
+    inputs.emplace_back(fmt::format("{}  1 00:00:00", month));
+    inputs.emplace_back(fmt::format("{} 28 23:59:59", month));
+  }
+  auto result = check_same("%b %e %H:%M:%S", "%b %Oe %H:%M:%S", inputs);
+  auto with_offset
+    = check_same("%b %e %H:%M:%S %z", "%b %Oe %H:%M:%S %z",
+                 {"Jan  1 00:00:00 +1400", "Dec 31 23:59:59 -1200"});
+  REQUIRE(result);
+  REQUIRE(with_offset);
+  const auto tomorrow = std::chrono::floor<std::chrono::days>(
+                          std::chrono::system_clock::now())
+                        + std::chrono::days{1};
+  for (const auto& x : *result)
+    CHECK(*x < tomorrow);
+  // A missing time of day defaults to midnight.
+  CHECK_EQUAL(check_same("%b %e", "%b %Oe", {"Jan 1"}),
+              check_same("%b %e %H:%M", "%b %Oe %H:%M", {"Jan 1 00:00"}));
+}
+
+TEST(strict) {
+  auto result = check_same("%Y-%m-%d %H:%M", "%Y-%m-%d %OH:%M",
+                           {"2023-12-05 10:11"}, "--strict");
+  REQUIRE(result);
+  CHECK_EQUAL(result->at(0), ymd_hms(2023, 12, 5, 10h + 11min));
+  CHECK_EQUAL(check_same("%b %e %H:%M:%S", "%b %Oe %H:%M:%S",
+                         {"Dec  5 10:11:12"}, "--strict"),
+              std::nullopt);
+  CHECK_EQUAL(check_same("%Y-%m-%d %H", "%Y-%m-%d %OH", {"2023-12-05 10"},
+                         "--strict"),
+              std::nullopt);
+}
+
+TEST(leap seconds) {
+  auto result = check_same(
+    "%Y-%m-%d %H:%M:%S", "%Y-%m-%d %H:%M:%OS",
+    {"2016-12-31 23:59:60", "2016-12-31 12:30:60", "2016-12-31 23:59:59"});
+  REQUIRE(result);
+  // POSIX time has no leap seconds, so they carry over into the next minute.
+  CHECK_EQUAL(result->at(0), ymd_hms(2017, 1, 1, 0s));
+  CHECK_EQUAL(result->at(1), ymd_hms(2016, 12, 31, 12h + 31min));
+  CHECK_EQUAL(result->at(2), ymd_hms(2016, 12, 31, 23h + 59min + 59s));
+  auto with_offset = check_same("%Y-%m-%d %H:%M:%S%z", "%Y-%m-%d %H:%M:%OS%z",
+                                {"2016-12-31 23:59:60-0100"});
+  REQUIRE(with_offset);
+  CHECK_EQUAL(with_offset->at(0), ymd_hms(2017, 1, 1, 1h));
+}
+
+TEST(invalid input) {
+  CHECK_EQUAL(check_same("%Y-%m-%d", "%Y-%Om-%d", {"2023-02-30"}),
+              std::nullopt);
+  CHECK_EQUAL(check_same("%Y-%m-%d", "%Y-%Om-%d", {"2023-13-01"}),
+              std::nullopt);
+  CHECK_EQUAL(check_same("%Y-%m-%d", "%Y-%Om-%d", {"2023-12-01 trailing"}),
+              std::nullopt);
+  CHECK_EQUAL(check_same("%H:%M:%S", "%H:%M:%OS", {"10:11:62"}),
+              std::nullopt);
+}
@@ -135,6 +135,35 @@ TEST(integer) {
 }
 
 // This was the first attempt in figuring out where the bug sat. It didn't fire.
+TEST(integer with Roaring bitmaps) {
+  caf::settings opts;
+  opts["roaring-bitmaps"] = true;
+  auto idx = factory<value_index>::make(type{int64_type{}}, opts);
+  REQUIRE_NOT_EQUAL(idx, nullptr);
+  CHECK(idx->encoding() == bitmap_encoding::roaring);
+  REQUIRE(idx->append(make_data_view(int64_t{42})));
+  REQUIRE(idx->append(make_data_view(int64_t{-7})));
+  REQUIRE(idx->append(make_data_view(int64_t{42})));
+  auto result = unbox(
+    idx->lookup(relational_operator::equal, make_data_view(int64_t{42})));
+  CHECK(caf::holds_alternative<roaring_bitmap>(result.get_data()));
+  CHECK_EQUAL(to_string(result), "101");
+  MESSAGE("the option does not leak into other bitmaps");
+  CHECK(caf::holds_alternative<ewah_bitmap>(ids{}.get_data()));
+  auto other = factory<value_index>::make(type{int64_type{}}, caf::settings{});
+  REQUIRE(other->append(make_data_view(int64_t{42})));
+  result = unbox(
+    other->lookup(relational_operator::equal, make_data_view(int64_t{42})));
+  CHECK(caf::holds_alternative<ewah_bitmap>(result.get_data()));
+  MESSAGE("the encoding survives serialization");
+  auto builder = flatbuffers::FlatBufferBuilder{};
+  builder.Finish(pack(builder, idx));
+  auto fb = unbox(flatbuffer<fbs::ValueIndex>::make(builder.Release()));
+  auto idx2 = value_index_ptr{};
+  REQUIRE_EQUAL(unpack(*fb, idx2), caf::none);
+  CHECK(idx2->encoding() == bitmap_encoding::roaring);
+}
+
 TEST(regression - checking the result single bitmap) {
   ewah_bitmap bm;
   bm.append<0>(680);
@@ -15,6 +15,10 @@
 
 #include <caf/expected.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
 #if __has_include(<rabbitmq-c/amqp.h>)
 #  include <rabbitmq-c/amqp.h>
 #  include <rabbitmq-c/ssl_socket.h>
@@ -43,6 +47,9 @@ constexpr auto default_queue = std::string_view{};
 /// The default routing key.
 constexpr auto default_routing_key = std::string_view{};
 
+/// The default time to wait for a batch of messages to fill up.
+constexpr auto default_batch_timeout = std::chrono::milliseconds{100};
+
 /// Assume ownership of the memory and wrap it in a chunk.
 /// @param msg The bytes to move into a chunk.
 auto move_into_chunk(amqp_bytes_t& bytes) -> chunk_ptr {
@@ -153,6 +160,15 @@ public:
     bool auto_delete{true};
     bool no_local{false};
     bool no_ack{true};
+    uint16_t prefetch{0};
+  };
+
+  /// A message that the server delivered to a consumer.
+  struct delivery {
+    /// The message payload, or nullptr if no message arrived.
+    chunk_ptr body;
+    /// The tag to acknowledge the message with.
+    uint64_t tag{0};
   };
 
   /// Aditional options for starting a consumer.
@@ -308,6 +324,15 @@ public:
                     as_amqp_bytes(opts.routing_key), arguments);
     if (auto err = to_error(amqp_get_rpc_reply(conn_)))
       return err;
+    // Bound the number of unacknowledged messages that the server sends us
+    // ahead of time. This only affects consumers that acknowledge messages.
+    if (opts.prefetch > 0) {
+      TENZIR_DEBUG("setting prefetch count to {}", opts.prefetch);
+      amqp_basic_qos(conn_, amqp_channel_t{opts.channel}, 0, opts.prefetch,
+                     as_amqp_bool(false));
+      if (auto err = to_error(amqp_get_rpc_reply(conn_)))
+        return err;
+    }
     TENZIR_DEBUG("setting up consume");
     auto consumer_tag = amqp_empty_bytes;
     amqp_basic_consume(conn_, amqp_channel_t{opts.channel},
@@ -317,10 +342,21 @@ public:
     return to_error(amqp_get_rpc_reply(conn_));
   }
 
+  /// Acknowledges delivered messages.
+  /// @param channel The channel of the consumer.
+  /// @param tag The delivery tag of the message to acknowledge.
+  /// @param multiple Whether to also acknowledge all previous messages.
+  auto ack(amqp_channel_t channel, uint64_t tag, bool multiple) -> caf::error {
+    TENZIR_DEBUG("acknowledging delivery tag {} (multiple: {})", tag,
+                 multiple);
+    auto status = amqp_basic_ack(conn_, channel, tag, as_amqp_bool(multiple));
+    return to_error(status, "failed to acknowledge message");
+  }
+
   /// Consumes a message.
   /// @returns The message from the server.
   auto consume(std::optional<std::chrono::microseconds> timeout = {})
-    -> caf::expected<chunk_ptr> {
+    -> caf::expected<delivery> {
     TENZIR_DEBUG("consuming message");
     auto envelope = amqp_envelope_t{};
     amqp_maybe_release_buffers(conn_);
@@ -339,7 +375,12 @@ public:
                    as_string_view(envelope.exchange), envelope.channel,
                    as_string_view(envelope.routing_key),
                    envelope.message.body.len);
-      auto result = move_into_chunk(envelope.message.body);
+      // The body becomes the chunk without copying; we only release the
+      // remaining parts of the envelope.
+      auto result = delivery{
+        .body = move_into_chunk(envelope.message.body),
+        .tag = envelope.delivery_tag,
+      };
       empty_amqp_pool(&envelope.message.pool);
       amqp_bytes_free(envelope.routing_key);
       amqp_bytes_free(envelope.exchange);
@@ -348,7 +389,7 @@ public:
     }
     // A timeout is no error.
     if (ret.library_error == AMQP_STATUS_TIMEOUT)
-      return chunk_ptr{};
+      return delivery{};
     // Now we're leaving the happy path.
     if (ret.reply_type == AMQP_RESPONSE_LIBRARY_EXCEPTION
         && ret.library_error == AMQP_STATUS_UNEXPECTED_STATE) {
@@ -397,7 +438,7 @@ public:
         }
       }
     }
-    return chunk_ptr{};
+    return delivery{};
   }
 
 private:
@@ -445,6 +486,9 @@ struct loader_args : connector_args {
   bool no_auto_delete{false};
   bool no_local{false};
   bool ack{false};
+  std::optional<located<uint16_t>> prefetch;
+  std::optional<located<size_t>> batch_size;
+  std::optional<located<duration>> batch_timeout;
 
   friend auto inspect(auto& f, loader_args& x) -> bool {
     return f.object(x)
@@ -455,7 +499,10 @@ struct loader_args : connector_args {
               f.field("url", x.url), f.field("passive", x.passive),
               f.field("durable", x.durable), f.field("exclusive", x.exclusive),
               f.field("no_auto_delete", x.no_auto_delete),
-              f.field("no_local", x.no_local), f.field("ack", x.ack));
+              f.field("no_local", x.no_local), f.field("ack", x.ack),
+              f.field("prefetch", x.prefetch),
+              f.field("batch_size", x.batch_size),
+              f.field("batch_timeout", x.batch_timeout));
   }
 };
 
@@ -521,6 +568,7 @@ public:
         .auto_delete = not args.no_auto_delete,
         .no_local = args.no_local,
         .no_ack = not args.ack,
+        .prefetch = args.prefetch ? args.prefetch->inner : uint16_t{0},
       });
       if (err) {
         diagnostic::error("failed to start AMQP consumer")
@@ -530,14 +578,52 @@ public:
       }
       co_yield {};
       TENZIR_DEBUG("looping over AMQP frames");
+      const auto batch_size = args.batch_size ? args.batch_size->inner : 1;
+      const auto batch_timeout = args.batch_timeout ? args.batch_timeout->inner
+                                                    : default_batch_timeout;
+      auto messages = std::vector<chunk_ptr>{};
+      auto last_tag = uint64_t{0};
       while (true) {
-        if (auto message = engine->consume(500ms)) {
-          co_yield std::move(*message);
-        } else {
-          diagnostic::error("failed to consume message")
-            .hint("{}", message.error())
-            .emit(ctrl.diagnostics());
-          break;
+        // Wait for the first message of a batch, and then for the batch to
+        // fill up until it is full or the batch timeout expires.
+        auto deadline = std::chrono::steady_clock::time_point{};
+        while (messages.size() < batch_size) {
+          auto timeout = std::chrono::microseconds{500ms};
+          if (not messages.empty())
+            timeout = std::max(
+              std::chrono::ceil<std::chrono::microseconds>(
+                deadline - std::chrono::steady_clock::now()),
+              std::chrono::microseconds::zero());
+          auto message = engine->consume(timeout);
+          if (not message) {
+            diagnostic::error("failed to consume message")
+              .hint("{}", message.error())
+              .emit(ctrl.diagnostics());
+            co_return;
+          }
+          if (not message->body)
+            break;
+          if (messages.empty())
+            deadline = std::chrono::steady_clock::now() + batch_timeout;
+          messages.push_back(std::move(message->body));
+          last_tag = message->tag;
+        }
+        if (messages.empty()) {
+          co_yield {};
+          continue;
+        }
+        // Without batching, we pass on messages as they are.
+        co_yield batch_size == 1 ? std::move(messages.front())
+                                 : join_lines(std::move(messages));
+        messages.clear();
+        // Acknowledge the whole batch at once after handing it downstream.
+        if (args.ack) {
+          if (auto err = engine->ack(channel, last_tag, true)) {
+            diagnostic::error("failed to acknowledge messages")
+              .hint("{}", err)
+              .emit(ctrl.diagnostics());
+            co_return;
+          }
         }
       }
     };
@@ -667,12 +753,30 @@ public:
       parser.add("--no-auto-delete", args.no_auto_delete);
       parser.add("--no-local", args.no_local);
       parser.add("--ack", args.ack);
+      parser.add("--prefetch", args.prefetch, "<n>");
+      parser.add("-b,--batch-size", args.batch_size, "<n>");
+      parser.add("--batch-timeout", args.batch_timeout, "<duration>");
     } else if constexpr (std::is_same_v<Args, saver_args>) {
       parser.add("--mandatory", args.mandatory);
       parser.add("--immediate", args.immediate);
     }
     parser.add(args.url, "<url>");
     parser.parse(p);
+    if constexpr (std::is_same_v<Args, loader_args>) {
+      if (args.batch_size && args.batch_size->inner == 0)
+        diagnostic::error("batch size must be positive")
+          .primary(args.batch_size->source)
+          .throw_();
+      if (args.batch_timeout && args.batch_timeout->inner < duration::zero())
+        diagnostic::error("batch timeout must not be negative")
+          .primary(args.batch_timeout->source)
+          .throw_();
+      if (args.prefetch && not args.ack)
+        diagnostic::error("--prefetch requires --ack")
+          .primary(args.prefetch->source)
+          .hint("the server only limits unacknowledged messages")
+          .throw_();
+    }
     auto config = config_;
     if (args.url) {
       if (auto cfg = parse_url(args.url->inner))
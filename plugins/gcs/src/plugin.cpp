@@ -8,6 +8,7 @@
 
 #include <tenzir/argument_parser.hpp>
 #include <tenzir/location.hpp>
+#include <tenzir/object_storage.hpp>
 #include <tenzir/plugin.hpp>
 
 #include <arrow/filesystem/filesystem.h>
@@ -27,12 +28,14 @@ struct gcs_args {
   bool anonymous;
   located<std::string> uri;
   std::string path;
+  object_read_args read;
 
   template <class Inspector>
   friend auto inspect(Inspector& f, gcs_args& x) -> bool {
     return f.object(x)
       .pretty_name("gcs_args")
-      .fields(f.field("anonymous", x.anonymous), f.field("uri", x.uri));
+      .fields(f.field("anonymous", x.anonymous), f.field("uri", x.uri),
+              f.field("read", x.read));
   }
 };
 
@@ -56,6 +59,7 @@ auto get_options(gcs_args& args) -> arrow::fs::GcsOptions {
 // upper limit defined by execution nodes for transporting events.
 // TODO: Get the backpressure-adjusted value at runtime from the execution node.
 constexpr size_t max_chunk_size = 1 << 20;
+
 } // namespace
 
 class gcs_loader final : public plugin_loader {
@@ -82,39 +86,28 @@ public:
         // fields of the filesystem & returns a shared_ptr. This is supposed to
         // be changed to a Result, sometime in the future.
         auto fs = arrow::fs::GcsFileSystem::Make(opts);
-        auto file_info
-          = fs->GetFileInfo(fmt::format("{}/{}", uri.host(), uri.path()));
-        if (not file_info.ok()) {
-          diagnostic::error("failed to get file info for URI "
-                            "`{}`: {}",
-                            args.uri.inner, file_info.status().ToString())
-            .primary(args.uri.source)
-            .emit(ctrl.diagnostics());
-          co_return;
-        }
-        auto input_stream = fs->OpenInputStream(*file_info);
-        if (not input_stream.ok()) {
-          diagnostic::error("failed to open input stream for URI "
-                            "`{}`: {}",
-                            args.uri.inner, input_stream.status().ToString())
+        // The path may refer to many objects, which we read concurrently
+        // with ranged reads.
+        auto files = expand_object_paths(
+          *fs, fmt::format("{}/{}", uri.host(), uri.path()));
+        if (not files) {
+          diagnostic::error("failed to resolve URI `{}`: {}", args.uri.inner,
+                            files.error())
             .primary(args.uri.source)
             .emit(ctrl.diagnostics());
           co_return;
         }
-        while (not input_stream.ValueUnsafe()->closed()) {
-          auto buffer = input_stream.ValueUnsafe()->Read(max_chunk_size);
-          if (not input_stream.ok()) {
-            diagnostic::error("failed to read from input stream for URI "
-                              "`{}`: {}",
-                              args.uri.inner, buffer.status().ToString())
+        auto chunks = read_objects(std::move(fs), std::move(*files),
+                                   args.read.to_options(max_chunk_size));
+        for (auto&& chunk : chunks) {
+          if (not chunk) {
+            diagnostic::error("failed to read from URI `{}`: {}",
+                              args.uri.inner, chunk.error())
               .primary(args.uri.source)
               .emit(ctrl.diagnostics());
             co_return;
           }
-          if (buffer.ValueUnsafe()->size() == 0) {
-            break;
-          }
-          co_yield chunk::make(buffer.MoveValueUnsafe());
+          co_yield std::move(*chunk);
         }
       }(args_, ctrl);
   }
@@ -238,8 +231,10 @@ public:
       fmt::format("https://docs.tenzir.com/docs/next/connectors/{}", name())};
     auto args = gcs_args{};
     parser.add("--anonymous", args.anonymous);
+    args.read.add_to(parser);
     parser.add(args.uri, "<uri>");
     parser.parse(p);
+    args.read.validate();
     // TODO: URI parser.
     if (not args.uri.inner.starts_with("gs://"))
       args.uri.inner = fmt::format("gs://{}", args.uri.inner);
@@ -16,7 +16,9 @@
 #include <librdkafka/rdkafkacpp.h>
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 
 namespace tenzir::plugins::kafka {
 
@@ -42,19 +44,24 @@ public:
   /// librdkafa.
   auto set(const record& options) -> caf::error;
 
-  /// Sets a rebalance callback.
+  /// Sets a rebalance callback that starts consuming a partition at `offset`
+  /// when it is assigned for the first time. All consumers created from this
+  /// configuration share the callback, and later assignments of the same
+  /// partition resume from the committed offset.
   auto set_rebalance_cb(int64_t offset) -> caf::error;
 
 private:
   class rebalancer : public RdKafka::RebalanceCb {
   public:
-    explicit rebalancer(int offset);
+    explicit rebalancer(int64_t offset);
 
     auto rebalance_cb(RdKafka::KafkaConsumer*, RdKafka::ErrorCode,
                       std::vector<RdKafka::TopicPartition*>&) -> void override;
 
   private:
     int64_t offset_ = RdKafka::Topic::OFFSET_INVALID;
+    std::mutex mutex_;
+    std::unordered_set<std::string> assigned_partitions_;
   };
 
   configuration();
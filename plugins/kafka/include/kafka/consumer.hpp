@@ -17,11 +17,19 @@
 #include <chrono>
 #include <cstddef>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace tenzir::plugins::kafka {
 
+/// The position of a message in a topic partition.
+struct message_offset {
+  std::string topic;
+  int32_t partition;
+  int64_t offset;
+};
+
 /// Wraps a `RdKafka::Consumer` in a friendly interface.
 class consumer {
 public:
@@ -31,8 +39,22 @@ public:
   /// Subscribes to a list of topics.
   auto subscribe(const std::vector<std::string>& topics) -> caf::error;
 
-  /// Consumes a message, blocking for a given maximum timeout.
-  auto consume(std::chrono::milliseconds timeout) -> caf::expected<chunk_ptr>;
+  /// Consumes up to `max_messages` messages at once, blocking for a given
+  /// maximum timeout until the first message arrives and then taking only the
+  /// messages that are readily available. The result includes messages that
+  /// signal errors or the end of a partition, but no timeouts.
+  auto consume_batch(size_t max_messages, std::chrono::milliseconds timeout)
+    -> std::vector<std::unique_ptr<RdKafka::Message>>;
+
+  /// Marks messages as processed. This requires `enable.auto.offset.store` to
+  /// be `false`, and librdkafka then commits the offsets asynchronously.
+  auto store_offsets(std::span<const message_offset> offsets) -> caf::error;
+
+  /// Returns the number of partitions currently assigned to the consumer.
+  auto num_assigned_partitions() const -> size_t;
+
+  /// Commits the stored offsets and leaves the consumer group.
+  auto close() -> caf::error;
 
 private:
   consumer() = default;
@@ -0,0 +1,60 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <utility>
+
+namespace tenzir::plugins::kafka {
+
+/// Splits a stream of bytes that arrives in chunks into lines, carrying over
+/// partial lines from one chunk to the next. Lines exclude the newline but
+/// keep a preceding carriage return. Empty lines are skipped.
+class line_splitter {
+public:
+  /// Invokes `f` with every complete line in `bytes`, including a line that
+  /// started in a previous chunk. Stops early if `f` returns false.
+  /// @returns Whether all invocations of `f` returned true.
+  template <class F>
+  auto split(std::span<const std::byte> bytes, F&& f) -> bool {
+    while (true) {
+      auto newline = std::find(bytes.begin(), bytes.end(), std::byte{'\n'});
+      if (newline == bytes.end()) {
+        partial_line_.append(reinterpret_cast<const char*>(bytes.data()),
+                             bytes.size());
+        return true;
+      }
+      auto line = bytes.first(static_cast<size_t>(newline - bytes.begin()));
+      bytes = bytes.subspan(line.size() + 1);
+      if (not partial_line_.empty()) {
+        partial_line_.append(reinterpret_cast<const char*>(line.data()),
+                             line.size());
+        auto ok = f(std::as_bytes(std::span{partial_line_}));
+        partial_line_.clear();
+        if (not ok)
+          return false;
+      } else if (not line.empty() and not f(line)) {
+        return false;
+      }
+    }
+  }
+
+  /// Returns the partial line that remains at the end of the stream.
+  auto finish() -> std::string {
+    return std::exchange(partial_line_, {});
+  }
+
+private:
+  std::string partial_line_ = {};
+};
+
+} // namespace tenzir::plugins::kafka
@@ -14,6 +14,7 @@
 #include <caf/expected.hpp>
 #include <librdkafka/rdkafkacpp.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <memory>
@@ -23,6 +24,36 @@ namespace tenzir::plugins::kafka {
 
 class message;
 
+/// Counters across all producers of the process, which the plugin reports
+/// as metrics.
+struct producer_metrics {
+  std::atomic<uint64_t> produced_messages = 0;
+  std::atomic<uint64_t> produced_bytes = 0;
+  std::atomic<uint64_t> delivered_messages = 0;
+  std::atomic<uint64_t> failed_messages = 0;
+  std::atomic<uint64_t> queue_full_waits = 0;
+  std::atomic<uint64_t> total_latency_us = 0;
+  std::atomic<uint64_t> max_latency_us = 0;
+
+  /// Returns the counters of the process.
+  static auto global() -> producer_metrics&;
+};
+
+/// Tracks the delivery reports of a producer, which librdkafka invokes from
+/// within `producer::poll` and `producer::flush`.
+class delivery_reporter final : public RdKafka::DeliveryReportCb {
+public:
+  auto dr_cb(RdKafka::Message& message) -> void override;
+
+  /// Returns the number of failed deliveries since the last call, and the
+  /// error of the first one.
+  auto take_failures() -> std::pair<size_t, caf::error>;
+
+private:
+  size_t num_failures_ = {};
+  caf::error first_failure_ = {};
+};
+
 /// Wraps a producer in a friendly interface.
 class producer {
 public:
@@ -33,6 +64,9 @@ public:
   auto produce(std::string topic, std::span<const std::byte> bytes,
                std::string_view key = {}, time timestamp = {}) -> caf::error;
 
+  /// Returns the delivery reports of the producer.
+  auto reporter() const -> delivery_reporter&;
+
   /// Polls the producer for events and invokes callbacks.
   auto poll(std::chrono::milliseconds timeout) -> int;
 
@@ -50,6 +84,7 @@ private:
   producer() = default;
 
   configuration config_{};
+  std::shared_ptr<delivery_reporter> reporter_{};
   std::shared_ptr<RdKafka::Producer> producer_{};
 };
 
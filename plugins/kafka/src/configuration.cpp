@@ -14,6 +14,7 @@
 #include <tenzir/detail/overload.hpp>
 #include <tenzir/die.hpp>
 #include <tenzir/error.hpp>
+#include <tenzir/logger.hpp>
 
 #include <fmt/format.h>
 
@@ -80,20 +81,30 @@ auto configuration::set_rebalance_cb(int64_t offset) -> caf::error {
   return {};
 }
 
-configuration::rebalancer::rebalancer(int offset) : offset_{offset} {
+configuration::rebalancer::rebalancer(int64_t offset) : offset_{offset} {
 }
 
 auto configuration::rebalancer::rebalance_cb(
   RdKafka::KafkaConsumer* consumer, RdKafka::ErrorCode err,
   std::vector<RdKafka::TopicPartition*>& partitions) -> void {
   // This branching logic comes from the librdkafka consumer example. See the
-  // implementation of ExampleRebalanceCb for details. The only thing we added
-  // is the offset assignment at the beginning.
+  // implementation of ExampleRebalanceCb for details. We added the offset
+  // assignment at the beginning and the commit before giving up partitions.
   if (err == RdKafka::ERR__ASSIGN_PARTITIONS) {
     if (offset_ != RdKafka::Topic::OFFSET_INVALID) {
-      TENZIR_DEBUG("setting offset to {}", offset_);
-      for (auto* partition : partitions)
-        partition->set_offset(offset_);
+      // Only the first assignment of a partition starts at the configured
+      // offset. When a partition moves between consumers that share this
+      // callback, the new owner resumes from the committed offset instead.
+      auto lock = std::unique_lock{mutex_};
+      for (auto* partition : partitions) {
+        auto key
+          = fmt::format("{}/{}", partition->topic(), partition->partition());
+        if (assigned_partitions_.insert(std::move(key)).second) {
+          TENZIR_DEBUG("setting offset of {}/{} to {}", partition->topic(),
+                       partition->partition(), offset_);
+          partition->set_offset(offset_);
+        }
+      }
     }
     if (consumer->rebalance_protocol() == "COOPERATIVE") {
       if (auto err = consumer->incremental_assign(partitions)) {
@@ -106,8 +117,13 @@ auto configuration::rebalancer::rebalance_cb(
         TENZIR_ERROR("failed to assign partitions: {}", RdKafka::err2str(err));
     }
   } else if (err == RdKafka::ERR__REVOKE_PARTITIONS) {
-    // Application may commit offsets manually here
-    // if auto.commit.enable=false
+    // Commit the stored offsets synchronously so that the next owner of the
+    // partitions resumes where we left off.
+    auto commit_err = consumer->commitSync();
+    if (commit_err != RdKafka::ERR_NO_ERROR
+        && commit_err != RdKafka::ERR__NO_OFFSET)
+      TENZIR_WARN("failed to commit offsets on revocation: {}",
+                  RdKafka::err2str(commit_err));
     if (consumer->rebalance_protocol() == "COOPERATIVE") {
       if (auto err = consumer->incremental_unassign(partitions)) {
         TENZIR_ERROR("failed to unassign incrementally: {}", err->str());
@@ -33,27 +33,56 @@ auto consumer::subscribe(const std::vector<std::string>& topics) -> caf::error {
   return {};
 }
 
-auto consumer::consume(std::chrono::milliseconds timeout)
-  -> caf::expected<chunk_ptr> {
+auto consumer::consume_batch(size_t max_messages,
+                             std::chrono::milliseconds timeout)
+  -> std::vector<std::unique_ptr<RdKafka::Message>> {
+  auto result = std::vector<std::unique_ptr<RdKafka::Message>>{};
   auto ms = detail::narrow_cast<int>(timeout.count());
-  auto* ptr = consumer_->consume(ms);
-  auto result = chunk::make(ptr->payload(), ptr->len(), [ptr]() noexcept {
-    delete ptr; // NOLINT
-  });
-  switch (ptr->err()) {
-    case RdKafka::ERR_NO_ERROR:
+  while (result.size() < max_messages) {
+    // Only wait for the first message; librdkafka prefetches the remaining
+    // ones in the background.
+    auto msg = std::unique_ptr<RdKafka::Message>{
+      consumer_->consume(result.empty() ? ms : 0)};
+    if (msg->err() == RdKafka::ERR__TIMED_OUT)
       break;
-    case RdKafka::ERR__TIMED_OUT:
-      return ec::timeout;
-    case RdKafka::ERR__PARTITION_EOF:
-      return ec::end_of_input;
-    default:
-      return caf::make_error(ec::unspecified,
-                             fmt::format("failed to consume message: {} ({})",
-                                         ptr->errstr(),
-                                         static_cast<int>(ptr->err())));
+    result.push_back(std::move(msg));
   }
   return result;
 }
 
+auto consumer::store_offsets(std::span<const message_offset> offsets)
+  -> caf::error {
+  auto partitions = std::vector<RdKafka::TopicPartition*>{};
+  partitions.reserve(offsets.size());
+  for (const auto& x : offsets)
+    // The stored offset is the offset of the next message to consume.
+    partitions.push_back(
+      RdKafka::TopicPartition::create(x.topic, x.partition, x.offset + 1));
+  auto result = consumer_->offsets_store(partitions);
+  RdKafka::TopicPartition::destroy(partitions);
+  if (result != RdKafka::ERR_NO_ERROR)
+    return caf::make_error(ec::unspecified,
+                           fmt::format("failed to store offsets: {}",
+                                       RdKafka::err2str(result)));
+  return {};
+}
+
+auto consumer::num_assigned_partitions() const -> size_t {
+  auto partitions = std::vector<RdKafka::TopicPartition*>{};
+  if (consumer_->assignment(partitions) != RdKafka::ERR_NO_ERROR)
+    return 0;
+  auto result = partitions.size();
+  RdKafka::TopicPartition::destroy(partitions);
+  return result;
+}
+
+auto consumer::close() -> caf::error {
+  auto result = consumer_->close();
+  if (result != RdKafka::ERR_NO_ERROR)
+    return caf::make_error(ec::unspecified,
+                           fmt::format("failed to close consumer: {}",
+                                       RdKafka::err2str(result)));
+  return {};
+}
+
 } // namespace tenzir::plugins::kafka
@@ -8,6 +8,7 @@
 
 #include "kafka/configuration.hpp"
 #include "kafka/consumer.hpp"
+#include "kafka/line_splitter.hpp"
 #include "kafka/producer.hpp"
 
 #include <tenzir/argument_parser.hpp>
@@ -25,9 +26,17 @@
 #include <tenzir/plugin.hpp>
 #include <tenzir/table_slice.hpp>
 
+#include <algorithm>
 #include <charconv>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <thread>
+#include <unordered_set>
 
 using namespace std::chrono_literals;
 
@@ -72,6 +81,8 @@ struct loader_args {
   std::optional<location> exit;
   std::optional<located<std::string>> offset;
   std::optional<located<std::string>> options;
+  std::optional<located<size_t>> batch_size;
+  std::optional<located<size_t>> consumers;
 
   template <class Inspector>
   friend auto inspect(Inspector& f, loader_args& x) -> bool {
@@ -79,10 +90,113 @@ struct loader_args {
       .pretty_name("loader_args")
       .fields(f.field("topic", x.topic), f.field("count", x.count),
               f.field("exit", x.exit), f.field("offset", x.offset),
-              f.field("options", x.options));
+              f.field("options", x.options),
+              f.field("batch_size", x.batch_size),
+              f.field("consumers", x.consumers));
   }
 };
 
+/// A batch of messages, along with the index of the consumer that consumed it.
+struct message_batch {
+  size_t consumer = {};
+  std::vector<std::unique_ptr<RdKafka::Message>> messages = {};
+};
+
+/// Runs consumers of the same consumer group on dedicated threads. The group
+/// spreads the partitions across the consumers, so that they consume in
+/// parallel. The pool owns the consumers and closes them on destruction.
+class consumer_pool {
+public:
+  consumer_pool(std::vector<consumer> consumers, size_t batch_size)
+    : consumers_{std::move(consumers)} {
+    for (auto i = size_t{0}; i < consumers_.size(); ++i)
+      threads_.emplace_back([this, i, batch_size] {
+        run(i, batch_size);
+      });
+  }
+
+  consumer_pool(const consumer_pool&) = delete;
+  auto operator=(const consumer_pool&) -> consumer_pool& = delete;
+
+  ~consumer_pool() noexcept {
+    {
+      auto lock = std::unique_lock{mutex_};
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_)
+      thread.join();
+    for (auto& consumer : consumers_)
+      if (auto err = consumer.close())
+        TENZIR_WARN("kafka {}", err);
+  }
+
+  /// Returns the next batch, or nothing if none arrived within the timeout.
+  auto next(std::chrono::milliseconds timeout) -> std::optional<message_batch> {
+    auto lock = std::unique_lock{mutex_};
+    if (not cv_.wait_for(lock, timeout, [&] {
+          return not queue_.empty();
+        }))
+      return std::nullopt;
+    auto result = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    cv_.notify_all();
+    return result;
+  }
+
+  /// Marks the messages of a batch as processed.
+  auto store_offsets(const message_batch& batch,
+                     std::span<const message_offset> offsets) -> caf::error {
+    return consumers_[batch.consumer].store_offsets(offsets);
+  }
+
+  /// Returns the number of partitions assigned to all consumers.
+  auto num_assigned_partitions() const -> size_t {
+    auto result = size_t{0};
+    for (const auto& consumer : consumers_)
+      result += consumer.num_assigned_partitions();
+    return result;
+  }
+
+private:
+  void run(size_t index, size_t batch_size) {
+    while (true) {
+      auto messages = consumers_[index].consume_batch(batch_size, 100ms);
+      auto lock = std::unique_lock{mutex_};
+      if (not messages.empty()) {
+        // Stop consuming while the loader falls behind, so that librdkafka's
+        // prefetch limits bound the memory usage.
+        cv_.wait(lock, [&] {
+          return stop_ or queue_.size() < 2 * consumers_.size();
+        });
+        if (not stop_) {
+          queue_.push_back({index, std::move(messages)});
+          cv_.notify_all();
+        }
+      }
+      if (stop_)
+        return;
+    }
+  }
+
+  std::vector<consumer> consumers_ = {};
+  std::vector<std::thread> threads_ = {};
+  std::mutex mutex_ = {};
+  std::condition_variable cv_ = {};
+  std::deque<message_batch> queue_ = {};
+  bool stop_ = false;
+};
+
+/// Creates a chunk from the payload of a message without copying, such that
+/// the chunk owns the message.
+auto make_chunk(std::unique_ptr<RdKafka::Message> message) -> chunk_ptr {
+  auto* msg = message.release();
+  return chunk::make(msg->payload(), msg->len(), [msg]() noexcept {
+    delete msg; // NOLINT
+  });
+}
+
 class kafka_loader final : public plugin_loader {
 public:
   kafka_loader() = default;
@@ -111,6 +225,15 @@ public:
         return {};
       }
     }
+    // We store offsets only after handing messages off, which makes
+    // librdkafka commit them asynchronously with at-least-once semantics.
+    if (not config_.contains("enable.auto.offset.store")) {
+      if (auto err = cfg->set("enable.auto.offset.store", "false")) {
+        ctrl.diagnostics().emit(
+          diagnostic::error("failed to disable offset store: {}", err).done());
+        return {};
+      }
+    }
     // Adjust rebalance callback to set desired offset.
     auto offset = RdKafka::Topic::OFFSET_END;
     if (args_.offset) {
@@ -146,48 +269,97 @@ public:
         }
       }
     }
-    // Create the consumer.
+    // Create the consumers.
     if (auto value = cfg->get("bootstrap.servers")) {
       TENZIR_INFO("kafka connects to broker: {}", *value);
     }
-    auto client = consumer::make(*cfg);
-    if (!client) {
-      ctrl.diagnostics().emit(
-        diagnostic::error("failed to create consumer: {}", client.error())
-          .done());
-      return {};
-    };
     auto topic = args_.topic ? args_.topic->inner : default_topic;
-    TENZIR_INFO("kafka subscribes to topic {}", topic);
-    if (auto err = client->subscribe({topic})) {
-      ctrl.diagnostics().emit(
-        diagnostic::error("failed to subscribe to topic: {}", err).done());
-      return {};
+    auto consumers = std::vector<consumer>{};
+    const auto num_consumers = args_.consumers ? args_.consumers->inner : 1;
+    for (auto i = size_t{0}; i < num_consumers; ++i) {
+      auto client = consumer::make(*cfg);
+      if (!client) {
+        ctrl.diagnostics().emit(
+          diagnostic::error("failed to create consumer: {}", client.error())
+            .done());
+        return {};
+      };
+      TENZIR_INFO("kafka subscribes to topic {}", topic);
+      if (auto err = client->subscribe({topic})) {
+        ctrl.diagnostics().emit(
+          diagnostic::error("failed to subscribe to topic: {}", err).done());
+        return {};
+      }
+      consumers.push_back(std::move(*client));
     }
     // Setup the coroutine factory.
-    auto make
-      = [](loader_args args, consumer client) mutable -> generator<chunk_ptr> {
+    auto make = [](loader_args args, std::vector<consumer> consumers,
+                   operator_control_plane& ctrl) -> generator<chunk_ptr> {
+      const auto batch_size = args.batch_size ? args.batch_size->inner : 1;
+      auto pool
+        = std::make_unique<consumer_pool>(std::move(consumers), batch_size);
       auto num_messages = size_t{0};
-      while (true) {
-        auto msg = client.consume(500ms);
-        if (!msg) {
+      // The partitions whose end we reached, for exiting once we reached the
+      // end of all assigned partitions.
+      auto eof_partitions = std::unordered_set<std::string>{};
+      auto done = false;
+      while (not done) {
+        auto batch = pool->next(500ms);
+        if (not batch) {
           co_yield {};
-          if (msg.error() == ec::timeout)
-            continue;
-          if (msg.error() == ec::end_of_input)
-            // FIXME: currently doesn't work for N partitions with N > 1.
-            // Upgrade to a counter and only break out of the loop once this
-            // signal has been received N times.
+          continue;
+        }
+        auto messages = std::vector<chunk_ptr>{};
+        auto offsets = std::vector<message_offset>{};
+        for (auto& msg : batch->messages) {
+          if (done)
             break;
-          TENZIR_ERROR(msg.error());
-          break;
+          auto partition
+            = fmt::format("{}/{}", msg->topic_name(), msg->partition());
+          switch (msg->err()) {
+            case RdKafka::ERR_NO_ERROR: {
+              eof_partitions.erase(partition);
+              auto it = std::find_if(offsets.begin(), offsets.end(),
+                                     [&](const message_offset& x) {
+                                       return x.partition == msg->partition()
+                                              && x.topic == msg->topic_name();
+                                     });
+              if (it == offsets.end())
+                offsets.push_back(
+                  {msg->topic_name(), msg->partition(), msg->offset()});
+              else
+                it->offset = std::max(it->offset, msg->offset());
+              messages.push_back(make_chunk(std::move(msg)));
+              if (args.count && args.count->inner == ++num_messages)
+                done = true;
+              break;
+            }
+            case RdKafka::ERR__PARTITION_EOF: {
+              if (not args.exit)
+                break;
+              eof_partitions.insert(std::move(partition));
+              done = eof_partitions.size() >= pool->num_assigned_partitions();
+              break;
+            }
+            default:
+              diagnostic::error("failed to consume message: {} ({})",
+                                msg->errstr(), static_cast<int>(msg->err()))
+                .emit(ctrl.diagnostics());
+              done = true;
+              break;
+          }
+        }
+        if (not messages.empty()) {
+          // Without batching, we pass on messages as they are.
+          co_yield batch_size == 1 ? std::move(messages.front())
+                                   : join_lines(std::move(messages));
+          // The messages are handed off, so we can commit their offsets.
+          if (auto err = pool->store_offsets(*batch, offsets))
+            TENZIR_DEBUG("kafka {}", err);
         }
-        co_yield *msg;
-        if (args.count && args.count->inner == ++num_messages)
-          break;
       }
     };
-    return make(args_, std::move(*client));
+    return make(args_, std::move(consumers), ctrl);
   }
 
   auto name() const -> std::string override {
@@ -213,16 +385,96 @@ struct saver_args {
   std::optional<located<std::string>> topic;
   std::optional<located<std::string>> key;
   std::optional<located<std::string>> timestamp;
+  std::optional<located<std::string>> options;
+  bool split_lines;
 
   template <class Inspector>
   friend auto inspect(Inspector& f, saver_args& x) -> bool {
     return f.object(x)
       .pretty_name("saver_args")
       .fields(f.field("topic", x.topic), f.field("key", x.key),
-              f.field("timestamp", x.timestamp));
+              f.field("timestamp", x.timestamp), f.field("options", x.options),
+              f.field("split_lines", x.split_lines));
   }
 };
 
+/// Produces printed bytes as Kafka messages, optionally with one message per
+/// line, and tracks their delivery.
+class message_writer {
+public:
+  message_writer(producer client, std::vector<std::string> topics,
+                 std::string key, time timestamp, bool split_lines,
+                 operator_control_plane& ctrl)
+    : client_{std::move(client)},
+      topics_{std::move(topics)},
+      key_{std::move(key)},
+      timestamp_{timestamp},
+      split_lines_{split_lines},
+      ctrl_{ctrl} {
+  }
+
+  message_writer(const message_writer&) = delete;
+  auto operator=(const message_writer&) -> message_writer& = delete;
+
+  ~message_writer() noexcept {
+    if (auto partial_line = lines_.finish(); not partial_line.empty())
+      static_cast<void>(produce(std::as_bytes(std::span{partial_line})));
+    TENZIR_VERBOSE("waiting 10 seconds to flush pending messages");
+    if (auto err = client_.flush(10s))
+      TENZIR_WARN(err);
+    auto num_messages = client_.queue_size();
+    if (num_messages > 0)
+      TENZIR_ERROR("{} messages were not delivered", num_messages);
+    if (auto [num_failures, error] = client_.reporter().take_failures();
+        num_failures > 0)
+      TENZIR_ERROR("{} messages failed to be delivered: {}", num_failures,
+                   error);
+  }
+
+  void write(const chunk_ptr& chunk) {
+    if (!chunk || chunk->size() == 0)
+      return;
+    if (not split_lines_) {
+      if (not produce(as_bytes(*chunk)))
+        return;
+    } else {
+      auto produce_line = [&](std::span<const std::byte> line) {
+        return produce(line);
+      };
+      if (not lines_.split(as_bytes(*chunk), produce_line))
+        return;
+    }
+    // It's advised to call poll periodically to tell Kafka "you can flush
+    // buffered messages if you like". This also serves delivery reports.
+    client_.poll(0ms);
+    if (auto [num_failures, error] = client_.reporter().take_failures();
+        num_failures > 0)
+      diagnostic::error(error)
+        .note("{} messages failed to be delivered", num_failures)
+        .emit(ctrl_.diagnostics());
+  }
+
+private:
+  auto produce(std::span<const std::byte> bytes) -> bool {
+    for (const auto& topic : topics_) {
+      TENZIR_DEBUG("publishing {} bytes to topic {}", bytes.size(), topic);
+      if (auto error = client_.produce(topic, bytes, key_, timestamp_)) {
+        diagnostic::error(error).emit(ctrl_.diagnostics());
+        return false;
+      }
+    }
+    return true;
+  }
+
+  producer client_;
+  std::vector<std::string> topics_;
+  std::string key_;
+  time timestamp_;
+  bool split_lines_;
+  operator_control_plane& ctrl_;
+  line_splitter lines_ = {};
+};
+
 class kafka_saver final : public plugin_saver {
 public:
   kafka_saver() = default;
@@ -238,6 +490,18 @@ public:
       TENZIR_ERROR("kafka failed to create configuration: {}", cfg.error());
       return cfg.error();
     };
+    // Override configuration with arguments.
+    if (args_.options) {
+      std::vector<std::pair<std::string, std::string>> options;
+      if (!parsers::kvp_list(args_.options->inner, options))
+        return caf::make_error(ec::parse_error,
+                               "invalid list of key=value pairs");
+      for (const auto& [key, value] : options) {
+        TENZIR_INFO("providing librdkafka option {}={}", key, value);
+        if (auto err = cfg->set(key, value))
+          return err;
+      }
+    }
     if (auto value = cfg->get("bootstrap.servers")) {
       TENZIR_INFO("kafka connects to broker: {}", *value);
     }
@@ -246,14 +510,6 @@ public:
       TENZIR_ERROR(client.error());
       return client.error();
     };
-    auto guard = caf::detail::make_scope_guard([client = *client]() mutable {
-      TENZIR_VERBOSE("waiting 10 seconds to flush pending messages");
-      if (auto err = client.flush(10s))
-        TENZIR_WARN(err);
-      auto num_messages = client.queue_size();
-      if (num_messages > 0)
-        TENZIR_ERROR("{} messages were not delivered", num_messages);
-    });
     auto topic = args_.topic ? args_.topic->inner : default_topic;
     auto topics = std::vector<std::string>{std::move(topic)};
     std::string key;
@@ -264,22 +520,11 @@ public:
       auto result = parsers::time(args_.timestamp->inner, timestamp);
       TENZIR_ASSERT(result); // validated earlier
     }
-    return [&ctrl, client = *client, key = std::move(key), ts = timestamp,
-            topics = std::move(topics),
-            guard = std::make_shared<decltype(guard)>(std::move(guard))](
-             chunk_ptr chunk) mutable {
-      if (!chunk || chunk->size() == 0)
-        return;
-      for (const auto& topic : topics) {
-        TENZIR_DEBUG("publishing {} bytes to topic {}", chunk->size(), topic);
-        if (auto error = client.produce(topic, as_bytes(*chunk), key, ts)) {
-          diagnostic::error(error).emit(ctrl.diagnostics());
-          return;
-        }
-      }
-      // It's advised to call poll periodically to tell Kafka "you can flush
-      // buffered messages if you like".
-      client.poll(0ms);
+    auto writer = std::make_shared<message_writer>(
+      std::move(*client), std::move(topics), std::move(key), timestamp,
+      args_.split_lines, ctrl);
+    return [writer = std::move(writer)](chunk_ptr chunk) {
+      writer->write(chunk);
     };
   }
 
@@ -307,7 +552,8 @@ private:
 };
 
 class plugin final : public virtual loader_plugin<kafka_loader>,
-                     public virtual saver_plugin<kafka_saver> {
+                     public virtual saver_plugin<kafka_saver>,
+                     public virtual metrics_plugin {
 public:
   auto initialize(const record& config, const record& /* global_config */)
     -> caf::error override {
@@ -331,7 +577,15 @@ public:
     parser.add("-o,--offset", args.offset, "<offset>");
     // We use -X because that's standard in Kafka applications, cf. kcat.
     parser.add("-X,--set", args.options, "<key=value>,...");
+    parser.add("-b,--batch-size", args.batch_size, "<n>");
+    parser.add("--consumers", args.consumers, "<n>");
     parser.parse(p);
+    for (const auto* option : {&args.batch_size, &args.consumers}) {
+      if (*option and (*option)->inner == 0)
+        diagnostic::error("value must be positive")
+          .primary((*option)->source)
+          .throw_();
+    }
     if (args.offset) {
       if (!offset_parser()(args.offset->inner))
         diagnostic::error("invalid `--offset` value")
@@ -352,6 +606,8 @@ public:
     parser.add("-t,--topic", args.topic, "<topic>");
     parser.add("-k,--key", args.key, "<key>");
     parser.add("-T,--timestamp", args.timestamp, "<time>");
+    parser.add("-X,--set", args.options, "<key=value>,...");
+    parser.add("--split-lines", args.split_lines);
     parser.parse(p);
     if (args.timestamp)
       if (!parsers::time(args.timestamp->inner))
@@ -365,6 +621,41 @@ public:
     return "kafka";
   }
 
+  auto metric_layout() const -> record_type override {
+    return record_type{{
+      {"produced_messages", uint64_type{}},
+      {"produced_bytes", uint64_type{}},
+      {"delivered_messages", uint64_type{}},
+      {"failed_messages", uint64_type{}},
+      {"queue_full_waits", uint64_type{}},
+      {"mean_latency", duration_type{}},
+      {"max_latency", duration_type{}},
+    }};
+  }
+
+  auto make_collector() const -> caf::expected<collector> override {
+    // Reports the producer activity since the previous collection.
+    return []() -> caf::expected<record> {
+      auto& metrics = producer_metrics::global();
+      const auto take = [](std::atomic<uint64_t>& counter) {
+        return counter.exchange(0, std::memory_order_relaxed);
+      };
+      auto delivered = take(metrics.delivered_messages);
+      auto total_latency = take(metrics.total_latency_us);
+      auto result = record{};
+      result["produced_messages"] = take(metrics.produced_messages);
+      result["produced_bytes"] = take(metrics.produced_bytes);
+      result["delivered_messages"] = delivered;
+      result["failed_messages"] = take(metrics.failed_messages);
+      result["queue_full_waits"] = take(metrics.queue_full_waits);
+      result["mean_latency"] = duration{std::chrono::microseconds{
+        delivered == 0 ? 0 : total_latency / delivered}};
+      result["max_latency"] = duration{
+        std::chrono::microseconds{take(metrics.max_latency_us)}};
+      return result;
+    };
+  }
+
 private:
   record config_;
 };
@@ -14,11 +14,52 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <utility>
+
 namespace tenzir::plugins::kafka {
 
+auto producer_metrics::global() -> producer_metrics& {
+  static auto metrics = producer_metrics{};
+  return metrics;
+}
+
+auto delivery_reporter::dr_cb(RdKafka::Message& message) -> void {
+  auto& metrics = producer_metrics::global();
+  if (message.err() != RdKafka::ERR_NO_ERROR) {
+    metrics.failed_messages.fetch_add(1, std::memory_order_relaxed);
+    if (num_failures_++ == 0)
+      first_failure_ = caf::make_error(
+        ec::unspecified, fmt::format("failed to deliver message to topic {}: "
+                                     "{}",
+                                     message.topic_name(), message.errstr()));
+    return;
+  }
+  metrics.delivered_messages.fetch_add(1, std::memory_order_relaxed);
+  const auto latency
+    = static_cast<uint64_t>(std::max(message.latency(), int64_t{0}));
+  metrics.total_latency_us.fetch_add(latency, std::memory_order_relaxed);
+  auto max = metrics.max_latency_us.load(std::memory_order_relaxed);
+  while (max < latency
+         && not metrics.max_latency_us.compare_exchange_weak(
+           max, latency, std::memory_order_relaxed)) {
+  }
+}
+
+auto delivery_reporter::take_failures() -> std::pair<size_t, caf::error> {
+  return {std::exchange(num_failures_, 0), std::exchange(first_failure_, {})};
+}
+
 auto producer::make(configuration config) -> caf::expected<producer> {
   producer result;
   std::string error;
+  result.reporter_ = std::make_shared<delivery_reporter>();
+  if (config.conf_->set("dr_cb", result.reporter_.get(), error)
+      != RdKafka::Conf::ConfResult::CONF_OK)
+    return caf::make_error(ec::unspecified,
+                           fmt::format("failed to set delivery report "
+                                       "callback: {}",
+                                       error));
   result.producer_.reset(RdKafka::Producer::create(config.conf_.get(), error));
   if (!result.producer_)
     return caf::make_error(ec::unspecified,
@@ -37,7 +78,7 @@ auto producer::produce(std::string topic, std::span<const std::byte> bytes,
   while (true) {
     auto result = producer_->produce(
       /// The message topic.
-      std::move(topic),
+      topic,
       // Any partition.
       RdKafka::Topic::PARTITION_UA,
       // Make a copy of the buffer.
@@ -70,6 +111,10 @@ auto producer::produce(std::string topic, std::span<const std::byte> bytes,
       default:
         return caf::make_error(ec::unspecified, err2str(result));
       case RdKafka::ERR_NO_ERROR: {
+        auto& metrics = producer_metrics::global();
+        metrics.produced_messages.fetch_add(1, std::memory_order_relaxed);
+        metrics.produced_bytes.fetch_add(bytes.size(),
+                                         std::memory_order_relaxed);
         producer_->poll(0);
         return {};
       }
@@ -79,10 +124,12 @@ auto producer::produce(std::string topic, std::span<const std::byte> bytes,
         // callback to be called.
         //
         // The internal queue is limited by the configuration property
-        // queue.buffering.max.messages and queue.buffering.max.kbytes
-        auto ms = 1000;
-        TENZIR_WARN("queue full, retrying in {}ms", ms);
-        producer_->poll(ms);
+        // queue.buffering.max.messages and queue.buffering.max.kbytes. We
+        // apply backpressure by serving delivery reports until there is room
+        // again, which takes as long as the broker needs to catch up.
+        producer_metrics::global().queue_full_waits.fetch_add(
+          1, std::memory_order_relaxed);
+        producer_->poll(10);
         break;
       }
     }
@@ -90,6 +137,10 @@ auto producer::produce(std::string topic, std::span<const std::byte> bytes,
   __builtin_unreachable();
 }
 
+auto producer::reporter() const -> delivery_reporter& {
+  return *reporter_;
+}
+
 auto producer::poll(std::chrono::milliseconds timeout) -> int {
   auto ms = detail::narrow_cast<int>(timeout.count());
   return producer_->poll(ms);
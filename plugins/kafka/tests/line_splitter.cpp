@@ -0,0 +1,92 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "kafka/line_splitter.hpp"
+
+#include <tenzir/test/test.hpp>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace tenzir::plugins::kafka;
+
+namespace {
+
+using lines = std::vector<std::string>;
+
+/// Feeds `input` to `splitter` and returns the resulting lines.
+auto split(line_splitter& splitter, std::string_view input) -> lines {
+  auto result = lines{};
+  auto ok = splitter.split(std::as_bytes(std::span{input}),
+                           [&](std::span<const std::byte> line) {
+                             result.emplace_back(
+                               reinterpret_cast<const char*>(line.data()),
+                               line.size());
+                             return true;
+                           });
+  CHECK(ok);
+  return result;
+}
+
+} // namespace
+
+TEST(complete lines) {
+  auto splitter = line_splitter{};
+  CHECK_EQUAL(split(splitter, "foo\nbar\n"), (lines{"foo", "bar"}));
+  CHECK_EQUAL(splitter.finish(), "");
+}
+
+TEST(lines across chunk boundaries) {
+  auto splitter = line_splitter{};
+  CHECK_EQUAL(split(splitter, "foo\nba"), (lines{"foo"}));
+  CHECK_EQUAL(split(splitter, "r"), lines{});
+  CHECK_EQUAL(split(splitter, ""), lines{});
+  CHECK_EQUAL(split(splitter, "\nbaz\nqu"), (lines{"bar", "baz"}));
+  CHECK_EQUAL(split(splitter, "x"), lines{});
+  CHECK_EQUAL(splitter.finish(), "qux");
+  CHECK_EQUAL(splitter.finish(), "");
+}
+
+TEST(newline at the start of a chunk) {
+  auto splitter = line_splitter{};
+  CHECK_EQUAL(split(splitter, "foo"), lines{});
+  CHECK_EQUAL(split(splitter, "\nbar"), (lines{"foo"}));
+  CHECK_EQUAL(splitter.finish(), "bar");
+}
+
+TEST(empty lines) {
+  auto splitter = line_splitter{};
+  CHECK_EQUAL(split(splitter, "\n\nfoo\n\n"), (lines{"foo"}));
+  CHECK_EQUAL(split(splitter, "\n"), lines{});
+  CHECK_EQUAL(split(splitter, "bar\n\n\nbaz"), (lines{"bar"}));
+  CHECK_EQUAL(split(splitter, "\n\n"), (lines{"baz"}));
+  CHECK_EQUAL(splitter.finish(), "");
+}
+
+TEST(carriage returns) {
+  auto splitter = line_splitter{};
+  CHECK_EQUAL(split(splitter, "foo\r\nbar\r"), (lines{"foo\r"}));
+  CHECK_EQUAL(split(splitter, "\n\r\n"), (lines{"bar\r", "\r"}));
+  CHECK_EQUAL(splitter.finish(), "");
+}
+
+TEST(stop early) {
+  auto splitter = line_splitter{};
+  auto result = lines{};
+  auto ok = splitter.split(std::as_bytes(std::span{std::string_view{"a\nb\n"}}),
+                           [&](std::span<const std::byte> line) {
+                             result.emplace_back(
+                               reinterpret_cast<const char*>(line.data()),
+                               line.size());
+                             return false;
+                           });
+  CHECK(not ok);
+  CHECK_EQUAL(result, (lines{"a"}));
+}
@@ -9,10 +9,12 @@
 #include <tenzir/argument_parser.hpp>
 #include <tenzir/chunk.hpp>
 #include <tenzir/concept/parseable/tenzir/ip.hpp>
+#include <tenzir/concept/parseable/tenzir/si.hpp>
 #include <tenzir/concept/parseable/to.hpp>
 #include <tenzir/concept/printable/tenzir/data.hpp>
 #include <tenzir/concept/printable/to_string.hpp>
 #include <tenzir/detail/posix.hpp>
+#include <tenzir/die.hpp>
 #include <tenzir/error.hpp>
 #include <tenzir/logger.hpp>
 #include <tenzir/pcap.hpp>
@@ -22,6 +24,13 @@
 #include <pcap/pcap.h>
 
 #include <chrono>
+#include <cstring>
+#include <limits>
+
+#if defined(__linux__)
+#  include <linux/if_packet.h>
+#  include <sys/socket.h>
+#endif
 
 using namespace std::chrono_literals;
 
@@ -29,27 +38,36 @@ namespace tenzir::plugins::nic {
 
 namespace {
 
+/// The default size of the kernel ring buffer that holds captured packets.
+constexpr auto default_buffer_size = uint64_t{64} << 20;
+
 struct loader_args {
   located<std::string> iface;
   std::optional<located<uint32_t>> snaplen;
   std::optional<location> emit_file_headers;
+  std::optional<located<std::string>> filter;
+  std::optional<located<uint64_t>> buffer_size;
+  std::optional<location> immediate;
+  std::optional<located<uint16_t>> fanout;
 
   template <class Inspector>
   friend auto inspect(Inspector& f, loader_args& x) -> bool {
     return f.object(x)
       .pretty_name("loader_args")
       .fields(f.field("iface", x.iface), f.field("snaplen", x.snaplen),
-              f.field("emit_file_headers", x.emit_file_headers));
+              f.field("emit_file_headers", x.emit_file_headers),
+              f.field("filter", x.filter),
+              f.field("buffer_size", x.buffer_size),
+              f.field("immediate", x.immediate), f.field("fanout", x.fanout));
   }
 };
 
-auto make_file_header(int snaplen, int linktype) -> pcap::file_header {
+auto make_file_header(int snaplen, int linktype, int precision)
+  -> pcap::file_header {
   return {
-    // Timestamps have microsecond resolution when using pcap_open_live(). If we
-    // want nanosecond resolution, we must stop using pcap_open_live() and
-    // replace it with pcap_create() and pcap_activate(). See
-    // https://stackoverflow.com/q/28310922/1170277 for details.
-    .magic_number = pcap::magic_number_1,
+    .magic_number = precision == PCAP_TSTAMP_PRECISION_NANO
+                      ? pcap::magic_number_2
+                      : pcap::magic_number_1,
     .major_version = 2,
     .minor_version = 4,
     .reserved1 = 0,
@@ -59,6 +77,140 @@ auto make_file_header(int snaplen, int linktype) -> pcap::file_header {
   };
 };
 
+/// The packets captured since the last emitted chunk.
+struct capture_buffer {
+  std::vector<std::byte> bytes = {};
+  size_t num_packets = 0;
+  /// The file header to prepend to every chunk, if any.
+  std::optional<pcap::file_header> file_header = {};
+};
+
+/// The `pcap_handler` that appends a packet record to a capture buffer.
+void append_packet(u_char* user, const pcap_pkthdr* pkt_hdr,
+                   const u_char* pkt_data) {
+  auto& buffer = *reinterpret_cast<capture_buffer*>(user);
+  if (buffer.file_header && buffer.bytes.empty()) {
+    auto bytes = as_bytes(*buffer.file_header);
+    buffer.bytes.insert(buffer.bytes.end(), bytes.begin(), bytes.end());
+  }
+  // With nanosecond precision, libpcap stores nanoseconds in `tv_usec`.
+  auto header = pcap::packet_header{
+    .timestamp = detail::narrow_cast<uint32_t>(pkt_hdr->ts.tv_sec),
+    .timestamp_fraction = detail::narrow_cast<uint32_t>(pkt_hdr->ts.tv_usec),
+    .captured_packet_length = pkt_hdr->caplen,
+    .original_packet_length = pkt_hdr->len,
+  };
+  auto size = buffer.bytes.size();
+  buffer.bytes.resize(size + sizeof(pcap::packet_header) + pkt_hdr->caplen);
+  std::memcpy(buffer.bytes.data() + size, &header, sizeof(header));
+  std::memcpy(buffer.bytes.data() + size + sizeof(pcap::packet_header),
+              pkt_data, pkt_hdr->caplen);
+  ++buffer.num_packets;
+}
+
+/// Creates and activates a capture handle.
+auto open_capture(const loader_args& args, uint32_t snaplen)
+  -> caf::expected<std::shared_ptr<pcap_t>> {
+  auto error = std::array<char, PCAP_ERRBUF_SIZE>{};
+  auto* ptr = pcap_create(args.iface.inner.c_str(), error.data());
+  if (!ptr)
+    return caf::make_error(ec::unspecified,
+                           fmt::format("failed to open interface: {}",
+                                       std::string_view{error.data()}));
+  auto pcap = std::shared_ptr<pcap_t>{ptr, [](pcap_t* p) {
+                                        pcap_close(p);
+                                      }};
+  const auto check = [&](int status, std::string_view what) -> caf::error {
+    if (status == 0)
+      return {};
+    return caf::make_error(ec::unspecified,
+                           fmt::format("failed to {}: {}", what,
+                                       pcap_statustostr(status)));
+  };
+  if (auto err = check(pcap_set_snaplen(pcap.get(),
+                                        detail::narrow_cast<int>(snaplen)),
+                       "set snaplen"))
+    return err;
+  if (auto err = check(pcap_set_promisc(pcap.get(), 1),
+                       "enable promiscuous mode"))
+    return err;
+  // On Linux, libpcap captures into a TPACKET_V3 ring buffer that is mapped
+  // into our address space, unless we request immediate mode. The ring
+  // delivers packets in blocks, which is considerably faster, but means that
+  // packets may sit in a partially filled block until the timeout hits.
+  if (args.immediate) {
+    if (auto err = check(pcap_set_immediate_mode(pcap.get(), 1),
+                         "enable immediate mode"))
+      return err;
+  }
+  // The packet buffer timeout functions much like a read timeout: It
+  // describes the number of milliseconds to wait at most until returning
+  // from pcap_dispatch.
+  auto packet_buffer_timeout_ms
+    = std::chrono::duration_cast<std::chrono::duration<int, std::milli>>(
+        defaults::import::read_timeout)
+        .count();
+  if (auto err = check(pcap_set_timeout(pcap.get(), packet_buffer_timeout_ms),
+                       "set packet buffer timeout"))
+    return err;
+  auto buffer_size = args.buffer_size ? args.buffer_size->inner
+                                      : default_buffer_size;
+  if (auto err = check(pcap_set_buffer_size(
+                         pcap.get(), detail::narrow_cast<int>(buffer_size)),
+                       "set buffer size"))
+    return err;
+  // Not all platforms support nanosecond timestamps, in which case we fall
+  // back to microseconds.
+  if (pcap_set_tstamp_precision(pcap.get(), PCAP_TSTAMP_PRECISION_NANO) != 0)
+    TENZIR_VERBOSE("{} does not support nanosecond timestamps",
+                   args.iface.inner);
+  auto status = pcap_activate(pcap.get());
+  if (status < 0) {
+    auto detail = status == PCAP_ERROR ? std::string{pcap_geterr(pcap.get())}
+                                       : std::string{pcap_statustostr(status)};
+    return caf::make_error(ec::unspecified,
+                           fmt::format("failed to activate capture: {}",
+                                       detail));
+  }
+  if (status > 0)
+    TENZIR_WARN("activated capture on {} with warning: {}", args.iface.inner,
+                pcap_statustostr(status));
+  if (args.filter) {
+    auto program = bpf_program{};
+    if (pcap_compile(pcap.get(), &program, args.filter->inner.c_str(), 1,
+                     PCAP_NETMASK_UNKNOWN)
+        != 0)
+      return caf::make_error(ec::invalid_argument,
+                             fmt::format("failed to compile filter: {}",
+                                         pcap_geterr(pcap.get())));
+    status = pcap_setfilter(pcap.get(), &program);
+    pcap_freecode(&program);
+    if (status != 0)
+      return caf::make_error(ec::unspecified,
+                             fmt::format("failed to set filter: {}",
+                                         pcap_geterr(pcap.get())));
+  }
+  if (args.fanout) {
+#if defined(__linux__)
+    // Every socket that joins the same fanout group receives a share of the
+    // packets, balanced by flow so that a flow always ends up in the same
+    // socket.
+    auto mode = uint32_t{PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG};
+    auto fanout = (mode << 16) | args.fanout->inner;
+    if (::setsockopt(pcap_fileno(pcap.get()), SOL_PACKET, PACKET_FANOUT,
+                     &fanout, sizeof(fanout))
+        != 0)
+      return caf::make_error(ec::unspecified,
+                             fmt::format("failed to join fanout group {}: {}",
+                                         args.fanout->inner,
+                                         detail::describe_errno()));
+#else
+    die("packet fanout is only available on Linux"); // validated earlier
+#endif
+  }
+  return pcap;
+}
+
 class nic_loader final : public plugin_loader {
 public:
   nic_loader() = default;
@@ -72,112 +224,94 @@ public:
     auto snaplen = args_.snaplen ? args_.snaplen->inner : 262'144;
     TENZIR_DEBUG("capturing from {} with snaplen of {}", args_.iface.inner,
                  snaplen);
-    auto make = [](auto& ctrl, auto iface, auto snaplen,
-                   bool emit_file_headers) mutable -> generator<chunk_ptr> {
-      auto put_iface_in_promiscuous_mode = 1;
-      // The packet buffer timeout functions much like a read timeout: It
-      // describes the number of milliseconds to wait at most until returning
-      // from pcap_next_ex.
-      auto packet_buffer_timeout_ms
-        = std::chrono::duration_cast<std::chrono::duration<int, std::milli>>(
-            defaults::import::read_timeout)
-            .count();
-      auto error = std::array<char, PCAP_ERRBUF_SIZE>{};
-      auto* ptr
-        = pcap_open_live(iface.c_str(), detail::narrow_cast<int>(snaplen),
-                         put_iface_in_promiscuous_mode,
-                         packet_buffer_timeout_ms, error.data());
-      if (!ptr) {
-        diagnostic::error("failed to open interface: {}",
-                          std::string_view{error.data()})
+    auto make = [](auto& ctrl, loader_args args,
+                   uint32_t snaplen) mutable -> generator<chunk_ptr> {
+      auto pcap = open_capture(args, snaplen);
+      if (!pcap) {
+        diagnostic::error("{}", pcap.error())
           .note("from `nic`")
           .emit(ctrl.diagnostics());
         co_return;
       }
-      auto pcap = std::shared_ptr<pcap_t>{ptr, [](pcap_t* p) {
-                                            pcap_close(p);
-                                          }};
-      auto linktype = pcap_datalink(pcap.get());
+      auto linktype = pcap_datalink(pcap->get());
       TENZIR_ASSERT(linktype != PCAP_ERROR_NOT_ACTIVATED);
+      auto precision = pcap_get_tstamp_precision(pcap->get());
+      auto file_header = make_file_header(detail::narrow_cast<int>(snaplen),
+                                          linktype, precision);
       // We yield once initially to signal that the operator successfully
       // started.
       co_yield {};
+      // Emit a PCAP file header, either with every chunk or once initially as
+      // separate chunk. This results in a packet stream that looks like a
+      // standard PCAP file downstream, allowing users to use the `pcap`
+      // format to parse the byte stream.
+      auto buffer = capture_buffer{};
+      if (args.emit_file_headers)
+        buffer.file_header = file_header;
       auto num_packets = size_t{0};
-      auto num_buffered_packets = size_t{0};
-      auto buffer = std::vector<std::byte>{};
+      auto num_drops = uint64_t{0};
       auto last_finish = std::chrono::steady_clock::now();
       while (true) {
         const auto now = std::chrono::steady_clock::now();
-        if (num_buffered_packets >= defaults::import::table_slice_size
-            or last_finish + defaults::import::batch_timeout < now) {
+        if (buffer.num_packets >= defaults::import::table_slice_size
+            or (buffer.num_packets > 0
+                and last_finish + defaults::import::batch_timeout < now)) {
           TENZIR_DEBUG("yielding buffer after {} with {} packets ({} bytes)",
-                       tenzir::data{now - last_finish}, num_buffered_packets,
-                       buffer.size());
+                       tenzir::data{now - last_finish}, buffer.num_packets,
+                       buffer.bytes.size());
           last_finish = now;
-          co_yield chunk::make(std::exchange(buffer, {}));
+          if (num_packets == buffer.num_packets and not buffer.file_header)
+            co_yield chunk::copy(as_bytes(file_header));
           // Reduce number of small allocations based on what we've seen
           // previously.
-          auto avg_packet_size = buffer.size() / num_buffered_packets;
-          buffer.reserve(avg_packet_size * defaults::import::table_slice_size);
-          num_buffered_packets = 0;
-        }
-        const u_char* pkt_data = nullptr;
-        pcap_pkthdr* pkt_hdr = nullptr;
-        auto r = ::pcap_next_ex(pcap.get(), &pkt_hdr, &pkt_data);
-        if (r == 0) {
-          // Timeout
-          if (last_finish != now) {
-            co_yield {};
+          auto avg_packet_size = buffer.bytes.size() / buffer.num_packets;
+          co_yield chunk::make(std::exchange(buffer.bytes, {}));
+          buffer.bytes.reserve(avg_packet_size
+                               * defaults::import::table_slice_size);
+          buffer.num_packets = 0;
+          // Check whether the kernel or the interface had to drop packets,
+          // which happens when we do not keep up with the ring buffer.
+          auto stats = pcap_stat{};
+          if (pcap_stats(pcap->get(), &stats) == 0) {
+            auto drops = uint64_t{stats.ps_drop} + stats.ps_ifdrop;
+            if (drops > num_drops) {
+              if (num_drops == 0)
+                diagnostic::warning("dropped packets while capturing")
+                  .note("from `nic`")
+                  .hint("increase `--buffer-size` or use `--fanout`")
+                  .emit(ctrl.diagnostics());
+              TENZIR_VERBOSE("nic dropped {} packets on {}", drops - num_drops,
+                             args.iface.inner);
+              num_drops = drops;
+            }
           }
-          continue;
         }
-        if (r == -2) {
-          TENZIR_DEBUG("reached end of trace with {} packets", num_packets);
+        // Process up to a full batch of packets at once, i.e., a full block
+        // of the ring buffer at a time.
+        auto max_packets = detail::narrow_cast<int>(
+          defaults::import::table_slice_size - buffer.num_packets);
+        auto r = ::pcap_dispatch(pcap->get(), max_packets, append_packet,
+                                 reinterpret_cast<u_char*>(&buffer));
+        if (r == PCAP_ERROR_BREAK) {
+          TENZIR_DEBUG("capture loop broke after {} packets", num_packets);
           break;
         }
         if (r == PCAP_ERROR) {
-          auto error = std::string_view{::pcap_geterr(pcap.get())};
+          auto error = std::string_view{::pcap_geterr(pcap->get())};
           diagnostic::error("failed to get next packet: {}", error)
             .note("from `nic`")
             .emit(ctrl.diagnostics());
           break;
         }
-        // Emit a PCAP file header, either with every chunk or once initially as
-        // separate chunk. This results in a packet stream that looks like a
-        // standard PCAP file downstream, allowing users to use the `pcap`
-        // format to parse the byte stream.
-        if (emit_file_headers) {
-          if (buffer.empty()) {
-            auto header = make_file_header(snaplen, linktype);
-            auto bytes = as_bytes(header);
-            buffer.insert(buffer.end(), bytes.begin(), bytes.end());
-          }
-        } else if (num_packets == 0) {
-          auto linktype = pcap_datalink(pcap.get());
-          TENZIR_ASSERT(linktype != PCAP_ERROR_NOT_ACTIVATED);
-          auto header = make_file_header(snaplen, linktype);
-          co_yield chunk::copy(as_bytes(header));
+        if (r == 0) {
+          // Timeout
+          co_yield {};
+          continue;
         }
-        auto header = pcap::packet_header{
-          .timestamp = detail::narrow_cast<uint32_t>(pkt_hdr->ts.tv_sec),
-          .timestamp_fraction
-          = detail::narrow_cast<uint32_t>(pkt_hdr->ts.tv_usec),
-          .captured_packet_length = pkt_hdr->caplen,
-          .original_packet_length = pkt_hdr->len,
-        };
-        auto data = std::span<const std::byte>{
-          reinterpret_cast<const std::byte*>(pkt_data),
-          static_cast<size_t>(pkt_hdr->caplen)};
-        auto buffer_size = buffer.size();
-        buffer.resize(buffer_size + sizeof(pcap::packet_header) + data.size());
-        std::memcpy(buffer.data() + buffer_size, &header, sizeof(header));
-        std::memcpy(buffer.data() + buffer_size + sizeof(pcap::packet_header),
-                    data.data(), data.size());
-        ++num_buffered_packets;
-        ++num_packets;
+        num_packets += detail::narrow_cast<size_t>(r);
       }
     };
-    return make(ctrl, args_.iface.inner, snaplen, !!args_.emit_file_headers);
+    return make(ctrl, args_, snaplen);
   }
 
   auto name() const -> std::string override {
@@ -337,10 +471,31 @@ public:
       name(),
       fmt::format("https://docs.tenzir.com/docs/connectors/{}", name())};
     auto args = loader_args{};
+    auto buffer_size = std::optional<located<std::string>>{};
     parser.add(args.iface, "<iface>");
     parser.add("-s,--snaplen", args.snaplen, "<count>");
     parser.add("-e,--emit-file-headers", args.emit_file_headers);
+    parser.add("-f,--filter", args.filter, "<bpf>");
+    parser.add("-b,--buffer-size", buffer_size, "<bytes>");
+    parser.add("--immediate", args.immediate);
+    parser.add("--fanout", args.fanout, "<group>");
     parser.parse(p);
+    if (buffer_size) {
+      auto bytes = uint64_t{0};
+      if (not parsers::bytesize(buffer_size->inner, bytes) or bytes == 0
+          or bytes > uint64_t{std::numeric_limits<int>::max()})
+        diagnostic::error("invalid buffer size `{}`", buffer_size->inner)
+          .primary(buffer_size->source)
+          .hint("use a positive number of bytes below 2Gi, e.g., `256Mi`")
+          .throw_();
+      args.buffer_size = located<uint64_t>{bytes, buffer_size->source};
+    }
+#if not defined(__linux__)
+    if (args.fanout)
+      diagnostic::error("packet fanout is only available on Linux")
+        .primary(args.fanout->source)
+        .throw_();
+#endif
     return std::make_unique<nic_loader>(std::move(args));
   }
 
@@ -10,6 +10,8 @@
 #include <tenzir/concept/convertible/data.hpp>
 #include <tenzir/detail/base64.hpp>
 #include <tenzir/detail/inspection_common.hpp>
+#include <tenzir/diagnostics.hpp>
+#include <tenzir/generator.hpp>
 #include <tenzir/plugin.hpp>
 #include <tenzir/store.hpp>
 
@@ -23,6 +25,8 @@
 #include <parquet/arrow/reader.h>
 #include <parquet/arrow/writer.h>
 
+#include <numeric>
+
 namespace tenzir::plugins::parquet {
 
 /// Configuration for the Parquet plugin.
@@ -85,25 +89,6 @@ fix_enum_array(const enumeration_type& et,
   }
 }
 
-/// Transform a chunked array by applying a mapping function `Mapper` over each
-/// chunk and constructs a new array from the transformed chunks.
-template <class Mapper, class VastType>
-std::shared_ptr<arrow::ChunkedArray>
-map_chunked_array(const VastType& t,
-                  const std::shared_ptr<arrow::ChunkedArray>& arr, Mapper m) {
-  auto chunks = arrow::ArrayVector{};
-  chunks.reserve(arr->num_chunks());
-  for (const auto& chunk : arr->chunks()) {
-    // short-circuit: if the first transform is a no-op, skip remaining chunks
-    if (std::shared_ptr<arrow::Array> c = m(t, chunk))
-      chunks.push_back(std::move(c));
-    else
-      return arr;
-  }
-  auto result = arrow::ChunkedArray::Make(chunks);
-  return result.ValueOrDie();
-}
-
 /// Transform an array into its canonical form for the provided tenzir type.
 /// the Arrow parquet reader does not fully restore the schema used during
 /// write. In particular, it doesn't handle extension types in map keys and
@@ -191,56 +176,6 @@ align_array_to_type(const tenzir::type& t,
   return caf::visit(f, t);
 }
 
-/// Transform a given `ChunkedArray` according to the provided Tenzir type
-/// `ChunkedArray`s only occur at the outermost level, and the Tenzir type
-/// that is not properly represented at this level is `enumeration_type`.
-std::shared_ptr<arrow::ChunkedArray>
-restore_enum_chunk_array(const tenzir::type& t,
-                         std::shared_ptr<arrow::ChunkedArray> array) {
-  auto f = detail::overload{
-    [&](const enumeration_type& et) -> std::shared_ptr<arrow::ChunkedArray> {
-      return map_chunked_array(et, array, fix_enum_array);
-    },
-    [&](const list_type&) -> std::shared_ptr<arrow::ChunkedArray> {
-      return map_chunked_array(t, array, align_array_to_type);
-    },
-    [&](const map_type&) -> std::shared_ptr<arrow::ChunkedArray> {
-      return map_chunked_array(t, array, align_array_to_type);
-    },
-    [&](const record_type&) -> std::shared_ptr<arrow::ChunkedArray> {
-      return map_chunked_array(t, array, align_array_to_type);
-    },
-    [&](const auto&) -> std::shared_ptr<arrow::ChunkedArray> {
-      TENZIR_ASSERT_EXPENSIVE(t.to_arrow_type()->Equals(array->type()));
-      return {};
-    },
-  };
-  return caf::visit(f, t);
-}
-
-/// Transform the table such that it adheres to the given arrow schema
-/// This is a work around for the lack of support for our extension types in the
-/// arrow parquet reader.
-std::shared_ptr<arrow::Table>
-align_table_to_schema(const std::shared_ptr<arrow::Schema>& target_schema,
-                      const std::shared_ptr<arrow::Table>& table) {
-  const auto start = std::chrono::steady_clock::now();
-  auto arrays = arrow::ChunkedArrayVector{};
-  auto rt = caf::get<record_type>(type::from_arrow(*target_schema));
-  for (int i = 0; i < table->num_columns(); ++i) {
-    if (auto new_arr
-        = restore_enum_chunk_array(rt.field(i).type, table->column(i)))
-      arrays.push_back(new_arr);
-    else
-      arrays.push_back(table->column(i));
-  }
-  auto new_table = arrow::Table::Make(target_schema, arrays, table->num_rows());
-  const auto delta = std::chrono::steady_clock::now() - start;
-  TENZIR_DEBUG("table schema aligned in {}[ns]",
-               data{std::chrono::duration_cast<duration>(delta)});
-  return new_table;
-}
-
 auto derive_import_time(const std::shared_ptr<arrow::Array>& time_col) {
   return value_at(time_type{}, *time_col, time_col->length() - 1);
 }
@@ -259,9 +194,10 @@ unwrap_record_batch(const std::shared_ptr<arrow::RecordBatch>& rb) {
 }
 
 /// Create multiple table slices for a record batch, splitting at `max_slice_size`
+/// and assigning consecutive offsets starting at `first`.
 std::vector<table_slice>
 create_table_slices(const std::shared_ptr<arrow::RecordBatch>& rb,
-                    int64_t max_slice_size) {
+                    int64_t max_slice_size, id first) {
   auto final_rb = unwrap_record_batch(rb);
   auto time_col = rb->GetColumnByName("import_time");
   auto slices = std::vector<table_slice>{};
@@ -272,7 +208,7 @@ create_table_slices(const std::shared_ptr<arrow::RecordBatch>& rb,
     auto& slice = slices.emplace_back(rb_sliced, schema);
     slice.import_time(
       derive_import_time(time_col->Slice(offset, max_slice_size)));
-    slice.offset(detail::narrow_cast<id>(offset));
+    slice.offset(first + detail::narrow_cast<id>(offset));
   }
   return slices;
 }
@@ -295,23 +231,71 @@ std::shared_ptr<arrow::Schema> parse_arrow_schema_from_metadata(
   return *arrow_schema;
 }
 
-caf::expected<std::shared_ptr<arrow::Table>>
-read_parquet_buffer(const chunk_ptr& chunk) {
+/// Transform the record batch such that it adheres to the given arrow schema.
+/// This is a work around for the lack of support for our extension types in
+/// the arrow parquet reader.
+std::shared_ptr<arrow::RecordBatch> align_record_batch_to_schema(
+  const std::shared_ptr<arrow::Schema>& target_schema,
+  const std::shared_ptr<arrow::RecordBatch>& batch) {
+  auto arrays = arrow::ArrayVector{};
+  arrays.reserve(batch->num_columns());
+  auto rt = caf::get<record_type>(type::from_arrow(*target_schema));
+  for (int i = 0; i < batch->num_columns(); ++i) {
+    if (auto new_arr = align_array_to_type(rt.field(i).type, batch->column(i)))
+      arrays.push_back(std::move(new_arr));
+    else
+      arrays.push_back(batch->column(i));
+  }
+  return arrow::RecordBatch::Make(target_schema, batch->num_rows(),
+                                  std::move(arrays));
+}
+
+/// Decode a Parquet file incrementally, one row group after another. The
+/// columns of a row group are decoded in parallel.
+auto decode_parquet_buffer(const chunk_ptr& chunk) -> caf::expected<
+  generator<caf::expected<std::shared_ptr<arrow::RecordBatch>>>> {
   TENZIR_ASSERT(chunk);
   auto bufr = std::make_shared<arrow::io::BufferReader>(as_arrow_buffer(chunk));
-  const auto options = ::parquet::default_reader_properties();
-  auto parquet_reader = ::parquet::ParquetFileReader::Open(bufr, options);
-  auto arrow_schema
-    = parse_arrow_schema_from_metadata(parquet_reader->metadata());
+  auto builder = ::parquet::arrow::FileReaderBuilder{};
+  if (auto st = builder.Open(bufr); !st.ok())
+    return caf::make_error(ec::parse_error, st.ToString());
+  auto properties = ::parquet::default_arrow_reader_properties();
+  properties.set_use_threads(true);
   std::unique_ptr<::parquet::arrow::FileReader> file_reader{};
-  if (auto st = ::parquet::arrow::OpenFile(bufr, arrow::default_memory_pool(),
-                                           &file_reader);
+  if (auto st = builder.memory_pool(arrow::default_memory_pool())
+                  ->properties(properties)
+                  ->Build(&file_reader);
       !st.ok())
     return caf::make_error(ec::parse_error, st.ToString());
-  std::shared_ptr<arrow::Table> table{};
-  if (auto st = file_reader->ReadTable(&table); !st.ok())
+  auto arrow_schema = parse_arrow_schema_from_metadata(
+    file_reader->parquet_reader()->metadata());
+  if (!arrow_schema)
+    return caf::make_error(ec::parse_error,
+                           "Parquet file has no Tenzir schema in its metadata");
+  auto row_groups = std::vector<int>(file_reader->num_row_groups());
+  std::iota(row_groups.begin(), row_groups.end(), 0);
+  std::unique_ptr<arrow::RecordBatchReader> batch_reader{};
+  if (auto st = file_reader->GetRecordBatchReader(row_groups, &batch_reader);
+      !st.ok())
     return caf::make_error(ec::parse_error, st.ToString());
-  return align_table_to_schema(arrow_schema, table);
+  return [](auto file_reader, auto batch_reader, auto arrow_schema)
+           -> generator<caf::expected<std::shared_ptr<arrow::RecordBatch>>> {
+    // The batch reader refers to the file reader, so the latter must be kept
+    // alive until we're done.
+    (void)file_reader;
+    while (true) {
+      auto batch = batch_reader->Next();
+      if (!batch.ok()) {
+        co_yield caf::make_error(ec::parse_error,
+                                 fmt::format("unable to read record batch: {}",
+                                             batch.status().ToString()));
+        co_return;
+      }
+      if (!*batch)
+        co_return;
+      co_yield align_record_batch_to_schema(arrow_schema, *batch);
+    }
+  }(std::move(file_reader), std::move(batch_reader), std::move(arrow_schema));
 }
 
 std::shared_ptr<::parquet::WriterProperties>
@@ -386,25 +370,78 @@ public:
   /// @param chunk The chunk pointing to the store's persisted data.
   /// @returns An error on failure.
   [[nodiscard]] caf::error load(chunk_ptr chunk) override {
-    auto table = read_parquet_buffer(chunk);
-    if (!table)
-      return table.error();
-    for (const auto& rb : arrow::TableBatchReader(*table)) {
-      if (!rb.ok())
-        return caf::make_error(ec::system_error,
-                               fmt::format("unable to read record batch: {}",
-                                           rb.status().ToString()));
+    auto batches = decode_parquet_buffer(chunk);
+    if (!batches)
+      return batches.error();
+    for (auto&& batch : *batches) {
+      if (!batch)
+        return batch.error();
       auto slices_for_batch = create_table_slices(
-        *rb, detail::narrow_cast<int64_t>(parquet_config_.row_group_size));
+        *batch, detail::narrow_cast<int64_t>(parquet_config_.row_group_size),
+        num_rows_);
       slices_.reserve(slices_for_batch.size() + slices_.size());
       slices_.insert(slices_.end(),
                      std::make_move_iterator(slices_for_batch.begin()),
                      std::make_move_iterator(slices_for_batch.end()));
-      num_rows_ += (*rb)->num_rows();
+      num_rows_ += (*batch)->num_rows();
     }
     return {};
   }
 
+  [[nodiscard]] generator<table_slice>
+  load_incrementally(generator<chunk_ptr> input,
+                     diagnostic_handler& dh) override {
+    // Parquet files store their metadata in a footer, so we cannot start
+    // decoding before the input is complete. We do, however, decode them one
+    // row group at a time instead of materializing the entire table, so that
+    // we never need to hold more than the file and a single row group in
+    // memory.
+    auto chunks = std::vector<chunk_ptr>{};
+    auto size = size_t{0};
+    for (auto&& chunk : input) {
+      if (chunk && chunk->size() > 0) {
+        size += chunk->size();
+        chunks.push_back(std::move(chunk));
+      }
+      co_yield {};
+    }
+    if (chunks.empty())
+      co_return;
+    auto input_chunk = chunk_ptr{};
+    if (chunks.size() == 1) {
+      input_chunk = std::move(chunks.front());
+    } else {
+      auto buffer = std::vector<std::byte>{};
+      buffer.reserve(size);
+      for (const auto& x : std::exchange(chunks, {}))
+        buffer.insert(buffer.end(), x->begin(), x->end());
+      input_chunk = chunk::make(std::move(buffer));
+    }
+    auto batches = decode_parquet_buffer(input_chunk);
+    if (!batches) {
+      diagnostic::error(batches.error())
+        .note("parser failed to load")
+        .emit(dh);
+      co_return;
+    }
+    auto offset = id{0};
+    for (auto&& batch : *batches) {
+      if (!batch) {
+        diagnostic::error(batch.error())
+          .note("parser failed to load")
+          .emit(dh);
+        co_return;
+      }
+      for (auto& slice : create_table_slices(
+             *batch,
+             detail::narrow_cast<int64_t>(parquet_config_.row_group_size),
+             offset)) {
+        offset += slice.rows();
+        co_yield std::move(slice);
+      }
+    }
+  }
+
   /// Retrieve all of the store's slices.
   /// @returns The store's slices.
   [[nodiscard]] generator<table_slice> slices() const override {
@@ -13,7 +13,9 @@
 #include <tenzir/concept/parseable/to.hpp>
 #include <tenzir/detail/narrow.hpp>
 #include <tenzir/detail/spawn_container_source.hpp>
+#include <tenzir/diagnostics.hpp>
 #include <tenzir/expression.hpp>
+#include <tenzir/generator.hpp>
 #include <tenzir/ids.hpp>
 #include <tenzir/logger.hpp>
 #include <tenzir/plugin.hpp>
@@ -451,6 +453,56 @@ TEST(active parquet store erase) {
   run();
 }
 
+TEST(passive parquet store incremental load) {
+  auto f = table_slice_fixture();
+  const auto* plugin = tenzir::plugins::find<tenzir::store_plugin>("parquet");
+  REQUIRE(plugin);
+  auto active = unbox(plugin->make_active_store());
+  auto slices = std::vector<table_slice>{f.slice, f.slice, f.slice};
+  REQUIRE_EQUAL(active->add(slices), caf::none);
+  auto chunk = unbox(active->finish());
+  REQUIRE(chunk);
+  // Feed the store in small chunks to exercise reassembling the file before
+  // decoding it one row group at a time.
+  auto input = [](chunk_ptr chunk) -> generator<chunk_ptr> {
+    constexpr auto chunk_size = size_t{5};
+    for (auto offset = size_t{0}; offset < chunk->size();
+         offset += chunk_size)
+      co_yield chunk->slice(offset, chunk_size);
+  };
+  auto passive = unbox(plugin->make_passive_store());
+  auto dh = collecting_diagnostic_handler{};
+  auto results = std::vector<table_slice>{};
+  auto offset = id{0};
+  for (auto&& slice : passive->load_incrementally(input(chunk), dh)) {
+    if (slice.rows() == 0)
+      continue;
+    CHECK_EQUAL(slice.offset(), offset);
+    offset += slice.rows();
+    results.push_back(std::move(slice));
+  }
+  CHECK(std::move(dh).collect().empty());
+  REQUIRE(not results.empty());
+  // The store may combine or split slices along row groups, so we compare
+  // the concatenated events.
+  compare_table_slices(concatenate(std::move(results)), concatenate(slices));
+}
+
+TEST(passive parquet store incremental load invalid input) {
+  const auto* plugin = tenzir::plugins::find<tenzir::store_plugin>("parquet");
+  REQUIRE(plugin);
+  auto input = []() -> generator<chunk_ptr> {
+    co_yield chunk::copy(std::string_view{"PAR1 not a parquet file"});
+  };
+  auto passive = unbox(plugin->make_passive_store());
+  auto dh = collecting_diagnostic_handler{};
+  auto rows = size_t{0};
+  for (auto&& slice : passive->load_incrementally(input(), dh))
+    rows += slice.rows();
+  CHECK_EQUAL(rows, size_t{0});
+  CHECK(not std::move(dh).collect().empty());
+}
+
 TEST(active parquet store status) {
   auto f = table_slice_fixture();
   auto slice = f.slice;
@@ -17,13 +17,17 @@
 #include <tenzir/concept/parseable/tenzir/pipeline.hpp>
 #include <tenzir/concept/parseable/to.hpp>
 #include <tenzir/data.hpp>
+#include <tenzir/detail/narrow.hpp>
 #include <tenzir/error.hpp>
 #include <tenzir/io/read.hpp>
+#include <tenzir/multi_query_filter.hpp>
 #include <tenzir/pipeline.hpp>
 #include <tenzir/plugin.hpp>
 #include <tenzir/table_slice_builder.hpp>
 
+#include <arrow/array/util.h>
 #include <arrow/record_batch.h>
+#include <arrow/scalar.h>
 #include <caf/error.hpp>
 #include <caf/expected.hpp>
 #include <caf/typed_event_based_actor.hpp>
@@ -41,13 +45,49 @@ public:
     : refresh_interval_{refresh_interval}, path_{std::move(path)} {
   }
 
+  /// A rule prepared for producing results.
+  struct compiled_rule {
+    std::string path;
+    data yaml;
+    type schema;
+    /// The rule as a single Arrow scalar that is repeated for every match.
+    std::shared_ptr<arrow::Scalar> scalar;
+  };
+
   struct monitor_state {
-    auto update(const std::filesystem::path& path, operator_control_plane& ctrl)
-      -> void {
-      auto old_rules = std::exchange(rules, {});
+    /// Reloads all rules from the configured path, returning whether the set
+    /// of rules changed.
+    auto update(operator_control_plane& ctrl) -> bool {
+      auto new_rules = decltype(rules){};
+      load(path, new_rules, ctrl);
+      for (const auto& [rule_path, rule] : new_rules) {
+        const auto old_rule = rules.find(rule_path);
+        if (old_rule == rules.end()) {
+          TENZIR_VERBOSE("added Sigma rule {}", rule_path);
+        } else if (old_rule->second != rule) {
+          TENZIR_VERBOSE("updated Sigma rule {}", rule_path);
+        }
+      }
+      for (const auto& [rule_path, _] : rules) {
+        if (not new_rules.contains(rule_path)) {
+          TENZIR_VERBOSE("removed Sigma rule {}", rule_path);
+        }
+      }
+      if (new_rules == rules) {
+        return false;
+      }
+      rules = std::move(new_rules);
+      compile();
+      return true;
+    }
+
+    static auto load(const std::filesystem::path& path,
+                     std::unordered_map<std::string,
+                                        std::pair<data, expression>>& result,
+                     operator_control_plane& ctrl) -> void {
       if (std::filesystem::is_directory(path)) {
         for (const auto& entry : std::filesystem::directory_iterator(path)) {
-          update(entry.path(), ctrl);
+          load(entry.path(), result, ctrl);
         }
         return;
       }
@@ -60,6 +100,7 @@ public:
         diagnostic::warning("sigma operator ignores rule '{}'", path.string())
           .note("failed to read file: {}", query.error())
           .emit(ctrl.diagnostics());
+        return;
       }
       auto query_str = std::string_view{
         reinterpret_cast<const char*>(query->data()),
@@ -78,25 +119,36 @@ public:
           .emit(ctrl.diagnostics());
         return;
       }
-      rules[path.string()] = {std::move(*yaml), std::move(*rule)};
-      for (const auto& [path, rule] : rules) {
-        const auto old_rule = old_rules.find(path);
-        if (old_rule == old_rules.end()) {
-          TENZIR_VERBOSE("added Sigma rule {}", path);
-        } else if (old_rule->second != rule) {
-          TENZIR_VERBOSE("updated Sigma rule {}", path);
-        }
-      }
-      for (const auto& [path, _] : old_rules) {
-        if (not rules.contains(path)) {
-          TENZIR_VERBOSE("removed Sigma rule {}", path);
-        }
+      result[path.string()] = {std::move(*yaml), std::move(*rule)};
+    }
+
+    /// Registers all rules with a fresh matcher and converts their YAML
+    /// representation to Arrow once, rather than for every matching event.
+    auto compile() -> void {
+      compiled.clear();
+      matcher = {};
+      for (const auto& [rule_path, entry] : rules) {
+        const auto& [yaml, rule] = entry;
+        auto schema = type{
+          caf::get<record_type>(type::infer(yaml).value_or(type{}))};
+        auto builder = schema.make_arrow_builder(arrow::default_memory_pool());
+        const auto append_result
+          = append_builder(caf::get<record_type>(schema),
+                           caf::get<arrow::StructBuilder>(*builder),
+                           caf::get<view<record>>(make_view(yaml)));
+        TENZIR_ASSERT(append_result.ok(), append_result.ToString().c_str());
+        auto array = builder->Finish().ValueOrDie();
+        auto scalar = array->GetScalar(0).ValueOrDie();
+        matcher.add(compiled.size(), rule);
+        compiled.push_back(
+          {rule_path, yaml, std::move(schema), std::move(scalar)});
       }
-      return;
     }
 
     std::filesystem::path path;
     std::unordered_map<std::string, std::pair<data, expression>> rules = {};
+    std::vector<compiled_rule> compiled = {};
+    multi_query_filter matcher = {};
   };
 
   auto
@@ -104,7 +156,7 @@ public:
     -> generator<table_slice> {
     auto state = monitor_state{};
     state.path = path_;
-    state.update(state.path, ctrl);
+    state.update(ctrl);
     auto last_update = std::chrono::steady_clock::now();
     co_yield {}; // signal that we're done initializing
     for (auto&& slice : input) {
@@ -113,54 +165,28 @@ public:
         continue;
       }
       if (last_update + refresh_interval_ < std::chrono::steady_clock::now()) {
-        state.update(state.path, ctrl);
+        state.update(ctrl);
         last_update = std::chrono::steady_clock::now();
       }
-      for (const auto& [path, entry] : state.rules) {
-        const auto& [yaml, rule] = entry;
-        auto expr = tailor(rule, slice.schema());
-        if (not expr) {
-          continue;
-        }
-        if (auto event = filter(slice, *expr)) {
-          const auto rule_schema
-            = caf::get<record_type>(type::infer(yaml).value_or(type{}));
-          const auto result_schema = type{
-            "tenzir.sigma",
-            record_type{
-              {"event", event->schema()},
-              {"rule", rule_schema},
-            },
-          };
-          auto result_builder
-            = result_schema.make_arrow_builder(arrow::default_memory_pool());
-          auto array = to_record_batch(*event)->ToStructArray().ValueOrDie();
-          for (const auto& row :
-               values(caf::get<record_type>(slice.schema()), *array)) {
-            const auto append_row_result
-              = caf::get<arrow::StructBuilder>(*result_builder).Append();
-            TENZIR_ASSERT(append_row_result.ok());
-            const auto append_event_result = append_builder(
-              caf::get<record_type>(event->schema()),
-              caf::get<arrow::StructBuilder>(
-                *caf::get<arrow::StructBuilder>(*result_builder)
-                   .field_builder(0)),
-              *row);
-            TENZIR_ASSERT(append_event_result.ok());
-            const auto append_rule_result = append_builder(
-              rule_schema,
-              caf::get<arrow::StructBuilder>(
-                *caf::get<arrow::StructBuilder>(*result_builder)
-                   .field_builder(1)),
-              caf::get<view<record>>(make_view(yaml)));
-            TENZIR_ASSERT(append_rule_result.ok());
-          }
-          auto result = result_builder->Finish().ValueOrDie();
-          auto rb = arrow::RecordBatch::Make(
-            result_schema.to_arrow_schema(), event->rows(),
-            caf::get<arrow::StructArray>(*result).fields());
-          co_yield table_slice{rb, result_schema};
-        }
+      // All rules are evaluated together, sharing predicates between them.
+      // The matching events of every rule are then combined column-wise
+      // with the rule itself.
+      for (auto& [index, event] : state.matcher.apply(slice)) {
+        const auto& rule = state.compiled[index];
+        const auto result_schema = type{
+          "tenzir.sigma",
+          record_type{
+            {"event", event.schema()},
+            {"rule", rule.schema},
+          },
+        };
+        auto event_array = to_record_batch(event)->ToStructArray().ValueOrDie();
+        auto rule_array
+          = arrow::MakeArrayFromScalar(*rule.scalar, event.rows()).ValueOrDie();
+        auto rb = arrow::RecordBatch::Make(
+          result_schema.to_arrow_schema(), detail::narrow<int64_t>(event.rows()),
+          arrow::ArrayVector{std::move(event_array), std::move(rule_array)});
+        co_yield table_slice{rb, result_schema};
       }
     }
   }
@@ -26,6 +26,7 @@ struct configuration {
       {"keyfile", tenzir::string_type{}},
       {"web-root", tenzir::string_type{}},
       {"cors-allowed-origin", tenzir::string_type{}},
+      {"io-threads", tenzir::int64_type{}},
     };
     return result;
   }
@@ -36,7 +37,8 @@ struct configuration {
       .pretty_name("tenzir.plugins.rest.configuration")
       .fields(f.field("bind-address", x.bind_address), f.field("port", x.port),
               f.field("mode", x.mode), f.field("certfile", x.certfile),
-              f.field("keyfile", x.keyfile), f.field("web-root", x.web_root));
+              f.field("keyfile", x.keyfile), f.field("web-root", x.web_root),
+              f.field("io-threads", x.io_threads));
   }
 
   enum class server_mode {
@@ -53,6 +55,7 @@ struct configuration {
   std::string web_root = {};
   std::string cors_allowed_origin = {};
   int port = 5160;
+  int io_threads = 0;
 };
 
 // The resolved and validated configuration that gets used at runtime.
@@ -98,6 +101,9 @@ public:
 
   /// The path from which to serve static files.
   std::optional<std::filesystem::path> webroot = {};
+
+  /// The number of threads that handle I/O for incoming connections.
+  size_t io_threads = 1;
 };
 
 /// Validate that the user-provided configuration makes sense.
@@ -0,0 +1,81 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <tenzir/actors.hpp>
+#include <tenzir/time.hpp>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tenzir::plugins::web {
+
+/// A latency histogram with exponentially growing buckets that can be updated
+/// concurrently from multiple threads.
+class latency_histogram {
+public:
+  /// The number of buckets. Bucket `i` counts latencies below `2^i`
+  /// microseconds, and the last bucket counts all remaining latencies.
+  static constexpr size_t num_buckets = 25;
+
+  /// A point-in-time copy of the histogram.
+  struct snapshot {
+    std::array<uint64_t, num_buckets> buckets = {};
+    uint64_t count = {};
+    uint64_t errors = {};
+    duration max = {};
+
+    /// Returns the upper bound of the bucket containing the given quantile.
+    auto quantile(double q) const -> duration;
+  };
+
+  /// Returns the upper bound of the given bucket.
+  static auto upper_bound(size_t bucket) -> duration;
+
+  /// Records a single request.
+  void add(duration latency, bool error) noexcept;
+
+  /// Returns the recorded requests and resets the histogram.
+  auto reset() noexcept -> snapshot;
+
+private:
+  std::array<std::atomic<uint64_t>, num_buckets> buckets_ = {};
+  std::atomic<uint64_t> errors_ = {};
+  std::atomic<duration::rep> max_ = {};
+};
+
+/// Latency histograms per API route. The set of routes is fixed before the
+/// server starts, so the lookup structure itself is never modified
+/// concurrently.
+class request_metrics {
+public:
+  /// Registers a route, returning the histogram to record its requests in.
+  auto add_route(std::string method, std::string path)
+    -> std::shared_ptr<latency_histogram>;
+
+  /// Builds one event per route that received requests since the last call.
+  auto collect(time now) -> std::vector<table_slice>;
+
+private:
+  std::map<std::pair<std::string, std::string>,
+           std::shared_ptr<latency_histogram>>
+    routes_ = {};
+};
+
+/// Periodically sends the collected request metrics to the importer.
+auto spawn_request_metrics_reporter(caf::actor_system& system,
+                                    std::shared_ptr<request_metrics> metrics,
+                                    importer_actor importer,
+                                    caf::timespan interval) -> caf::actor;
+
+} // namespace tenzir::plugins::web
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "web/request_metrics.hpp"
+
 #include <tenzir/http_api.hpp>
 #include <tenzir/plugin.hpp>
 
@@ -29,7 +31,8 @@ using route_params_t = restinio::router::route_params_t;
 class restinio_response final {
 public:
   restinio_response(request_handle_t&& handle, route_params_t&& route_params,
-                    bool enable_detailed_errors, const rest_endpoint&);
+                    bool enable_detailed_errors, const rest_endpoint&,
+                    std::shared_ptr<latency_histogram> histogram = nullptr);
   ~restinio_response();
 
   restinio_response(restinio_response&&) = default;
@@ -38,6 +41,7 @@ public:
   auto operator=(restinio_response&&) -> restinio_response& = delete;
 
   void finish(caf::expected<std::string>);
+  void finish(rest_response rsp);
   void append(std::string body);
 
   void abort(uint16_t error_code, std::string message, caf::error detail);
@@ -57,6 +61,9 @@ private:
   bool enable_detailed_errors_ = false;
   response_t response_;
   size_t body_size_ = {};
+  std::shared_ptr<latency_histogram> histogram_ = {};
+  std::chrono::steady_clock::time_point start_ = {};
+  bool failed_ = false;
 };
 
 } // namespace tenzir::plugins::web
@@ -23,8 +23,9 @@ namespace tenzir::plugins::web {
 
 using router_t = restinio::router::express_router_t<>;
 
-/// Traits class for the dev server.
-struct dev_traits_t : public restinio::default_single_thread_traits_t {
+/// Traits class for the dev server. The server may run on multiple I/O
+/// threads, so we must use the thread-safe default traits.
+struct dev_traits_t : public restinio::default_traits_t {
   using request_handler_t = restinio::router::express_router_t<>;
 };
 
@@ -32,9 +33,10 @@ struct dev_traits_t : public restinio::default_single_thread_traits_t {
 using dev_server_t = restinio::http_server_t<dev_traits_t>;
 
 /// Traits class for the TLS server.
-using tls_traits_t = restinio::single_thread_tls_traits_t<
-  restinio::asio_timer_manager_t, restinio::single_threaded_ostream_logger_t,
-  restinio::router::express_router_t<>>;
+using tls_traits_t
+  = restinio::tls_traits_t<restinio::asio_timer_manager_t,
+                           restinio::shared_ostream_logger_t,
+                           restinio::router::express_router_t<>>;
 
 /// The TLS server class.
 using tls_server_t = restinio::http_server_t<tls_traits_t>;
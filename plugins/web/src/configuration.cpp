@@ -7,11 +7,22 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <tenzir/detail/installdirs.hpp>
+#include <tenzir/detail/narrow.hpp>
 
 #include <web/configuration.hpp>
 
+#include <algorithm>
+#include <thread>
+
 namespace tenzir::plugins::web {
 
+namespace defaults {
+
+/// The upper bound for the automatically chosen number of I/O threads.
+inline constexpr size_t max_io_threads = 8;
+
+} // namespace defaults
+
 static caf::expected<enum configuration::server_mode>
 to_server_mode(const std::string& str) {
   if (str == "dev")
@@ -89,6 +100,16 @@ caf::expected<server_config> convert_and_validate(configuration config) {
         ec::invalid_argument,
         fmt::format("can only bind to localhost in {} mode", config.mode));
   result.port = config.port;
+  if (config.io_threads < 0)
+    return caf::make_error(ec::invalid_argument,
+                           "the number of I/O threads must not be negative");
+  // Zero selects the number of threads based on the available hardware
+  // concurrency, which restinio does not benefit from beyond a few threads.
+  result.io_threads
+    = config.io_threads > 0
+        ? detail::narrow_cast<size_t>(config.io_threads)
+        : std::clamp(size_t{std::thread::hardware_concurrency()}, size_t{1},
+                     defaults::max_io_threads);
   return result;
 }
 
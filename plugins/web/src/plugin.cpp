@@ -64,7 +64,9 @@ class plugin final : public virtual command_plugin,
                                             "defaults to '*' in dev mode.")
         .add<std::string>("root", "document root of the server")
         .add<std::string>("bind", "listen address of server")
-        .add<int64_t>("port", "listen port"));
+        .add<int64_t>("port", "listen port")
+        .add<int64_t>("io-threads", "number of threads handling connections; "
+                                    "0 chooses based on the hardware"));
     rest_command->add_subcommand("generate-token", "generate auth token",
                                  command::opts("?plugins.web.token"));
     auto factory = command::factory{};
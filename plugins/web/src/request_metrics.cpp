@@ -0,0 +1,149 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "web/request_metrics.hpp"
+
+#include <tenzir/detail/weak_run_delayed.hpp>
+#include <tenzir/logger.hpp>
+#include <tenzir/series_builder.hpp>
+#include <tenzir/table_slice.hpp>
+
+#include <caf/event_based_actor.hpp>
+
+#include <bit>
+
+namespace tenzir::plugins::web {
+
+auto latency_histogram::upper_bound(size_t bucket) -> duration {
+  return std::chrono::microseconds{uint64_t{1} << bucket};
+}
+
+auto latency_histogram::snapshot::quantile(double q) const -> duration {
+  const auto rank = static_cast<uint64_t>(q * static_cast<double>(count));
+  auto seen = uint64_t{0};
+  for (size_t i = 0; i < num_buckets - 1; ++i) {
+    seen += buckets[i];
+    if (seen > rank) {
+      return std::min(upper_bound(i), max);
+    }
+  }
+  return max;
+}
+
+void latency_histogram::add(duration latency, bool error) noexcept {
+  const auto us = std::max(
+    int64_t{0},
+    std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+  const auto bucket = std::min(
+    static_cast<size_t>(std::bit_width(static_cast<uint64_t>(us))),
+    num_buckets - 1);
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  if (error) {
+    errors_.fetch_add(1, std::memory_order_relaxed);
+  }
+  auto current = max_.load(std::memory_order_relaxed);
+  while (latency.count() > current
+         and not max_.compare_exchange_weak(current, latency.count(),
+                                            std::memory_order_relaxed)) {
+  }
+}
+
+auto latency_histogram::reset() noexcept -> snapshot {
+  auto result = snapshot{};
+  for (size_t i = 0; i < num_buckets; ++i) {
+    result.buckets[i] = buckets_[i].exchange(0, std::memory_order_relaxed);
+    result.count += result.buckets[i];
+  }
+  result.errors = errors_.exchange(0, std::memory_order_relaxed);
+  result.max = duration{max_.exchange(0, std::memory_order_relaxed)};
+  return result;
+}
+
+auto request_metrics::add_route(std::string method, std::string path)
+  -> std::shared_ptr<latency_histogram> {
+  auto& result = routes_[{std::move(method), std::move(path)}];
+  if (not result) {
+    result = std::make_shared<latency_histogram>();
+  }
+  return result;
+}
+
+auto request_metrics::collect(time now) -> std::vector<table_slice> {
+  auto builder = series_builder{
+    type{"tenzir.metrics.api", record_type{}, {{"internal", ""}}}};
+  for (const auto& [route, histogram] : routes_) {
+    const auto snapshot = histogram->reset();
+    if (snapshot.count == 0) {
+      continue;
+    }
+    auto event = builder.record();
+    event.field("timestamp", now);
+    event.field("method", std::string_view{route.first});
+    event.field("path", std::string_view{route.second});
+    event.field("requests", snapshot.count);
+    event.field("errors", snapshot.errors);
+    event.field("latency_p50", snapshot.quantile(0.5));
+    event.field("latency_p90", snapshot.quantile(0.9));
+    event.field("latency_p99", snapshot.quantile(0.99));
+    event.field("latency_max", snapshot.max);
+    auto buckets = event.field("histogram").list();
+    for (size_t i = 0; i < latency_histogram::num_buckets; ++i) {
+      if (snapshot.buckets[i] == 0) {
+        continue;
+      }
+      auto bucket = buckets.record();
+      if (i + 1 < latency_histogram::num_buckets) {
+        bucket.field("upper_bound", latency_histogram::upper_bound(i));
+      } else {
+        bucket.field("upper_bound", caf::none);
+      }
+      bucket.field("count", snapshot.buckets[i]);
+    }
+  }
+  return builder.finish_as_table_slice();
+}
+
+namespace {
+
+struct request_metrics_reporter_state {
+  static constexpr auto name = "request-metrics-reporter";
+
+  std::shared_ptr<request_metrics> metrics = {};
+  importer_actor importer = {};
+};
+
+auto request_metrics_reporter(
+  caf::stateful_actor<request_metrics_reporter_state>* self,
+  std::shared_ptr<request_metrics> metrics, importer_actor importer,
+  caf::timespan interval) -> caf::behavior {
+  self->state.metrics = std::move(metrics);
+  self->state.importer = std::move(importer);
+  detail::weak_run_delayed_loop(self, interval, [self] {
+    const auto now = time{std::chrono::system_clock::now()};
+    for (auto& slice : self->state.metrics->collect(now)) {
+      self->send(self->state.importer, std::move(slice));
+    }
+  });
+  return {
+    [](atom::ping) {
+      // nop
+    },
+  };
+}
+
+} // namespace
+
+auto spawn_request_metrics_reporter(caf::actor_system& system,
+                                    std::shared_ptr<request_metrics> metrics,
+                                    importer_actor importer,
+                                    caf::timespan interval) -> caf::actor {
+  return system.spawn(request_metrics_reporter, std::move(metrics),
+                      std::move(importer), interval);
+}
+
+} // namespace tenzir::plugins::web
@@ -16,21 +16,43 @@ static std::string content_type_to_string(tenzir::http_content_type type) {
       return "application/json; charset=utf-8";
     case http_content_type::ldjson:
       return "application/ld+json; charset=utf-8";
+    case http_content_type::arrow_stream:
+      return "application/vnd.apache.arrow.stream";
   }
   // Unreachable
   return "application/octet-stream";
 }
 
+namespace {
+
+/// Adapts a chunk to restinio's requirements for shared buffers.
+struct chunk_buffer {
+  chunk_ptr chunk;
+
+  auto data() const noexcept -> const void* {
+    return chunk->data();
+  }
+
+  auto size() const noexcept -> std::size_t {
+    return chunk->size();
+  }
+};
+
+} // namespace
+
 restinio_response::restinio_response(request_handle_t&& handle,
                                      route_params_t&& route_params,
                                      bool enable_detailed_errors,
-                                     const rest_endpoint& endpoint)
+                                     const rest_endpoint& endpoint,
+                                     std::shared_ptr<latency_histogram> histogram)
   : request_(std::move(handle)),
     route_params_(std::move(route_params)),
     enable_detailed_errors_(enable_detailed_errors),
     // Note that ownership of the `connection` is transferred when creating a
     // response.
-    response_(request_->create_response<restinio::user_controlled_output_t>()) {
+    response_(request_->create_response<restinio::user_controlled_output_t>()),
+    histogram_(std::move(histogram)),
+    start_(std::chrono::steady_clock::now()) {
   response_.append_header(restinio::http_field::content_type,
                           content_type_to_string(endpoint.content_type));
   response_.header().status_code(
@@ -40,6 +62,9 @@ restinio_response::restinio_response(request_handle_t&& handle,
 restinio_response::~restinio_response() {
   // `done()` must only be called exactly once.
   response_.append_header_date_field().set_content_length(body_size_).done();
+  if (histogram_) {
+    histogram_->add(std::chrono::steady_clock::now() - start_, failed_);
+  }
 }
 
 void restinio_response::append(std::string body) {
@@ -55,8 +80,36 @@ void restinio_response::finish(caf::expected<std::string> body) {
   response_.append_body(std::move(text));
 }
 
+void restinio_response::finish(rest_response rsp) {
+  failed_ = rsp.is_error();
+  if (const auto& content_type = rsp.content_type()) {
+    response_.header().set_field(restinio::http_field::content_type,
+                                 content_type_to_string(*content_type));
+  }
+  for (const auto& [field, value] : rsp.headers()) {
+    response_.append_header(field, value);
+  }
+  if (rsp.chunks().empty()) {
+    finish(std::move(rsp).release());
+    return;
+  }
+  response_.header().status_code(
+    restinio::http_status_code_t{restinio::status_code::ok});
+  // We hand the chunks to restinio as-is so that they are written to the
+  // socket directly from the memory that they were produced in.
+  for (auto& chunk : std::move(rsp).release_chunks()) {
+    if (not chunk or chunk->size() == 0) {
+      continue;
+    }
+    body_size_ += chunk->size();
+    response_.append_body(restinio::writable_item_t{
+      std::make_shared<chunk_buffer>(std::move(chunk))});
+  }
+}
+
 void restinio_response::abort(uint16_t error_code, std::string message,
                               caf::error detail) {
+  failed_ = true;
   response_.header().status_code(restinio::http_status_code_t{error_code});
   std::string body;
   if (enable_detailed_errors_)
@@ -11,6 +11,7 @@
 #include "web/authenticator.hpp"
 #include "web/configuration.hpp"
 #include "web/mime.hpp"
+#include "web/request_metrics.hpp"
 #include "web/restinio_response.hpp"
 #include "web/restinio_server.hpp"
 
@@ -19,6 +20,7 @@
 #include <tenzir/concept/parseable/tenzir/expression.hpp>
 #include <tenzir/concept/parseable/to.hpp>
 #include <tenzir/detail/flat_map.hpp>
+#include <tenzir/detail/narrow.hpp>
 #include <tenzir/format/json.hpp>
 #include <tenzir/logger.hpp>
 #include <tenzir/node.hpp>
@@ -29,6 +31,8 @@
 #include <tenzir/spawn_or_connect_to_node.hpp>
 #include <tenzir/validate.hpp>
 
+#include <atomic>
+
 #include <caf/event_based_actor.hpp>
 #include <caf/scoped_actor.hpp>
 #include <caf/stateful_actor.hpp>
@@ -204,8 +208,7 @@ request_dispatcher_actor::behavior_type request_dispatcher(
                   endpoint.endpoint_id, std::move(*params))
         .then(
           [response](rest_response& rsp) {
-            auto&& body = std::move(rsp).release();
-            response->finish(std::move(body));
+            response->finish(std::move(rsp));
           },
           [response](const caf::error& e) {
             TENZIR_WARN("internal server error while handling request: {}", e);
@@ -215,30 +218,44 @@ request_dispatcher_actor::behavior_type request_dispatcher(
   };
 }
 
-void setup_route(caf::scoped_actor& self, std::unique_ptr<router_t>& router,
-                 request_dispatcher_actor dispatcher,
-                 const server_config& config, tenzir::rest_endpoint endpoint,
-                 rest_handler_actor handler) {
+/// A fixed set of request dispatchers that incoming requests are distributed
+/// over in a round-robin fashion. Shared between all I/O threads.
+struct dispatcher_pool {
+  std::vector<request_dispatcher_actor> dispatchers = {};
+  std::atomic<size_t> next = {};
+
+  auto pick() -> const request_dispatcher_actor& {
+    TENZIR_ASSERT(not dispatchers.empty());
+    return dispatchers[next.fetch_add(1, std::memory_order_relaxed)
+                       % dispatchers.size()];
+  }
+};
+
+void setup_route(std::unique_ptr<router_t>& router,
+                 std::shared_ptr<dispatcher_pool> dispatchers,
+                 request_metrics& metrics, const server_config& config,
+                 tenzir::rest_endpoint endpoint, rest_handler_actor handler) {
   auto method = to_restinio_method(endpoint.method);
   auto path = format_api_route(endpoint);
   TENZIR_VERBOSE("setting up route {}", path);
+  auto histogram = metrics.add_route(method.c_str(), path);
   // The handler just injects the request into the actor system, the
-  // actual processing starts in the request_dispatcher.
+  // actual processing starts in the request_dispatcher. This runs on any of
+  // the I/O threads, so we must not touch actor state here.
   router->add_handler(
     method, path,
-    [=, &self](request_handle_t req,
-               restinio::router::route_params_t route_params)
+    [=](request_handle_t req, restinio::router::route_params_t route_params)
       -> restinio::request_handling_status_t {
       auto response = std::make_shared<restinio_response>(
         std::move(req), std::move(route_params), config.enable_detailed_errors,
-        endpoint);
+        endpoint, histogram);
       if (config.cors_allowed_origin)
         response->add_header("Access-Control-Allow-Origin",
                              *config.cors_allowed_origin);
       for (auto const& [field, value] : config.response_headers)
         response->add_header(field, value);
-      self->send(dispatcher, atom::request_v, std::move(response),
-                 std::move(endpoint), handler);
+      caf::anon_send(dispatchers->pick(), atom::request_v, std::move(response),
+                     endpoint, handler);
       // TODO: Measure if always accepting introduces a noticeable
       // overhead and if so whether we can reject immediately in
       // some cases here.
@@ -324,11 +341,18 @@ auto server_command(const tenzir::invocation& inv, caf::actor_system& system)
     TENZIR_ERROR("failed to get web component: {}", authenticator.error());
     return caf::make_message(std::move(authenticator.error()));
   }
-  auto dispatcher
-    = self->spawn(request_dispatcher, *server_config, *authenticator);
+  // Spawn one dispatcher per I/O thread so that request parsing and
+  // authentication do not serialize on a single actor.
+  auto dispatchers = std::make_shared<dispatcher_pool>();
+  for (size_t i = 0; i < server_config->io_threads; ++i) {
+    auto dispatcher
+      = self->spawn(request_dispatcher, *server_config, *authenticator);
+    TENZIR_ASSERT(dispatcher);
+    dispatchers->dispatchers.push_back(std::move(dispatcher));
+  }
+  auto metrics = std::make_shared<request_metrics>();
   // Set up router.
   auto router = std::make_unique<router_t>();
-  TENZIR_ASSERT(dispatcher);
   // Set up API routes from plugins.
   std::vector<rest_handler_actor> handlers;
   std::vector<std::string> api_routes;
@@ -341,8 +365,8 @@ auto server_command(const tenzir::invocation& inv, caf::actor_system& system)
         continue;
       }
       api_routes.push_back(format_api_route(endpoint));
-      setup_route(self, router, dispatcher, *server_config, std::move(endpoint),
-                  handler);
+      setup_route(router, dispatchers, *metrics, *server_config,
+                  std::move(endpoint), handler);
     }
     // TODO: Monitor the handlers and re-spawn them if they go down.
   }
@@ -410,8 +434,20 @@ auto server_command(const tenzir::invocation& inv, caf::actor_system& system)
       "not serving a document root because no --web-root was given "
       "and the default location does not exist");
   }
+  // Report per-route request latencies as metrics. The set of routes is fixed
+  // from here on, so the reporter may read the metrics concurrently.
+  auto metrics_reporter = caf::actor{};
+  if (auto components = get_node_components<importer_actor>(self, node)) {
+    auto [importer] = std::move(*components);
+    metrics_reporter = spawn_request_metrics_reporter(
+      system, metrics, std::move(importer), std::chrono::seconds{10});
+  } else {
+    TENZIR_WARN("not reporting request metrics: failed to get importer: {}",
+                components.error());
+  }
   // Run server.
-  auto io_context = asio::io_context{};
+  auto io_context
+    = asio::io_context{detail::narrow_cast<int>(server_config->io_threads)};
   auto server = make_server(*server_config, std::move(router),
                             restinio::external_io_context(io_context));
   // Post initial action to asio event loop. Note that the action
@@ -422,13 +458,18 @@ auto server_command(const tenzir::invocation& inv, caf::actor_system& system)
                }},
                server);
   });
-  // Launch the thread on which the server will work.
-  std::thread server_thread{[&] {
-    auto const* scheme = server_config->require_tls ? "https" : "http";
-    TENZIR_INFO("server listening on on {}://{}:{}", scheme,
-                server_config->bind_address, server_config->port);
-    io_context.run();
-  }};
+  // Launch the threads on which the server will work.
+  auto const* scheme = server_config->require_tls ? "https" : "http";
+  TENZIR_INFO("server listening on on {}://{}:{} with {} I/O threads", scheme,
+              server_config->bind_address, server_config->port,
+              server_config->io_threads);
+  auto server_threads = std::vector<std::thread>{};
+  server_threads.reserve(server_config->io_threads);
+  for (size_t i = 0; i < server_config->io_threads; ++i) {
+    server_threads.emplace_back([&] {
+      io_context.run();
+    });
+  }
   // Run main loop.
   caf::error err;
   auto stop = false;
@@ -453,8 +494,15 @@ auto server_command(const tenzir::invocation& inv, caf::actor_system& system)
       return stop;
     });
   // Shutdown
-  self->send_exit(dispatcher, caf::exit_reason::user_shutdown);
-  self->wait_for(dispatcher);
+  for (const auto& dispatcher : dispatchers->dispatchers) {
+    self->send_exit(dispatcher, caf::exit_reason::user_shutdown);
+  }
+  for (const auto& dispatcher : dispatchers->dispatchers) {
+    self->wait_for(dispatcher);
+  }
+  if (metrics_reporter) {
+    self->send_exit(metrics_reporter, caf::exit_reason::user_shutdown);
+  }
   std::visit(
     detail::overload{
       [](auto& server) {
@@ -464,7 +512,9 @@ auto server_command(const tenzir::invocation& inv, caf::actor_system& system)
     server);
   for (auto& handler : handlers)
     self->send_exit(handler, caf::exit_reason::user_shutdown);
-  server_thread.join();
+  for (auto& thread : server_threads) {
+    thread.join();
+  }
   return caf::make_message(std::move(err));
 }
 
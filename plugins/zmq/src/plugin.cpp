@@ -10,10 +10,13 @@
 #include <tenzir/chunk.hpp>
 #include <tenzir/plugin.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <regex>
 #include <string>
+#include <vector>
 #include <zmq.hpp>
 
 using namespace std::chrono_literals;
@@ -25,6 +28,9 @@ namespace {
 /// The default ZeroMQ socket endpoint.
 constexpr auto default_endpoint = "tcp://127.0.0.1:5555";
 
+/// The default time to wait for a batch of messages to fill up.
+constexpr auto default_batch_timeout = std::chrono::milliseconds{100};
+
 struct saver_args {
   std::optional<located<std::string>> endpoint;
   std::optional<location> connect;
@@ -44,13 +50,17 @@ struct loader_args {
   std::optional<located<std::string>> filter;
   std::optional<location> connect;
   std::optional<location> listen;
+  std::optional<located<size_t>> batch_size;
+  std::optional<located<duration>> batch_timeout;
 
   template <class Inspector>
   friend auto inspect(Inspector& f, loader_args& x) -> bool {
     return f.object(x)
       .pretty_name("loader_args")
       .fields(f.field("endpoint", x.endpoint), f.field("filter", x.filter),
-              f.field("listen", x.listen), f.field("connect", x.connect));
+              f.field("listen", x.listen), f.field("connect", x.connect),
+              f.field("batch_size", x.batch_size),
+              f.field("batch_timeout", x.batch_timeout));
   }
 };
 
@@ -207,15 +217,16 @@ public:
       TENZIR_DEBUG("waiting until socket is ready to receive");
       if (not poll(socket_, ZMQ_POLLIN, timeout))
         return caf::make_error(ec::timeout, "timed out while polling socket");
-      auto message = std::make_shared<::zmq::message_t>();
+      // The message lives on the heap because small messages store their
+      // data inline, which would move along with the message.
+      auto message = std::make_unique<::zmq::message_t>();
       auto flags = ::zmq::recv_flags::none;
       auto bytes = socket_.recv(*message, flags);
       TENZIR_ASSERT(bytes); // only nullopt in non-blocking mode.
       TENZIR_DEBUG("got 0mq message with {} bytes", *bytes);
       const auto* data = message->data();
       auto size = message->size();
-      auto deleter = [msg = std::move(message)]() noexcept {};
-      return chunk::make(data, size, deleter);
+      return chunk::make(data, size, [msg = std::move(message)]() noexcept {});
     } catch (const ::zmq::error_t& e) {
       return make_error(e);
     }
@@ -326,8 +337,10 @@ public:
       TENZIR_ERROR(engine.error());
       return std::nullopt;
     }
-    auto make = [](operator_control_plane& ctrl,
-                   class engine engine) mutable -> generator<chunk_ptr> {
+    auto make = [](operator_control_plane& ctrl, class engine engine,
+                   size_t batch_size,
+                   duration batch_timeout) mutable -> generator<chunk_ptr> {
+      auto messages = std::vector<chunk_ptr>{};
       while (true) {
         // Poll in larger strides when we have no peers. If we have at least one
         // peer, there is no need to wait on the monitor.
@@ -337,17 +350,42 @@ public:
           co_yield {};
           continue;
         }
-        if (auto message = engine.receive(250ms)) {
-          co_yield *message;
-        } else if (message == ec::timeout) {
+        // Wait for the first message of a batch, and then for the batch to
+        // fill up until it is full or the batch timeout expires.
+        auto deadline = std::chrono::steady_clock::time_point{};
+        while (messages.size() < batch_size) {
+          auto timeout = std::chrono::milliseconds{250};
+          if (not messages.empty())
+            timeout = std::max(
+              std::chrono::ceil<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()),
+              std::chrono::milliseconds::zero());
+          auto message = engine.receive(timeout);
+          if (message) {
+            if (messages.empty())
+              deadline = std::chrono::steady_clock::now() + batch_timeout;
+            messages.push_back(std::move(*message));
+          } else if (message == ec::timeout) {
+            break;
+          } else {
+            diagnostic::error(message.error()).emit(ctrl.diagnostics());
+            co_return;
+          }
+        }
+        if (messages.empty()) {
           co_yield {};
-        } else {
-          diagnostic::error(message.error()).emit(ctrl.diagnostics());
-          break;
+          continue;
         }
+        // Without batching, we pass on messages as they are.
+        co_yield batch_size == 1 ? std::move(messages.front())
+                                 : join_lines(std::move(messages));
+        messages.clear();
       }
     };
-    return make(ctrl, std::move(*engine));
+    return make(ctrl, std::move(*engine),
+                args_.batch_size ? args_.batch_size->inner : 1,
+                args_.batch_timeout ? args_.batch_timeout->inner
+                                    : default_batch_timeout);
   }
 
   auto name() const -> std::string override {
@@ -432,6 +470,8 @@ public:
     parser.add("-f,--filter", args.filter, "<prefix>");
     parser.add("-l,--listen", args.listen);
     parser.add("-c,--connect", args.connect);
+    parser.add("-b,--batch-size", args.batch_size, "<n>");
+    parser.add("--batch-timeout", args.batch_timeout, "<duration>");
     parser.parse(p);
     if (args.listen && args.connect)
       diagnostic::error("both --listen and --connect provided")
@@ -439,6 +479,14 @@ public:
         .primary(*args.connect)
         .hint("--listen and --connect are mutually exclusive")
         .throw_();
+    if (args.batch_size && args.batch_size->inner == 0)
+      diagnostic::error("batch size must be positive")
+        .primary(args.batch_size->source)
+        .throw_();
+    if (args.batch_timeout && args.batch_timeout->inner < duration::zero())
+      diagnostic::error("batch timeout must not be negative")
+        .primary(args.batch_timeout->source)
+        .throw_();
     if (args.endpoint && args.endpoint->inner.find("://") == std::string::npos)
       args.endpoint->inner = fmt::format("tcp://{}", args.endpoint->inner);
     return std::make_unique<zmq_loader>(std::move(args));
@@ -456,6 +456,8 @@ setup() {
   check tenzir "from ${INPUTSDIR}/syslog/syslog-rfc3164.log read lines | parse line grok --include-unnamed \"(<%{NONNEGINT:priority}>\s*)?%{SYSLOGTIMESTAMP:timestamp} (%{HOSTNAME:hostname}/%{IPV4:hostip}|%{WORD:host}) %{SYSLOGPROG}:%{GREEDYDATA:message}\""
   check tenzir 'show version | put version="v4.5.0-71-gae887a0ca3-dirty" | parse version grok "%{TIMESTAMP_ISO8601}"'
   check tenzir 'show version | put line="55.3.244.1 GET /index.html 15824 0.043" | parse line grok "%{IP:client} %{WORD:method} %{URIPATHPARAM:request} %{NUMBER:bytes} %{NUMBER:duration}"'
+  check tenzir 'show version | put line="55.3.244.1 GET /index.html" | parse line grok --pattern "%{IP:client} %{WORD:method} %{URIPATHPARAM:request}" "%{IP:client} %{NUMBER:bytes}"'
+  check tenzir 'show version | put line="2023-10-19 error" | parse line grok "[0-9]{4}-[0-9]{2}-%{INT:day:int} %{WORD:level}"'
 }
 
 # bats test_tags=pipelines, csv
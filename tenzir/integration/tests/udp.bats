@@ -0,0 +1,42 @@
+: "${BATS_TEST_TIMEOUT:=10}"
+
+setup() {
+  bats_load_library bats-support
+  bats_load_library bats-assert
+  bats_load_library bats-tenzir
+}
+
+@test "loader - receive datagrams" {
+  check --bg listen \
+    tenzir "load udp://127.0.0.1:5500 --insert-newlines | read lines | head 2 | write json -c"
+  timeout 10 bash -c 'until lsof -i UDP:5500; do sleep 0.2; done'
+  printf foo | socat - UDP-SENDTO:127.0.0.1:5500
+  printf 'bar\n' | socat - UDP-SENDTO:127.0.0.1:5500
+  wait_all "${listen[@]}"
+}
+
+@test "loader - receive datagrams with shards" {
+  check --sort --bg listen \
+    tenzir "load udp://127.0.0.1:5501 --shards 2 --batch-size 1024 -n | read lines | head 2 | write json -c"
+  timeout 10 bash -c 'until lsof -i UDP:5501; do sleep 0.2; done'
+  printf foo | socat - UDP-SENDTO:127.0.0.1:5501
+  printf bar | socat - UDP-SENDTO:127.0.0.1:5501
+  wait_all "${listen[@]}"
+}
+
+@test "loader - receive datagrams over IPv6" {
+  check --bg listen \
+    tenzir "load udp://[::1]:5502 -n | read lines | head 1 | write json -c"
+  timeout 10 bash -c 'until lsof -i UDP:5502; do sleep 0.2; done'
+  printf foo | socat - UDP6-SENDTO:[::1]:5502
+  wait_all "${listen[@]}"
+}
+
+@test "loader - invalid options" {
+  check ! tenzir "load udp://127.0.0.1:5503 --batch-size 1025"
+  check ! tenzir "load udp://127.0.0.1:5503 --batch-size 0"
+  check ! tenzir "load udp://127.0.0.1:5503 --max-datagram-size 65537"
+  check ! tenzir "load udp://::1:5503"
+  check ! tenzir "load udp://[::1]5503"
+  check ! tenzir "load udp://127.0.0.1"
+}